@@ -0,0 +1,545 @@
+#include <stdint.h>
+#include "params.h"
+#include "avx2.h"
+
+#ifdef DILITHIUM_AVX2
+
+#include <immintrin.h>
+#include "ntt.h"
+#include "reduce.h"
+
+#define AVX2 __attribute__((target("avx2,popcnt")))
+
+int dilithium_avx2_disable = 0;
+
+/*
+ * rej_idx[m] lists the positions of the set bits of m, i.e. the lanes
+ * accepted by one round of rej_uniform_avx2, padded with zeros.
+ */
+static const uint8_t rej_idx[256][8] __attribute__((aligned(8))) = {
+  {0, 0, 0, 0, 0, 0, 0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0},
+  {1, 0, 0, 0, 0, 0, 0, 0},
+  {0, 1, 0, 0, 0, 0, 0, 0},
+  {2, 0, 0, 0, 0, 0, 0, 0},
+  {0, 2, 0, 0, 0, 0, 0, 0},
+  {1, 2, 0, 0, 0, 0, 0, 0},
+  {0, 1, 2, 0, 0, 0, 0, 0},
+  {3, 0, 0, 0, 0, 0, 0, 0},
+  {0, 3, 0, 0, 0, 0, 0, 0},
+  {1, 3, 0, 0, 0, 0, 0, 0},
+  {0, 1, 3, 0, 0, 0, 0, 0},
+  {2, 3, 0, 0, 0, 0, 0, 0},
+  {0, 2, 3, 0, 0, 0, 0, 0},
+  {1, 2, 3, 0, 0, 0, 0, 0},
+  {0, 1, 2, 3, 0, 0, 0, 0},
+  {4, 0, 0, 0, 0, 0, 0, 0},
+  {0, 4, 0, 0, 0, 0, 0, 0},
+  {1, 4, 0, 0, 0, 0, 0, 0},
+  {0, 1, 4, 0, 0, 0, 0, 0},
+  {2, 4, 0, 0, 0, 0, 0, 0},
+  {0, 2, 4, 0, 0, 0, 0, 0},
+  {1, 2, 4, 0, 0, 0, 0, 0},
+  {0, 1, 2, 4, 0, 0, 0, 0},
+  {3, 4, 0, 0, 0, 0, 0, 0},
+  {0, 3, 4, 0, 0, 0, 0, 0},
+  {1, 3, 4, 0, 0, 0, 0, 0},
+  {0, 1, 3, 4, 0, 0, 0, 0},
+  {2, 3, 4, 0, 0, 0, 0, 0},
+  {0, 2, 3, 4, 0, 0, 0, 0},
+  {1, 2, 3, 4, 0, 0, 0, 0},
+  {0, 1, 2, 3, 4, 0, 0, 0},
+  {5, 0, 0, 0, 0, 0, 0, 0},
+  {0, 5, 0, 0, 0, 0, 0, 0},
+  {1, 5, 0, 0, 0, 0, 0, 0},
+  {0, 1, 5, 0, 0, 0, 0, 0},
+  {2, 5, 0, 0, 0, 0, 0, 0},
+  {0, 2, 5, 0, 0, 0, 0, 0},
+  {1, 2, 5, 0, 0, 0, 0, 0},
+  {0, 1, 2, 5, 0, 0, 0, 0},
+  {3, 5, 0, 0, 0, 0, 0, 0},
+  {0, 3, 5, 0, 0, 0, 0, 0},
+  {1, 3, 5, 0, 0, 0, 0, 0},
+  {0, 1, 3, 5, 0, 0, 0, 0},
+  {2, 3, 5, 0, 0, 0, 0, 0},
+  {0, 2, 3, 5, 0, 0, 0, 0},
+  {1, 2, 3, 5, 0, 0, 0, 0},
+  {0, 1, 2, 3, 5, 0, 0, 0},
+  {4, 5, 0, 0, 0, 0, 0, 0},
+  {0, 4, 5, 0, 0, 0, 0, 0},
+  {1, 4, 5, 0, 0, 0, 0, 0},
+  {0, 1, 4, 5, 0, 0, 0, 0},
+  {2, 4, 5, 0, 0, 0, 0, 0},
+  {0, 2, 4, 5, 0, 0, 0, 0},
+  {1, 2, 4, 5, 0, 0, 0, 0},
+  {0, 1, 2, 4, 5, 0, 0, 0},
+  {3, 4, 5, 0, 0, 0, 0, 0},
+  {0, 3, 4, 5, 0, 0, 0, 0},
+  {1, 3, 4, 5, 0, 0, 0, 0},
+  {0, 1, 3, 4, 5, 0, 0, 0},
+  {2, 3, 4, 5, 0, 0, 0, 0},
+  {0, 2, 3, 4, 5, 0, 0, 0},
+  {1, 2, 3, 4, 5, 0, 0, 0},
+  {0, 1, 2, 3, 4, 5, 0, 0},
+  {6, 0, 0, 0, 0, 0, 0, 0},
+  {0, 6, 0, 0, 0, 0, 0, 0},
+  {1, 6, 0, 0, 0, 0, 0, 0},
+  {0, 1, 6, 0, 0, 0, 0, 0},
+  {2, 6, 0, 0, 0, 0, 0, 0},
+  {0, 2, 6, 0, 0, 0, 0, 0},
+  {1, 2, 6, 0, 0, 0, 0, 0},
+  {0, 1, 2, 6, 0, 0, 0, 0},
+  {3, 6, 0, 0, 0, 0, 0, 0},
+  {0, 3, 6, 0, 0, 0, 0, 0},
+  {1, 3, 6, 0, 0, 0, 0, 0},
+  {0, 1, 3, 6, 0, 0, 0, 0},
+  {2, 3, 6, 0, 0, 0, 0, 0},
+  {0, 2, 3, 6, 0, 0, 0, 0},
+  {1, 2, 3, 6, 0, 0, 0, 0},
+  {0, 1, 2, 3, 6, 0, 0, 0},
+  {4, 6, 0, 0, 0, 0, 0, 0},
+  {0, 4, 6, 0, 0, 0, 0, 0},
+  {1, 4, 6, 0, 0, 0, 0, 0},
+  {0, 1, 4, 6, 0, 0, 0, 0},
+  {2, 4, 6, 0, 0, 0, 0, 0},
+  {0, 2, 4, 6, 0, 0, 0, 0},
+  {1, 2, 4, 6, 0, 0, 0, 0},
+  {0, 1, 2, 4, 6, 0, 0, 0},
+  {3, 4, 6, 0, 0, 0, 0, 0},
+  {0, 3, 4, 6, 0, 0, 0, 0},
+  {1, 3, 4, 6, 0, 0, 0, 0},
+  {0, 1, 3, 4, 6, 0, 0, 0},
+  {2, 3, 4, 6, 0, 0, 0, 0},
+  {0, 2, 3, 4, 6, 0, 0, 0},
+  {1, 2, 3, 4, 6, 0, 0, 0},
+  {0, 1, 2, 3, 4, 6, 0, 0},
+  {5, 6, 0, 0, 0, 0, 0, 0},
+  {0, 5, 6, 0, 0, 0, 0, 0},
+  {1, 5, 6, 0, 0, 0, 0, 0},
+  {0, 1, 5, 6, 0, 0, 0, 0},
+  {2, 5, 6, 0, 0, 0, 0, 0},
+  {0, 2, 5, 6, 0, 0, 0, 0},
+  {1, 2, 5, 6, 0, 0, 0, 0},
+  {0, 1, 2, 5, 6, 0, 0, 0},
+  {3, 5, 6, 0, 0, 0, 0, 0},
+  {0, 3, 5, 6, 0, 0, 0, 0},
+  {1, 3, 5, 6, 0, 0, 0, 0},
+  {0, 1, 3, 5, 6, 0, 0, 0},
+  {2, 3, 5, 6, 0, 0, 0, 0},
+  {0, 2, 3, 5, 6, 0, 0, 0},
+  {1, 2, 3, 5, 6, 0, 0, 0},
+  {0, 1, 2, 3, 5, 6, 0, 0},
+  {4, 5, 6, 0, 0, 0, 0, 0},
+  {0, 4, 5, 6, 0, 0, 0, 0},
+  {1, 4, 5, 6, 0, 0, 0, 0},
+  {0, 1, 4, 5, 6, 0, 0, 0},
+  {2, 4, 5, 6, 0, 0, 0, 0},
+  {0, 2, 4, 5, 6, 0, 0, 0},
+  {1, 2, 4, 5, 6, 0, 0, 0},
+  {0, 1, 2, 4, 5, 6, 0, 0},
+  {3, 4, 5, 6, 0, 0, 0, 0},
+  {0, 3, 4, 5, 6, 0, 0, 0},
+  {1, 3, 4, 5, 6, 0, 0, 0},
+  {0, 1, 3, 4, 5, 6, 0, 0},
+  {2, 3, 4, 5, 6, 0, 0, 0},
+  {0, 2, 3, 4, 5, 6, 0, 0},
+  {1, 2, 3, 4, 5, 6, 0, 0},
+  {0, 1, 2, 3, 4, 5, 6, 0},
+  {7, 0, 0, 0, 0, 0, 0, 0},
+  {0, 7, 0, 0, 0, 0, 0, 0},
+  {1, 7, 0, 0, 0, 0, 0, 0},
+  {0, 1, 7, 0, 0, 0, 0, 0},
+  {2, 7, 0, 0, 0, 0, 0, 0},
+  {0, 2, 7, 0, 0, 0, 0, 0},
+  {1, 2, 7, 0, 0, 0, 0, 0},
+  {0, 1, 2, 7, 0, 0, 0, 0},
+  {3, 7, 0, 0, 0, 0, 0, 0},
+  {0, 3, 7, 0, 0, 0, 0, 0},
+  {1, 3, 7, 0, 0, 0, 0, 0},
+  {0, 1, 3, 7, 0, 0, 0, 0},
+  {2, 3, 7, 0, 0, 0, 0, 0},
+  {0, 2, 3, 7, 0, 0, 0, 0},
+  {1, 2, 3, 7, 0, 0, 0, 0},
+  {0, 1, 2, 3, 7, 0, 0, 0},
+  {4, 7, 0, 0, 0, 0, 0, 0},
+  {0, 4, 7, 0, 0, 0, 0, 0},
+  {1, 4, 7, 0, 0, 0, 0, 0},
+  {0, 1, 4, 7, 0, 0, 0, 0},
+  {2, 4, 7, 0, 0, 0, 0, 0},
+  {0, 2, 4, 7, 0, 0, 0, 0},
+  {1, 2, 4, 7, 0, 0, 0, 0},
+  {0, 1, 2, 4, 7, 0, 0, 0},
+  {3, 4, 7, 0, 0, 0, 0, 0},
+  {0, 3, 4, 7, 0, 0, 0, 0},
+  {1, 3, 4, 7, 0, 0, 0, 0},
+  {0, 1, 3, 4, 7, 0, 0, 0},
+  {2, 3, 4, 7, 0, 0, 0, 0},
+  {0, 2, 3, 4, 7, 0, 0, 0},
+  {1, 2, 3, 4, 7, 0, 0, 0},
+  {0, 1, 2, 3, 4, 7, 0, 0},
+  {5, 7, 0, 0, 0, 0, 0, 0},
+  {0, 5, 7, 0, 0, 0, 0, 0},
+  {1, 5, 7, 0, 0, 0, 0, 0},
+  {0, 1, 5, 7, 0, 0, 0, 0},
+  {2, 5, 7, 0, 0, 0, 0, 0},
+  {0, 2, 5, 7, 0, 0, 0, 0},
+  {1, 2, 5, 7, 0, 0, 0, 0},
+  {0, 1, 2, 5, 7, 0, 0, 0},
+  {3, 5, 7, 0, 0, 0, 0, 0},
+  {0, 3, 5, 7, 0, 0, 0, 0},
+  {1, 3, 5, 7, 0, 0, 0, 0},
+  {0, 1, 3, 5, 7, 0, 0, 0},
+  {2, 3, 5, 7, 0, 0, 0, 0},
+  {0, 2, 3, 5, 7, 0, 0, 0},
+  {1, 2, 3, 5, 7, 0, 0, 0},
+  {0, 1, 2, 3, 5, 7, 0, 0},
+  {4, 5, 7, 0, 0, 0, 0, 0},
+  {0, 4, 5, 7, 0, 0, 0, 0},
+  {1, 4, 5, 7, 0, 0, 0, 0},
+  {0, 1, 4, 5, 7, 0, 0, 0},
+  {2, 4, 5, 7, 0, 0, 0, 0},
+  {0, 2, 4, 5, 7, 0, 0, 0},
+  {1, 2, 4, 5, 7, 0, 0, 0},
+  {0, 1, 2, 4, 5, 7, 0, 0},
+  {3, 4, 5, 7, 0, 0, 0, 0},
+  {0, 3, 4, 5, 7, 0, 0, 0},
+  {1, 3, 4, 5, 7, 0, 0, 0},
+  {0, 1, 3, 4, 5, 7, 0, 0},
+  {2, 3, 4, 5, 7, 0, 0, 0},
+  {0, 2, 3, 4, 5, 7, 0, 0},
+  {1, 2, 3, 4, 5, 7, 0, 0},
+  {0, 1, 2, 3, 4, 5, 7, 0},
+  {6, 7, 0, 0, 0, 0, 0, 0},
+  {0, 6, 7, 0, 0, 0, 0, 0},
+  {1, 6, 7, 0, 0, 0, 0, 0},
+  {0, 1, 6, 7, 0, 0, 0, 0},
+  {2, 6, 7, 0, 0, 0, 0, 0},
+  {0, 2, 6, 7, 0, 0, 0, 0},
+  {1, 2, 6, 7, 0, 0, 0, 0},
+  {0, 1, 2, 6, 7, 0, 0, 0},
+  {3, 6, 7, 0, 0, 0, 0, 0},
+  {0, 3, 6, 7, 0, 0, 0, 0},
+  {1, 3, 6, 7, 0, 0, 0, 0},
+  {0, 1, 3, 6, 7, 0, 0, 0},
+  {2, 3, 6, 7, 0, 0, 0, 0},
+  {0, 2, 3, 6, 7, 0, 0, 0},
+  {1, 2, 3, 6, 7, 0, 0, 0},
+  {0, 1, 2, 3, 6, 7, 0, 0},
+  {4, 6, 7, 0, 0, 0, 0, 0},
+  {0, 4, 6, 7, 0, 0, 0, 0},
+  {1, 4, 6, 7, 0, 0, 0, 0},
+  {0, 1, 4, 6, 7, 0, 0, 0},
+  {2, 4, 6, 7, 0, 0, 0, 0},
+  {0, 2, 4, 6, 7, 0, 0, 0},
+  {1, 2, 4, 6, 7, 0, 0, 0},
+  {0, 1, 2, 4, 6, 7, 0, 0},
+  {3, 4, 6, 7, 0, 0, 0, 0},
+  {0, 3, 4, 6, 7, 0, 0, 0},
+  {1, 3, 4, 6, 7, 0, 0, 0},
+  {0, 1, 3, 4, 6, 7, 0, 0},
+  {2, 3, 4, 6, 7, 0, 0, 0},
+  {0, 2, 3, 4, 6, 7, 0, 0},
+  {1, 2, 3, 4, 6, 7, 0, 0},
+  {0, 1, 2, 3, 4, 6, 7, 0},
+  {5, 6, 7, 0, 0, 0, 0, 0},
+  {0, 5, 6, 7, 0, 0, 0, 0},
+  {1, 5, 6, 7, 0, 0, 0, 0},
+  {0, 1, 5, 6, 7, 0, 0, 0},
+  {2, 5, 6, 7, 0, 0, 0, 0},
+  {0, 2, 5, 6, 7, 0, 0, 0},
+  {1, 2, 5, 6, 7, 0, 0, 0},
+  {0, 1, 2, 5, 6, 7, 0, 0},
+  {3, 5, 6, 7, 0, 0, 0, 0},
+  {0, 3, 5, 6, 7, 0, 0, 0},
+  {1, 3, 5, 6, 7, 0, 0, 0},
+  {0, 1, 3, 5, 6, 7, 0, 0},
+  {2, 3, 5, 6, 7, 0, 0, 0},
+  {0, 2, 3, 5, 6, 7, 0, 0},
+  {1, 2, 3, 5, 6, 7, 0, 0},
+  {0, 1, 2, 3, 5, 6, 7, 0},
+  {4, 5, 6, 7, 0, 0, 0, 0},
+  {0, 4, 5, 6, 7, 0, 0, 0},
+  {1, 4, 5, 6, 7, 0, 0, 0},
+  {0, 1, 4, 5, 6, 7, 0, 0},
+  {2, 4, 5, 6, 7, 0, 0, 0},
+  {0, 2, 4, 5, 6, 7, 0, 0},
+  {1, 2, 4, 5, 6, 7, 0, 0},
+  {0, 1, 2, 4, 5, 6, 7, 0},
+  {3, 4, 5, 6, 7, 0, 0, 0},
+  {0, 3, 4, 5, 6, 7, 0, 0},
+  {1, 3, 4, 5, 6, 7, 0, 0},
+  {0, 1, 3, 4, 5, 6, 7, 0},
+  {2, 3, 4, 5, 6, 7, 0, 0},
+  {0, 2, 3, 4, 5, 6, 7, 0},
+  {1, 2, 3, 4, 5, 6, 7, 0},
+  {0, 1, 2, 3, 4, 5, 6, 7}
+};
+
+/*************************************************
+* Name:        montmul
+*
+* Description: Montgomery multiplication of eight pairs of 32-bit lanes;
+*              every lane equals montgomery_reduce((int64_t)a*b).
+*              Even and odd lanes are multiplied separately into 64-bit
+*              products.
+*
+* Arguments:   - __m256i a: first factors
+*              - __m256i b: second factors
+*
+* Returns a*b*2^{-32} mod Q per lane, in (-Q,Q)
+**************************************************/
+static inline __m256i AVX2 montmul(__m256i a, __m256i b)
+{
+  const __m256i q = _mm256_set1_epi32(Q);
+  const __m256i qinv = _mm256_set1_epi32(QINV);
+  __m256i lo, hi, tlo, thi;
+
+  lo = _mm256_mul_epi32(a, b);
+  hi = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+  tlo = _mm256_mul_epi32(lo, qinv);
+  thi = _mm256_mul_epi32(hi, qinv);
+  tlo = _mm256_mul_epi32(tlo, q);
+  thi = _mm256_mul_epi32(thi, q);
+  lo = _mm256_sub_epi64(lo, tlo);
+  hi = _mm256_sub_epi64(hi, thi);
+  return _mm256_blend_epi32(_mm256_srli_epi64(lo, 32), hi, 0xAA);
+}
+
+static inline void AVX2 butterfly(__m256i *a, __m256i *b, __m256i zeta)
+{
+  __m256i t = montmul(zeta, *b);
+  *b = _mm256_sub_epi32(*a, t);
+  *a = _mm256_add_epi32(*a, t);
+}
+
+static inline void AVX2 butterfly_inv(__m256i *a, __m256i *b, __m256i zeta)
+{
+  __m256i t = *a;
+  *a = _mm256_add_epi32(t, *b);
+  *b = montmul(zeta, _mm256_sub_epi32(t, *b));
+}
+
+/*
+ * Zetas for the last three NTT layers (first three inverse layers), in
+ * the order the coefficients sit in registers after the permutes below.
+ * The inverse NTT uses the zetas in reverse order and negated.
+ */
+static inline __m256i AVX2 zetas_len4(const int32_t *z, int inv)
+{
+  __m256i t = _mm256_castsi128_si256(_mm_loadl_epi64((const __m128i *)z));
+
+  if(inv)
+    return _mm256_sub_epi32(_mm256_setzero_si256(),
+                            _mm256_permutevar8x32_epi32(t, _mm256_setr_epi32(1, 1, 1, 1, 0, 0, 0, 0)));
+  return _mm256_permutevar8x32_epi32(t, _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1));
+}
+
+static inline __m256i AVX2 zetas_len2(const int32_t *z, int inv)
+{
+  __m256i t = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)z));
+
+  if(inv)
+    return _mm256_sub_epi32(_mm256_setzero_si256(),
+                            _mm256_permutevar8x32_epi32(t, _mm256_setr_epi32(3, 3, 1, 1, 2, 2, 0, 0)));
+  return _mm256_permutevar8x32_epi32(t, _mm256_setr_epi32(0, 0, 2, 2, 1, 1, 3, 3));
+}
+
+static inline __m256i AVX2 zetas_len1(const int32_t *z, int inv)
+{
+  __m256i t = _mm256_loadu_si256((const __m256i *)z);
+
+  if(inv)
+    return _mm256_sub_epi32(_mm256_setzero_si256(),
+                            _mm256_permutevar8x32_epi32(t, _mm256_setr_epi32(7, 6, 3, 2, 5, 4, 1, 0)));
+  return _mm256_permutevar8x32_epi32(t, _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7));
+}
+
+/*************************************************
+* Name:        ntt_avx2
+*
+* Description: AVX2 version of ntt. Layers with len >= 8 work on whole
+*              registers; the last three layers work on pairs of
+*              registers after permuting the coefficients so that every
+*              butterfly has its operands in the same lane of x and y.
+*
+* Arguments:   - int32_t a[N]: input/output coefficient array
+**************************************************/
+void AVX2 ntt_avx2(int32_t a[N])
+{
+  unsigned int d, start, j, p, k;
+  __m256i v[N/8], s, t, x, y, zeta;
+
+  for(j = 0; j < N/8; j++)
+    v[j] = _mm256_loadu_si256((const __m256i *)&a[8*j]);
+
+  k = 0;
+  for(d = 16; d >= 1; d >>= 1) {
+    for(start = 0; start < N/8; start += 2*d) {
+      zeta = _mm256_set1_epi32(zetas[++k]);
+      for(j = start; j < start + d; j++)
+        butterfly(&v[j], &v[j + d], zeta);
+    }
+  }
+
+  for(p = 0; p < N/16; p++) {
+    s = v[2*p];
+    t = v[2*p+1];
+
+    x = _mm256_permute2x128_si256(s, t, 0x20);
+    y = _mm256_permute2x128_si256(s, t, 0x31);
+    butterfly(&x, &y, zetas_len4(&zetas[32+2*p], 0));
+    s = _mm256_permute2x128_si256(x, y, 0x20);
+    t = _mm256_permute2x128_si256(x, y, 0x31);
+
+    x = _mm256_unpacklo_epi64(s, t);
+    y = _mm256_unpackhi_epi64(s, t);
+    butterfly(&x, &y, zetas_len2(&zetas[64+4*p], 0));
+    s = _mm256_unpacklo_epi64(x, y);
+    t = _mm256_unpackhi_epi64(x, y);
+
+    s = _mm256_shuffle_epi32(s, 0xD8);
+    t = _mm256_shuffle_epi32(t, 0xD8);
+    x = _mm256_unpacklo_epi64(s, t);
+    y = _mm256_unpackhi_epi64(s, t);
+    butterfly(&x, &y, zetas_len1(&zetas[128+8*p], 0));
+    v[2*p] = _mm256_unpacklo_epi32(x, y);
+    v[2*p+1] = _mm256_unpackhi_epi32(x, y);
+  }
+
+  for(j = 0; j < N/8; j++)
+    _mm256_storeu_si256((__m256i *)&a[8*j], v[j]);
+}
+
+/*************************************************
+* Name:        invntt_tomont_avx2
+*
+* Description: AVX2 version of invntt_tomont; runs the steps of ntt_avx2
+*              backwards.
+*
+* Arguments:   - int32_t a[N]: input/output coefficient array
+**************************************************/
+void AVX2 invntt_tomont_avx2(int32_t a[N])
+{
+  unsigned int d, start, j, p, k;
+  __m256i v[N/8], s, t, x, y, zeta;
+  const __m256i f = _mm256_set1_epi32(41978); // mont^2/256
+
+  for(p = 0; p < N/16; p++) {
+    s = _mm256_loadu_si256((const __m256i *)&a[16*p]);
+    t = _mm256_loadu_si256((const __m256i *)&a[16*p+8]);
+
+    s = _mm256_shuffle_epi32(s, 0xD8);
+    t = _mm256_shuffle_epi32(t, 0xD8);
+    x = _mm256_unpacklo_epi64(s, t);
+    y = _mm256_unpackhi_epi64(s, t);
+    butterfly_inv(&x, &y, zetas_len1(&zetas[248-8*p], 1));
+    s = _mm256_unpacklo_epi32(x, y);
+    t = _mm256_unpackhi_epi32(x, y);
+
+    x = _mm256_unpacklo_epi64(s, t);
+    y = _mm256_unpackhi_epi64(s, t);
+    butterfly_inv(&x, &y, zetas_len2(&zetas[124-4*p], 1));
+    s = _mm256_unpacklo_epi64(x, y);
+    t = _mm256_unpackhi_epi64(x, y);
+
+    x = _mm256_permute2x128_si256(s, t, 0x20);
+    y = _mm256_permute2x128_si256(s, t, 0x31);
+    butterfly_inv(&x, &y, zetas_len4(&zetas[62-2*p], 1));
+    v[2*p] = _mm256_permute2x128_si256(x, y, 0x20);
+    v[2*p+1] = _mm256_permute2x128_si256(x, y, 0x31);
+  }
+
+  k = 32;
+  for(d = 1; d < N/8; d <<= 1) {
+    for(start = 0; start < N/8; start += 2*d) {
+      zeta = _mm256_set1_epi32(-zetas[--k]);
+      for(j = start; j < start + d; j++)
+        butterfly_inv(&v[j], &v[j + d], zeta);
+    }
+  }
+
+  for(j = 0; j < N/8; j++)
+    _mm256_storeu_si256((__m256i *)&a[8*j], montmul(f, v[j]));
+}
+
+/*************************************************
+* Name:        poly_pointwise_montgomery_avx2
+*
+* Description: AVX2 version of poly_pointwise_montgomery.
+*
+* Arguments:   - poly *c: pointer to output polynomial
+*              - const poly *a: pointer to first input polynomial
+*              - const poly *b: pointer to second input polynomial
+**************************************************/
+void AVX2 poly_pointwise_montgomery_avx2(poly *c, const poly *a, const poly *b)
+{
+  unsigned int i;
+  __m256i f, g;
+
+  for(i = 0; i < N/8; i++) {
+    f = _mm256_loadu_si256((const __m256i *)&a->coeffs[8*i]);
+    g = _mm256_loadu_si256((const __m256i *)&b->coeffs[8*i]);
+    _mm256_storeu_si256((__m256i *)&c->coeffs[8*i], montmul(f, g));
+  }
+}
+
+/*************************************************
+* Name:        rej_uniform_avx2
+*
+* Description: AVX2 version of rej_uniform. Takes eight 23-bit candidates
+*              from 24 bytes per round and stores the accepted ones in
+*              order; finishes with the scalar loop.
+*
+* Arguments:   - int32_t *a: pointer to output array
+*              - unsigned int len: number of coefficients to be sampled
+*              - const uint8_t *buf: array of random bytes
+*              - unsigned int buflen: length of array of random bytes
+*
+* Returns number of sampled coefficients. Can be smaller than len if not
+* enough random bytes were given.
+**************************************************/
+unsigned int AVX2 rej_uniform_avx2(int32_t *a,
+                                   unsigned int len,
+                                   const uint8_t *buf,
+                                   unsigned int buflen)
+{
+  unsigned int ctr, pos, good;
+  uint32_t t;
+  const __m256i bound = _mm256_set1_epi32(Q);
+  const __m256i mask = _mm256_set1_epi32(0x7FFFFF);
+  const __m256i idx8 = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1,
+                                        6, 7, 8, -1, 9, 10, 11, -1,
+                                        4, 5, 6, -1, 7, 8, 9, -1,
+                                        10, 11, 12, -1, 13, 14, 15, -1);
+  __m256i d, g;
+
+  ctr = pos = 0;
+  while(ctr + 8 <= len && pos + 24 <= buflen) {
+    d = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)&buf[pos]));
+    d = _mm256_inserti128_si256(d, _mm_loadu_si128((const __m128i *)&buf[pos+8]), 1);
+    d = _mm256_shuffle_epi8(d, idx8);
+    d = _mm256_and_si256(d, mask);
+    pos += 24;
+
+    g = _mm256_cmpgt_epi32(bound, d);
+    good = (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(g));
+    g = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)rej_idx[good]));
+    d = _mm256_permutevar8x32_epi32(d, g);
+    _mm256_storeu_si256((__m256i *)&a[ctr], d);
+    ctr += __builtin_popcount(good);
+  }
+
+  while(ctr < len && pos + 3 <= buflen) {
+    t  = buf[pos++];
+    t |= (uint32_t)buf[pos++] << 8;
+    t |= (uint32_t)buf[pos++] << 16;
+    t &= 0x7FFFFF;
+
+    if(t < Q)
+      a[ctr++] = t;
+  }
+
+  return ctr;
+}
+
+#endif
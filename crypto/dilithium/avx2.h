@@ -0,0 +1,46 @@
+#ifndef AVX2_H
+#define AVX2_H
+
+#include <stdint.h>
+#include "params.h"
+#include "poly.h"
+
+/*
+ * AVX2 kernels are compiled with per-function target attributes, so the
+ * library is built without -mavx2 and the reference code is used on CPUs
+ * without AVX2. Define DILITHIUM_NO_AVX2 to build the reference code only.
+ * All kernels produce exactly the same output as the reference functions
+ * they replace.
+ */
+#if !defined(DILITHIUM_NO_AVX2) && (defined(__x86_64__) || defined(__i386__)) \
+    && (defined(__GNUC__) || defined(__clang__))
+#define DILITHIUM_AVX2
+
+/*
+ * Set to non-zero to force the reference kernels (e.g. to compare speed).
+ * Only change it while no other thread is using the library.
+ */
+#define dilithium_avx2_disable DILITHIUM_NAMESPACE(dilithium_avx2_disable)
+extern int dilithium_avx2_disable;
+
+static inline int dilithium_has_avx2(void)
+{
+  return !dilithium_avx2_disable
+         && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+}
+
+#define ntt_avx2 DILITHIUM_NAMESPACE(ntt_avx2)
+void ntt_avx2(int32_t a[N]);
+#define invntt_tomont_avx2 DILITHIUM_NAMESPACE(invntt_tomont_avx2)
+void invntt_tomont_avx2(int32_t a[N]);
+#define poly_pointwise_montgomery_avx2 DILITHIUM_NAMESPACE(poly_pointwise_montgomery_avx2)
+void poly_pointwise_montgomery_avx2(poly *c, const poly *a, const poly *b);
+#define rej_uniform_avx2 DILITHIUM_NAMESPACE(rej_uniform_avx2)
+unsigned int rej_uniform_avx2(int32_t *a,
+                              unsigned int len,
+                              const uint8_t *buf,
+                              unsigned int buflen);
+
+#endif
+
+#endif
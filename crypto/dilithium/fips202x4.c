@@ -0,0 +1,426 @@
+#include <stddef.h>
+#include <stdint.h>
+#include "fips202.h"
+#include "fips202x4.h"
+#include "avx2.h"
+
+#ifdef DILITHIUM_AVX2
+#include <immintrin.h>
+
+#define AVX2 __attribute__((target("avx2")))
+#define NROUNDS 24
+#define XOR(a, b) _mm256_xor_si256(a, b)
+#define XOR5(a, b, c, d, e) XOR(XOR(XOR(a, b), XOR(c, d)), e)
+#define ANDNOT(a, b) _mm256_andnot_si256(a, b)
+#define ROL(a, offset) _mm256_or_si256(_mm256_slli_epi64(a, offset), \
+                                       _mm256_srli_epi64(a, 64-(offset)))
+
+/*************************************************
+* Name:        KeccakF1600_StatePermute4x_avx2
+*
+* Description: The Keccak F1600 Permutation on four interleaved states,
+*              one state per 64-bit lane of every register;
+*              same steps as KeccakF1600_StatePermute
+*
+* Arguments:   - uint64_t *state: pointer to input/output Keccak states
+**************************************************/
+static void AVX2 KeccakF1600_StatePermute4x_avx2(uint64_t state[4*25])
+{
+  int round;
+
+  __m256i Aba, Abe, Abi, Abo, Abu;
+  __m256i Aga, Age, Agi, Ago, Agu;
+  __m256i Aka, Ake, Aki, Ako, Aku;
+  __m256i Ama, Ame, Ami, Amo, Amu;
+  __m256i Asa, Ase, Asi, Aso, Asu;
+  __m256i BCa, BCe, BCi, BCo, BCu;
+  __m256i Da, De, Di, Do, Du;
+  __m256i Eba, Ebe, Ebi, Ebo, Ebu;
+  __m256i Ega, Ege, Egi, Ego, Egu;
+  __m256i Eka, Eke, Eki, Eko, Eku;
+  __m256i Ema, Eme, Emi, Emo, Emu;
+  __m256i Esa, Ese, Esi, Eso, Esu;
+
+  //copyFromState(A, state)
+  Aba = _mm256_loadu_si256((const __m256i *)&state[4*0]);
+  Abe = _mm256_loadu_si256((const __m256i *)&state[4*1]);
+  Abi = _mm256_loadu_si256((const __m256i *)&state[4*2]);
+  Abo = _mm256_loadu_si256((const __m256i *)&state[4*3]);
+  Abu = _mm256_loadu_si256((const __m256i *)&state[4*4]);
+  Aga = _mm256_loadu_si256((const __m256i *)&state[4*5]);
+  Age = _mm256_loadu_si256((const __m256i *)&state[4*6]);
+  Agi = _mm256_loadu_si256((const __m256i *)&state[4*7]);
+  Ago = _mm256_loadu_si256((const __m256i *)&state[4*8]);
+  Agu = _mm256_loadu_si256((const __m256i *)&state[4*9]);
+  Aka = _mm256_loadu_si256((const __m256i *)&state[4*10]);
+  Ake = _mm256_loadu_si256((const __m256i *)&state[4*11]);
+  Aki = _mm256_loadu_si256((const __m256i *)&state[4*12]);
+  Ako = _mm256_loadu_si256((const __m256i *)&state[4*13]);
+  Aku = _mm256_loadu_si256((const __m256i *)&state[4*14]);
+  Ama = _mm256_loadu_si256((const __m256i *)&state[4*15]);
+  Ame = _mm256_loadu_si256((const __m256i *)&state[4*16]);
+  Ami = _mm256_loadu_si256((const __m256i *)&state[4*17]);
+  Amo = _mm256_loadu_si256((const __m256i *)&state[4*18]);
+  Amu = _mm256_loadu_si256((const __m256i *)&state[4*19]);
+  Asa = _mm256_loadu_si256((const __m256i *)&state[4*20]);
+  Ase = _mm256_loadu_si256((const __m256i *)&state[4*21]);
+  Asi = _mm256_loadu_si256((const __m256i *)&state[4*22]);
+  Aso = _mm256_loadu_si256((const __m256i *)&state[4*23]);
+  Asu = _mm256_loadu_si256((const __m256i *)&state[4*24]);
+
+  for( round = 0; round < NROUNDS; round += 2 )
+  {
+    //    prepareTheta
+    BCa = XOR5(Aba, Aga, Aka, Ama, Asa);
+    BCe = XOR5(Abe, Age, Ake, Ame, Ase);
+    BCi = XOR5(Abi, Agi, Aki, Ami, Asi);
+    BCo = XOR5(Abo, Ago, Ako, Amo, Aso);
+    BCu = XOR5(Abu, Agu, Aku, Amu, Asu);
+
+    //thetaRhoPiChiIotaPrepareTheta(round  , A, E)
+    Da = XOR(BCu, ROL(BCe, 1));
+    De = XOR(BCa, ROL(BCi, 1));
+    Di = XOR(BCe, ROL(BCo, 1));
+    Do = XOR(BCi, ROL(BCu, 1));
+    Du = XOR(BCo, ROL(BCa, 1));
+
+    Aba = XOR(Aba, Da);
+    BCa = Aba;
+    Age = XOR(Age, De);
+    BCe = ROL(Age, 44);
+    Aki = XOR(Aki, Di);
+    BCi = ROL(Aki, 43);
+    Amo = XOR(Amo, Do);
+    BCo = ROL(Amo, 21);
+    Asu = XOR(Asu, Du);
+    BCu = ROL(Asu, 14);
+    Eba = XOR(BCa, ANDNOT(BCe, BCi));
+    Eba = XOR(Eba, _mm256_set1_epi64x((long long)KeccakF_RoundConstants[round]));
+    Ebe = XOR(BCe, ANDNOT(BCi, BCo));
+    Ebi = XOR(BCi, ANDNOT(BCo, BCu));
+    Ebo = XOR(BCo, ANDNOT(BCu, BCa));
+    Ebu = XOR(BCu, ANDNOT(BCa, BCe));
+
+    Abo = XOR(Abo, Do);
+    BCa = ROL(Abo, 28);
+    Agu = XOR(Agu, Du);
+    BCe = ROL(Agu, 20);
+    Aka = XOR(Aka, Da);
+    BCi = ROL(Aka, 3);
+    Ame = XOR(Ame, De);
+    BCo = ROL(Ame, 45);
+    Asi = XOR(Asi, Di);
+    BCu = ROL(Asi, 61);
+    Ega = XOR(BCa, ANDNOT(BCe, BCi));
+    Ege = XOR(BCe, ANDNOT(BCi, BCo));
+    Egi = XOR(BCi, ANDNOT(BCo, BCu));
+    Ego = XOR(BCo, ANDNOT(BCu, BCa));
+    Egu = XOR(BCu, ANDNOT(BCa, BCe));
+
+    Abe = XOR(Abe, De);
+    BCa = ROL(Abe, 1);
+    Agi = XOR(Agi, Di);
+    BCe = ROL(Agi, 6);
+    Ako = XOR(Ako, Do);
+    BCi = ROL(Ako, 25);
+    Amu = XOR(Amu, Du);
+    BCo = ROL(Amu, 8);
+    Asa = XOR(Asa, Da);
+    BCu = ROL(Asa, 18);
+    Eka = XOR(BCa, ANDNOT(BCe, BCi));
+    Eke = XOR(BCe, ANDNOT(BCi, BCo));
+    Eki = XOR(BCi, ANDNOT(BCo, BCu));
+    Eko = XOR(BCo, ANDNOT(BCu, BCa));
+    Eku = XOR(BCu, ANDNOT(BCa, BCe));
+
+    Abu = XOR(Abu, Du);
+    BCa = ROL(Abu, 27);
+    Aga = XOR(Aga, Da);
+    BCe = ROL(Aga, 36);
+    Ake = XOR(Ake, De);
+    BCi = ROL(Ake, 10);
+    Ami = XOR(Ami, Di);
+    BCo = ROL(Ami, 15);
+    Aso = XOR(Aso, Do);
+    BCu = ROL(Aso, 56);
+    Ema = XOR(BCa, ANDNOT(BCe, BCi));
+    Eme = XOR(BCe, ANDNOT(BCi, BCo));
+    Emi = XOR(BCi, ANDNOT(BCo, BCu));
+    Emo = XOR(BCo, ANDNOT(BCu, BCa));
+    Emu = XOR(BCu, ANDNOT(BCa, BCe));
+
+    Abi = XOR(Abi, Di);
+    BCa = ROL(Abi, 62);
+    Ago = XOR(Ago, Do);
+    BCe = ROL(Ago, 55);
+    Aku = XOR(Aku, Du);
+    BCi = ROL(Aku, 39);
+    Ama = XOR(Ama, Da);
+    BCo = ROL(Ama, 41);
+    Ase = XOR(Ase, De);
+    BCu = ROL(Ase, 2);
+    Esa = XOR(BCa, ANDNOT(BCe, BCi));
+    Ese = XOR(BCe, ANDNOT(BCi, BCo));
+    Esi = XOR(BCi, ANDNOT(BCo, BCu));
+    Eso = XOR(BCo, ANDNOT(BCu, BCa));
+    Esu = XOR(BCu, ANDNOT(BCa, BCe));
+
+    //    prepareTheta
+    BCa = XOR5(Eba, Ega, Eka, Ema, Esa);
+    BCe = XOR5(Ebe, Ege, Eke, Eme, Ese);
+    BCi = XOR5(Ebi, Egi, Eki, Emi, Esi);
+    BCo = XOR5(Ebo, Ego, Eko, Emo, Eso);
+    BCu = XOR5(Ebu, Egu, Eku, Emu, Esu);
+
+    //thetaRhoPiChiIotaPrepareTheta(round+1, E, A)
+    Da = XOR(BCu, ROL(BCe, 1));
+    De = XOR(BCa, ROL(BCi, 1));
+    Di = XOR(BCe, ROL(BCo, 1));
+    Do = XOR(BCi, ROL(BCu, 1));
+    Du = XOR(BCo, ROL(BCa, 1));
+
+    Eba = XOR(Eba, Da);
+    BCa = Eba;
+    Ege = XOR(Ege, De);
+    BCe = ROL(Ege, 44);
+    Eki = XOR(Eki, Di);
+    BCi = ROL(Eki, 43);
+    Emo = XOR(Emo, Do);
+    BCo = ROL(Emo, 21);
+    Esu = XOR(Esu, Du);
+    BCu = ROL(Esu, 14);
+    Aba = XOR(BCa, ANDNOT(BCe, BCi));
+    Aba = XOR(Aba, _mm256_set1_epi64x((long long)KeccakF_RoundConstants[round+1]));
+    Abe = XOR(BCe, ANDNOT(BCi, BCo));
+    Abi = XOR(BCi, ANDNOT(BCo, BCu));
+    Abo = XOR(BCo, ANDNOT(BCu, BCa));
+    Abu = XOR(BCu, ANDNOT(BCa, BCe));
+
+    Ebo = XOR(Ebo, Do);
+    BCa = ROL(Ebo, 28);
+    Egu = XOR(Egu, Du);
+    BCe = ROL(Egu, 20);
+    Eka = XOR(Eka, Da);
+    BCi = ROL(Eka, 3);
+    Eme = XOR(Eme, De);
+    BCo = ROL(Eme, 45);
+    Esi = XOR(Esi, Di);
+    BCu = ROL(Esi, 61);
+    Aga = XOR(BCa, ANDNOT(BCe, BCi));
+    Age = XOR(BCe, ANDNOT(BCi, BCo));
+    Agi = XOR(BCi, ANDNOT(BCo, BCu));
+    Ago = XOR(BCo, ANDNOT(BCu, BCa));
+    Agu = XOR(BCu, ANDNOT(BCa, BCe));
+
+    Ebe = XOR(Ebe, De);
+    BCa = ROL(Ebe, 1);
+    Egi = XOR(Egi, Di);
+    BCe = ROL(Egi, 6);
+    Eko = XOR(Eko, Do);
+    BCi = ROL(Eko, 25);
+    Emu = XOR(Emu, Du);
+    BCo = ROL(Emu, 8);
+    Esa = XOR(Esa, Da);
+    BCu = ROL(Esa, 18);
+    Aka = XOR(BCa, ANDNOT(BCe, BCi));
+    Ake = XOR(BCe, ANDNOT(BCi, BCo));
+    Aki = XOR(BCi, ANDNOT(BCo, BCu));
+    Ako = XOR(BCo, ANDNOT(BCu, BCa));
+    Aku = XOR(BCu, ANDNOT(BCa, BCe));
+
+    Ebu = XOR(Ebu, Du);
+    BCa = ROL(Ebu, 27);
+    Ega = XOR(Ega, Da);
+    BCe = ROL(Ega, 36);
+    Eke = XOR(Eke, De);
+    BCi = ROL(Eke, 10);
+    Emi = XOR(Emi, Di);
+    BCo = ROL(Emi, 15);
+    Eso = XOR(Eso, Do);
+    BCu = ROL(Eso, 56);
+    Ama = XOR(BCa, ANDNOT(BCe, BCi));
+    Ame = XOR(BCe, ANDNOT(BCi, BCo));
+    Ami = XOR(BCi, ANDNOT(BCo, BCu));
+    Amo = XOR(BCo, ANDNOT(BCu, BCa));
+    Amu = XOR(BCu, ANDNOT(BCa, BCe));
+
+    Ebi = XOR(Ebi, Di);
+    BCa = ROL(Ebi, 62);
+    Ego = XOR(Ego, Do);
+    BCe = ROL(Ego, 55);
+    Eku = XOR(Eku, Du);
+    BCi = ROL(Eku, 39);
+    Ema = XOR(Ema, Da);
+    BCo = ROL(Ema, 41);
+    Ese = XOR(Ese, De);
+    BCu = ROL(Ese, 2);
+    Asa = XOR(BCa, ANDNOT(BCe, BCi));
+    Ase = XOR(BCe, ANDNOT(BCi, BCo));
+    Asi = XOR(BCi, ANDNOT(BCo, BCu));
+    Aso = XOR(BCo, ANDNOT(BCu, BCa));
+    Asu = XOR(BCu, ANDNOT(BCa, BCe));
+  }
+
+  //copyToState(state, A)
+  _mm256_storeu_si256((__m256i *)&state[4*0], Aba);
+  _mm256_storeu_si256((__m256i *)&state[4*1], Abe);
+  _mm256_storeu_si256((__m256i *)&state[4*2], Abi);
+  _mm256_storeu_si256((__m256i *)&state[4*3], Abo);
+  _mm256_storeu_si256((__m256i *)&state[4*4], Abu);
+  _mm256_storeu_si256((__m256i *)&state[4*5], Aga);
+  _mm256_storeu_si256((__m256i *)&state[4*6], Age);
+  _mm256_storeu_si256((__m256i *)&state[4*7], Agi);
+  _mm256_storeu_si256((__m256i *)&state[4*8], Ago);
+  _mm256_storeu_si256((__m256i *)&state[4*9], Agu);
+  _mm256_storeu_si256((__m256i *)&state[4*10], Aka);
+  _mm256_storeu_si256((__m256i *)&state[4*11], Ake);
+  _mm256_storeu_si256((__m256i *)&state[4*12], Aki);
+  _mm256_storeu_si256((__m256i *)&state[4*13], Ako);
+  _mm256_storeu_si256((__m256i *)&state[4*14], Aku);
+  _mm256_storeu_si256((__m256i *)&state[4*15], Ama);
+  _mm256_storeu_si256((__m256i *)&state[4*16], Ame);
+  _mm256_storeu_si256((__m256i *)&state[4*17], Ami);
+  _mm256_storeu_si256((__m256i *)&state[4*18], Amo);
+  _mm256_storeu_si256((__m256i *)&state[4*19], Amu);
+  _mm256_storeu_si256((__m256i *)&state[4*20], Asa);
+  _mm256_storeu_si256((__m256i *)&state[4*21], Ase);
+  _mm256_storeu_si256((__m256i *)&state[4*22], Asi);
+  _mm256_storeu_si256((__m256i *)&state[4*23], Aso);
+  _mm256_storeu_si256((__m256i *)&state[4*24], Asu);
+}
+#endif
+
+/*************************************************
+* Name:        KeccakF1600_StatePermute4x
+*
+* Description: The Keccak F1600 Permutation on four interleaved states
+*
+* Arguments:   - uint64_t *state: pointer to input/output Keccak states
+**************************************************/
+void KeccakF1600_StatePermute4x(uint64_t state[4*25])
+{
+  unsigned int i, j;
+  uint64_t s[25];
+
+#ifdef DILITHIUM_AVX2
+  if(dilithium_has_avx2()) {
+    KeccakF1600_StatePermute4x_avx2(state);
+    return;
+  }
+#endif
+
+  for(j=0;j<4;j++) {
+    for(i=0;i<25;i++)
+      s[i] = state[4*i+j];
+    KeccakF1600_StatePermute(s);
+    for(i=0;i<25;i++)
+      state[4*i+j] = s[i];
+  }
+}
+
+/*************************************************
+* Name:        keccakx4_absorb
+*
+* Description: Absorb step of four Keccak instances with inputs of equal
+*              length; non-incremental, starts by zeroeing the states.
+*
+* Arguments:   - uint64_t *s: pointer to (uninitialized) output Keccak states
+*              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+*              - const uint8_t *in0..in3: pointers to inputs to be absorbed
+*              - size_t inlen: length of every input in bytes
+*              - uint8_t p: domain-separation byte for different
+*                           Keccak-derived functions
+**************************************************/
+static void keccakx4_absorb(uint64_t s[4*25],
+                            unsigned int r,
+                            const uint8_t *in0,
+                            const uint8_t *in1,
+                            const uint8_t *in2,
+                            const uint8_t *in3,
+                            size_t inlen,
+                            uint8_t p)
+{
+  size_t i, pos;
+  const uint8_t *in[4] = { in0, in1, in2, in3 };
+  unsigned int j;
+
+  for(i=0;i<4*25;i++)
+    s[i] = 0;
+
+  pos = 0;
+  while(inlen - pos >= r) {
+    for(i=0;i<r;i++)
+      for(j=0;j<4;j++)
+        s[4*(i/8)+j] ^= (uint64_t)in[j][pos+i] << 8*(i%8);
+
+    KeccakF1600_StatePermute4x(s);
+    pos += r;
+  }
+
+  for(i=0;i<inlen-pos;i++)
+    for(j=0;j<4;j++)
+      s[4*(i/8)+j] ^= (uint64_t)in[j][pos+i] << 8*(i%8);
+
+  for(j=0;j<4;j++) {
+    s[4*(i/8)+j] ^= (uint64_t)p << 8*(i%8);
+    s[4*((r-1)/8)+j] ^= (uint64_t)128 << 8*((r-1)%8);
+  }
+}
+
+/*************************************************
+* Name:        keccakx4_squeezeblocks
+*
+* Description: Squeeze step of four Keccak instances. Squeezes full blocks
+*              of r bytes from every instance. Modifies the states.
+*              Can be called multiple times to keep squeezing.
+*
+* Arguments:   - uint8_t *out0..out3: pointers to output blocks
+*              - size_t nblocks: number of blocks to be squeezed per instance
+*              - uint64_t *s: pointer to input/output Keccak states
+*              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+**************************************************/
+static void keccakx4_squeezeblocks(uint8_t *out0,
+                                   uint8_t *out1,
+                                   uint8_t *out2,
+                                   uint8_t *out3,
+                                   size_t nblocks,
+                                   uint64_t s[4*25],
+                                   unsigned int r)
+{
+  unsigned int i;
+
+  while(nblocks > 0) {
+    KeccakF1600_StatePermute4x(s);
+    for(i=0;i<r;i++) {
+      out0[i] = s[4*(i/8)+0] >> 8*(i%8);
+      out1[i] = s[4*(i/8)+1] >> 8*(i%8);
+      out2[i] = s[4*(i/8)+2] >> 8*(i%8);
+      out3[i] = s[4*(i/8)+3] >> 8*(i%8);
+    }
+    out0 += r;
+    out1 += r;
+    out2 += r;
+    out3 += r;
+    --nblocks;
+  }
+}
+
+void shake128x4_absorb(keccakx4_state *state,
+                       const uint8_t *in0,
+                       const uint8_t *in1,
+                       const uint8_t *in2,
+                       const uint8_t *in3,
+                       size_t inlen)
+{
+  keccakx4_absorb(state->s, SHAKE128_RATE, in0, in1, in2, in3, inlen, 0x1F);
+}
+
+void shake128x4_squeezeblocks(uint8_t *out0,
+                              uint8_t *out1,
+                              uint8_t *out2,
+                              uint8_t *out3,
+                              size_t nblocks,
+                              keccakx4_state *state)
+{
+  keccakx4_squeezeblocks(out0, out1, out2, out3, nblocks, state->s, SHAKE128_RATE);
+}
@@ -4,6 +4,9 @@
 #include <stdint.h>
 #include "params.h"
 
+#define zetas DILITHIUM_NAMESPACE(zetas)
+extern const int32_t zetas[N];
+
 #define ntt DILITHIUM_NAMESPACE(ntt)
 void ntt(int32_t a[N]);
 
@@ -5,6 +5,8 @@
 #include "reduce.h"
 #include "rounding.h"
 #include "symmetric.h"
+#include "fips202x4.h"
+#include "avx2.h"
 
 #ifdef DBENCH
 #include "test/cpucycles.h"
@@ -122,6 +124,13 @@ void poly_shiftl(poly *a) {
 void poly_ntt(poly *a) {
   DBENCH_START();
 
+#ifdef DILITHIUM_AVX2
+  if(dilithium_has_avx2()) {
+    ntt_avx2(a->coeffs);
+    DBENCH_STOP(*tmul);
+    return;
+  }
+#endif
   ntt(a->coeffs);
 
   DBENCH_STOP(*tmul);
@@ -139,6 +148,13 @@ void poly_ntt(poly *a) {
 void poly_invntt_tomont(poly *a) {
   DBENCH_START();
 
+#ifdef DILITHIUM_AVX2
+  if(dilithium_has_avx2()) {
+    invntt_tomont_avx2(a->coeffs);
+    DBENCH_STOP(*tmul);
+    return;
+  }
+#endif
   invntt_tomont(a->coeffs);
 
   DBENCH_STOP(*tmul);
@@ -159,6 +175,13 @@ void poly_pointwise_montgomery(poly *c, const poly *a, const poly *b) {
   unsigned int i;
   DBENCH_START();
 
+#ifdef DILITHIUM_AVX2
+  if(dilithium_has_avx2()) {
+    poly_pointwise_montgomery_avx2(c, a, b);
+    DBENCH_STOP(*tmul);
+    return;
+  }
+#endif
   for(i = 0; i < N; ++i)
     c->coeffs[i] = montgomery_reduce((int64_t)a->coeffs[i] * b->coeffs[i]);
 
@@ -315,6 +338,13 @@ static unsigned int rej_uniform(int32_t *a,
   uint32_t t;
   DBENCH_START();
 
+#ifdef DILITHIUM_AVX2
+  if(dilithium_has_avx2()) {
+    ctr = rej_uniform_avx2(a, len, buf, buflen);
+    DBENCH_STOP(*tsample);
+    return ctr;
+  }
+#endif
   ctr = pos = 0;
   while(ctr < len && pos + 3 <= buflen) {
     t  = buf[pos++];
@@ -367,6 +397,57 @@ void poly_uniform(poly *a,
   }
 }
 
+/*************************************************
+* Name:        poly_uniform_4x
+*
+* Description: Same as four calls of poly_uniform, with the four SHAKE128
+*              instances run side by side (AVX2 permutation when available).
+*              Output is identical to poly_uniform.
+*
+* Arguments:   - poly *a0..a3: pointers to output polynomials
+*              - const uint8_t seed[]: byte array with seed of length SEEDBYTES
+*              - uint16_t nonce0..nonce3: 2-byte nonces
+**************************************************/
+#if (POLY_UNIFORM_NBLOCKS*STREAM128_BLOCKBYTES) % 3 || STREAM128_BLOCKBYTES % 3
+#error "poly_uniform_4x assumes no bytes are left over between blocks"
+#endif
+void poly_uniform_4x(poly *a0,
+                     poly *a1,
+                     poly *a2,
+                     poly *a3,
+                     const uint8_t seed[SEEDBYTES],
+                     uint16_t nonce0,
+                     uint16_t nonce1,
+                     uint16_t nonce2,
+                     uint16_t nonce3)
+{
+  unsigned int i, j, ctr[4];
+  poly *a[4] = { a0, a1, a2, a3 };
+  const uint16_t nonce[4] = { nonce0, nonce1, nonce2, nonce3 };
+  uint8_t in[4][SEEDBYTES + 2];
+  uint8_t buf[4][POLY_UNIFORM_NBLOCKS*STREAM128_BLOCKBYTES];
+  keccakx4_state state;
+
+  for(j = 0; j < 4; ++j) {
+    for(i = 0; i < SEEDBYTES; ++i)
+      in[j][i] = seed[i];
+    in[j][SEEDBYTES] = nonce[j];
+    in[j][SEEDBYTES + 1] = nonce[j] >> 8;
+  }
+
+  shake128x4_absorb(&state, in[0], in[1], in[2], in[3], SEEDBYTES + 2);
+  shake128x4_squeezeblocks(buf[0], buf[1], buf[2], buf[3], POLY_UNIFORM_NBLOCKS, &state);
+
+  for(j = 0; j < 4; ++j)
+    ctr[j] = rej_uniform(a[j]->coeffs, N, buf[j], POLY_UNIFORM_NBLOCKS*STREAM128_BLOCKBYTES);
+
+  while(ctr[0] < N || ctr[1] < N || ctr[2] < N || ctr[3] < N) {
+    shake128x4_squeezeblocks(buf[0], buf[1], buf[2], buf[3], 1, &state);
+    for(j = 0; j < 4; ++j)
+      ctr[j] += rej_uniform(a[j]->coeffs + ctr[j], N - ctr[j], buf[j], STREAM128_BLOCKBYTES);
+  }
+}
+
 /*************************************************
 * Name:        rej_eta
 *
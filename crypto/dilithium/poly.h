@@ -42,6 +42,16 @@ int poly_chknorm(const poly *a, int32_t B);
 void poly_uniform(poly *a,
                   const uint8_t seed[SEEDBYTES],
                   uint16_t nonce);
+#define poly_uniform_4x DILITHIUM_NAMESPACE(poly_uniform_4x)
+void poly_uniform_4x(poly *a0,
+                     poly *a1,
+                     poly *a2,
+                     poly *a3,
+                     const uint8_t seed[SEEDBYTES],
+                     uint16_t nonce0,
+                     uint16_t nonce1,
+                     uint16_t nonce2,
+                     uint16_t nonce3);
 #define poly_uniform_eta DILITHIUM_NAMESPACE(poly_uniform_eta)
 void poly_uniform_eta(poly *a,
                       const uint8_t seed[CRHBYTES],
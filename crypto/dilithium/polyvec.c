@@ -2,6 +2,7 @@
 #include "params.h"
 #include "polyvec.h"
 #include "poly.h"
+#include "avx2.h"
 
 /*************************************************
 * Name:        expand_mat
@@ -15,6 +16,33 @@
 **************************************************/
 void polyvec_matrix_expand(polyvecl mat[K], const uint8_t rho[SEEDBYTES]) {
   unsigned int i, j;
+#ifdef DILITHIUM_AVX2
+  unsigned int n, m;
+  poly *a[4];
+  uint16_t nonce[4];
+  poly unused;
+
+  if(dilithium_has_avx2()) {
+    /* Entries in row-major order, four at a time; the last batch is
+       padded with throwaway samples */
+    for(n = 0; n < K*L; n += 4) {
+      for(m = 0; m < 4; ++m) {
+        if(n + m < K*L) {
+          i = (n + m) / L;
+          j = (n + m) % L;
+          a[m] = &mat[i].vec[j];
+          nonce[m] = (i << 8) + j;
+        }
+        else {
+          a[m] = &unused;
+          nonce[m] = 0;
+        }
+      }
+      poly_uniform_4x(a[0], a[1], a[2], a[3], rho, nonce[0], nonce[1], nonce[2], nonce[3]);
+    }
+    return;
+  }
+#endif
 
   for(i = 0; i < K; ++i)
     for(j = 0; j < L; ++j)
@@ -272,9 +272,32 @@ int crypto_sign(uint8_t *sm,
 }
 
 /*************************************************
-* Name:        crypto_sign_verify_internal
+* Name:        crypto_sign_pk_expand
 *
-* Description: Verifies signature. Internal API.
+* Description: Unpacks a public key into the form used by verification:
+*              tr = H(pk), matrix A expanded from rho and t1*2^D in NTT
+*              domain. Verifying many signatures under one key with
+*              crypto_sign_verify_expanded skips these steps.
+*
+* Arguments:   - crypto_sign_expanded_pk *epk: pointer to output expanded key
+*              - const uint8_t *pk: pointer to bit-packed public key
+**************************************************/
+void crypto_sign_pk_expand(crypto_sign_expanded_pk *epk, const uint8_t *pk)
+{
+  uint8_t rho[SEEDBYTES];
+
+  unpack_pk(rho, &epk->t1, pk);
+  shake256(epk->tr, TRBYTES, pk, CRYPTO_PUBLICKEYBYTES);
+  polyvec_matrix_expand(epk->mat, rho);
+
+  polyveck_shiftl(&epk->t1);
+  polyveck_ntt(&epk->t1);
+}
+
+/*************************************************
+* Name:        crypto_sign_verify_expanded_internal
+*
+* Description: Verifies signature under an expanded public key. Internal API.
 *
 * Arguments:   - uint8_t *m: pointer to input signature
 *              - size_t siglen: length of signature
@@ -282,42 +305,40 @@ int crypto_sign(uint8_t *sm,
 *              - size_t mlen: length of message
 *              - const uint8_t *pre: pointer to prefix string
 *              - size_t prelen: length of prefix string
-*              - const uint8_t *pk: pointer to bit-packed public key
+*              - const crypto_sign_expanded_pk *epk: pointer to expanded
+*                public key
 *
 * Returns 0 if signature could be verified correctly and -1 otherwise
 **************************************************/
-int crypto_sign_verify_internal(const uint8_t *sig,
-                                size_t siglen,
-                                const uint8_t *m,
-                                size_t mlen,
-                                const uint8_t *pre,
-                                size_t prelen,
-                                const uint8_t *pk)
+int crypto_sign_verify_expanded_internal(const uint8_t *sig,
+                                         size_t siglen,
+                                         const uint8_t *m,
+                                         size_t mlen,
+                                         const uint8_t *pre,
+                                         size_t prelen,
+                                         const crypto_sign_expanded_pk *epk)
 {
   unsigned int i;
   uint8_t buf[K*POLYW1_PACKEDBYTES];
-  uint8_t rho[SEEDBYTES];
   uint8_t mu[CRHBYTES];
   uint8_t c[CTILDEBYTES];
   uint8_t c2[CTILDEBYTES];
   poly cp;
-  polyvecl mat[K], z;
+  polyvecl z;
   polyveck t1, w1, h;
   keccak_state state;
 
   if(siglen != CRYPTO_BYTES)
     return -1;
 
-  unpack_pk(rho, &t1, pk);
   if(unpack_sig(c, &z, &h, sig))
     return -1;
   if(polyvecl_chknorm(&z, GAMMA1 - BETA))
     return -1;
 
   /* Compute CRH(H(rho, t1), pre, msg) */
-  shake256(mu, TRBYTES, pk, CRYPTO_PUBLICKEYBYTES);
   shake256_init(&state);
-  shake256_absorb(&state, mu, TRBYTES);
+  shake256_absorb(&state, epk->tr, TRBYTES);
   shake256_absorb(&state, pre, prelen);
   shake256_absorb(&state, m, mlen);
   shake256_finalize(&state);
@@ -325,15 +346,12 @@ int crypto_sign_verify_internal(const uint8_t *sig,
 
   /* Matrix-vector multiplication; compute Az - c2^dt1 */
   poly_challenge(&cp, c);
-  polyvec_matrix_expand(mat, rho);
 
   polyvecl_ntt(&z);
-  polyvec_matrix_pointwise_montgomery(&w1, mat, &z);
+  polyvec_matrix_pointwise_montgomery(&w1, epk->mat, &z);
 
   poly_ntt(&cp);
-  polyveck_shiftl(&t1);
-  polyveck_ntt(&t1);
-  polyveck_pointwise_poly_montgomery(&t1, &cp, &t1);
+  polyveck_pointwise_poly_montgomery(&t1, &cp, &epk->t1);
 
   polyveck_sub(&w1, &w1, &t1);
   polyveck_reduce(&w1);
@@ -357,6 +375,38 @@ int crypto_sign_verify_internal(const uint8_t *sig,
   return 0;
 }
 
+/*************************************************
+* Name:        crypto_sign_verify_internal
+*
+* Description: Verifies signature. Internal API.
+*
+* Arguments:   - uint8_t *m: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const uint8_t *m: pointer to message
+*              - size_t mlen: length of message
+*              - const uint8_t *pre: pointer to prefix string
+*              - size_t prelen: length of prefix string
+*              - const uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_internal(const uint8_t *sig,
+                                size_t siglen,
+                                const uint8_t *m,
+                                size_t mlen,
+                                const uint8_t *pre,
+                                size_t prelen,
+                                const uint8_t *pk)
+{
+  crypto_sign_expanded_pk epk;
+
+  if(siglen != CRYPTO_BYTES)
+    return -1;
+
+  crypto_sign_pk_expand(&epk, pk);
+  return crypto_sign_verify_expanded_internal(sig, siglen, m, mlen, pre, prelen, &epk);
+}
+
 /*************************************************
 * Name:        crypto_sign_verify
 *
@@ -394,6 +444,45 @@ int crypto_sign_verify(const uint8_t *sig,
   return crypto_sign_verify_internal(sig,siglen,m,mlen,pre,2+ctxlen,pk);
 }
 
+/*************************************************
+* Name:        crypto_sign_verify_expanded
+*
+* Description: Same as crypto_sign_verify, with a public key expanded by
+*              crypto_sign_pk_expand.
+*
+* Arguments:   - uint8_t *m: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const uint8_t *m: pointer to message
+*              - size_t mlen: length of message
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const crypto_sign_expanded_pk *epk: pointer to expanded
+*                public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int crypto_sign_verify_expanded(const uint8_t *sig,
+                                size_t siglen,
+                                const uint8_t *m,
+                                size_t mlen,
+                                const uint8_t *ctx,
+                                size_t ctxlen,
+                                const crypto_sign_expanded_pk *epk)
+{
+  size_t i;
+  uint8_t pre[257];
+
+  if(ctxlen > 255)
+    return -1;
+
+  pre[0] = 0;
+  pre[1] = ctxlen;
+  for(i = 0; i < ctxlen; i++)
+    pre[2 + i] = ctx[i];
+
+  return crypto_sign_verify_expanded_internal(sig,siglen,m,mlen,pre,2+ctxlen,epk);
+}
+
 /*************************************************
 * Name:        crypto_sign_open
 *
@@ -7,6 +7,13 @@
 #include "polyvec.h"
 #include "poly.h"
 
+/* Public key unpacked for verification: H(pk), A and NTT(t1*2^D) */
+typedef struct {
+  uint8_t tr[TRBYTES];
+  polyvecl mat[K];
+  polyveck t1;
+} crypto_sign_expanded_pk;
+
 #define crypto_sign_keypair DILITHIUM_NAMESPACE(keypair)
 int crypto_sign_keypair(uint8_t *pk, uint8_t *sk);
 
@@ -41,12 +48,30 @@ int crypto_sign_verify_internal(const uint8_t *sig,
                                 size_t prelen,
                                 const uint8_t *pk);
 
+#define crypto_sign_pk_expand DILITHIUM_NAMESPACE(pk_expand)
+void crypto_sign_pk_expand(crypto_sign_expanded_pk *epk, const uint8_t *pk);
+
+#define crypto_sign_verify_expanded_internal DILITHIUM_NAMESPACE(verify_expanded_internal)
+int crypto_sign_verify_expanded_internal(const uint8_t *sig,
+                                         size_t siglen,
+                                         const uint8_t *m,
+                                         size_t mlen,
+                                         const uint8_t *pre,
+                                         size_t prelen,
+                                         const crypto_sign_expanded_pk *epk);
+
 #define crypto_sign_verify DILITHIUM_NAMESPACE(verify)
 int crypto_sign_verify(const uint8_t *sig, size_t siglen,
                        const uint8_t *m, size_t mlen,
                        const uint8_t *ctx, size_t ctxlen,
                        const uint8_t *pk);
 
+#define crypto_sign_verify_expanded DILITHIUM_NAMESPACE(verify_expanded)
+int crypto_sign_verify_expanded(const uint8_t *sig, size_t siglen,
+                                const uint8_t *m, size_t mlen,
+                                const uint8_t *ctx, size_t ctxlen,
+                                const crypto_sign_expanded_pk *epk);
+
 #define crypto_sign_open DILITHIUM_NAMESPACE(open)
 int crypto_sign_open(uint8_t *m, size_t *mlen,
                      const uint8_t *sm, size_t smlen,
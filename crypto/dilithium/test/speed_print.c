@@ -28,13 +28,14 @@ static uint64_t average(uint64_t *t, size_t tlen) {
   return acc/tlen;
 }
 
-void print_results(const char *s, uint64_t *t, size_t tlen) {
+uint64_t print_results(const char *s, uint64_t *t, size_t tlen) {
   size_t i;
+  uint64_t med;
   static uint64_t overhead = -1;
 
   if(tlen < 2) {
     fprintf(stderr, "ERROR: Need a least two cycle counts!\n");
-    return;
+    return 0;
   }
 
   if(overhead  == (uint64_t)-1)
@@ -44,8 +45,11 @@ void print_results(const char *s, uint64_t *t, size_t tlen) {
   for(i=0;i<tlen;++i)
     t[i] = t[i+1] - t[i] - overhead;
 
+  med = median(t, tlen);
   printf("%s\n", s);
-  printf("median: %llu cycles/ticks\n", (unsigned long long)median(t, tlen));
+  printf("median: %llu cycles/ticks\n", (unsigned long long)med);
   printf("average: %llu cycles/ticks\n", (unsigned long long)average(t, tlen));
   printf("\n");
+
+  return med;
 }
@@ -4,6 +4,6 @@
 #include <stddef.h>
 #include <stdint.h>
 
-void print_results(const char *s, uint64_t *t, size_t tlen);
+uint64_t print_results(const char *s, uint64_t *t, size_t tlen);
 
 #endif
@@ -1,8 +1,10 @@
 #include <stdint.h>
+#include <stdio.h>
 #include "../sign.h"
 #include "../poly.h"
 #include "../polyvec.h"
 #include "../params.h"
+#include "../avx2.h"
 #include "cpucycles.h"
 #include "speed_print.h"
 
@@ -10,24 +12,72 @@
 
 uint64_t t[NTESTS];
 
-int main(void)
+static size_t siglen;
+static uint8_t pk[CRYPTO_PUBLICKEYBYTES];
+static uint8_t sk[CRYPTO_SECRETKEYBYTES];
+static uint8_t sig[CRYPTO_BYTES];
+static uint8_t seed[CRHBYTES];
+static polyvecl mat[K];
+static poly *a = &mat[0].vec[0];
+static poly *b = &mat[0].vec[1];
+static poly *c = &mat[0].vec[2];
+
+static void run_matrix_expand(void) { polyvec_matrix_expand(mat, seed); }
+static void run_ntt(void) { poly_ntt(a); }
+static void run_invntt(void) { poly_invntt_tomont(a); }
+static void run_pointwise(void) { poly_pointwise_montgomery(c, a, b); }
+static void run_keypair(void) { crypto_sign_keypair(pk, sk); }
+static void run_sign(void) { crypto_sign_signature(sig, &siglen, sig, CRHBYTES, NULL, 0, sk); }
+static void run_verify(void) { crypto_sign_verify(sig, CRYPTO_BYTES, sig, CRHBYTES, NULL, 0, pk); }
+
+static uint64_t bench(const char *s, void (*f)(void))
 {
   unsigned int i;
-  size_t siglen;
-  uint8_t pk[CRYPTO_PUBLICKEYBYTES];
-  uint8_t sk[CRYPTO_SECRETKEYBYTES];
-  uint8_t sig[CRYPTO_BYTES];
-  uint8_t seed[CRHBYTES];
-  polyvecl mat[K];
-  poly *a = &mat[0].vec[0];
-  poly *b = &mat[0].vec[1];
-  poly *c = &mat[0].vec[2];
 
   for(i = 0; i < NTESTS; ++i) {
     t[i] = cpucycles();
-    polyvec_matrix_expand(mat, seed);
+    f();
+  }
+  return print_results(s, t, NTESTS);
+}
+
+/*
+ * Times f with the reference kernels and, when the CPU supports it, with
+ * the AVX2 kernels, and prints the ratio of the medians.
+ */
+static void compare(const char *s, void (*f)(void))
+{
+  char label[64];
+#ifdef DILITHIUM_AVX2
+  uint64_t ref, avx2;
+
+  if(dilithium_has_avx2()) {
+    dilithium_avx2_disable = 1;
+    snprintf(label, sizeof(label), "%s (ref):", s);
+    ref = bench(label, f);
+    dilithium_avx2_disable = 0;
+    snprintf(label, sizeof(label), "%s (avx2):", s);
+    avx2 = bench(label, f);
+    printf("%s speedup: %.2fx\n\n", s, avx2 ? (double)ref/avx2 : 0.0);
+    return;
   }
-  print_results("polyvec_matrix_expand:", t, NTESTS);
+#endif
+
+  snprintf(label, sizeof(label), "%s:", s);
+  bench(label, f);
+}
+
+int main(void)
+{
+  unsigned int i;
+
+#ifdef DILITHIUM_AVX2
+  printf("Kernels: %s\n\n", dilithium_has_avx2() ? "AVX2" : "reference (no AVX2 on this CPU)");
+#else
+  printf("Kernels: reference\n\n");
+#endif
+
+  compare("polyvec_matrix_expand", run_matrix_expand);
 
   for(i = 0; i < NTESTS; ++i) {
     t[i] = cpucycles();
@@ -41,23 +91,9 @@ int main(void)
   }
   print_results("poly_uniform_gamma1:", t, NTESTS);
 
-  for(i = 0; i < NTESTS; ++i) {
-    t[i] = cpucycles();
-    poly_ntt(a);
-  }
-  print_results("poly_ntt:", t, NTESTS);
-
-  for(i = 0; i < NTESTS; ++i) {
-    t[i] = cpucycles();
-    poly_invntt_tomont(a);
-  }
-  print_results("poly_invntt_tomont:", t, NTESTS);
-
-  for(i = 0; i < NTESTS; ++i) {
-    t[i] = cpucycles();
-    poly_pointwise_montgomery(c, a, b);
-  }
-  print_results("poly_pointwise_montgomery:", t, NTESTS);
+  compare("poly_ntt", run_ntt);
+  compare("poly_invntt_tomont", run_invntt);
+  compare("poly_pointwise_montgomery", run_pointwise);
 
   for(i = 0; i < NTESTS; ++i) {
     t[i] = cpucycles();
@@ -65,23 +101,9 @@ int main(void)
   }
   print_results("poly_challenge:", t, NTESTS);
 
-  for(i = 0; i < NTESTS; ++i) {
-    t[i] = cpucycles();
-    crypto_sign_keypair(pk, sk);
-  }
-  print_results("Keypair:", t, NTESTS);
-
-  for(i = 0; i < NTESTS; ++i) {
-    t[i] = cpucycles();
-    crypto_sign_signature(sig, &siglen, sig, CRHBYTES, NULL, 0, sk);
-  }
-  print_results("Sign:", t, NTESTS);
-
-  for(i = 0; i < NTESTS; ++i) {
-    t[i] = cpucycles();
-    crypto_sign_verify(sig, CRYPTO_BYTES, sig, CRHBYTES, NULL, 0, pk);
-  }
-  print_results("Verify:", t, NTESTS);
+  compare("Keypair", run_keypair);
+  compare("Sign", run_sign);
+  compare("Verify", run_verify);
 
   return 0;
 }
@@ -0,0 +1,867 @@
+#include <stdint.h>
+#include "params.h"
+#include "avx2_kyber.h"
+
+#ifdef KYBER_AVX2
+
+#include <immintrin.h>
+#include "ntt_kyber.h"
+#include "reduce_kyber.h"
+
+#define AVX2 __attribute__((target("avx2,popcnt")))
+
+/*
+ * Zetas for the last two NTT layers (first two inverse layers), in the
+ * order the coefficients sit in registers after the unpacks below.
+ * Generated from zetas and zetas_inv.
+ */
+static const int16_t zetas_len4[128] __attribute__((aligned(32))) = {
+   1223, 1223, 1223, 1223, 2777, 2777, 2777, 2777,
+    652,  652,  652,  652, 1015, 1015, 1015, 1015,
+   2036, 2036, 2036, 2036, 3047, 3047, 3047, 3047,
+   1491, 1491, 1491, 1491, 1785, 1785, 1785, 1785,
+    516,  516,  516,  516, 3009, 3009, 3009, 3009,
+   3321, 3321, 3321, 3321, 2663, 2663, 2663, 2663,
+   1711, 1711, 1711, 1711,  126,  126,  126,  126,
+   2167, 2167, 2167, 2167, 1469, 1469, 1469, 1469,
+   2476, 2476, 2476, 2476, 3058, 3058, 3058, 3058,
+   3239, 3239, 3239, 3239,  830,  830,  830,  830,
+    107,  107,  107,  107, 3082, 3082, 3082, 3082,
+   1908, 1908, 1908, 1908, 2378, 2378, 2378, 2378,
+   2931, 2931, 2931, 2931, 1821, 1821, 1821, 1821,
+    961,  961,  961,  961, 2604, 2604, 2604, 2604,
+    448,  448,  448,  448,  677,  677,  677,  677,
+   2264, 2264, 2264, 2264, 2054, 2054, 2054, 2054
+};
+
+static const int16_t zetas_inv_len4[128] __attribute__((aligned(32))) = {
+   1275, 1275, 1275, 1275, 1065, 1065, 1065, 1065,
+   2652, 2652, 2652, 2652, 2881, 2881, 2881, 2881,
+    725,  725,  725,  725, 2368, 2368, 2368, 2368,
+   1508, 1508, 1508, 1508,  398,  398,  398,  398,
+    951,  951,  951,  951, 1421, 1421, 1421, 1421,
+    247,  247,  247,  247, 3222, 3222, 3222, 3222,
+   2499, 2499, 2499, 2499,   90,   90,   90,   90,
+    271,  271,  271,  271,  853,  853,  853,  853,
+   1860, 1860, 1860, 1860, 1162, 1162, 1162, 1162,
+   3203, 3203, 3203, 3203, 1618, 1618, 1618, 1618,
+    666,  666,  666,  666,    8,    8,    8,    8,
+    320,  320,  320,  320, 2813, 2813, 2813, 2813,
+   1544, 1544, 1544, 1544, 1838, 1838, 1838, 1838,
+    282,  282,  282,  282, 1293, 1293, 1293, 1293,
+   2314, 2314, 2314, 2314, 2677, 2677, 2677, 2677,
+    552,  552,  552,  552, 2106, 2106, 2106, 2106
+};
+
+static const int16_t zetas_len2[128] __attribute__((aligned(32))) = {
+   2226, 2226,  430,  430, 2078, 2078,  871,  871,
+    555,  555,  843,  843, 1550, 1550,  105,  105,
+    422,  422,  587,  587, 3038, 3038, 2869, 2869,
+    177,  177, 3094, 3094, 1574, 1574, 1653, 1653,
+   3083, 3083,  778,  778, 2552, 2552, 1483, 1483,
+   1159, 1159, 3182, 3182, 2727, 2727, 1119, 1119,
+   1739, 1739,  644,  644,  418,  418,  329,  329,
+   2457, 2457,  349,  349, 3173, 3173, 3254, 3254,
+    817,  817, 1097, 1097, 1322, 1322, 2044, 2044,
+    603,  603,  610,  610, 1864, 1864,  384,  384,
+   2114, 2114, 3193, 3193, 2455, 2455,  220,  220,
+   1218, 1218, 1994, 1994, 2142, 2142, 1670, 1670,
+   2144, 2144, 1799, 1799, 1819, 1819, 2475, 2475,
+   2051, 2051,  794,  794, 2459, 2459,  478,  478,
+   3221, 3221, 3021, 3021,  958,  958, 1869, 1869,
+    996,  996,  991,  991, 1522, 1522, 1628, 1628
+};
+
+static const int16_t zetas_inv_len2[128] __attribute__((aligned(32))) = {
+   1701, 1701, 1807, 1807, 2338, 2338, 2333, 2333,
+   1460, 1460, 2371, 2371,  308,  308,  108,  108,
+   2851, 2851,  870,  870, 2535, 2535, 1278, 1278,
+    854,  854, 1510, 1510, 1530, 1530, 1185, 1185,
+   1659, 1659, 1187, 1187, 1335, 1335, 2111, 2111,
+   3109, 3109,  874,  874,  136,  136, 1215, 1215,
+   2945, 2945, 1465, 1465, 2719, 2719, 2726, 2726,
+   1285, 1285, 2007, 2007, 2232, 2232, 2512, 2512,
+     75,   75,  156,  156, 2980, 2980,  872,  872,
+   3000, 3000, 2911, 2911, 2685, 2685, 1590, 1590,
+   2210, 2210,  602,  602,  147,  147, 2170, 2170,
+   1846, 1846,  777,  777, 2551, 2551,  246,  246,
+   1676, 1676, 1755, 1755,  235,  235, 3152, 3152,
+    460,  460,  291,  291, 2742, 2742, 2907, 2907,
+   3224, 3224, 1779, 1779, 2486, 2486, 2774, 2774,
+   2458, 2458, 1251, 1251, 2899, 2899, 1103, 1103
+};
+
+// [0, zeta, 0, -zeta] for every four coefficients, as in poly_basemul_montgomery
+static const int16_t zetas_basemul[256] __attribute__((aligned(32))) = {
+      0, 2226,    0,-2226,    0,  430,    0, -430,
+      0,  555,    0, -555,    0,  843,    0, -843,
+      0, 2078,    0,-2078,    0,  871,    0, -871,
+      0, 1550,    0,-1550,    0,  105,    0, -105,
+      0,  422,    0, -422,    0,  587,    0, -587,
+      0,  177,    0, -177,    0, 3094,    0,-3094,
+      0, 3038,    0,-3038,    0, 2869,    0,-2869,
+      0, 1574,    0,-1574,    0, 1653,    0,-1653,
+      0, 3083,    0,-3083,    0,  778,    0, -778,
+      0, 1159,    0,-1159,    0, 3182,    0,-3182,
+      0, 2552,    0,-2552,    0, 1483,    0,-1483,
+      0, 2727,    0,-2727,    0, 1119,    0,-1119,
+      0, 1739,    0,-1739,    0,  644,    0, -644,
+      0, 2457,    0,-2457,    0,  349,    0, -349,
+      0,  418,    0, -418,    0,  329,    0, -329,
+      0, 3173,    0,-3173,    0, 3254,    0,-3254,
+      0,  817,    0, -817,    0, 1097,    0,-1097,
+      0,  603,    0, -603,    0,  610,    0, -610,
+      0, 1322,    0,-1322,    0, 2044,    0,-2044,
+      0, 1864,    0,-1864,    0,  384,    0, -384,
+      0, 2114,    0,-2114,    0, 3193,    0,-3193,
+      0, 1218,    0,-1218,    0, 1994,    0,-1994,
+      0, 2455,    0,-2455,    0,  220,    0, -220,
+      0, 2142,    0,-2142,    0, 1670,    0,-1670,
+      0, 2144,    0,-2144,    0, 1799,    0,-1799,
+      0, 2051,    0,-2051,    0,  794,    0, -794,
+      0, 1819,    0,-1819,    0, 2475,    0,-2475,
+      0, 2459,    0,-2459,    0,  478,    0, -478,
+      0, 3221,    0,-3221,    0, 3021,    0,-3021,
+      0,  996,    0, -996,    0,  991,    0, -991,
+      0,  958,    0, -958,    0, 1869,    0,-1869,
+      0, 1522,    0,-1522,    0, 1628,    0,-1628
+};
+
+// Byte shuffles moving the accepted 16-bit samples (mask bits) to the front
+static const int8_t rej_idx[256][16] __attribute__((aligned(16))) = {
+  {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 4, 5,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 6, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 6, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 6, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 6, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 6, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 6, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 6, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 6, 7,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 8, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 8, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 8, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 8, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 8, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 8, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 8, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 8, 9,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 6, 7, 8, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 6, 7, 8, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 6, 7, 8, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 6, 7, 8, 9,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 6, 7, 8, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 6, 7, 8, 9,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 6, 7, 8, 9,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,-1,-1,-1,-1,-1,-1},
+  {10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 4, 5,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5,10,11,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 6, 7,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 6, 7,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 6, 7,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 6, 7,10,11,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 6, 7,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 6, 7,10,11,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 6, 7,10,11,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 6, 7,10,11,-1,-1,-1,-1,-1,-1},
+  { 8, 9,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 8, 9,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 8, 9,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 8, 9,10,11,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 8, 9,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 8, 9,10,11,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 8, 9,10,11,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 8, 9,10,11,-1,-1,-1,-1,-1,-1},
+  { 6, 7, 8, 9,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 6, 7, 8, 9,10,11,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 6, 7, 8, 9,10,11,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 6, 7, 8, 9,10,11,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 6, 7, 8, 9,10,11,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 6, 7, 8, 9,10,11,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 6, 7, 8, 9,10,11,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,-1,-1,-1,-1},
+  {12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 4, 5,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 6, 7,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 6, 7,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 6, 7,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 6, 7,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 6, 7,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 6, 7,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 6, 7,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 6, 7,12,13,-1,-1,-1,-1,-1,-1},
+  { 8, 9,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 8, 9,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 8, 9,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 8, 9,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 8, 9,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 8, 9,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 8, 9,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 8, 9,12,13,-1,-1,-1,-1,-1,-1},
+  { 6, 7, 8, 9,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 6, 7, 8, 9,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 6, 7, 8, 9,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 6, 7, 8, 9,12,13,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 6, 7, 8, 9,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 6, 7, 8, 9,12,13,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 6, 7, 8, 9,12,13,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,12,13,-1,-1,-1,-1},
+  {10,11,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1,10,11,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3,10,11,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3,10,11,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 4, 5,10,11,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5,10,11,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5,10,11,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5,10,11,12,13,-1,-1,-1,-1,-1,-1},
+  { 6, 7,10,11,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 6, 7,10,11,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 6, 7,10,11,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 6, 7,10,11,12,13,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 6, 7,10,11,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 6, 7,10,11,12,13,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 6, 7,10,11,12,13,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 6, 7,10,11,12,13,-1,-1,-1,-1},
+  { 8, 9,10,11,12,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 8, 9,10,11,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 8, 9,10,11,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 8, 9,10,11,12,13,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 8, 9,10,11,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 8, 9,10,11,12,13,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 8, 9,10,11,12,13,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 8, 9,10,11,12,13,-1,-1,-1,-1},
+  { 6, 7, 8, 9,10,11,12,13,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 6, 7, 8, 9,10,11,12,13,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 6, 7, 8, 9,10,11,12,13,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 6, 7, 8, 9,10,11,12,13,-1,-1,-1,-1},
+  { 4, 5, 6, 7, 8, 9,10,11,12,13,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 6, 7, 8, 9,10,11,12,13,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,-1,-1},
+  {14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 4, 5,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 6, 7,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 6, 7,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 6, 7,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 6, 7,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 6, 7,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 6, 7,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 6, 7,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 6, 7,14,15,-1,-1,-1,-1,-1,-1},
+  { 8, 9,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 8, 9,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 8, 9,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 8, 9,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 8, 9,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 8, 9,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 8, 9,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 8, 9,14,15,-1,-1,-1,-1,-1,-1},
+  { 6, 7, 8, 9,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 6, 7, 8, 9,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 6, 7, 8, 9,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 6, 7, 8, 9,14,15,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 6, 7, 8, 9,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 6, 7, 8, 9,14,15,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 6, 7, 8, 9,14,15,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,14,15,-1,-1,-1,-1},
+  {10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1,10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3,10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3,10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 4, 5,10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5,10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5,10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5,10,11,14,15,-1,-1,-1,-1,-1,-1},
+  { 6, 7,10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 6, 7,10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 6, 7,10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 6, 7,10,11,14,15,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 6, 7,10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 6, 7,10,11,14,15,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 6, 7,10,11,14,15,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 6, 7,10,11,14,15,-1,-1,-1,-1},
+  { 8, 9,10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 8, 9,10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 8, 9,10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 8, 9,10,11,14,15,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 8, 9,10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 8, 9,10,11,14,15,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 8, 9,10,11,14,15,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 8, 9,10,11,14,15,-1,-1,-1,-1},
+  { 6, 7, 8, 9,10,11,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 6, 7, 8, 9,10,11,14,15,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 6, 7, 8, 9,10,11,14,15,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 6, 7, 8, 9,10,11,14,15,-1,-1,-1,-1},
+  { 4, 5, 6, 7, 8, 9,10,11,14,15,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 6, 7, 8, 9,10,11,14,15,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 6, 7, 8, 9,10,11,14,15,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,14,15,-1,-1},
+  {12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 4, 5,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 6, 7,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 6, 7,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 6, 7,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 6, 7,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 6, 7,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 6, 7,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 6, 7,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 6, 7,12,13,14,15,-1,-1,-1,-1},
+  { 8, 9,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 8, 9,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 8, 9,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 8, 9,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 4, 5, 8, 9,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 8, 9,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 8, 9,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 8, 9,12,13,14,15,-1,-1,-1,-1},
+  { 6, 7, 8, 9,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 6, 7, 8, 9,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 6, 7, 8, 9,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 6, 7, 8, 9,12,13,14,15,-1,-1,-1,-1},
+  { 4, 5, 6, 7, 8, 9,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 6, 7, 8, 9,12,13,14,15,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 6, 7, 8, 9,12,13,14,15,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,12,13,14,15,-1,-1},
+  {10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 2, 3,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 4, 5,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 4, 5,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5,10,11,12,13,14,15,-1,-1,-1,-1},
+  { 6, 7,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 6, 7,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 6, 7,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 6, 7,10,11,12,13,14,15,-1,-1,-1,-1},
+  { 4, 5, 6, 7,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 6, 7,10,11,12,13,14,15,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 6, 7,10,11,12,13,14,15,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 6, 7,10,11,12,13,14,15,-1,-1},
+  { 8, 9,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 8, 9,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 2, 3, 8, 9,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 8, 9,10,11,12,13,14,15,-1,-1,-1,-1},
+  { 4, 5, 8, 9,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 8, 9,10,11,12,13,14,15,-1,-1,-1,-1},
+  { 2, 3, 4, 5, 8, 9,10,11,12,13,14,15,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 8, 9,10,11,12,13,14,15,-1,-1},
+  { 6, 7, 8, 9,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1},
+  { 0, 1, 6, 7, 8, 9,10,11,12,13,14,15,-1,-1,-1,-1},
+  { 2, 3, 6, 7, 8, 9,10,11,12,13,14,15,-1,-1,-1,-1},
+  { 0, 1, 2, 3, 6, 7, 8, 9,10,11,12,13,14,15,-1,-1},
+  { 4, 5, 6, 7, 8, 9,10,11,12,13,14,15,-1,-1,-1,-1},
+  { 0, 1, 4, 5, 6, 7, 8, 9,10,11,12,13,14,15,-1,-1},
+  { 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14,15,-1,-1},
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14,15}
+};
+
+/*************************************************
+* Name:        fqmul
+*
+* Description: Multiplication followed by Montgomery reduction of
+*              16 coefficients; same result as montgomery_reduce(a*b)
+*
+* Arguments:   - __m256i a: first factors
+*              - __m256i b: second factors
+*
+* Returns coefficients congruent to a*b*R^{-1} mod q
+**************************************************/
+static inline __m256i AVX2 fqmul(__m256i a, __m256i b)
+{
+  const __m256i q = _mm256_set1_epi16(KYBER_Q);
+  const __m256i qinv = _mm256_set1_epi16((int16_t)QINV);
+  __m256i lo, hi;
+
+  lo = _mm256_mullo_epi16(a, b);
+  hi = _mm256_mulhi_epi16(a, b);
+  lo = _mm256_mullo_epi16(lo, qinv);
+  lo = _mm256_mulhi_epi16(lo, q);
+  return _mm256_sub_epi16(hi, lo);
+}
+
+/*************************************************
+* Name:        barrett
+*
+* Description: Barrett reduction of 16 coefficients;
+*              same result as barrett_reduce
+*
+* Arguments:   - __m256i a: coefficients to reduce
+**************************************************/
+static inline __m256i AVX2 barrett(__m256i a)
+{
+  const __m256i q = _mm256_set1_epi16(KYBER_Q);
+  const __m256i v = _mm256_set1_epi16(((1U << 26) + KYBER_Q/2)/KYBER_Q);
+  __m256i t;
+
+  t = _mm256_mulhi_epi16(a, v);
+  t = _mm256_srai_epi16(t, 10);
+  t = _mm256_mullo_epi16(t, q);
+  return _mm256_sub_epi16(a, t);
+}
+
+static inline void AVX2 butterfly(__m256i *a, __m256i *b, __m256i zeta)
+{
+  __m256i t = fqmul(zeta, *b);
+  *b = _mm256_sub_epi16(*a, t);
+  *a = _mm256_add_epi16(*a, t);
+}
+
+static inline void AVX2 butterfly_inv(__m256i *a, __m256i *b, __m256i zeta)
+{
+  __m256i t = *a;
+  *a = barrett(_mm256_add_epi16(t, *b));
+  *b = fqmul(zeta, _mm256_sub_epi16(t, *b));
+}
+
+static inline __m256i AVX2 zeta_halves(int16_t lo, int16_t hi)
+{
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_set1_epi16(lo)),
+                                 _mm_set1_epi16(hi), 1);
+}
+
+/*************************************************
+* Name:        ntt_avx2
+*
+* Description: AVX2 version of ntt. Layers with len >= 16 work on whole
+*              registers; the last three layers work on register pairs
+*              after regrouping the coefficients (len 8: 128-bit halves,
+*              len 4: 64-bit quarters, len 2: 32-bit pairs)
+*
+* Arguments:   - int16_t r[256]: pointer to input/output vector of elements
+*                                of Zq
+**************************************************/
+void AVX2 ntt_avx2(int16_t r[256])
+{
+  unsigned int d, start, j, p, k;
+  __m256i v[16], a, b, x, y, zeta;
+
+  for(j = 0; j < 16; j++)
+    v[j] = _mm256_loadu_si256((const __m256i *)&r[16*j]);
+
+  k = 1;
+  for(d = 8; d >= 1; d >>= 1) {
+    for(start = 0; start < 16; start += 2*d) {
+      zeta = _mm256_set1_epi16(zetas[k++]);
+      for(j = start; j < start + d; j++)
+        butterfly(&v[j], &v[j + d], zeta);
+    }
+  }
+
+  for(p = 0; p < 8; p++) {
+    a = v[2*p];
+    b = v[2*p+1];
+
+    x = _mm256_permute2x128_si256(a, b, 0x20);
+    y = _mm256_permute2x128_si256(a, b, 0x31);
+    butterfly(&x, &y, zeta_halves(zetas[16+2*p], zetas[17+2*p]));
+    a = _mm256_permute2x128_si256(x, y, 0x20);
+    b = _mm256_permute2x128_si256(x, y, 0x31);
+
+    x = _mm256_unpacklo_epi64(a, b);
+    y = _mm256_unpackhi_epi64(a, b);
+    butterfly(&x, &y, _mm256_load_si256((const __m256i *)&zetas_len4[16*p]));
+    a = _mm256_unpacklo_epi64(x, y);
+    b = _mm256_unpackhi_epi64(x, y);
+
+    a = _mm256_shuffle_epi32(a, 0xD8);
+    b = _mm256_shuffle_epi32(b, 0xD8);
+    x = _mm256_unpacklo_epi64(a, b);
+    y = _mm256_unpackhi_epi64(a, b);
+    butterfly(&x, &y, _mm256_load_si256((const __m256i *)&zetas_len2[16*p]));
+    a = _mm256_unpacklo_epi64(x, y);
+    b = _mm256_unpackhi_epi64(x, y);
+    v[2*p] = _mm256_shuffle_epi32(a, 0xD8);
+    v[2*p+1] = _mm256_shuffle_epi32(b, 0xD8);
+  }
+
+  for(j = 0; j < 16; j++)
+    _mm256_storeu_si256((__m256i *)&r[16*j], v[j]);
+}
+
+/*************************************************
+* Name:        invntt_avx2
+*
+* Description: AVX2 version of invntt; the register layout mirrors ntt_avx2
+*
+* Arguments:   - int16_t r[256]: pointer to input/output vector of elements
+*                                of Zq
+**************************************************/
+void AVX2 invntt_avx2(int16_t r[256])
+{
+  unsigned int d, start, j, p, k;
+  __m256i v[16], a, b, x, y, zeta;
+
+  for(p = 0; p < 8; p++) {
+    a = _mm256_loadu_si256((const __m256i *)&r[32*p]);
+    b = _mm256_loadu_si256((const __m256i *)&r[32*p+16]);
+
+    a = _mm256_shuffle_epi32(a, 0xD8);
+    b = _mm256_shuffle_epi32(b, 0xD8);
+    x = _mm256_unpacklo_epi64(a, b);
+    y = _mm256_unpackhi_epi64(a, b);
+    butterfly_inv(&x, &y, _mm256_load_si256((const __m256i *)&zetas_inv_len2[16*p]));
+    a = _mm256_unpacklo_epi64(x, y);
+    b = _mm256_unpackhi_epi64(x, y);
+    a = _mm256_shuffle_epi32(a, 0xD8);
+    b = _mm256_shuffle_epi32(b, 0xD8);
+
+    x = _mm256_unpacklo_epi64(a, b);
+    y = _mm256_unpackhi_epi64(a, b);
+    butterfly_inv(&x, &y, _mm256_load_si256((const __m256i *)&zetas_inv_len4[16*p]));
+    a = _mm256_unpacklo_epi64(x, y);
+    b = _mm256_unpackhi_epi64(x, y);
+
+    x = _mm256_permute2x128_si256(a, b, 0x20);
+    y = _mm256_permute2x128_si256(a, b, 0x31);
+    butterfly_inv(&x, &y, zeta_halves(zetas_inv[96+2*p], zetas_inv[97+2*p]));
+    v[2*p] = _mm256_permute2x128_si256(x, y, 0x20);
+    v[2*p+1] = _mm256_permute2x128_si256(x, y, 0x31);
+  }
+
+  k = 112;
+  for(d = 1; d <= 8; d <<= 1) {
+    for(start = 0; start < 16; start += 2*d) {
+      zeta = _mm256_set1_epi16(zetas_inv[k++]);
+      for(j = start; j < start + d; j++)
+        butterfly_inv(&v[j], &v[j + d], zeta);
+    }
+  }
+
+  zeta = _mm256_set1_epi16(zetas_inv[127]);
+  for(j = 0; j < 16; j++)
+    _mm256_storeu_si256((__m256i *)&r[16*j], fqmul(v[j], zeta));
+}
+
+/*************************************************
+* Name:        poly_basemul_montgomery_avx2
+*
+* Description: AVX2 version of poly_basemul_montgomery. Products a0*b0 and
+*              a1*b1 are formed in one multiplication, a0*b1 and a1*b0 in a
+*              second one against b with its pairs swapped
+*
+* Arguments:   - poly *r:       pointer to output polynomial
+*              - const poly *a: pointer to first input polynomial
+*              - const poly *b: pointer to second input polynomial
+**************************************************/
+void AVX2 poly_basemul_montgomery_avx2(poly *r, const poly *a, const poly *b)
+{
+  unsigned int i;
+  const __m256i swap = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5,
+                                        10, 11, 8, 9, 14, 15, 12, 13,
+                                        2, 3, 0, 1, 6, 7, 4, 5,
+                                        10, 11, 8, 9, 14, 15, 12, 13);
+  __m256i fa, fb, prod, cross, z, even, odd;
+
+  for(i = 0; i < KYBER_N/16; i++) {
+    fa = _mm256_loadu_si256((const __m256i *)&a->coeffs[16*i]);
+    fb = _mm256_loadu_si256((const __m256i *)&b->coeffs[16*i]);
+    z = _mm256_load_si256((const __m256i *)&zetas_basemul[16*i]);
+
+    prod = fqmul(fa, fb);
+    cross = fqmul(fa, _mm256_shuffle_epi8(fb, swap));
+    z = fqmul(prod, z);
+
+    even = _mm256_add_epi16(prod, _mm256_shuffle_epi8(z, swap));
+    odd = _mm256_add_epi16(cross, _mm256_shuffle_epi8(cross, swap));
+    _mm256_storeu_si256((__m256i *)&r->coeffs[16*i],
+                        _mm256_blend_epi16(even, odd, 0xAA));
+  }
+}
+
+/*************************************************
+* Name:        poly_reduce_avx2
+*
+* Description: AVX2 version of poly_reduce
+*
+* Arguments:   - poly *r: pointer to input/output polynomial
+**************************************************/
+void AVX2 poly_reduce_avx2(poly *r)
+{
+  unsigned int i;
+  __m256i f;
+
+  for(i = 0; i < KYBER_N/16; i++) {
+    f = _mm256_loadu_si256((const __m256i *)&r->coeffs[16*i]);
+    _mm256_storeu_si256((__m256i *)&r->coeffs[16*i], barrett(f));
+  }
+}
+
+#if (KYBER_POLYCOMPRESSEDBYTES == 128)
+/*************************************************
+* Name:        poly_compress_avx2
+*
+* Description: AVX2 version of poly_compress (4 bits per coefficient).
+*              Like the reference, leaves a reduced by csubq. Division by q
+*              is a multiplication by ceil(2^26/q) and a shift, exact for
+*              coefficients in [0,q)
+*
+* Arguments:   - uint8_t *r: pointer to output byte array
+*                            (of length KYBER_POLYCOMPRESSEDBYTES)
+*              - poly *a:    pointer to input polynomial
+**************************************************/
+void AVX2 poly_compress_avx2(uint8_t r[KYBER_POLYCOMPRESSEDBYTES], poly *a)
+{
+  unsigned int i, j;
+  const __m256i q = _mm256_set1_epi16(KYBER_Q);
+  const __m256i half = _mm256_set1_epi16(KYBER_Q/2);
+  const __m256i v = _mm256_set1_epi16(((1U << 26) + KYBER_Q/2)/KYBER_Q);
+  const __m256i mask = _mm256_set1_epi16(15);
+  const __m256i shift = _mm256_set1_epi16((16 << 8) + 1);
+  const __m256i permdidx = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  __m256i f[4], f0, f1;
+
+  for(i = 0; i < KYBER_N/64; i++) {
+    for(j = 0; j < 4; j++) {
+      f[j] = _mm256_loadu_si256((const __m256i *)&a->coeffs[64*i+16*j]);
+      f[j] = _mm256_sub_epi16(f[j], q);
+      f[j] = _mm256_add_epi16(f[j], _mm256_and_si256(_mm256_srai_epi16(f[j], 15), q));
+      _mm256_storeu_si256((__m256i *)&a->coeffs[64*i+16*j], f[j]);
+
+      f[j] = _mm256_add_epi16(_mm256_slli_epi16(f[j], 4), half);
+      f[j] = _mm256_srli_epi16(_mm256_mulhi_epu16(f[j], v), 10);
+      f[j] = _mm256_and_si256(f[j], mask);
+    }
+
+    f0 = _mm256_maddubs_epi16(_mm256_packus_epi16(f[0], f[1]), shift);
+    f1 = _mm256_maddubs_epi16(_mm256_packus_epi16(f[2], f[3]), shift);
+    f0 = _mm256_packus_epi16(f0, f1);
+    f0 = _mm256_permutevar8x32_epi32(f0, permdidx);
+    _mm256_storeu_si256((__m256i *)&r[32*i], f0);
+  }
+}
+#endif
+
+/*************************************************
+* Name:        cbd2_avx2
+*
+* Description: AVX2 version of cbd2; 32 input bytes give 64 coefficients,
+*              two per byte
+*
+* Arguments:   - poly *r:            pointer to output polynomial
+*              - const uint8_t *buf: pointer to input byte array
+**************************************************/
+static void AVX2 cbd2_avx2(poly *r, const uint8_t buf[2*KYBER_N/4])
+{
+  unsigned int i;
+  const __m256i mask55 = _mm256_set1_epi32(0x55555555);
+  const __m256i mask33 = _mm256_set1_epi32(0x33333333);
+  const __m256i mask03 = _mm256_set1_epi32(0x03030303);
+  const __m256i mask0F = _mm256_set1_epi32(0x0F0F0F0F);
+  __m256i f0, f1, f2, f3;
+
+  for(i = 0; i < KYBER_N/64; i++) {
+    f0 = _mm256_loadu_si256((const __m256i *)&buf[32*i]);
+
+    // Bit pair sums, then a - b + 3 in every nibble
+    f1 = _mm256_srli_epi16(f0, 1);
+    f0 = _mm256_and_si256(mask55, f0);
+    f1 = _mm256_and_si256(mask55, f1);
+    f0 = _mm256_add_epi8(f0, f1);
+
+    f1 = _mm256_srli_epi16(f0, 2);
+    f0 = _mm256_and_si256(mask33, f0);
+    f1 = _mm256_and_si256(mask33, f1);
+    f0 = _mm256_add_epi8(f0, mask33);
+    f0 = _mm256_sub_epi8(f0, f1);
+
+    f1 = _mm256_srli_epi16(f0, 4);
+    f0 = _mm256_and_si256(mask0F, f0);
+    f1 = _mm256_and_si256(mask0F, f1);
+    f0 = _mm256_sub_epi8(f0, mask03);
+    f1 = _mm256_sub_epi8(f1, mask03);
+
+    // Low nibble is the even coefficient, high nibble the odd one
+    f2 = _mm256_unpacklo_epi8(f0, f1);
+    f3 = _mm256_unpackhi_epi8(f0, f1);
+
+    f0 = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(f2));
+    f1 = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(f2, 1));
+    f2 = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(f3));
+    f3 = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(f3, 1));
+
+    _mm256_storeu_si256((__m256i *)&r->coeffs[64*i+0], f0);
+    _mm256_storeu_si256((__m256i *)&r->coeffs[64*i+16], f2);
+    _mm256_storeu_si256((__m256i *)&r->coeffs[64*i+32], f1);
+    _mm256_storeu_si256((__m256i *)&r->coeffs[64*i+48], f3);
+  }
+}
+
+#if KYBER_ETA1 == 3
+/*************************************************
+* Name:        cbd3_avx2
+*
+* Description: AVX2 version of cbd3; every 3-byte group is spread over a
+*              32-bit lane, 24 input bytes give 32 coefficients
+*
+* Arguments:   - poly *r:            pointer to output polynomial
+*              - const uint8_t *buf: pointer to input byte array
+**************************************************/
+static void AVX2 cbd3_avx2(poly *r, const uint8_t buf[3*KYBER_N/4])
+{
+  unsigned int i;
+  const __m256i mask249 = _mm256_set1_epi32(0x249249);
+  const __m256i mask6DB = _mm256_set1_epi32(0x6DB6DB);
+  const __m256i mask07 = _mm256_set1_epi32(7);
+  const __m256i mask70 = _mm256_set1_epi32(7 << 16);
+  const __m256i mask3 = _mm256_set1_epi16(3);
+  const __m256i shufbidx = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1,
+                                            6, 7, 8, -1, 9, 10, 11, -1,
+                                            4, 5, 6, -1, 7, 8, 9, -1,
+                                            10, 11, 12, -1, 13, 14, 15, -1);
+  __m256i f0, f1, f2, f3;
+
+  for(i = 0; i < KYBER_N/32; i++) {
+    // Bytes 0..15 and 8..23: no read past the 24 bytes of this round
+    f0 = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)&buf[24*i]));
+    f0 = _mm256_inserti128_si256(f0, _mm_loadu_si128((const __m128i *)&buf[24*i+8]), 1);
+    f0 = _mm256_shuffle_epi8(f0, shufbidx);
+
+    f1 = _mm256_srli_epi32(f0, 1);
+    f2 = _mm256_srli_epi32(f0, 2);
+    f0 = _mm256_and_si256(mask249, f0);
+    f1 = _mm256_and_si256(mask249, f1);
+    f2 = _mm256_and_si256(mask249, f2);
+    f0 = _mm256_add_epi32(f0, f1);
+    f0 = _mm256_add_epi32(f0, f2);
+
+    // a - b + 3 in bits 0-2, 6-8, 12-14 and 18-20
+    f1 = _mm256_srli_epi32(f0, 3);
+    f0 = _mm256_add_epi32(f0, mask6DB);
+    f0 = _mm256_sub_epi32(f0, f1);
+
+    f1 = _mm256_slli_epi32(f0, 10);
+    f2 = _mm256_srli_epi32(f0, 12);
+    f3 = _mm256_srli_epi32(f0, 2);
+    f0 = _mm256_and_si256(f0, mask07);
+    f1 = _mm256_and_si256(f1, mask70);
+    f2 = _mm256_and_si256(f2, mask07);
+    f3 = _mm256_and_si256(f3, mask70);
+    f0 = _mm256_add_epi16(f0, f1);
+    f1 = _mm256_add_epi16(f2, f3);
+    f0 = _mm256_sub_epi16(f0, mask3);
+    f1 = _mm256_sub_epi16(f1, mask3);
+
+    f2 = _mm256_unpacklo_epi32(f0, f1);
+    f3 = _mm256_unpackhi_epi32(f0, f1);
+
+    f0 = _mm256_permute2x128_si256(f2, f3, 0x20);
+    f1 = _mm256_permute2x128_si256(f2, f3, 0x31);
+
+    _mm256_storeu_si256((__m256i *)&r->coeffs[32*i+0], f0);
+    _mm256_storeu_si256((__m256i *)&r->coeffs[32*i+16], f1);
+  }
+}
+#endif
+
+void cbd_eta1_avx2(poly *r, const uint8_t buf[KYBER_ETA1*KYBER_N/4])
+{
+#if KYBER_ETA1 == 2
+  cbd2_avx2(r, buf);
+#elif KYBER_ETA1 == 3
+  cbd3_avx2(r, buf);
+#else
+#error "This implementation requires eta1 in {2,3}"
+#endif
+}
+
+void cbd_eta2_avx2(poly *r, const uint8_t buf[KYBER_ETA2*KYBER_N/4])
+{
+#if KYBER_ETA2 != 2
+#error "This implementation requires eta2 = 2"
+#else
+  cbd2_avx2(r, buf);
+#endif
+}
+
+/*************************************************
+* Name:        rej_uniform_avx2
+*
+* Description: AVX2 part of rej_uniform: takes 16 candidates from 24 bytes
+*              per round while at least 16 outputs are still missing.
+*              Accepts values in the same order as the reference, which
+*              finishes the remaining bytes
+*
+* Arguments:   - int16_t *r:          pointer to output buffer
+*              - unsigned int len:    requested number of 16-bit integers
+*              - const uint8_t *buf:  pointer to input buffer
+*              - unsigned int buflen: length of input buffer in bytes
+*              - unsigned int *pos:   output: number of bytes consumed
+*
+* Returns number of sampled 16-bit integers (at most len)
+**************************************************/
+unsigned int AVX2 rej_uniform_avx2(int16_t *r,
+                                   unsigned int len,
+                                   const uint8_t *buf,
+                                   unsigned int buflen,
+                                   unsigned int *pos)
+{
+  unsigned int ctr, off, good;
+  const __m256i bound = _mm256_set1_epi16(KYBER_Q);
+  const __m256i mask = _mm256_set1_epi16(0xFFF);
+  const __m256i idx8 = _mm256_setr_epi8(0, 1, 1, 2, 3, 4, 4, 5,
+                                        6, 7, 7, 8, 9, 10, 10, 11,
+                                        4, 5, 5, 6, 7, 8, 8, 9,
+                                        10, 11, 11, 12, 13, 14, 14, 15);
+  __m256i f, g;
+  __m128i lo, hi;
+
+  ctr = off = 0;
+  while(ctr + 16 <= len && off + 24 <= buflen) {
+    f = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)&buf[off]));
+    f = _mm256_inserti128_si256(f, _mm_loadu_si128((const __m128i *)&buf[off+8]), 1);
+    f = _mm256_shuffle_epi8(f, idx8);
+    f = _mm256_blend_epi16(f, _mm256_srli_epi16(f, 4), 0xAA);
+    f = _mm256_and_si256(f, mask);
+    off += 24;
+
+    g = _mm256_cmpgt_epi16(bound, f);
+    g = _mm256_packs_epi16(g, _mm256_setzero_si256());
+    good = (unsigned int)_mm256_movemask_epi8(g);
+
+    lo = _mm256_castsi256_si128(f);
+    hi = _mm256_extracti128_si256(f, 1);
+    lo = _mm_shuffle_epi8(lo, _mm_load_si128((const __m128i *)rej_idx[good & 0xFF]));
+    _mm_storeu_si128((__m128i *)&r[ctr], lo);
+    ctr += __builtin_popcount(good & 0xFF);
+    hi = _mm_shuffle_epi8(hi, _mm_load_si128((const __m128i *)rej_idx[(good >> 16) & 0xFF]));
+    _mm_storeu_si128((__m128i *)&r[ctr], hi);
+    ctr += __builtin_popcount((good >> 16) & 0xFF);
+  }
+
+  *pos = off;
+  return ctr;
+}
+
+#endif
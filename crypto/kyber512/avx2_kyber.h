@@ -0,0 +1,49 @@
+#ifndef AVX2_KYBER_H
+#define AVX2_KYBER_H
+
+#include <stdint.h>
+#include "params.h"
+#include "poly_kyber.h"
+
+/*
+ * AVX2 kernels are compiled with per-function target attributes, so the
+ * library is built without -mavx2 and the reference code is used on CPUs
+ * without AVX2. Define KYBER_NO_AVX2 to build the reference code only.
+ * All kernels produce exactly the same output as the reference functions
+ * they replace.
+ */
+#if !defined(KYBER_NO_AVX2) && (defined(__x86_64__) || defined(__i386__)) \
+    && (defined(__GNUC__) || defined(__clang__))
+#define KYBER_AVX2
+
+static inline int kyber_has_avx2(void)
+{
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+}
+
+#define ntt_avx2 KYBER_NAMESPACE(_ntt_avx2)
+void ntt_avx2(int16_t r[256]);
+#define invntt_avx2 KYBER_NAMESPACE(_invntt_avx2)
+void invntt_avx2(int16_t r[256]);
+#define poly_basemul_montgomery_avx2 KYBER_NAMESPACE(_poly_basemul_montgomery_avx2)
+void poly_basemul_montgomery_avx2(poly *r, const poly *a, const poly *b);
+#define poly_reduce_avx2 KYBER_NAMESPACE(_poly_reduce_avx2)
+void poly_reduce_avx2(poly *r);
+#if (KYBER_POLYCOMPRESSEDBYTES == 128)
+#define poly_compress_avx2 KYBER_NAMESPACE(_poly_compress_avx2)
+void poly_compress_avx2(uint8_t r[KYBER_POLYCOMPRESSEDBYTES], poly *a);
+#endif
+#define cbd_eta1_avx2 KYBER_NAMESPACE(_cbd_eta1_avx2)
+void cbd_eta1_avx2(poly *r, const uint8_t buf[KYBER_ETA1*KYBER_N/4]);
+#define cbd_eta2_avx2 KYBER_NAMESPACE(_cbd_eta2_avx2)
+void cbd_eta2_avx2(poly *r, const uint8_t buf[KYBER_ETA2*KYBER_N/4]);
+#define rej_uniform_avx2 KYBER_NAMESPACE(_rej_uniform_avx2)
+unsigned int rej_uniform_avx2(int16_t *r,
+                              unsigned int len,
+                              const uint8_t *buf,
+                              unsigned int buflen,
+                              unsigned int *pos);
+
+#endif
+
+#endif
@@ -1,6 +1,7 @@
 #include <stdint.h>
 #include "params.h"
 #include "cbd.h"
+#include "avx2_kyber.h"
 
 /*************************************************
 * Name:        load32_littleendian
@@ -109,6 +110,13 @@ static void cbd3(poly *r, const uint8_t buf[3*KYBER_N/4])
 
 void cbd_eta1(poly *r, const uint8_t buf[KYBER_ETA1*KYBER_N/4])
 {
+#ifdef KYBER_AVX2
+  if(kyber_has_avx2()) {
+    cbd_eta1_avx2(r, buf);
+    return;
+  }
+#endif
+
 #if KYBER_ETA1 == 2
   cbd2(r, buf);
 #elif KYBER_ETA1 == 3
@@ -123,6 +131,12 @@ void cbd_eta2(poly *r, const uint8_t buf[KYBER_ETA1*KYBER_N/4])
 #if KYBER_ETA2 != 2
 #error "This implementation requires eta2 = 2"
 #else
+#ifdef KYBER_AVX2
+  if(kyber_has_avx2()) {
+    cbd_eta2_avx2(r, buf);
+    return;
+  }
+#endif
   cbd2(r, buf);
 #endif
 }
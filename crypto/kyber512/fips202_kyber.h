@@ -15,6 +15,12 @@ typedef struct {
   uint64_t s[25];
 } keccak_state;
 
+#define KeccakF_RoundConstants FIPS202_NAMESPACE(_KeccakF_RoundConstants)
+extern const uint64_t KeccakF_RoundConstants[24];
+
+#define KeccakF1600_StatePermute FIPS202_NAMESPACE(_KeccakF1600_StatePermute)
+void KeccakF1600_StatePermute(uint64_t state[25]);
+
 #define shake128_absorb FIPS202_NAMESPACE(_shake128_absorb)
 void shake128_absorb(keccak_state *state, const uint8_t *in, size_t inlen);
 #define shake128_squeezeblocks FIPS202_NAMESPACE(_shake128_squeezeblocks)
@@ -0,0 +1,50 @@
+#ifndef FIPS202X4_H
+#define FIPS202X4_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "fips202_kyber.h"
+
+/*
+ * Four independent Keccak states, interleaved lane by lane:
+ * s[4*i + j] is lane i of state j. The permutation runs on all four at
+ * once (AVX2 when available, otherwise four scalar permutations).
+ */
+typedef struct {
+  uint64_t s[4*25];
+} keccakx4_state;
+
+#define KeccakF1600_StatePermute4x FIPS202_NAMESPACE(_KeccakF1600_StatePermute4x)
+void KeccakF1600_StatePermute4x(uint64_t state[4*25]);
+
+#define shake128x4_absorb FIPS202_NAMESPACE(_shake128x4_absorb)
+void shake128x4_absorb(keccakx4_state *state,
+                       const uint8_t *in0,
+                       const uint8_t *in1,
+                       const uint8_t *in2,
+                       const uint8_t *in3,
+                       size_t inlen);
+#define shake128x4_squeezeblocks FIPS202_NAMESPACE(_shake128x4_squeezeblocks)
+void shake128x4_squeezeblocks(uint8_t *out0,
+                              uint8_t *out1,
+                              uint8_t *out2,
+                              uint8_t *out3,
+                              size_t nblocks,
+                              keccakx4_state *state);
+
+#define shake256x4_absorb FIPS202_NAMESPACE(_shake256x4_absorb)
+void shake256x4_absorb(keccakx4_state *state,
+                       const uint8_t *in0,
+                       const uint8_t *in1,
+                       const uint8_t *in2,
+                       const uint8_t *in3,
+                       size_t inlen);
+#define shake256x4_squeezeblocks FIPS202_NAMESPACE(_shake256x4_squeezeblocks)
+void shake256x4_squeezeblocks(uint8_t *out0,
+                              uint8_t *out1,
+                              uint8_t *out2,
+                              uint8_t *out3,
+                              size_t nblocks,
+                              keccakx4_state *state);
+
+#endif
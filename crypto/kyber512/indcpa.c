@@ -7,6 +7,7 @@
 #include "../../qgp_random.h"
 #include "ntt_kyber.h"
 #include "symmetric.h"
+#include "avx2_kyber.h"
 
 // Map Kyber's randombytes to our implementation
 #define randombytes qgp_randombytes
@@ -144,6 +145,10 @@ static unsigned int rej_uniform(int16_t *r,
   uint16_t val0, val1;
 
   ctr = pos = 0;
+#ifdef KYBER_AVX2
+  if(kyber_has_avx2())
+    ctr = rej_uniform_avx2(r, len, buf, buflen, &pos);
+#endif
   while(ctr < len && pos + 3 <= buflen) {
     val0 = ((buf[pos+0] >> 0) | ((uint16_t)buf[pos+1] << 8)) & 0xFFF;
     val1 = ((buf[pos+1] >> 4) | ((uint16_t)buf[pos+2] << 4)) & 0xFFF;
@@ -176,6 +181,7 @@ static unsigned int rej_uniform(int16_t *r,
 **************************************************/
 #define GEN_MATRIX_NBLOCKS ((12*KYBER_N/8*(1 << 12)/KYBER_Q \
                              + XOF_BLOCKBYTES)/XOF_BLOCKBYTES)
+#ifdef KYBER_90S
 // Not static for benchmarking
 void gen_matrix(polyvec *a, const uint8_t seed[KYBER_SYMBYTES], int transposed)
 {
@@ -206,6 +212,51 @@ void gen_matrix(polyvec *a, const uint8_t seed[KYBER_SYMBYTES], int transposed)
     }
   }
 }
+#else
+// Not static for benchmarking
+// Four matrix entries per round, from four interleaved SHAKE128 streams;
+// every stream is consumed exactly as in the one-entry-at-a-time loop
+void gen_matrix(polyvec *a, const uint8_t seed[KYBER_SYMBYTES], int transposed)
+{
+  unsigned int ctr[4], e, i, j, k, l;
+  unsigned int buflen, off;
+  uint8_t x[4], y[4];
+  int16_t *r[4];
+  int16_t unused[KYBER_N];
+  uint8_t buf[4][GEN_MATRIX_NBLOCKS*XOF_BLOCKBYTES+2];
+  xof_state_x4 state;
+
+  for(e=0;e<KYBER_K*KYBER_K;e+=4) {
+    for(k=0;k<4;k++) {
+      // Lanes past the last entry recompute it into a scratch polynomial
+      l = e + k < KYBER_K*KYBER_K ? e + k : KYBER_K*KYBER_K - 1;
+      i = l / KYBER_K;
+      j = l % KYBER_K;
+      x[k] = transposed ? i : j;
+      y[k] = transposed ? j : i;
+      r[k] = e + k < KYBER_K*KYBER_K ? a[i].vec[j].coeffs : unused;
+    }
+
+    xof_absorb_x4(&state, seed, x, y);
+    xof_squeezeblocks_x4(buf[0], buf[1], buf[2], buf[3], GEN_MATRIX_NBLOCKS, &state);
+    buflen = GEN_MATRIX_NBLOCKS*XOF_BLOCKBYTES;
+    for(k=0;k<4;k++)
+      ctr[k] = rej_uniform(r[k], KYBER_N, buf[k], buflen);
+
+    while(ctr[0] < KYBER_N || ctr[1] < KYBER_N || ctr[2] < KYBER_N || ctr[3] < KYBER_N) {
+      off = buflen % 3;
+      for(k=0;k<4;k++)
+        for(l=0;l<off;l++)
+          buf[k][l] = buf[k][buflen - off + l];
+      xof_squeezeblocks_x4(buf[0] + off, buf[1] + off, buf[2] + off, buf[3] + off, 1, &state);
+      buflen = off + XOF_BLOCKBYTES;
+      for(k=0;k<4;k++)
+        if(ctr[k] < KYBER_N)
+          ctr[k] += rej_uniform(r[k] + ctr[k], KYBER_N - ctr[k], buf[k], buflen);
+    }
+  }
+}
+#endif
 
 /*************************************************
 * Name:        indcpa_keypair
@@ -233,10 +284,15 @@ void indcpa_keypair(uint8_t pk[KYBER_INDCPA_PUBLICKEYBYTES],
 
   gen_a(a, publicseed);
 
+#if !defined(KYBER_90S) && (KYBER_K == 2)
+  poly_getnoise_eta1_4x(&skpv.vec[0], &skpv.vec[1], &e.vec[0], &e.vec[1],
+                        noiseseed, nonce, nonce+1, nonce+2, nonce+3);
+#else
   for(i=0;i<KYBER_K;i++)
     poly_getnoise_eta1(&skpv.vec[i], noiseseed, nonce++);
   for(i=0;i<KYBER_K;i++)
     poly_getnoise_eta1(&e.vec[i], noiseseed, nonce++);
+#endif
 
   polyvec_ntt(&skpv);
   polyvec_ntt(&e);
@@ -255,50 +311,74 @@ void indcpa_keypair(uint8_t pk[KYBER_INDCPA_PUBLICKEYBYTES],
 }
 
 /*************************************************
-* Name:        indcpa_enc
+* Name:        indcpa_pk_expand
+*
+* Description: Unpacks a public key and generates the transposed
+*              matrix A from its seed, so that several encryptions
+*              under the same key only do this once.
+*
+* Arguments:   - indcpa_expanded_pk *epk: pointer to output expanded key
+*              - const uint8_t *pk:       pointer to input public key
+*                                         (of length KYBER_INDCPA_PUBLICKEYBYTES)
+**************************************************/
+void indcpa_pk_expand(indcpa_expanded_pk *epk,
+                      const uint8_t pk[KYBER_INDCPA_PUBLICKEYBYTES])
+{
+  uint8_t seed[KYBER_SYMBYTES];
+
+  unpack_pk(&epk->pkpv, seed, pk);
+  gen_at(epk->at, seed);
+}
+
+/*************************************************
+* Name:        indcpa_enc_expanded
 *
 * Description: Encryption function of the CPA-secure
-*              public-key encryption scheme underlying Kyber.
+*              public-key encryption scheme underlying Kyber,
+*              with a public key expanded by indcpa_pk_expand.
 *
 * Arguments:   - uint8_t *c:           pointer to output ciphertext
 *                                      (of length KYBER_INDCPA_BYTES bytes)
 *              - const uint8_t *m:     pointer to input message
 *                                      (of length KYBER_INDCPA_MSGBYTES bytes)
-*              - const uint8_t *pk:    pointer to input public key
-*                                      (of length KYBER_INDCPA_PUBLICKEYBYTES)
+*              - const indcpa_expanded_pk *epk: pointer to input expanded
+*                                      public key
 *              - const uint8_t *coins: pointer to input random coins
 *                                      used as seed (of length KYBER_SYMBYTES)
 *                                      to deterministically generate all
 *                                      randomness
 **************************************************/
-void indcpa_enc(uint8_t c[KYBER_INDCPA_BYTES],
-                const uint8_t m[KYBER_INDCPA_MSGBYTES],
-                const uint8_t pk[KYBER_INDCPA_PUBLICKEYBYTES],
-                const uint8_t coins[KYBER_SYMBYTES])
+void indcpa_enc_expanded(uint8_t c[KYBER_INDCPA_BYTES],
+                         const uint8_t m[KYBER_INDCPA_MSGBYTES],
+                         const indcpa_expanded_pk *epk,
+                         const uint8_t coins[KYBER_SYMBYTES])
 {
   unsigned int i;
-  uint8_t seed[KYBER_SYMBYTES];
   uint8_t nonce = 0;
-  polyvec sp, pkpv, ep, at[KYBER_K], bp;
+  polyvec sp, ep, bp;
   poly v, k, epp;
 
-  unpack_pk(&pkpv, seed, pk);
   poly_frommsg(&k, m);
-  gen_at(at, seed);
 
+#if !defined(KYBER_90S) && (KYBER_K == 2)
+  poly_getnoise_eta1122_4x(sp.vec+0, sp.vec+1, ep.vec+0, ep.vec+1,
+                           coins, nonce, nonce+1, nonce+2, nonce+3);
+  poly_getnoise_eta2(&epp, coins, nonce+4);
+#else
   for(i=0;i<KYBER_K;i++)
     poly_getnoise_eta1(sp.vec+i, coins, nonce++);
   for(i=0;i<KYBER_K;i++)
     poly_getnoise_eta2(ep.vec+i, coins, nonce++);
   poly_getnoise_eta2(&epp, coins, nonce++);
+#endif
 
   polyvec_ntt(&sp);
 
   // matrix-vector multiplication
   for(i=0;i<KYBER_K;i++)
-    polyvec_pointwise_acc_montgomery(&bp.vec[i], &at[i], &sp);
+    polyvec_pointwise_acc_montgomery(&bp.vec[i], &epk->at[i], &sp);
 
-  polyvec_pointwise_acc_montgomery(&v, &pkpv, &sp);
+  polyvec_pointwise_acc_montgomery(&v, &epk->pkpv, &sp);
 
   polyvec_invntt_tomont(&bp);
   poly_invntt_tomont(&v);
@@ -312,6 +392,34 @@ void indcpa_enc(uint8_t c[KYBER_INDCPA_BYTES],
   pack_ciphertext(c, &bp, &v);
 }
 
+/*************************************************
+* Name:        indcpa_enc
+*
+* Description: Encryption function of the CPA-secure
+*              public-key encryption scheme underlying Kyber.
+*
+* Arguments:   - uint8_t *c:           pointer to output ciphertext
+*                                      (of length KYBER_INDCPA_BYTES bytes)
+*              - const uint8_t *m:     pointer to input message
+*                                      (of length KYBER_INDCPA_MSGBYTES bytes)
+*              - const uint8_t *pk:    pointer to input public key
+*                                      (of length KYBER_INDCPA_PUBLICKEYBYTES)
+*              - const uint8_t *coins: pointer to input random coins
+*                                      used as seed (of length KYBER_SYMBYTES)
+*                                      to deterministically generate all
+*                                      randomness
+**************************************************/
+void indcpa_enc(uint8_t c[KYBER_INDCPA_BYTES],
+                const uint8_t m[KYBER_INDCPA_MSGBYTES],
+                const uint8_t pk[KYBER_INDCPA_PUBLICKEYBYTES],
+                const uint8_t coins[KYBER_SYMBYTES])
+{
+  indcpa_expanded_pk epk;
+
+  indcpa_pk_expand(&epk, pk);
+  indcpa_enc_expanded(c, m, &epk, coins);
+}
+
 /*************************************************
 * Name:        indcpa_dec
 *
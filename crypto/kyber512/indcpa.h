@@ -11,6 +11,25 @@ void gen_matrix(polyvec *a, const uint8_t seed[KYBER_SYMBYTES], int transposed);
 void indcpa_keypair(uint8_t pk[KYBER_INDCPA_PUBLICKEYBYTES],
                     uint8_t sk[KYBER_INDCPA_SECRETKEYBYTES]);
 
+/*
+ * Public key unpacked for repeated encryption: t in NTT domain and the
+ * transposed matrix A generated from the public seed.
+ */
+typedef struct {
+  polyvec pkpv;
+  polyvec at[KYBER_K];
+} indcpa_expanded_pk;
+
+#define indcpa_pk_expand KYBER_NAMESPACE(_indcpa_pk_expand)
+void indcpa_pk_expand(indcpa_expanded_pk *epk,
+                      const uint8_t pk[KYBER_INDCPA_PUBLICKEYBYTES]);
+
+#define indcpa_enc_expanded KYBER_NAMESPACE(_indcpa_enc_expanded)
+void indcpa_enc_expanded(uint8_t c[KYBER_INDCPA_BYTES],
+                         const uint8_t m[KYBER_INDCPA_MSGBYTES],
+                         const indcpa_expanded_pk *epk,
+                         const uint8_t coins[KYBER_SYMBYTES]);
+
 #define indcpa_enc KYBER_NAMESPACE(_indcpa_enc)
 void indcpa_enc(uint8_t c[KYBER_INDCPA_BYTES],
                 const uint8_t m[KYBER_INDCPA_MSGBYTES],
@@ -36,24 +36,42 @@ int crypto_kem_keypair(unsigned char *pk, unsigned char *sk)
 }
 
 /*************************************************
-* Name:        crypto_kem_enc
+* Name:        crypto_kem_pk_expand
+*
+* Description: Precomputes everything crypto_kem_enc derives from the
+*              public key alone, for repeated encapsulation
+*
+* Arguments:   - crypto_kem_expanded_pk *epk: pointer to output expanded key
+*              - const unsigned char *pk: pointer to input public key
+*                (an already allocated array of CRYPTO_PUBLICKEYBYTES bytes)
+**************************************************/
+void crypto_kem_pk_expand(crypto_kem_expanded_pk *epk,
+                          const unsigned char *pk)
+{
+  indcpa_pk_expand(&epk->indcpa, pk);
+  hash_h(epk->hpk, pk, KYBER_PUBLICKEYBYTES);
+}
+
+/*************************************************
+* Name:        crypto_kem_enc_expanded
 *
 * Description: Generates cipher text and shared
-*              secret for given public key
+*              secret for given expanded public key
 *
 * Arguments:   - unsigned char *ct: pointer to output cipher text
 *                (an already allocated array of CRYPTO_CIPHERTEXTBYTES bytes)
 *              - unsigned char *ss: pointer to output shared secret
 *                (an already allocated array of CRYPTO_BYTES bytes)
-*              - const unsigned char *pk: pointer to input public key
-*                (an already allocated array of CRYPTO_PUBLICKEYBYTES bytes)
+*              - const crypto_kem_expanded_pk *epk: pointer to input
+*                public key expanded by crypto_kem_pk_expand
 *
 * Returns 0 (success)
 **************************************************/
-int crypto_kem_enc(unsigned char *ct,
-                   unsigned char *ss,
-                   const unsigned char *pk)
+int crypto_kem_enc_expanded(unsigned char *ct,
+                            unsigned char *ss,
+                            const crypto_kem_expanded_pk *epk)
 {
+  size_t i;
   uint8_t buf[2*KYBER_SYMBYTES];
   /* Will contain key, coins */
   uint8_t kr[2*KYBER_SYMBYTES];
@@ -63,11 +81,12 @@ int crypto_kem_enc(unsigned char *ct,
   hash_h(buf, buf, KYBER_SYMBYTES);
 
   /* Multitarget countermeasure for coins + contributory KEM */
-  hash_h(buf+KYBER_SYMBYTES, pk, KYBER_PUBLICKEYBYTES);
+  for(i=0;i<KYBER_SYMBYTES;i++)
+    buf[KYBER_SYMBYTES+i] = epk->hpk[i];
   hash_g(kr, buf, 2*KYBER_SYMBYTES);
 
   /* coins are in kr+KYBER_SYMBYTES */
-  indcpa_enc(ct, buf, pk, kr+KYBER_SYMBYTES);
+  indcpa_enc_expanded(ct, buf, &epk->indcpa, kr+KYBER_SYMBYTES);
 
   /* overwrite coins in kr with H(c) */
   hash_h(kr+KYBER_SYMBYTES, ct, KYBER_CIPHERTEXTBYTES);
@@ -76,6 +95,31 @@ int crypto_kem_enc(unsigned char *ct,
   return 0;
 }
 
+/*************************************************
+* Name:        crypto_kem_enc
+*
+* Description: Generates cipher text and shared
+*              secret for given public key
+*
+* Arguments:   - unsigned char *ct: pointer to output cipher text
+*                (an already allocated array of CRYPTO_CIPHERTEXTBYTES bytes)
+*              - unsigned char *ss: pointer to output shared secret
+*                (an already allocated array of CRYPTO_BYTES bytes)
+*              - const unsigned char *pk: pointer to input public key
+*                (an already allocated array of CRYPTO_PUBLICKEYBYTES bytes)
+*
+* Returns 0 (success)
+**************************************************/
+int crypto_kem_enc(unsigned char *ct,
+                   unsigned char *ss,
+                   const unsigned char *pk)
+{
+  crypto_kem_expanded_pk epk;
+
+  crypto_kem_pk_expand(&epk, pk);
+  return crypto_kem_enc_expanded(ct, ss, &epk);
+}
+
 /*************************************************
 * Name:        crypto_kem_dec
 *
@@ -1,7 +1,9 @@
 #ifndef KEM_H
 #define KEM_H
 
+#include <stdint.h>
 #include "params.h"
+#include "indcpa.h"
 
 #define crypto_kem_keypair KYBER_NAMESPACE(_keypair)
 int crypto_kem_keypair(unsigned char *pk, unsigned char *sk);
@@ -11,6 +13,24 @@ int crypto_kem_enc(unsigned char *ct,
                    unsigned char *ss,
                    const unsigned char *pk);
 
+/*
+ * Public key prepared once for repeated encapsulation to one recipient:
+ * the expanded CPA key and H(pk).
+ */
+typedef struct {
+  indcpa_expanded_pk indcpa;
+  uint8_t hpk[KYBER_SYMBYTES];
+} crypto_kem_expanded_pk;
+
+#define crypto_kem_pk_expand KYBER_NAMESPACE(_pk_expand)
+void crypto_kem_pk_expand(crypto_kem_expanded_pk *epk,
+                          const unsigned char *pk);
+
+#define crypto_kem_enc_expanded KYBER_NAMESPACE(_enc_expanded)
+int crypto_kem_enc_expanded(unsigned char *ct,
+                            unsigned char *ss,
+                            const crypto_kem_expanded_pk *epk);
+
 #define crypto_kem_dec KYBER_NAMESPACE(_dec)
 int crypto_kem_dec(unsigned char *ss,
                    const unsigned char *ct,
@@ -1,6 +1,8 @@
 HEADERS += $$PWD/aes256ctr.h \
+           $$PWD/avx2_kyber.h \
            $$PWD/cbd.h \
            $$PWD/fips202_kyber.h \
+           $$PWD/fips202x4_kyber.h \
            $$PWD/indcpa.h \
            $$PWD/kem.h \
            $$PWD/kyber512.h \
@@ -16,8 +18,10 @@ HEADERS += $$PWD/aes256ctr.h \
 
 
 SOURCES += $$PWD/aes256ctr.c \
+           $$PWD/avx2_kyber.c \
            $$PWD/cbd.c \
            $$PWD/fips202_kyber.c \
+           $$PWD/fips202x4_kyber.c \
            $$PWD/indcpa.c \
            $$PWD/kem.c \
            $$PWD/ntt_kyber.c \
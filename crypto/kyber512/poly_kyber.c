@@ -5,6 +5,7 @@
 #include "reduce_kyber.h"
 #include "cbd.h"
 #include "symmetric.h"
+#include "avx2_kyber.h"
 
 /*************************************************
 * Name:        poly_compress
@@ -20,6 +21,13 @@ void poly_compress(uint8_t r[KYBER_POLYCOMPRESSEDBYTES], poly *a)
   unsigned int i,j;
   uint8_t t[8];
 
+#if defined(KYBER_AVX2) && (KYBER_POLYCOMPRESSEDBYTES == 128)
+  if(kyber_has_avx2()) {
+    poly_compress_avx2(r, a);
+    return;
+  }
+#endif
+
   poly_csubq(a);
 
 #if (KYBER_POLYCOMPRESSEDBYTES == 128)
@@ -224,6 +232,77 @@ void poly_getnoise_eta2(poly *r, const uint8_t seed[KYBER_SYMBYTES], uint8_t non
 }
 
 
+#ifndef KYBER_90S
+/*************************************************
+* Name:        poly_getnoise_eta1_4x
+*
+* Description: Sample four polynomials like poly_getnoise_eta1, squeezing
+*              the four PRF streams together
+*
+* Arguments:   - poly *r0..r3:        pointers to output polynomials
+*              - const uint8_t *seed: pointer to input seed
+*                                     (of length KYBER_SYMBYTES bytes)
+*              - uint8_t nonce0..3:   one-byte input nonces
+**************************************************/
+void poly_getnoise_eta1_4x(poly *r0,
+                           poly *r1,
+                           poly *r2,
+                           poly *r3,
+                           const uint8_t seed[KYBER_SYMBYTES],
+                           uint8_t nonce0,
+                           uint8_t nonce1,
+                           uint8_t nonce2,
+                           uint8_t nonce3)
+{
+  uint8_t buf[4][KYBER_ETA1*KYBER_N/4];
+  const uint8_t nonce[4] = { nonce0, nonce1, nonce2, nonce3 };
+
+  prf_x4(buf[0], buf[1], buf[2], buf[3], sizeof(buf[0]), seed, nonce);
+  cbd_eta1(r0, buf[0]);
+  cbd_eta1(r1, buf[1]);
+  cbd_eta1(r2, buf[2]);
+  cbd_eta1(r3, buf[3]);
+}
+
+/*************************************************
+* Name:        poly_getnoise_eta1122_4x
+*
+* Description: Sample two polynomials like poly_getnoise_eta1 and two like
+*              poly_getnoise_eta2 from four PRF streams squeezed together.
+*              The eta2 polynomials use a prefix of their stream, which is
+*              exactly the shorter PRF output
+*
+* Arguments:   - poly *r0, *r1:       pointers to output polynomials (eta1)
+*              - poly *r2, *r3:       pointers to output polynomials (eta2)
+*              - const uint8_t *seed: pointer to input seed
+*                                     (of length KYBER_SYMBYTES bytes)
+*              - uint8_t nonce0..3:   one-byte input nonces
+**************************************************/
+void poly_getnoise_eta1122_4x(poly *r0,
+                              poly *r1,
+                              poly *r2,
+                              poly *r3,
+                              const uint8_t seed[KYBER_SYMBYTES],
+                              uint8_t nonce0,
+                              uint8_t nonce1,
+                              uint8_t nonce2,
+                              uint8_t nonce3)
+{
+#if KYBER_ETA1 < KYBER_ETA2
+#error "poly_getnoise_eta1122_4x requires eta1 >= eta2"
+#endif
+  uint8_t buf[4][KYBER_ETA1*KYBER_N/4];
+  const uint8_t nonce[4] = { nonce0, nonce1, nonce2, nonce3 };
+
+  prf_x4(buf[0], buf[1], buf[2], buf[3], sizeof(buf[0]), seed, nonce);
+  cbd_eta1(r0, buf[0]);
+  cbd_eta1(r1, buf[1]);
+  cbd_eta2(r2, buf[2]);
+  cbd_eta2(r3, buf[3]);
+}
+#endif
+
+
 /*************************************************
 * Name:        poly_ntt
 *
@@ -235,6 +314,13 @@ void poly_getnoise_eta2(poly *r, const uint8_t seed[KYBER_SYMBYTES], uint8_t non
 **************************************************/
 void poly_ntt(poly *r)
 {
+#ifdef KYBER_AVX2
+  if(kyber_has_avx2()) {
+    ntt_avx2(r->coeffs);
+    poly_reduce(r);
+    return;
+  }
+#endif
   ntt(r->coeffs);
   poly_reduce(r);
 }
@@ -250,6 +336,12 @@ void poly_ntt(poly *r)
 **************************************************/
 void poly_invntt_tomont(poly *r)
 {
+#ifdef KYBER_AVX2
+  if(kyber_has_avx2()) {
+    invntt_avx2(r->coeffs);
+    return;
+  }
+#endif
   invntt(r->coeffs);
 }
 
@@ -265,6 +357,14 @@ void poly_invntt_tomont(poly *r)
 void poly_basemul_montgomery(poly *r, const poly *a, const poly *b)
 {
   unsigned int i;
+
+#ifdef KYBER_AVX2
+  if(kyber_has_avx2()) {
+    poly_basemul_montgomery_avx2(r, a, b);
+    return;
+  }
+#endif
+
   for(i=0;i<KYBER_N/4;i++) {
     basemul(&r->coeffs[4*i], &a->coeffs[4*i], &b->coeffs[4*i], zetas[64+i]);
     basemul(&r->coeffs[4*i+2], &a->coeffs[4*i+2], &b->coeffs[4*i+2],
@@ -299,6 +399,14 @@ void poly_tomont(poly *r)
 void poly_reduce(poly *r)
 {
   unsigned int i;
+
+#ifdef KYBER_AVX2
+  if(kyber_has_avx2()) {
+    poly_reduce_avx2(r);
+    return;
+  }
+#endif
+
   for(i=0;i<KYBER_N;i++)
     r->coeffs[i] = barrett_reduce(r->coeffs[i]);
 }
@@ -33,6 +33,30 @@ void poly_getnoise_eta1(poly *r, const uint8_t seed[KYBER_SYMBYTES], uint8_t non
 #define poly_getnoise_eta2 KYBER_NAMESPACE(_poly_getnoise_eta2)
 void poly_getnoise_eta2(poly *r, const uint8_t seed[KYBER_SYMBYTES], uint8_t nonce);
 
+#ifndef KYBER_90S
+#define poly_getnoise_eta1_4x KYBER_NAMESPACE(_poly_getnoise_eta1_4x)
+void poly_getnoise_eta1_4x(poly *r0,
+                           poly *r1,
+                           poly *r2,
+                           poly *r3,
+                           const uint8_t seed[KYBER_SYMBYTES],
+                           uint8_t nonce0,
+                           uint8_t nonce1,
+                           uint8_t nonce2,
+                           uint8_t nonce3);
+
+#define poly_getnoise_eta1122_4x KYBER_NAMESPACE(_poly_getnoise_eta1122_4x)
+void poly_getnoise_eta1122_4x(poly *r0,
+                              poly *r1,
+                              poly *r2,
+                              poly *r3,
+                              const uint8_t seed[KYBER_SYMBYTES],
+                              uint8_t nonce0,
+                              uint8_t nonce1,
+                              uint8_t nonce2,
+                              uint8_t nonce3);
+#endif
+
 #define poly_ntt KYBER_NAMESPACE(_poly_ntt)
 void poly_ntt(poly *r);
 #define poly_invntt_tomont KYBER_NAMESPACE(_poly_invntt_tomont)
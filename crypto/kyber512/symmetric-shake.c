@@ -2,6 +2,7 @@
 #include <stdint.h>
 #include "params.h"
 #include "fips202_kyber.h"
+#include "fips202x4_kyber.h"
 #include "symmetric.h"
 
 /*************************************************
@@ -58,3 +59,84 @@ void kyber_shake256_prf(uint8_t *out,
 
   shake256(out, outlen, extkey, sizeof(extkey));
 }
+
+/*************************************************
+* Name:        kyber_shake128x4_absorb
+*
+* Description: Absorb step of four SHAKE128 instances specialized for the
+*              Kyber context (four matrix entries at once).
+*
+* Arguments:   - keccakx4_state *state: pointer to (uninitialized) output
+*                                       Keccak states
+*              - const uint8_t *seed:   pointer to KYBER_SYMBYTES input
+*                                       to be absorbed into every state
+*              - const uint8_t *x:      first additional byte per instance
+*              - const uint8_t *y:      second additional byte per instance
+**************************************************/
+void kyber_shake128x4_absorb(keccakx4_state *state,
+                             const uint8_t seed[KYBER_SYMBYTES],
+                             const uint8_t x[4],
+                             const uint8_t y[4])
+{
+  unsigned int i, j;
+  uint8_t extseed[4][KYBER_SYMBYTES+2];
+
+  for(j=0;j<4;j++) {
+    for(i=0;i<KYBER_SYMBYTES;i++)
+      extseed[j][i] = seed[i];
+    extseed[j][KYBER_SYMBYTES] = x[j];
+    extseed[j][KYBER_SYMBYTES+1] = y[j];
+  }
+
+  shake128x4_absorb(state, extseed[0], extseed[1], extseed[2], extseed[3],
+                    KYBER_SYMBYTES+2);
+}
+
+/*************************************************
+* Name:        kyber_shake256x4_prf
+*
+* Description: Four evaluations of kyber_shake256_prf with the same key
+*              and different nonces, computed together
+*
+* Arguments:   - uint8_t *out0..out3: pointers to outputs
+*              - size_t outlen:       number of requested output bytes
+*                                     per nonce
+*              - const uint8_t *key:  pointer to the key
+*                                     (of length KYBER_SYMBYTES)
+*              - const uint8_t *nonce: four single-byte nonces
+**************************************************/
+void kyber_shake256x4_prf(uint8_t *out0,
+                          uint8_t *out1,
+                          uint8_t *out2,
+                          uint8_t *out3,
+                          size_t outlen,
+                          const uint8_t key[KYBER_SYMBYTES],
+                          const uint8_t nonce[4])
+{
+  unsigned int i, j;
+  size_t nblocks = outlen/SHAKE256_RATE;
+  uint8_t extkey[4][KYBER_SYMBYTES+1];
+  uint8_t t[4][SHAKE256_RATE];
+  keccakx4_state state;
+
+  for(j=0;j<4;j++) {
+    for(i=0;i<KYBER_SYMBYTES;i++)
+      extkey[j][i] = key[i];
+    extkey[j][KYBER_SYMBYTES] = nonce[j];
+  }
+
+  shake256x4_absorb(&state, extkey[0], extkey[1], extkey[2], extkey[3],
+                    KYBER_SYMBYTES+1);
+  shake256x4_squeezeblocks(out0, out1, out2, out3, nblocks, &state);
+
+  outlen -= nblocks*SHAKE256_RATE;
+  if(outlen) {
+    shake256x4_squeezeblocks(t[0], t[1], t[2], t[3], 1, &state);
+    for(i=0;i<outlen;i++) {
+      out0[nblocks*SHAKE256_RATE+i] = t[0][i];
+      out1[nblocks*SHAKE256_RATE+i] = t[1][i];
+      out2[nblocks*SHAKE256_RATE+i] = t[2][i];
+      out3[nblocks*SHAKE256_RATE+i] = t[3][i];
+    }
+  }
+}
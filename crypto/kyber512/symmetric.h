@@ -43,8 +43,10 @@ void kyber_aes256ctr_prf(uint8_t *out,
 #else
 
 #include "fips202_kyber.h"
+#include "fips202x4_kyber.h"
 
 typedef keccak_state xof_state;
+typedef keccakx4_state xof_state_x4;
 
 #define kyber_shake128_absorb KYBER_NAMESPACE(_kyber_shake128_absorb)
 void kyber_shake128_absorb(keccak_state *s,
@@ -58,6 +60,21 @@ void kyber_shake256_prf(uint8_t *out,
                         const uint8_t key[KYBER_SYMBYTES],
                         uint8_t nonce);
 
+#define kyber_shake128x4_absorb KYBER_NAMESPACE(_kyber_shake128x4_absorb)
+void kyber_shake128x4_absorb(keccakx4_state *state,
+                             const uint8_t seed[KYBER_SYMBYTES],
+                             const uint8_t x[4],
+                             const uint8_t y[4]);
+
+#define kyber_shake256x4_prf KYBER_NAMESPACE(_kyber_shake256x4_prf)
+void kyber_shake256x4_prf(uint8_t *out0,
+                          uint8_t *out1,
+                          uint8_t *out2,
+                          uint8_t *out3,
+                          size_t outlen,
+                          const uint8_t key[KYBER_SYMBYTES],
+                          const uint8_t nonce[4]);
+
 #define XOF_BLOCKBYTES SHAKE128_RATE
 
 #define hash_h(OUT, IN, INBYTES) sha3_256(OUT, IN, INBYTES)
@@ -67,6 +84,14 @@ void kyber_shake256_prf(uint8_t *out,
         shake128_squeezeblocks(OUT, OUTBLOCKS, STATE)
 #define prf(OUT, OUTBYTES, KEY, NONCE) \
         kyber_shake256_prf(OUT, OUTBYTES, KEY, NONCE)
+
+/* Four independent streams per call (interleaved Keccak) */
+#define xof_absorb_x4(STATE, SEED, X, Y) \
+        kyber_shake128x4_absorb(STATE, SEED, X, Y)
+#define xof_squeezeblocks_x4(OUT0, OUT1, OUT2, OUT3, OUTBLOCKS, STATE) \
+        shake128x4_squeezeblocks(OUT0, OUT1, OUT2, OUT3, OUTBLOCKS, STATE)
+#define prf_x4(OUT0, OUT1, OUT2, OUT3, OUTBYTES, KEY, NONCE) \
+        kyber_shake256x4_prf(OUT0, OUT1, OUT2, OUT3, OUTBYTES, KEY, NONCE)
 #define kdf(OUT, IN, INBYTES) shake256(OUT, KYBER_SSBYTES, IN, INBYTES)
 
 #endif /* KYBER_90S */
@@ -2,12 +2,12 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
-#include "api.h"
-#include "kex.h"
+#include "kyber512.h"
 #include "params.h"
 #include "indcpa.h"
-#include "poly.h"
+#include "poly_kyber.h"
 #include "polyvec.h"
+#include "avx2_kyber.h"
 #include "cpucycles.h"
 #include "speed_print.h"
 
@@ -16,6 +16,11 @@
 uint64_t t[NTESTS];
 uint8_t seed[KYBER_SYMBYTES] = {0};
 
+/*
+ * Kernels are picked at run time: AVX2 when the CPU has it, the reference
+ * code otherwise. The kyber512_test_speed_ref build (KYBER_NO_AVX2) times
+ * the reference code on the same machine for comparison.
+ */
 int main()
 {
   unsigned int i;
@@ -23,11 +28,15 @@ int main()
   unsigned char sk[CRYPTO_SECRETKEYBYTES] = {0};
   unsigned char ct[CRYPTO_CIPHERTEXTBYTES] = {0};
   unsigned char key[CRYPTO_BYTES] = {0};
-  unsigned char kexsenda[KEX_AKE_SENDABYTES] = {0};
-  unsigned char kexsendb[KEX_AKE_SENDBBYTES] = {0};
-  unsigned char kexkey[KEX_SSBYTES] = {0};
+  uint8_t compressed[KYBER_POLYCOMPRESSEDBYTES];
   polyvec matrix[KYBER_K];
-  poly ap;
+  poly ap, bp;
+
+#ifdef KYBER_AVX2
+  printf("Kernels: %s\n\n", kyber_has_avx2() ? "AVX2" : "reference (no AVX2 on this CPU)");
+#else
+  printf("Kernels: reference\n\n");
+#endif
 
   for(i=0;i<NTESTS;i++) {
     t[i] = cpucycles();
@@ -49,69 +58,54 @@ int main()
 
   for(i=0;i<NTESTS;i++) {
     t[i] = cpucycles();
-    poly_ntt(&ap);
+    poly_getnoise_eta1_4x(&matrix[0].vec[0], &matrix[0].vec[1],
+                          &matrix[1].vec[0], &matrix[1].vec[1], seed, 0, 1, 2, 3);
   }
-  print_results("NTT: ", t, NTESTS);
-
-  for(i=0;i<NTESTS;i++) {
-    t[i] = cpucycles();
-    poly_invntt_tomont(&ap);
-  }
-  print_results("INVNTT: ", t, NTESTS);
+  print_results("poly_getnoise_eta1_4x: ", t, NTESTS);
 
   for(i=0;i<NTESTS;i++) {
     t[i] = cpucycles();
-    crypto_kem_keypair(pk, sk);
-  }
-  print_results("kyber_keypair: ", t, NTESTS);
-
-  for(i=0;i<NTESTS;i++) {
-    t[i] = cpucycles();
-    crypto_kem_enc(ct, key, pk);
-  }
-  print_results("kyber_encaps: ", t, NTESTS);
-
-  for(i=0;i<NTESTS;i++) {
-    t[i] = cpucycles();
-    crypto_kem_dec(key, ct, sk);
+    poly_ntt(&ap);
   }
-  print_results("kyber_decaps: ", t, NTESTS);
+  print_results("NTT: ", t, NTESTS);
 
   for(i=0;i<NTESTS;i++) {
     t[i] = cpucycles();
-    kex_uake_initA(kexsenda, key, sk, pk);
+    poly_invntt_tomont(&ap);
   }
-  print_results("kex_uake_initA: ", t, NTESTS);
+  print_results("INVNTT: ", t, NTESTS);
 
+  bp = matrix[0].vec[0];
   for(i=0;i<NTESTS;i++) {
     t[i] = cpucycles();
-    kex_uake_sharedB(kexsendb, kexkey, kexsenda, sk);
+    poly_basemul_montgomery(&ap, &bp, &matrix[0].vec[1]);
   }
-  print_results("kex_uake_sharedB: ", t, NTESTS);
+  print_results("poly_basemul_montgomery: ", t, NTESTS);
 
+  poly_reduce(&ap);
   for(i=0;i<NTESTS;i++) {
     t[i] = cpucycles();
-    kex_uake_sharedA(kexkey, kexsendb, key, sk);
+    poly_compress(compressed, &ap);
   }
-  print_results("kex_uake_sharedA: ", t, NTESTS);
+  print_results("poly_compress: ", t, NTESTS);
 
   for(i=0;i<NTESTS;i++) {
     t[i] = cpucycles();
-    kex_ake_initA(kexsenda, key, sk, pk);
+    crypto_kem_keypair(pk, sk);
   }
-  print_results("kex_ake_initA: ", t, NTESTS);
+  print_results("kyber_keypair: ", t, NTESTS);
 
   for(i=0;i<NTESTS;i++) {
     t[i] = cpucycles();
-    kex_ake_sharedB(kexsendb, kexkey, kexsenda, sk, pk);
+    crypto_kem_enc(ct, key, pk);
   }
-  print_results("kex_ake_sharedB: ", t, NTESTS);
+  print_results("kyber_encaps: ", t, NTESTS);
 
   for(i=0;i<NTESTS;i++) {
     t[i] = cpucycles();
-    kex_ake_sharedA(kexkey, kexsendb, key, sk, sk);
+    crypto_kem_dec(key, ct, sk);
   }
-  print_results("kex_ake_sharedA: ", t, NTESTS);
+  print_results("kyber_decaps: ", t, NTESTS);
 
   return 0;
 }
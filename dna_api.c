@@ -716,6 +716,26 @@ dna_error_t dna_decrypt_message_raw(
     size_t *plaintext_len_out,
     uint8_t **sender_sign_pubkey_out,
     size_t *sender_sign_pubkey_len_out)
+{
+    return dna_decrypt_message_raw_expanded(ctx, ciphertext, ciphertext_len,
+                                            recipient_enc_privkey, NULL,
+                                            plaintext_out, plaintext_len_out,
+                                            sender_sign_pubkey_out, sender_sign_pubkey_len_out);
+}
+
+/**
+ * Decrypt message with raw keys, verifying with an expanded sender key
+ */
+dna_error_t dna_decrypt_message_raw_expanded(
+    dna_context_t *ctx,
+    const uint8_t *ciphertext,
+    size_t ciphertext_len,
+    const uint8_t *recipient_enc_privkey,
+    const qgp_dilithium3_expanded_pk *sender_sign_epk,
+    uint8_t **plaintext_out,
+    size_t *plaintext_len_out,
+    uint8_t **sender_sign_pubkey_out,
+    size_t *sender_sign_pubkey_len_out)
 {
     if (!ctx || !ciphertext || !recipient_enc_privkey ||
         !plaintext_out || !plaintext_len_out ||
@@ -837,8 +857,15 @@ dna_error_t dna_decrypt_message_raw(
             uint8_t *sig_pubkey = qgp_signature_get_pubkey(signature);
             uint8_t *sig_bytes = qgp_signature_get_bytes(signature);
 
-            if (qgp_dilithium3_verify(sig_bytes, signature->signature_size,
-                                     decrypted, decrypted_size, sig_pubkey) != 0) {
+            int verified;
+            if (qgp_dilithium3_expanded_pk_matches(sender_sign_epk, sig_pubkey, signature->public_key_size)) {
+                verified = qgp_dilithium3_verify_expanded(sig_bytes, signature->signature_size,
+                                                          decrypted, decrypted_size, sender_sign_epk);
+            } else {
+                verified = qgp_dilithium3_verify(sig_bytes, signature->signature_size,
+                                                 decrypted, decrypted_size, sig_pubkey);
+            }
+            if (verified != 0) {
                 result = DNA_ERROR_VERIFY;
                 goto cleanup;
             }
@@ -230,6 +230,32 @@ dna_error_t dna_decrypt_message_raw(
     size_t *sender_sign_pubkey_len_out
 );
 
+struct qgp_dilithium3_expanded_pk;
+
+/**
+ * Decrypt message with raw keys, verifying with an expanded sender key
+ *
+ * Same as dna_decrypt_message_raw(). If the message is signed with the key
+ * sender_sign_epk was expanded from (see qgp_dilithium3_pk_expand()), the
+ * signature is checked against sender_sign_epk, which skips unpacking the
+ * key and expanding its matrix for every message. Messages signed with any
+ * other key are verified as usual.
+ *
+ * @param sender_sign_epk: Expected sender's expanded Dilithium3 key (NULL = none)
+ * (other parameters as dna_decrypt_message_raw())
+ */
+dna_error_t dna_decrypt_message_raw_expanded(
+    dna_context_t *ctx,
+    const uint8_t *ciphertext,
+    size_t ciphertext_len,
+    const uint8_t *recipient_enc_privkey,
+    const struct qgp_dilithium3_expanded_pk *sender_sign_epk,
+    uint8_t **plaintext_out,
+    size_t *plaintext_len_out,
+    uint8_t **sender_sign_pubkey_out,
+    size_t *sender_sign_pubkey_len_out
+);
+
 // ============================================================================
 // SIGNATURE OPERATIONS
 // ============================================================================
@@ -24,14 +24,21 @@ int dna_config_load(dna_config_t *config) {
     char config_path[512];
     get_config_path(config_path, sizeof(config_path));
 
+    // Defaults (used if file doesn't exist or a key is missing)
+    memset(config, 0, sizeof(*config));
+    strcpy(config->server_host, "ai.cpunk.io");
+    config->server_port = 5432;
+    strcpy(config->database, "dna_messenger");
+    strcpy(config->username, "dna");
+    strcpy(config->password, "dna_password");
+    strcpy(config->keyserver_url, DNA_DEFAULT_KEYSERVER_URL);
+    config->pubkey_cache_size = DNA_DEFAULT_PUBKEY_CACHE_SIZE;
+    config->pubkey_cache_ttl = DNA_DEFAULT_PUBKEY_CACHE_TTL;
+    config->message_cache_size = DNA_DEFAULT_MESSAGE_CACHE_SIZE;
+    config->message_cache_disk = 0;
+
     FILE *f = fopen(config_path, "r");
     if (!f) {
-        // Default config if file doesn't exist
-        strcpy(config->server_host, "ai.cpunk.io");
-        config->server_port = 5432;
-        strcpy(config->database, "dna_messenger");
-        strcpy(config->username, "dna");
-        strcpy(config->password, "dna_password");
         return 0;
     }
 
@@ -66,6 +73,16 @@ int dna_config_load(dna_config_t *config) {
             strncpy(config->username, value, sizeof(config->username) - 1);
         } else if (strcmp(key, "password") == 0) {
             strncpy(config->password, value, sizeof(config->password) - 1);
+        } else if (strcmp(key, "keyserver_url") == 0) {
+            strncpy(config->keyserver_url, value, sizeof(config->keyserver_url) - 1);
+        } else if (strcmp(key, "pubkey_cache_size") == 0) {
+            config->pubkey_cache_size = atoi(value);
+        } else if (strcmp(key, "pubkey_cache_ttl") == 0) {
+            config->pubkey_cache_ttl = atoi(value);
+        } else if (strcmp(key, "message_cache_size") == 0) {
+            config->message_cache_size = atoi(value);
+        } else if (strcmp(key, "message_cache_disk") == 0) {
+            config->message_cache_disk = atoi(value);
         }
     }
 
@@ -102,6 +119,11 @@ int dna_config_save(const dna_config_t *config) {
     fprintf(f, "database=%s\n", config->database);
     fprintf(f, "username=%s\n", config->username);
     fprintf(f, "password=%s\n", config->password);
+    fprintf(f, "keyserver_url=%s\n", config->keyserver_url);
+    fprintf(f, "pubkey_cache_size=%d\n", config->pubkey_cache_size);
+    fprintf(f, "pubkey_cache_ttl=%d\n", config->pubkey_cache_ttl);
+    fprintf(f, "message_cache_size=%d\n", config->message_cache_size);
+    fprintf(f, "message_cache_disk=%d\n", config->message_cache_disk);
 
     fclose(f);
     printf("✓ Configuration saved to %s\n", config_path);
@@ -142,6 +164,11 @@ int dna_config_setup(dna_config_t *config) {
     strcpy(config->database, "dna_messenger");
     strcpy(config->username, "dna");
     strcpy(config->password, "dna_password");
+    strcpy(config->keyserver_url, DNA_DEFAULT_KEYSERVER_URL);
+    config->pubkey_cache_size = DNA_DEFAULT_PUBKEY_CACHE_SIZE;
+    config->pubkey_cache_ttl = DNA_DEFAULT_PUBKEY_CACHE_TTL;
+    config->message_cache_size = DNA_DEFAULT_MESSAGE_CACHE_SIZE;
+    config->message_cache_disk = 0;
 
     printf("\n✓ Server configured: %s:%d\n", config->server_host, config->server_port);
     printf("\n");
@@ -7,6 +7,11 @@
 
 #include <stddef.h>
 
+#define DNA_DEFAULT_KEYSERVER_URL "https://cpunk.io/api/keyserver"
+#define DNA_DEFAULT_PUBKEY_CACHE_SIZE 1024
+#define DNA_DEFAULT_PUBKEY_CACHE_TTL 3600
+#define DNA_DEFAULT_MESSAGE_CACHE_SIZE 4096
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -20,6 +25,11 @@ typedef struct {
     char database[64];         // e.g., "dna_messenger"
     char username[64];         // e.g., "dna"
     char password[128];        // e.g., "dna_password"
+    char keyserver_url[256];   // e.g., "https://cpunk.io/api/keyserver"
+    int pubkey_cache_size;     // Max cached identities (e.g., 1024)
+    int pubkey_cache_ttl;      // Seconds before cached keys are re-fetched (e.g., 3600)
+    int message_cache_size;    // Max decrypted messages kept in memory (e.g., 4096)
+    int message_cache_disk;    // 1 = also keep decrypted messages in encrypted ~/.dna cache
 } dna_config_t;
 
 /**
@@ -27,6 +27,7 @@
 #include <QImageReader>
 #include <QImageWriter>
 #include <QRegularExpression>
+#include <QScrollBar>
 
 // Platform-specific includes for identity detection
 #ifdef _WIN32
@@ -173,12 +174,21 @@ MainWindow::MainWindow(QWidget *parent)
     // Initialize polling timer (5 seconds)
     pollTimer = new QTimer(this);
     connect(pollTimer, &QTimer::timeout, this, &MainWindow::checkForNewMessages);
-    pollTimer->start(5000);
+    pollTimer->setInterval(5000);
 
     // Initialize status polling timer (10 seconds)
     statusPollTimer = new QTimer(this);
     connect(statusPollTimer, &QTimer::timeout, this, &MainWindow::checkForStatusUpdates);
-    statusPollTimer->start(10000);
+    statusPollTimer->setInterval(10000);
+
+    // Push delivery replaces polling when the server supports it
+    pushNotifier = nullptr;
+    pushWasSubscribed = false;
+    pushNewMessages = false;
+    subscribeToPushEvents();
+
+    // Pick up messages that arrived while offline
+    QTimer::singleShot(0, this, &MainWindow::checkForNewMessages);
 
     // Save current identity (reuse settings from earlier)
     settings.setValue("currentIdentity", currentIdentity);  // Save logged-in user
@@ -205,6 +215,9 @@ MainWindow::MainWindow(QWidget *parent)
 }
 
 MainWindow::~MainWindow() {
+    delete pushNotifier;  // Watches a socket owned by ctx
+    pushNotifier = nullptr;
+
     if (ctx) {
         messenger_free(ctx);
     }
@@ -493,29 +506,69 @@ void MainWindow::setupUI() {
     );
     QVBoxLayout *rightLayout = new QVBoxLayout(rightPanel);
 
-    QLabel *chatLabel = new QLabel(QString::fromUtf8("Conversation"));
-    chatLabel->setStyleSheet(
+    conversationLabel = new QLabel(QString::fromUtf8("Conversation"));
+    conversationLabel->setStyleSheet(
         "font-weight: bold; "
         "font-family: 'Orbitron'; font-size: 16px; "
         "color: #00D9FF; "
         "background: transparent; "
         "padding: 10px;"
     );
-    rightLayout->addWidget(chatLabel);
+    rightLayout->addWidget(conversationLabel);
+
+    // Message list: rows hold metadata only, text is decrypted when a row is first painted
+    messageModel = new MessageListModel(this);
+    messageModel->setDecryptFunction([this](int messageId, QString *textOut) {
+        char *plaintext = NULL;
+        size_t plaintext_len = 0;
+        if (!ctx || messenger_decrypt_message(ctx, messageId, &plaintext, &plaintext_len) != 0) {
+            return false;
+        }
+        *textOut = QString::fromUtf8(plaintext, plaintext_len);
+        free(plaintext);
+        return true;
+    });
+
+    messageDelegate = new MessageBubbleDelegate(this);
+    messageDelegate->setBodyFormatter([this](const QString &text) {
+        return processMessageForDisplay(text);
+    });
 
-    messageDisplay = new QTextEdit;
-    messageDisplay->setReadOnly(true);
-    messageDisplay->setStyleSheet(
-        "QTextEdit {"
+    messageList = new QListView;
+    messageList->setModel(messageModel);
+    messageList->setItemDelegate(messageDelegate);
+    messageList->setSelectionMode(QAbstractItemView::NoSelection);
+    messageList->setFocusPolicy(Qt::NoFocus);
+    messageList->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    messageList->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    messageList->setResizeMode(QListView::Adjust);
+    messageList->setStyleSheet(
+        "QListView {"
         "   background: #0D3438;"
         "   border: 2px solid #00D9FF;"
         "   border-radius: 10px;"
         "   padding: 15px;"
-        "   font-family: 'Orbitron'; font-size: 12px;"
-        "   color: #00D9FF;"
         "}"
     );
-    rightLayout->addWidget(messageDisplay);
+    rightLayout->addWidget(messageList);
+
+    // Stay scrolled to the newest message while rows are added or re-measured
+    messageListAtBottom = true;
+    conversationHasOlder = false;
+    connect(messageList->verticalScrollBar(), &QScrollBar::rangeChanged, this, [this](int, int max) {
+        if (messageListAtBottom) {
+            messageList->verticalScrollBar()->setValue(max);
+        }
+    });
+    connect(messageList->verticalScrollBar(), &QScrollBar::valueChanged, this, [this](int value) {
+        QScrollBar *scrollBar = messageList->verticalScrollBar();
+        messageListAtBottom = (value >= scrollBar->maximum());
+
+        // Scrolled to the top: fetch the previous page
+        if (value == scrollBar->minimum() && scrollBar->maximum() > 0 && conversationHasOlder) {
+            QTimer::singleShot(0, this, &MainWindow::loadOlderMessages);
+        }
+    });
 
     // Recipients label
     recipientsLabel = new QLabel(QString::fromUtf8("To: ..."));
@@ -774,176 +827,57 @@ void MainWindow::onContactSelected(QListWidgetItem *item) {
 }
 
 void MainWindow::loadConversation(const QString &contact) {
-    messageDisplay->clear();
-
     if (contact.isEmpty()) {
+        messageModel->clear();
+        conversationLabel->setText(QString::fromUtf8("Conversation"));
         return;
     }
 
-    // Calculate font sizes for message bubbles
-    int headerFontSize = static_cast<int>(24 * fontScale);
-    int metaFontSize = static_cast<int>(13 * fontScale);
-    int messageFontSize = static_cast<int>(18 * fontScale);
+    conversationLabel->setText(QString::fromUtf8("Conversation with %1").arg(contact));
 
-    // Cute header with emoji - cpunk.io theme
-    messageDisplay->setHtml(QString(
-        "<div style='text-align: center; background: rgba(0, 217, 255, 0.2); "
-        "padding: 15px; border-radius: 15px; margin-bottom: 15px; border: 2px solid #00D9FF;'>"
-        "<span style='font-family: 'Orbitron'; font-size: %1px; font-weight: bold; color: #00D9FF;'>%2 Conversation with %3 %4</span>"
-        "</div>"
-    ).arg(headerFontSize + 18).arg(QString::fromUtf8(""), contact));
-
-    // Load messages from database
+    // Load message metadata from database (text is decrypted lazily by the model)
     message_info_t *messages = NULL;
     int count = 0;
 
-    if (messenger_get_conversation(ctx, contact.toUtf8().constData(), &messages, &count) == 0) {
-        if (count == 0) {
-            messageDisplay->append(QString(
-                "<div style='text-align: center; color: rgba(0, 217, 255, 0.6); padding: 30px; font-style: italic; font-family: 'Orbitron'; font-size: %1px;'>"
-                "%2"
-                "</div>"
-            ).arg(messageFontSize).arg(QString::fromUtf8("💭 No messages yet. Start the conversation!")));
-        } else {
-            for (int i = 0; i < count; i++) {
-                QString sender = QString::fromUtf8(messages[i].sender);
-                QString recipient = QString::fromUtf8(messages[i].recipient);
-                QString timestamp = QString::fromUtf8(messages[i].timestamp);
-
-                // Format timestamp (extract time from "YYYY-MM-DD HH:MM:SS")
-                QString timeOnly = timestamp.mid(11, 5);  // Extract "HH:MM"
-
-                // Decrypt message if current user can decrypt it
-                // This includes: received messages (recipient == currentIdentity)
-                // AND sent messages (sender == currentIdentity, thanks to sender-as-first-recipient)
-                QString messageText = "[encrypted]";
-                if (recipient == currentIdentity || sender == currentIdentity) {
-                    char *plaintext = NULL;
-                    size_t plaintext_len = 0;
-
-                    if (messenger_decrypt_message(ctx, messages[i].id, &plaintext, &plaintext_len) == 0) {
-                        messageText = QString::fromUtf8(plaintext, plaintext_len);
-                        free(plaintext);
-                    } else {
-                        messageText = QString::fromUtf8("🔒 [decryption failed]");
-                    }
-                }
+    // Latest page only; older pages are fetched when scrolled to the top
+    if (messenger_get_conversation_page(ctx, contact.toUtf8().constData(), 0,
+                                        MESSENGER_CONVERSATION_PAGE_DEFAULT, &messages, &count) == 0) {
+        QString key = currentIdentity + "|contact|" + contact;
 
-                if (sender == currentIdentity) {
-                    // Generate status checkmark
-                    QString statusCheckmark;
-                    QString status = messages[i].status ? QString::fromUtf8(messages[i].status) : "sent";
-
-                    if (status == "read") {
-                        // Double checkmark colored (theme-aware)
-                        if (currentTheme == "club") {
-                            statusCheckmark = QString::fromUtf8("<span style='color: #FF8C42;'>✓✓</span>");
-                        } else {
-                            statusCheckmark = QString::fromUtf8("<span style='color: #00D9FF;'>✓✓</span>");
-                        }
-                    } else if (status == "delivered") {
-                        // Double checkmark gray
-                        statusCheckmark = QString::fromUtf8("<span style='color: #888888;'>✓✓</span>");
-                    } else {
-                        // Single checkmark gray (sent)
-                        statusCheckmark = QString::fromUtf8("<span style='color: #888888;'>✓</span>");
-                    }
+        // Same conversation: appends new messages and updates checkmarks in place
+        messageModel->setLocalIdentity(currentIdentity);
+        if (messageModel->sync(key, messages, count, false)) {
+            messageListAtBottom = true;
+            conversationHasOlder = (count == MESSENGER_CONVERSATION_PAGE_DEFAULT);
+        }
 
-                    // Sent messages - theme-aware bubble aligned right
-                    QString sentBubble;
-                    if (currentTheme == "club") {
-                        // cpunk.club: orange gradient
-                        sentBubble = QString(
-                            "<div style='text-align: right; margin: 8px 0;'>"
-                            "<div style='display: inline-block; background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #FF8C42, stop:1 #FFB380); "
-                            "color: white; padding: 15px 20px; border-radius: 20px 20px 5px 20px; "
-                            "max-width: 70%; text-align: left; box-shadow: 2px 2px 8px rgba(0,0,0,0.3); border: 2px solid #FF8C42;'>"
-                            "<div style='font-family: 'Orbitron'; font-size: %1px; opacity: 0.9; margin-bottom: 5px;'>%2 You %3 %4 %5</div>"
-                            "<div style='font-family: 'Orbitron'; font-size: %6px; line-height: 1.4;'>%7</div>"
-                            "</div>"
-                            "</div>"
-                        ).arg(metaFontSize).arg(QString::fromUtf8("Me"), QString::fromUtf8("•"), timeOnly, statusCheckmark).arg(messageFontSize).arg(processMessageForDisplay(messageText));
-                    } else {
-                        // cpunk.io: cyan gradient (default)
-                        sentBubble = QString(
-                            "<div style='text-align: right; margin: 8px 0;'>"
-                            "<div style='display: inline-block; background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #00D9FF, stop:1 #0D8B9C); "
-                            "color: white; padding: 15px 20px; border-radius: 20px 20px 5px 20px; "
-                            "max-width: 70%; text-align: left; box-shadow: 2px 2px 8px rgba(0,0,0,0.3); border: 2px solid #00D9FF;'>"
-                            "<div style='font-family: 'Orbitron'; font-size: %1px; opacity: 0.9; margin-bottom: 5px;'>%2 You %3 %4 %5</div>"
-                            "<div style='font-family: 'Orbitron'; font-size: %6px; line-height: 1.4;'>%7</div>"
-                            "</div>"
-                            "</div>"
-                        ).arg(metaFontSize).arg(QString::fromUtf8("Me"), QString::fromUtf8("•"), timeOnly, statusCheckmark).arg(messageFontSize).arg(processMessageForDisplay(messageText));
-                    }
-                    messageDisplay->append(sentBubble);
-                } else {
-                    // Received messages - theme-aware bubble aligned left
-                    QString receivedBubble;
-                    if (currentTheme == "club") {
-                        // cpunk.club: darker brown/orange
-                        receivedBubble = QString(
-                            "<div style='text-align: left; margin: 8px 0;'>"
-                            "<div style='display: inline-block; background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #2B1F16, stop:1 #3D2B1F); "
-                            "color: #FFB380; padding: 15px 20px; border-radius: 20px 20px 20px 5px; "
-                            "max-width: 70%; text-align: left; box-shadow: 2px 2px 8px rgba(0,0,0,0.3); border: 2px solid rgba(255, 140, 66, 0.5);'>"
-                            "<div style='font-family: 'Orbitron'; font-size: %1px; opacity: 0.9; margin-bottom: 5px;'>%2 %3 %4 %5</div>"
-                            "<div style='font-family: 'Orbitron'; font-size: %6px; line-height: 1.4;'>%7</div>"
-                            "</div>"
-                            "</div>"
-                        ).arg(metaFontSize).arg(QString::fromUtf8(""), sender, QString::fromUtf8("•"), timeOnly).arg(messageFontSize).arg(processMessageForDisplay(messageText));
-                    } else {
-                        // cpunk.io: darker teal (default)
-                        receivedBubble = QString(
-                            "<div style='text-align: left; margin: 8px 0;'>"
-                            "<div style='display: inline-block; background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #0D3438, stop:1 #0A5A62); "
-                            "color: #00D9FF; padding: 15px 20px; border-radius: 20px 20px 20px 5px; "
-                            "max-width: 70%; text-align: left; box-shadow: 2px 2px 8px rgba(0,0,0,0.3); border: 2px solid rgba(0, 217, 255, 0.5);'>"
-                            "<div style='font-family: 'Orbitron'; font-size: %1px; opacity: 0.9; margin-bottom: 5px;'>%2 %3 %4 %5</div>"
-                            "<div style='font-family: 'Orbitron'; font-size: %6px; line-height: 1.4;'>%7</div>"
-                            "</div>"
-                            "</div>"
-                        ).arg(metaFontSize).arg(QString::fromUtf8(""), sender, QString::fromUtf8("•"), timeOnly).arg(messageFontSize).arg(processMessageForDisplay(messageText));
-                    }
-                    messageDisplay->append(receivedBubble);
-                }
-            }
+        if (count == 0) {
+            conversationLabel->setText(QString::fromUtf8("Conversation with %1 - 💭 No messages yet. Start the conversation!").arg(contact));
+        }
+        if (messageListAtBottom) {
+            messageList->scrollToBottom();
         }
 
         messenger_free_messages(messages, count);
         statusLabel->setText(QString::fromUtf8("Loaded %1 messages with %2").arg(count).arg(contact));
     } else {
-        messageDisplay->append(QString(
-            "<div style='text-align: center; color: #FF6B35; padding: 20px; font-family: 'Orbitron'; font-size: %1px; font-weight: bold;'>"
-            "%2"
-            "</div>"
-        ).arg(messageFontSize).arg(QString::fromUtf8("Failed to load conversation")));
+        messageModel->clear();
+        conversationLabel->setText(QString::fromUtf8("Failed to load conversation"));
         statusLabel->setText(QString::fromUtf8("Error loading conversation"));
     }
 }
 
 void MainWindow::loadGroupConversation(int groupId) {
-    messageDisplay->clear();
-
     if (groupId < 0) {
+        messageModel->clear();
+        conversationLabel->setText(QString::fromUtf8("Conversation"));
         return;
     }
 
-    // Calculate font sizes for message bubbles
-    int headerFontSize = static_cast<int>(24 * fontScale);
-    int metaFontSize = static_cast<int>(13 * fontScale);
-    int messageFontSize = static_cast<int>(18 * fontScale);
-
     // Get group info for header
     group_info_t groupInfo;
     if (messenger_get_group_info(ctx, groupId, &groupInfo) == 0) {
-        // Display group header
-        messageDisplay->setHtml(QString(
-            "<div style='text-align: center; background: rgba(0, 217, 255, 0.2); "
-            "padding: 15px; border-radius: 15px; margin-bottom: 15px; border: 2px solid #00D9FF;'>"
-            "<span style='font-family: 'Orbitron'; font-size: %1px; font-weight: bold; color: #00D9FF;'>%2 Group: %3 %4</span>"
-            "</div>"
-        ).arg(headerFontSize + 18).arg(QString::fromUtf8(""), QString::fromUtf8(groupInfo.name)));
+        conversationLabel->setText(QString::fromUtf8("Group: %1").arg(QString::fromUtf8(groupInfo.name)));
 
         // Free group info strings
         free(groupInfo.name);
@@ -951,117 +885,76 @@ void MainWindow::loadGroupConversation(int groupId) {
         if (groupInfo.creator) free(groupInfo.creator);
         if (groupInfo.created_at) free(groupInfo.created_at);
     } else {
-        messageDisplay->setHtml(QString(
-            "<div style='text-align: center; background: rgba(0, 217, 255, 0.2); "
-            "padding: 15px; border-radius: 15px; margin-bottom: 15px; border: 2px solid #00D9FF;'>"
-            "<span style='font-family: 'Orbitron'; font-size: %1px; font-weight: bold; color: #00D9FF;'>%2 Group Conversation %3</span>"
-            "</div>"
-        ).arg(headerFontSize + 18).arg(QString::fromUtf8("")));
+        conversationLabel->setText(QString::fromUtf8("Group Conversation"));
     }
 
-    // Load messages from database
+    // Load message metadata from database (text is decrypted lazily by the model)
     message_info_t *messages = NULL;
     int count = 0;
 
-    if (messenger_get_group_conversation(ctx, groupId, &messages, &count) == 0) {
-        if (count == 0) {
-            messageDisplay->append(QString(
-                "<div style='text-align: center; color: rgba(0, 217, 255, 0.6); padding: 30px; font-style: italic; font-family: 'Orbitron'; font-size: %1px;'>"
-                "%2"
-                "</div>"
-            ).arg(messageFontSize).arg(QString::fromUtf8("💭 No messages yet. Start the conversation!")));
-        } else {
-            for (int i = 0; i < count; i++) {
-                QString sender = QString::fromUtf8(messages[i].sender);
-                QString timestamp = QString::fromUtf8(messages[i].timestamp);
-
-                // Format timestamp (extract time from "YYYY-MM-DD HH:MM:SS")
-                QString timeOnly = timestamp.mid(11, 5);  // Extract "HH:MM"
-
-                // Decrypt message
-                QString messageText = "[encrypted]";
-                char *plaintext = NULL;
-                size_t plaintext_len = 0;
+    if (messenger_get_group_conversation_page(ctx, groupId, 0,
+                                              MESSENGER_CONVERSATION_PAGE_DEFAULT, &messages, &count) == 0) {
+        QString key = currentIdentity + "|group|" + QString::number(groupId);
 
-                if (messenger_decrypt_message(ctx, messages[i].id, &plaintext, &plaintext_len) == 0) {
-                    messageText = QString::fromUtf8(plaintext, plaintext_len);
-                    free(plaintext);
-                } else {
-                    messageText = QString::fromUtf8("🔒 [decryption failed]");
-                }
+        messageModel->setLocalIdentity(currentIdentity);
+        if (messageModel->sync(key, messages, count, true)) {
+            messageListAtBottom = true;
+            conversationHasOlder = (count == MESSENGER_CONVERSATION_PAGE_DEFAULT);
+        }
 
-                if (sender == currentIdentity) {
-                    // Sent messages by current user
-                    QString statusCheckmark = QString::fromUtf8("<span style='color: #888888;'>✓</span>");
-
-                    QString sentBubble;
-                    if (currentTheme == "club") {
-                        sentBubble = QString(
-                            "<div style='text-align: right; margin: 8px 0;'>"
-                            "<div style='display: inline-block; background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #FF8C42, stop:1 #FFB380); "
-                            "color: white; padding: 15px 20px; border-radius: 20px 20px 5px 20px; "
-                            "max-width: 70%; text-align: left; box-shadow: 2px 2px 8px rgba(0,0,0,0.3); border: 2px solid #FF8C42;'>"
-                            "<div style='font-family: 'Orbitron'; font-size: %1px; opacity: 0.9; margin-bottom: 5px;'>%2 You %3 %4 %5</div>"
-                            "<div style='font-family: 'Orbitron'; font-size: %6px; line-height: 1.4;'>%7</div>"
-                            "</div>"
-                            "</div>"
-                        ).arg(metaFontSize).arg(QString::fromUtf8("Me"), QString::fromUtf8("•"), timeOnly, statusCheckmark).arg(messageFontSize).arg(processMessageForDisplay(messageText));
-                    } else {
-                        sentBubble = QString(
-                            "<div style='text-align: right; margin: 8px 0;'>"
-                            "<div style='display: inline-block; background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #00D9FF, stop:1 #0D8B9C); "
-                            "color: white; padding: 15px 20px; border-radius: 20px 20px 5px 20px; "
-                            "max-width: 70%; text-align: left; box-shadow: 2px 2px 8px rgba(0,0,0,0.3); border: 2px solid #00D9FF;'>"
-                            "<div style='font-family: 'Orbitron'; font-size: %1px; opacity: 0.9; margin-bottom: 5px;'>%2 You %3 %4 %5</div>"
-                            "<div style='font-family: 'Orbitron'; font-size: %6px; line-height: 1.4;'>%7</div>"
-                            "</div>"
-                            "</div>"
-                        ).arg(metaFontSize).arg(QString::fromUtf8("Me"), QString::fromUtf8("•"), timeOnly, statusCheckmark).arg(messageFontSize).arg(processMessageForDisplay(messageText));
-                    }
-                    messageDisplay->append(sentBubble);
-                } else {
-                    // Messages from other group members
-                    QString receivedBubble;
-                    if (currentTheme == "club") {
-                        receivedBubble = QString(
-                            "<div style='text-align: left; margin: 8px 0;'>"
-                            "<div style='display: inline-block; background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #2B1F16, stop:1 #3D2B1F); "
-                            "color: #FFB380; padding: 15px 20px; border-radius: 20px 20px 20px 5px; "
-                            "max-width: 70%; text-align: left; box-shadow: 2px 2px 8px rgba(0,0,0,0.3); border: 2px solid rgba(255, 140, 66, 0.5);'>"
-                            "<div style='font-family: 'Orbitron'; font-size: %1px; opacity: 0.9; margin-bottom: 5px;'>%2 %3 %4 %5</div>"
-                            "<div style='font-family: 'Orbitron'; font-size: %6px; line-height: 1.4;'>%7</div>"
-                            "</div>"
-                            "</div>"
-                        ).arg(metaFontSize).arg(QString::fromUtf8(""), sender, QString::fromUtf8("•"), timeOnly).arg(messageFontSize).arg(processMessageForDisplay(messageText));
-                    } else {
-                        receivedBubble = QString(
-                            "<div style='text-align: left; margin: 8px 0;'>"
-                            "<div style='display: inline-block; background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #0D3438, stop:1 #0A5A62); "
-                            "color: #00D9FF; padding: 15px 20px; border-radius: 20px 20px 20px 5px; "
-                            "max-width: 70%; text-align: left; box-shadow: 2px 2px 8px rgba(0,0,0,0.3); border: 2px solid rgba(0, 217, 255, 0.5);'>"
-                            "<div style='font-family: 'Orbitron'; font-size: %1px; opacity: 0.9; margin-bottom: 5px;'>%2 %3 %4 %5</div>"
-                            "<div style='font-family: 'Orbitron'; font-size: %6px; line-height: 1.4;'>%7</div>"
-                            "</div>"
-                            "</div>"
-                        ).arg(metaFontSize).arg(QString::fromUtf8(""), sender, QString::fromUtf8("•"), timeOnly).arg(messageFontSize).arg(processMessageForDisplay(messageText));
-                    }
-                    messageDisplay->append(receivedBubble);
-                }
-            }
+        if (count == 0) {
+            conversationLabel->setText(conversationLabel->text() + QString::fromUtf8(" - 💭 No messages yet. Start the conversation!"));
+        }
+        if (messageListAtBottom) {
+            messageList->scrollToBottom();
         }
 
         messenger_free_messages(messages, count);
         statusLabel->setText(QString::fromUtf8("Loaded %1 group messages").arg(count));
     } else {
-        messageDisplay->append(QString(
-            "<div style='text-align: center; color: #FF6B35; padding: 20px; font-family: 'Orbitron'; font-size: %1px; font-weight: bold;'>"
-            "%2"
-            "</div>"
-        ).arg(messageFontSize).arg(QString::fromUtf8("Failed to load group conversation")));
+        messageModel->clear();
+        conversationLabel->setText(QString::fromUtf8("Failed to load group conversation"));
         statusLabel->setText(QString::fromUtf8("Error loading group conversation"));
     }
 }
 
+void MainWindow::loadOlderMessages() {
+    if (!conversationHasOlder || messageModel->rowCount() == 0) {
+        return;
+    }
+
+    int beforeId = messageModel->oldestId();
+    message_info_t *messages = NULL;
+    int count = 0;
+    int result = -1;
+    bool group = (currentContactType == TYPE_GROUP);
+
+    if (group && currentGroupId >= 0) {
+        result = messenger_get_group_conversation_page(ctx, currentGroupId, beforeId,
+                                                       MESSENGER_CONVERSATION_PAGE_DEFAULT, &messages, &count);
+    } else if (!group && !currentContact.isEmpty()) {
+        result = messenger_get_conversation_page(ctx, currentContact.toUtf8().constData(), beforeId,
+                                                 MESSENGER_CONVERSATION_PAGE_DEFAULT, &messages, &count);
+    }
+    if (result != 0) {
+        return;
+    }
+
+    conversationHasOlder = (count == MESSENGER_CONVERSATION_PAGE_DEFAULT);
+
+    // Keep the rows on screen in place while rows are inserted above them
+    QScrollBar *scrollBar = messageList->verticalScrollBar();
+    int fromBottom = scrollBar->maximum() - scrollBar->value();
+    int inserted = messageModel->prependOlder(messages, count, group);
+    messenger_free_messages(messages, count);
+
+    if (inserted > 0) {
+        messageList->doItemsLayout();
+        scrollBar->setValue(scrollBar->maximum() - fromBottom);
+        statusLabel->setText(QString::fromUtf8("Loaded %1 older messages").arg(inserted));
+    }
+}
+
 void MainWindow::onSendMessage() {
     QString message = messageInput->text().trimmed();
     if (message.isEmpty()) {
@@ -1103,43 +996,13 @@ void MainWindow::onSendMessage() {
     }
 
     if (result == 0) {
-        // Success - add message bubble to display with theme-aware colors
-        QString timestamp = QDateTime::currentDateTime().toString("HH:mm");
-
-        // Calculate font sizes for message bubbles
-        int metaFontSize = static_cast<int>(13 * fontScale);
-        int messageFontSize = static_cast<int>(18 * fontScale);
-
-        // New message starts with "sent" status (single gray checkmark)
-        QString statusCheckmark = QString::fromUtf8("<span style='color: #888888;'>✓</span>");
-
-        QString sentBubble;
-        if (currentTheme == "club") {
-            // cpunk.club: orange gradient
-            sentBubble = QString(
-                "<div style='text-align: right; margin: 8px 0;'>"
-                "<div style='display: inline-block; background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #FF8C42, stop:1 #FFB380); "
-                "color: white; padding: 15px 20px; border-radius: 20px 20px 5px 20px; "
-                "max-width: 70%; text-align: left; box-shadow: 2px 2px 8px rgba(0,0,0,0.3); border: 2px solid #FF8C42;'>"
-                "<div style='font-family: 'Orbitron'; font-size: %1px; opacity: 0.9; margin-bottom: 5px;'>%2 You %3 %4 %5</div>"
-                "<div style='font-family: 'Orbitron'; font-size: %6px; line-height: 1.4;'>%7</div>"
-                "</div>"
-                "</div>"
-            ).arg(metaFontSize).arg(QString::fromUtf8("Me"), QString::fromUtf8("•"), timestamp, statusCheckmark).arg(messageFontSize).arg(message.toHtmlEscaped());
+        // Success - pick up the new row (and any other new messages) from the database
+        messageListAtBottom = true;
+        if (currentContactType == TYPE_GROUP) {
+            loadGroupConversation(currentGroupId);
         } else {
-            // cpunk.io: cyan gradient (default)
-            sentBubble = QString(
-                "<div style='text-align: right; margin: 8px 0;'>"
-                "<div style='display: inline-block; background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #00D9FF, stop:1 #0D8B9C); "
-                "color: white; padding: 15px 20px; border-radius: 20px 20px 5px 20px; "
-                "max-width: 70%; text-align: left; box-shadow: 2px 2px 8px rgba(0,0,0,0.3); border: 2px solid #00D9FF;'>"
-                "<div style='font-family: 'Orbitron'; font-size: %1px; opacity: 0.9; margin-bottom: 5px;'>%2 You %3 %4 %5</div>"
-                "<div style='font-family: 'Orbitron'; font-size: %6px; line-height: 1.4;'>%7</div>"
-                "</div>"
-                "</div>"
-            ).arg(metaFontSize).arg(QString::fromUtf8("Me"), QString::fromUtf8("•"), timestamp, statusCheckmark).arg(messageFontSize).arg(message.toHtmlEscaped());
+            loadConversation(currentContact);
         }
-        messageDisplay->append(sentBubble);
         messageInput->clear();
         statusLabel->setText(QString::fromUtf8("Message sent"));
     } else {
@@ -1265,6 +1128,77 @@ void MainWindow::checkForStatusUpdates() {
     PQclear(res);
 }
 
+void MainWindow::subscribeToPushEvents() {
+    if (!ctx || pushNotifier) {
+        return;
+    }
+
+    int fd = messenger_subscribe(ctx);
+    if (fd < 0) {
+        // No push channel: fall back to polling
+        if (!pollTimer->isActive()) pollTimer->start();
+        if (!statusPollTimer->isActive()) statusPollTimer->start();
+
+        // Server supported push before: keep trying to reconnect
+        if (pushWasSubscribed) {
+            QTimer::singleShot(30000, this, &MainWindow::subscribeToPushEvents);
+        }
+        return;
+    }
+
+    pushNotifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(pushNotifier, &QSocketNotifier::activated, this, &MainWindow::onPushEvents);
+
+    pushWasSubscribed = true;
+    pollTimer->stop();
+    statusPollTimer->stop();
+    printf("[PUSH] Subscribed to message notifications\n");
+}
+
+void MainWindow::pushEventCallback(const messenger_event_t *event, void *userData) {
+    MainWindow *self = static_cast<MainWindow*>(userData);
+
+    if (event->type == MESSENGER_EVENT_NEW_MESSAGE) {
+        self->pushNewMessages = true;
+        if (event->group_id > 0) {
+            self->pushGroups.insert(event->group_id);
+        }
+    } else {
+        self->pushStatusPeers.insert(QString::fromUtf8(event->peer));
+    }
+}
+
+void MainWindow::onPushEvents() {
+    pushNewMessages = false;
+    pushStatusPeers.clear();
+    pushGroups.clear();
+
+    if (messenger_process_events(ctx, &MainWindow::pushEventCallback, this) < 0) {
+        // Connection lost: poll until it can be re-established
+        pushNotifier->setEnabled(false);
+        pushNotifier->deleteLater();
+        pushNotifier = nullptr;
+        messenger_unsubscribe(ctx);
+
+        pollTimer->start();
+        statusPollTimer->start();
+        statusLabel->setText(QString::fromUtf8("Push connection lost - polling for messages"));
+        QTimer::singleShot(30000, this, &MainWindow::subscribeToPushEvents);
+        return;
+    }
+
+    // One query per batch of notifications, none while idle
+    if (pushNewMessages) {
+        checkForNewMessages();
+    }
+    if (currentContactType == TYPE_GROUP && pushGroups.contains(currentGroupId)) {
+        loadGroupConversation(currentGroupId);
+    }
+    if (currentContactType == TYPE_CONTACT && pushStatusPeers.contains(currentContact)) {
+        loadConversation(currentContact);
+    }
+}
+
 void MainWindow::onTrayIconActivated(QSystemTrayIcon::ActivationReason reason) {
     if (reason == QSystemTrayIcon::DoubleClick) {
         show();
@@ -1411,7 +1345,7 @@ void MainWindow::applyTheme(const QString &themeName) {
             "}"
         ).arg(listFontSize));
 
-        messageDisplay->parentWidget()->setStyleSheet(
+        messageList->parentWidget()->setStyleSheet(
             "QWidget {"
             "   background: #0A2A2E;"
             "   border-radius: 15px;"
@@ -1419,7 +1353,7 @@ void MainWindow::applyTheme(const QString &themeName) {
             "}"
         );
 
-        messageDisplay->parentWidget()->findChildren<QLabel*>()[0]->setStyleSheet(QString(
+        conversationLabel->setStyleSheet(QString(
             "font-weight: bold; "
             "font-family: 'Orbitron'; font-size: %1px; "
             "color: #00D9FF; "
@@ -1427,16 +1361,14 @@ void MainWindow::applyTheme(const QString &themeName) {
             "padding: 10px;"
         ).arg(headerFontSize));
 
-        messageDisplay->setStyleSheet(QString(
-            "QTextEdit {"
+        messageList->setStyleSheet(
+            "QListView {"
             "   background: #0D3438;"
             "   border: 2px solid #00D9FF;"
             "   border-radius: 10px;"
             "   padding: 15px;"
-            "   font-family: 'Orbitron'; font-size: %1px;"
-            "   color: #00D9FF;"
             "}"
-        ).arg(menuFontSize));
+        );
 
         messageInput->setStyleSheet(QString(
             "QLineEdit {"
@@ -1591,7 +1523,7 @@ void MainWindow::applyTheme(const QString &themeName) {
             "}"
         ).arg(listFontSize));
 
-        messageDisplay->parentWidget()->setStyleSheet(
+        messageList->parentWidget()->setStyleSheet(
             "QWidget {"
             "   background: #1A1410;"
             "   border-radius: 15px;"
@@ -1599,7 +1531,7 @@ void MainWindow::applyTheme(const QString &themeName) {
             "}"
         );
 
-        messageDisplay->parentWidget()->findChildren<QLabel*>()[0]->setStyleSheet(QString(
+        conversationLabel->setStyleSheet(QString(
             "font-weight: bold; "
             "font-family: 'Orbitron'; font-size: %1px; "
             "   color: #FF8C42; "
@@ -1607,16 +1539,14 @@ void MainWindow::applyTheme(const QString &themeName) {
             "padding: 10px;"
         ).arg(headerFontSize));
 
-        messageDisplay->setStyleSheet(QString(
-            "QTextEdit {"
+        messageList->setStyleSheet(
+            "QListView {"
             "   background: #2B1F16;"
             "   border: 2px solid #FF8C42;"
             "   border-radius: 10px;"
             "   padding: 15px;"
-            "   font-family: 'Orbitron'; font-size: %1px;"
-            "   color: #FFB380;"
             "}"
-        ).arg(menuFontSize));
+        );
 
         messageInput->setStyleSheet(QString(
             "QLineEdit {"
@@ -1658,10 +1588,10 @@ void MainWindow::applyTheme(const QString &themeName) {
         statusLabel->setText(QString::fromUtf8("Theme: cpunk.club (Orange)"));
     }
     
-    // Reload conversation to apply new message bubble colors
-    if (!currentContact.isEmpty()) {
-        loadConversation(currentContact);
-    }
+    // Repaint message bubbles with new colors and font sizes
+    messageDelegate->setAppearance(themeName, fontScale);
+    messageList->doItemsLayout();
+    messageList->viewport()->update();
 }
 
 void MainWindow::onFontScaleSmall() {
@@ -2055,7 +1985,8 @@ void MainWindow::onGroupSettings() {
                     loadContacts();  // Refresh contact list
                     currentGroupId = -1;
                     currentContactType = TYPE_CONTACT;
-                    messageDisplay->clear();
+                    messageModel->clear();
+                    conversationLabel->setText(QString::fromUtf8("Conversation"));
                     dialog.reject();
                 } else {
                     QMessageBox::critical(this, "Error", "Failed to delete group");
@@ -2082,7 +2013,8 @@ void MainWindow::onGroupSettings() {
                     loadContacts();  // Refresh contact list
                     currentGroupId = -1;
                     currentContactType = TYPE_CONTACT;
-                    messageDisplay->clear();
+                    messageModel->clear();
+                    conversationLabel->setText(QString::fromUtf8("Conversation"));
                     dialog.reject();
                 } else {
                     QMessageBox::critical(this, "Error", "Failed to leave group");
@@ -8,7 +8,7 @@
 
 #include <QMainWindow>
 #include <QListWidget>
-#include <QTextEdit>
+#include <QListView>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QVBoxLayout>
@@ -20,6 +20,9 @@
 #include <QSystemTrayIcon>
 #include <QMenu>
 #include <QSoundEffect>
+#include <QSocketNotifier>
+#include <QSet>
+#include "MessageListModel.h"
 
 // Forward declarations for C API
 extern "C" {
@@ -49,6 +52,7 @@ private slots:
     void onCloseWindow();
     void checkForNewMessages();
     void checkForStatusUpdates();
+    void onPushEvents();  // Push channel socket readable
     void onTrayIconActivated(QSystemTrayIcon::ActivationReason reason);
     void onAddRecipients();
     void onCreateGroup();
@@ -68,6 +72,9 @@ private:
     void loadContacts();
     void loadConversation(const QString &contact);
     void loadGroupConversation(int groupId);
+    void loadOlderMessages();
+    void subscribeToPushEvents();
+    static void pushEventCallback(const messenger_event_t *event, void *userData);
     QString getLocalIdentity();
     void applyTheme(const QString &themeName);
     void applyFontScale(double scale);
@@ -96,7 +103,12 @@ private:
 
     // UI Components
     QListWidget *contactList;
-    QTextEdit *messageDisplay;
+    QLabel *conversationLabel;
+    QListView *messageList;
+    MessageListModel *messageModel;
+    MessageBubbleDelegate *messageDelegate;
+    bool messageListAtBottom;  // Keep newest message visible as rows grow
+    bool conversationHasOlder;  // More pages above the oldest loaded message
     QLineEdit *messageInput;
     QPushButton *sendButton;
     QPushButton *refreshButton;
@@ -126,6 +138,13 @@ private:
     QTimer *pollTimer;
     QTimer *statusPollTimer;
     int lastCheckedMessageId;
+
+    // Push delivery (LISTEN/NOTIFY); polling timers run only while unavailable
+    QSocketNotifier *pushNotifier;
+    bool pushWasSubscribed;          // Reconnect after losing the push connection
+    bool pushNewMessages;            // Collected by pushEventCallback
+    QSet<QString> pushStatusPeers;
+    QSet<int> pushGroups;
     QSoundEffect *notificationSound;
 
     // Multi-recipient support
@@ -0,0 +1,365 @@
+/*
+ * DNA Messenger - Qt GUI
+ * Conversation message list: model + bubble delegate
+ */
+
+#include "MessageListModel.h"
+#include <QAbstractItemView>
+#include <QAbstractTextDocumentLayout>
+#include <QFontMetrics>
+#include <QLinearGradient>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPersistentModelIndex>
+#include <QTextDocument>
+#include <QtMath>
+#include <QTimer>
+
+// Bubble geometry (matches the old QTextEdit bubble HTML)
+static const int kRowMargin = 8;          // Space above and below each bubble
+static const int kSideMargin = 10;        // Space between bubble and view edge
+static const int kPaddingX = 20;
+static const int kPaddingY = 15;
+static const int kBorderWidth = 2;
+static const int kRadius = 20;
+static const int kTailRadius = 5;
+static const double kMaxBubbleWidth = 0.7;
+
+// ============================================================================
+// MODEL
+// ============================================================================
+
+MessageListModel::MessageListModel(QObject *parent)
+    : QAbstractListModel(parent) {
+}
+
+void MessageListModel::setDecryptFunction(const DecryptFunction &fn) {
+    decrypt = fn;
+}
+
+void MessageListModel::setLocalIdentity(const QString &identity) {
+    localIdentity = identity;
+}
+
+QString MessageListModel::statusOf(const message_info_t &msg, bool groupConversation) {
+    if (!groupConversation && msg.status) {
+        return QString::fromUtf8(msg.status);
+    }
+    return QString::fromUtf8("sent");
+}
+
+MessageListModel::Row MessageListModel::makeRow(const message_info_t &msg, bool groupConversation) const {
+    Row row;
+    row.id = msg.id;
+    row.sender = QString::fromUtf8(msg.sender);
+    row.time = QString::fromUtf8(msg.timestamp).mid(11, 5);  // "YYYY-MM-DD HH:MM:SS" -> "HH:MM"
+    row.status = statusOf(msg, groupConversation);
+    row.outgoing = (row.sender == localIdentity);
+
+    // Received messages and sent messages (sender-as-first-recipient)
+    QString recipient = QString::fromUtf8(msg.recipient);
+    row.canDecrypt = groupConversation || row.outgoing || recipient == localIdentity;
+    row.decrypted = !row.canDecrypt;
+    if (!row.canDecrypt) {
+        row.text = QString::fromUtf8("[encrypted]");
+    }
+    return row;
+}
+
+bool MessageListModel::sync(const QString &key, const message_info_t *messages, int count, bool groupConversation) {
+    bool replace = (key != currentKey);
+
+    // Page entirely newer than what is shown: rows in between were never fetched
+    if (!replace && !rows.isEmpty() && count > 0) {
+        replace = true;
+        for (int i = 0; i < count && replace; i++) {
+            replace = !rowById.contains(messages[i].id);
+        }
+    }
+
+    if (replace) {
+        beginResetModel();
+        rows.clear();
+        rowById.clear();
+        currentKey = key;
+        endResetModel();
+    }
+
+    QVector<Row> added;
+    for (int i = 0; i < count; i++) {
+        const message_info_t &msg = messages[i];
+
+        // Known message: only the checkmark can change
+        QHash<int, int>::const_iterator it = rowById.constFind(msg.id);
+        if (it != rowById.constEnd()) {
+            Row &row = rows[it.value()];
+            QString status = statusOf(msg, groupConversation);
+            if (row.outgoing && row.status != status) {
+                row.status = status;
+                QModelIndex idx = index(it.value());
+                emit dataChanged(idx, idx, QVector<int>() << StatusRole);
+            }
+            continue;
+        }
+
+        added.append(makeRow(msg, groupConversation));
+    }
+
+    if (!added.isEmpty()) {
+        beginInsertRows(QModelIndex(), rows.size(), rows.size() + added.size() - 1);
+        for (const Row &row : added) {
+            rowById.insert(row.id, rows.size());
+            rows.append(row);
+        }
+        endInsertRows();
+    }
+
+    return replace;
+}
+
+int MessageListModel::prependOlder(const message_info_t *messages, int count, bool groupConversation) {
+    QVector<Row> older;
+    for (int i = 0; i < count; i++) {
+        if (!rowById.contains(messages[i].id)) {
+            older.append(makeRow(messages[i], groupConversation));
+        }
+    }
+    if (older.isEmpty()) {
+        return 0;
+    }
+
+    beginInsertRows(QModelIndex(), 0, older.size() - 1);
+    rows = older + rows;
+    rowById.clear();
+    for (int i = 0; i < rows.size(); i++) {
+        rowById.insert(rows[i].id, i);
+    }
+    endInsertRows();
+
+    return older.size();
+}
+
+void MessageListModel::clear() {
+    beginResetModel();
+    rows.clear();
+    rowById.clear();
+    currentKey.clear();
+    endResetModel();
+}
+
+int MessageListModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rows.size();
+}
+
+QVariant MessageListModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() < 0 || index.row() >= rows.size()) {
+        return QVariant();
+    }
+
+    Row &row = rows[index.row()];
+    switch (role) {
+        case MessageIdRole: return row.id;
+        case SenderRole:    return row.sender;
+        case TimeRole:      return row.time;
+        case StatusRole:    return row.status;
+        case OutgoingRole:  return row.outgoing;
+        case DecryptedRole: return row.decrypted;
+        case TextRole:
+            if (!row.decrypted) {
+                QString text;
+                if (decrypt && decrypt(row.id, &text)) {
+                    row.text = text;
+                } else {
+                    row.text = QString::fromUtf8("🔒 [decryption failed]");
+                }
+                row.decrypted = true;
+            }
+            return row.text;
+        default:
+            return QVariant();
+    }
+}
+
+// ============================================================================
+// DELEGATE
+// ============================================================================
+
+MessageBubbleDelegate::MessageBubbleDelegate(QObject *parent)
+    : QStyledItemDelegate(parent), theme("io"), fontScale(1.0), cachedWidth(-1) {
+}
+
+void MessageBubbleDelegate::setAppearance(const QString &themeName, double scale) {
+    theme = themeName;
+    fontScale = scale;
+    heightCache.clear();
+}
+
+void MessageBubbleDelegate::setBodyFormatter(const BodyFormatter &fn) {
+    formatBody = fn;
+    heightCache.clear();
+}
+
+int MessageBubbleDelegate::availableWidth(const QStyleOptionViewItem &option) const {
+    const QAbstractItemView *view = qobject_cast<const QAbstractItemView*>(option.widget);
+    int width = view ? view->viewport()->width() : option.rect.width();
+
+    // Heights depend on wrapping width
+    if (width != cachedWidth) {
+        heightCache.clear();
+        cachedWidth = width;
+    }
+    return width;
+}
+
+void MessageBubbleDelegate::buildDocument(QTextDocument &doc, const QModelIndex &index, int maxTextWidth) const {
+    int metaFontSize = static_cast<int>(13 * fontScale);
+    int messageFontSize = static_cast<int>(18 * fontScale);
+
+    QString time = index.data(MessageListModel::TimeRole).toString();
+    QString meta;
+    if (index.data(MessageListModel::OutgoingRole).toBool()) {
+        QString status = index.data(MessageListModel::StatusRole).toString();
+        QString checkmark;
+        if (status == "read") {
+            // Double checkmark colored (theme-aware)
+            checkmark = QString::fromUtf8("<span style='color: %1;'>✓✓</span>")
+                .arg(theme == "club" ? "#FF8C42" : "#00D9FF");
+        } else if (status == "delivered") {
+            checkmark = QString::fromUtf8("<span style='color: #888888;'>✓✓</span>");
+        } else {
+            checkmark = QString::fromUtf8("<span style='color: #888888;'>✓</span>");
+        }
+        meta = QString::fromUtf8("Me You • %1 %2").arg(time, checkmark);
+    } else {
+        meta = QString::fromUtf8(" %1 • %2")
+            .arg(index.data(MessageListModel::SenderRole).toString().toHtmlEscaped(), time);
+    }
+
+    QString text = index.data(MessageListModel::TextRole).toString();
+    QString body = formatBody ? formatBody(text) : text.toHtmlEscaped();
+
+    doc.setDocumentMargin(0);
+    doc.setDefaultFont(QFont("Orbitron"));
+    doc.setHtml(QString(
+        "<div style='font-size: %1px; margin-bottom: 5px;'>%2</div>"
+        "<div style='font-size: %3px;'>%4</div>"
+    ).arg(metaFontSize).arg(meta).arg(messageFontSize).arg(body));
+
+    // Shrink to content, wrap at max bubble width
+    doc.setTextWidth(maxTextWidth);
+    qreal ideal = doc.idealWidth();
+    if (ideal < maxTextWidth) {
+        doc.setTextWidth(qCeil(ideal));
+    }
+}
+
+QSize MessageBubbleDelegate::bubbleSize(const QTextDocument &doc) const {
+    QSizeF size = doc.size();
+    return QSize(qCeil(size.width()) + 2 * kPaddingX, qCeil(size.height()) + 2 * kPaddingY);
+}
+
+QSize MessageBubbleDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const {
+    int width = availableWidth(option);
+    int id = index.data(MessageListModel::MessageIdRole).toInt();
+
+    QHash<int, int>::const_iterator it = heightCache.constFind(id);
+    if (it != heightCache.constEnd()) {
+        return QSize(width, it.value());
+    }
+
+    // Not decrypted yet: estimate one line of text, corrected when painted
+    if (!index.data(MessageListModel::DecryptedRole).toBool()) {
+        QFont metaFont("Orbitron");
+        metaFont.setPixelSize(static_cast<int>(13 * fontScale));
+        QFont messageFont("Orbitron");
+        messageFont.setPixelSize(static_cast<int>(18 * fontScale));
+        int height = QFontMetrics(metaFont).lineSpacing() + 5 +
+                     QFontMetrics(messageFont).lineSpacing() +
+                     2 * kPaddingY + 2 * kRowMargin;
+        return QSize(width, height);
+    }
+
+    QTextDocument doc;
+    int maxTextWidth = qMax(1, static_cast<int>(width * kMaxBubbleWidth) - 2 * kPaddingX);
+    buildDocument(doc, index, maxTextWidth);
+    int height = bubbleSize(doc).height() + 2 * kRowMargin;
+    heightCache.insert(id, height);
+    return QSize(width, height);
+}
+
+void MessageBubbleDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                                  const QModelIndex &index) const {
+    int width = availableWidth(option);
+    int id = index.data(MessageListModel::MessageIdRole).toInt();
+    bool outgoing = index.data(MessageListModel::OutgoingRole).toBool();
+
+    // Decrypts the message on first paint
+    QTextDocument doc;
+    int maxTextWidth = qMax(1, static_cast<int>(width * kMaxBubbleWidth) - 2 * kPaddingX);
+    buildDocument(doc, index, maxTextWidth);
+    QSize bubble = bubbleSize(doc);
+
+    // Row was laid out with an estimate: ask the view to relayout it
+    int height = bubble.height() + 2 * kRowMargin;
+    if (heightCache.value(id, -1) != height) {
+        heightCache.insert(id, height);
+        if (option.rect.height() != height) {
+            MessageBubbleDelegate *self = const_cast<MessageBubbleDelegate*>(this);
+            QPersistentModelIndex persistent(index);
+            QTimer::singleShot(0, self, [self, persistent]() {
+                if (persistent.isValid()) {
+                    emit self->sizeHintChanged(persistent);
+                }
+            });
+        }
+    }
+
+    // Theme colors
+    QColor gradientStart, gradientEnd, border, textColor;
+    if (outgoing) {
+        gradientStart = QColor(theme == "club" ? "#FF8C42" : "#00D9FF");
+        gradientEnd = QColor(theme == "club" ? "#FFB380" : "#0D8B9C");
+        border = gradientStart;
+        textColor = Qt::white;
+    } else if (theme == "club") {
+        gradientStart = QColor("#2B1F16");
+        gradientEnd = QColor("#3D2B1F");
+        border = QColor(255, 140, 66, 128);
+        textColor = QColor("#FFB380");
+    } else {
+        gradientStart = QColor("#0D3438");
+        gradientEnd = QColor("#0A5A62");
+        border = QColor(0, 217, 255, 128);
+        textColor = QColor("#00D9FF");
+    }
+
+    int x = outgoing ? option.rect.right() - kSideMargin - bubble.width()
+                     : option.rect.left() + kSideMargin;
+    QRectF rect(x, option.rect.top() + kRowMargin, bubble.width(), bubble.height());
+
+    // Rounded bubble with a sharp corner on the sender's side
+    QPainterPath path;
+    path.addRoundedRect(rect, kRadius, kRadius);
+    QRectF tail(outgoing ? rect.right() - kRadius : rect.left(),
+                rect.bottom() - kRadius, kRadius, kRadius);
+    QPainterPath tailPath;
+    tailPath.addRoundedRect(tail, kTailRadius, kTailRadius);
+    path = path.united(tailPath);
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, true);
+
+    QLinearGradient gradient(rect.topLeft(), rect.topRight());
+    gradient.setColorAt(0, gradientStart);
+    gradient.setColorAt(1, gradientEnd);
+    painter->setPen(QPen(border, kBorderWidth));
+    painter->setBrush(gradient);
+    painter->drawPath(path);
+
+    painter->translate(rect.left() + kPaddingX, rect.top() + kPaddingY);
+    QAbstractTextDocumentLayout::PaintContext context;
+    context.palette.setColor(QPalette::Text, textColor);
+    doc.documentLayout()->draw(painter, context);
+
+    painter->restore();
+}
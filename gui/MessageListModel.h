@@ -0,0 +1,132 @@
+/*
+ * DNA Messenger - Qt GUI
+ * Conversation message list: model + bubble delegate
+ *
+ * The model holds message metadata only. Message text is decrypted the
+ * first time a row is painted, so rows that are never scrolled into view
+ * are never decrypted. Refreshing the same conversation appends new rows
+ * and updates checkmarks in place instead of rebuilding the view.
+ */
+
+#ifndef MESSAGELISTMODEL_H
+#define MESSAGELISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QStyledItemDelegate>
+#include <QHash>
+#include <QVector>
+#include <functional>
+
+// Forward declarations for C API
+extern "C" {
+    #include "../messenger.h"
+}
+
+class QTextDocument;
+
+class MessageListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Roles {
+        MessageIdRole = Qt::UserRole + 1,
+        SenderRole,
+        TimeRole,          // "HH:MM"
+        StatusRole,        // "sent", "delivered" or "read"
+        OutgoingRole,      // bool: sent by local identity
+        DecryptedRole,     // bool: TextRole is available without decrypting
+        TextRole           // Message text (decrypted on first access)
+    };
+
+    // Decrypt one message; return false on failure
+    typedef std::function<bool(int messageId, QString *textOut)> DecryptFunction;
+
+    explicit MessageListModel(QObject *parent = nullptr);
+
+    void setDecryptFunction(const DecryptFunction &fn);
+    void setLocalIdentity(const QString &identity);
+
+    /**
+     * Show the latest page of conversation `key` (e.g. "contact:alice", "group:3")
+     *
+     * Same key as currently shown: appends unseen messages and updates
+     * changed statuses in place. Different key, or a page that does not
+     * overlap the rows shown (more new messages than one page): replaces
+     * all rows.
+     *
+     * @param groupConversation true for group messages: all rows are
+     *        decryptable and outgoing rows always show a single checkmark
+     * @return true if all rows were replaced
+     */
+    bool sync(const QString &key, const message_info_t *messages, int count, bool groupConversation);
+
+    /**
+     * Insert an older page (oldest first) above the current rows
+     *
+     * @return Number of rows inserted
+     */
+    int prependOlder(const message_info_t *messages, int count, bool groupConversation);
+
+    // ID of the oldest row (page cursor), 0 if empty
+    int oldestId() const { return rows.isEmpty() ? 0 : rows.first().id; }
+
+    void clear();
+    QString conversationKey() const { return currentKey; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    struct Row {
+        int id;
+        QString sender;
+        QString time;
+        QString status;
+        bool outgoing;
+        bool canDecrypt;       // Local identity is sender or recipient
+        bool decrypted;        // text is final
+        QString text;
+    };
+
+    Row makeRow(const message_info_t &msg, bool groupConversation) const;
+    static QString statusOf(const message_info_t &msg, bool groupConversation);
+
+    // Mutable: text is filled in lazily from data()
+    mutable QVector<Row> rows;
+    QHash<int, int> rowById;
+    QString currentKey;
+    QString localIdentity;
+    DecryptFunction decrypt;
+};
+
+class MessageBubbleDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    // Turns message text into bubble body HTML (e.g. inline images)
+    typedef std::function<QString(const QString &text)> BodyFormatter;
+
+    explicit MessageBubbleDelegate(QObject *parent = nullptr);
+
+    void setAppearance(const QString &theme, double fontScale);
+    void setBodyFormatter(const BodyFormatter &fn);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+private:
+    int availableWidth(const QStyleOptionViewItem &option) const;
+    void buildDocument(QTextDocument &doc, const QModelIndex &index, int maxTextWidth) const;
+    QSize bubbleSize(const QTextDocument &doc) const;
+
+    QString theme;
+    double fontScale;
+    BodyFormatter formatBody;
+
+    // Row heights of decrypted messages by id, valid for cachedWidth
+    mutable QHash<int, int> heightCache;
+    mutable int cachedWidth;
+};
+
+#endif // MESSAGELISTMODEL_H
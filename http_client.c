@@ -0,0 +1,772 @@
+/*
+ * DNA Messenger - Minimal HTTP/1.1 Client
+ *
+ * Plain sockets + OpenSSL. Only what the keyserver API needs:
+ * request line + a few headers out, status + body in.
+ */
+
+#include "http_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET http_socket_t;
+#define HTTP_INVALID_SOCKET INVALID_SOCKET
+#define http_closesocket closesocket
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <pthread.h>
+typedef int http_socket_t;
+#define HTTP_INVALID_SOCKET (-1)
+#define http_closesocket close
+#endif
+
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <openssl/x509v3.h>
+
+#define HTTP_BUF_SIZE 16384
+#define HTTP_LINE_MAX 8192
+#define HTTP_TIMEOUT_SEC 15
+
+struct http_client {
+    int use_tls;
+    char host[256];
+    char port[8];
+    char prefix[512];              // Path prefix from base URL (no trailing '/')
+
+    http_socket_t sock;
+    SSL_CTX *ssl_ctx;
+    SSL *ssl;
+    SSL_SESSION *session;          // Saved for resumption on reconnect
+
+    // Receive buffer
+    char buf[HTTP_BUF_SIZE];
+    size_t buf_pos;
+    size_t buf_len;
+    int got_bytes;                 // Any response bytes seen for current request
+};
+
+// ============================================================================
+// URL PARSING
+// ============================================================================
+
+static int parse_base_url(http_client_t *c, const char *url) {
+    const char *p;
+
+    if (strncmp(url, "https://", 8) == 0) {
+        c->use_tls = 1;
+        p = url + 8;
+        strcpy(c->port, "443");
+    } else if (strncmp(url, "http://", 7) == 0) {
+        c->use_tls = 0;
+        p = url + 7;
+        strcpy(c->port, "80");
+    } else {
+        fprintf(stderr, "Error: Unsupported URL scheme: %s\n", url);
+        return -1;
+    }
+
+    // Host (IPv6 literals in brackets)
+    const char *host_end;
+    if (*p == '[') {
+        host_end = strchr(p, ']');
+        if (!host_end) {
+            return -1;
+        }
+        p++;
+    } else {
+        host_end = p + strcspn(p, ":/");
+    }
+
+    size_t host_len = (size_t)(host_end - p);
+    if (host_len == 0 || host_len >= sizeof(c->host)) {
+        fprintf(stderr, "Error: Invalid host in URL: %s\n", url);
+        return -1;
+    }
+    memcpy(c->host, p, host_len);
+    c->host[host_len] = '\0';
+    p = host_end;
+    if (*p == ']') {
+        p++;
+    }
+
+    // Port
+    if (*p == ':') {
+        p++;
+        size_t port_len = strspn(p, "0123456789");
+        if (port_len == 0 || port_len >= sizeof(c->port)) {
+            fprintf(stderr, "Error: Invalid port in URL: %s\n", url);
+            return -1;
+        }
+        memcpy(c->port, p, port_len);
+        c->port[port_len] = '\0';
+        p += port_len;
+    }
+
+    // Path prefix
+    if (*p != '\0' && *p != '/') {
+        return -1;
+    }
+    size_t prefix_len = strlen(p);
+    while (prefix_len > 0 && p[prefix_len - 1] == '/') {
+        prefix_len--;
+    }
+    if (prefix_len >= sizeof(c->prefix)) {
+        return -1;
+    }
+    memcpy(c->prefix, p, prefix_len);
+    c->prefix[prefix_len] = '\0';
+
+    return 0;
+}
+
+int http_client_escape(const char *in, char *out, size_t out_size) {
+    static const char hex[] = "0123456789ABCDEF";
+    size_t o = 0;
+
+    for (const unsigned char *p = (const unsigned char *)in; *p; p++) {
+        if (isalnum(*p) || *p == '-' || *p == '.' || *p == '_' || *p == '~') {
+            if (o + 1 >= out_size) {
+                return -1;
+            }
+            out[o++] = (char)*p;
+        } else {
+            if (o + 3 >= out_size) {
+                return -1;
+            }
+            out[o++] = '%';
+            out[o++] = hex[*p >> 4];
+            out[o++] = hex[*p & 0x0F];
+        }
+    }
+
+    if (o >= out_size) {
+        return -1;
+    }
+    out[o] = '\0';
+    return 0;
+}
+
+// ============================================================================
+// CONNECTION
+// ============================================================================
+
+static void conn_close(http_client_t *c) {
+    if (c->ssl) {
+        // TLS 1.3 tickets arrive after the handshake - grab the latest one
+        SSL_SESSION *sess = SSL_get1_session(c->ssl);
+        if (sess) {
+            if (c->session) {
+                SSL_SESSION_free(c->session);
+            }
+            c->session = sess;
+        }
+        SSL_shutdown(c->ssl);
+        SSL_free(c->ssl);
+        c->ssl = NULL;
+    }
+
+    if (c->sock != HTTP_INVALID_SOCKET) {
+        http_closesocket(c->sock);
+        c->sock = HTTP_INVALID_SOCKET;
+    }
+
+    c->buf_pos = 0;
+    c->buf_len = 0;
+}
+
+static void set_socket_timeouts(http_socket_t s) {
+#ifdef _WIN32
+    DWORD tv = HTTP_TIMEOUT_SEC * 1000;
+#else
+    struct timeval tv;
+    tv.tv_sec = HTTP_TIMEOUT_SEC;
+    tv.tv_usec = 0;
+#endif
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, (const char *)&tv, sizeof(tv));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, (const char *)&tv, sizeof(tv));
+
+    int nodelay = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char *)&nodelay, sizeof(nodelay));
+
+#ifdef SO_NOSIGPIPE
+    // BSD/macOS: no MSG_NOSIGNAL, but the socket itself can suppress SIGPIPE
+    int nosigpipe = 1;
+    setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, (const char *)&nosigpipe, sizeof(nosigpipe));
+#endif
+}
+
+#ifdef MSG_NOSIGNAL
+/*
+ * Socket BIO whose writes use send(MSG_NOSIGNAL), so SSL_write() to a peer
+ * that already closed fails with EPIPE instead of raising SIGPIPE. Per
+ * call, so no process-wide signal disposition is touched.
+ */
+static BIO_METHOD *nosigpipe_method;
+static pthread_once_t nosigpipe_once = PTHREAD_ONCE_INIT;
+
+static int nosigpipe_write(BIO *b, const char *data, int len) {
+    int fd = -1;
+    BIO_get_fd(b, &fd);
+
+    int n = (int)send(fd, data, (size_t)len, MSG_NOSIGNAL);
+    BIO_clear_retry_flags(b);
+    if (n <= 0 && BIO_sock_should_retry(n)) {
+        BIO_set_retry_write(b);
+    }
+    return n;
+}
+
+static void nosigpipe_method_init(void) {
+    const BIO_METHOD *sock = BIO_s_socket();
+    BIO_METHOD *m = BIO_meth_new(BIO_TYPE_SOCKET, "socket (MSG_NOSIGNAL)");
+    if (!m) {
+        return;
+    }
+
+    BIO_meth_set_write(m, nosigpipe_write);
+    BIO_meth_set_read(m, BIO_meth_get_read(sock));
+    BIO_meth_set_ctrl(m, BIO_meth_get_ctrl(sock));
+    BIO_meth_set_create(m, BIO_meth_get_create(sock));
+    BIO_meth_set_destroy(m, BIO_meth_get_destroy(sock));
+    nosigpipe_method = m;
+}
+#endif
+
+/**
+ * Socket BIO for the TLS layer (socket stays owned by the client)
+ */
+static BIO* socket_bio_new(http_socket_t s) {
+#ifdef MSG_NOSIGNAL
+    pthread_once(&nosigpipe_once, nosigpipe_method_init);
+    if (!nosigpipe_method) {
+        return NULL;
+    }
+
+    BIO *bio = BIO_new(nosigpipe_method);
+    if (bio) {
+        BIO_set_fd(bio, (int)s, BIO_NOCLOSE);
+    }
+    return bio;
+#else
+    return BIO_new_socket((int)s, BIO_NOCLOSE);
+#endif
+}
+
+static int conn_open(http_client_t *c) {
+    struct addrinfo hints;
+    struct addrinfo *res = NULL;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    int rc = getaddrinfo(c->host, c->port, &hints, &res);
+    if (rc != 0) {
+        fprintf(stderr, "Error: Cannot resolve '%s': %s\n", c->host, gai_strerror(rc));
+        return -1;
+    }
+
+    for (struct addrinfo *ai = res; ai; ai = ai->ai_next) {
+        http_socket_t s = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (s == HTTP_INVALID_SOCKET) {
+            continue;
+        }
+        set_socket_timeouts(s);
+        if (connect(s, ai->ai_addr, (int)ai->ai_addrlen) == 0) {
+            c->sock = s;
+            break;
+        }
+        http_closesocket(s);
+    }
+    freeaddrinfo(res);
+
+    if (c->sock == HTTP_INVALID_SOCKET) {
+        fprintf(stderr, "Error: Cannot connect to %s:%s\n", c->host, c->port);
+        return -1;
+    }
+
+    if (!c->use_tls) {
+        return 0;
+    }
+
+    c->ssl = SSL_new(c->ssl_ctx);
+    BIO *bio = c->ssl ? socket_bio_new(c->sock) : NULL;
+    if (!bio) {
+        conn_close(c);
+        return -1;
+    }
+
+    SSL_set_bio(c->ssl, bio, bio);
+    SSL_set_tlsext_host_name(c->ssl, c->host);
+    SSL_set1_host(c->ssl, c->host);
+    if (c->session) {
+        SSL_set_session(c->ssl, c->session);
+    }
+
+    if (SSL_connect(c->ssl) != 1) {
+        long verify = SSL_get_verify_result(c->ssl);
+        if (verify != X509_V_OK) {
+            fprintf(stderr, "Error: TLS certificate verification failed for %s: %s\n",
+                    c->host, X509_verify_cert_error_string(verify));
+        } else {
+            fprintf(stderr, "Error: TLS handshake with %s failed\n", c->host);
+        }
+        ERR_clear_error();
+        // Do not save a session from a failed handshake
+        SSL_free(c->ssl);
+        c->ssl = NULL;
+        conn_close(c);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int conn_write(http_client_t *c, const char *data, size_t len) {
+    while (len > 0) {
+        int chunk = len > 65536 ? 65536 : (int)len;
+        int n;
+        if (c->ssl) {
+            n = SSL_write(c->ssl, data, chunk);
+        } else {
+#ifdef MSG_NOSIGNAL
+            n = (int)send(c->sock, data, chunk, MSG_NOSIGNAL);
+#else
+            n = (int)send(c->sock, data, chunk, 0);
+#endif
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * Refill receive buffer
+ * @return bytes read, 0 on EOF, -1 on error
+ */
+static int conn_fill(http_client_t *c) {
+    int n;
+
+    c->buf_pos = 0;
+    c->buf_len = 0;
+
+    if (c->ssl) {
+        n = SSL_read(c->ssl, c->buf, sizeof(c->buf));
+        if (n <= 0) {
+            int err = SSL_get_error(c->ssl, n);
+            ERR_clear_error();
+            // Only close_notify is a clean end; a bare TCP close may have
+            // cut an unframed body short. Framed bodies stop reading before
+            // the connection ends, so they never get here once complete.
+            if (err == SSL_ERROR_ZERO_RETURN) {
+                return 0;
+            }
+            return -1;
+        }
+    } else {
+        n = (int)recv(c->sock, c->buf, sizeof(c->buf), 0);
+        if (n < 0) {
+            return -1;
+        }
+    }
+
+    if (n > 0) {
+        c->got_bytes = 1;
+    }
+    c->buf_len = (size_t)n;
+    return n;
+}
+
+/**
+ * Read one CRLF-terminated line (terminator stripped)
+ * @return line length, -1 on error/EOF/overlong line
+ */
+static int read_line(http_client_t *c, char *line, size_t size) {
+    size_t len = 0;
+
+    for (;;) {
+        if (c->buf_pos >= c->buf_len && conn_fill(c) <= 0) {
+            return -1;
+        }
+
+        char ch = c->buf[c->buf_pos++];
+        if (ch == '\n') {
+            break;
+        }
+        if (len + 1 >= size) {
+            return -1;
+        }
+        line[len++] = ch;
+    }
+
+    if (len > 0 && line[len - 1] == '\r') {
+        len--;
+    }
+    line[len] = '\0';
+    return (int)len;
+}
+
+/**
+ * Pass exactly n body bytes to the callback
+ * @return 0 on success, -1 on error/abort
+ */
+static int read_body_bytes(http_client_t *c, size_t n, http_body_cb on_body, void *userdata) {
+    while (n > 0) {
+        if (c->buf_pos >= c->buf_len && conn_fill(c) <= 0) {
+            return -1;
+        }
+
+        size_t avail = c->buf_len - c->buf_pos;
+        size_t take = avail < n ? avail : n;
+        if (on_body && on_body(c->buf + c->buf_pos, take, userdata) != 0) {
+            return -1;
+        }
+        c->buf_pos += take;
+        n -= take;
+    }
+    return 0;
+}
+
+/**
+ * Pass body bytes to the callback until the server closes the connection
+ */
+static int read_body_until_close(http_client_t *c, http_body_cb on_body, void *userdata) {
+    for (;;) {
+        if (c->buf_pos < c->buf_len) {
+            if (on_body && on_body(c->buf + c->buf_pos, c->buf_len - c->buf_pos, userdata) != 0) {
+                return -1;
+            }
+            c->buf_pos = c->buf_len;
+        }
+
+        int n = conn_fill(c);
+        if (n == 0) {
+            return 0;
+        }
+        if (n < 0) {
+            return -1;
+        }
+    }
+}
+
+static int read_body_chunked(http_client_t *c, http_body_cb on_body, void *userdata) {
+    char line[HTTP_LINE_MAX];
+
+    for (;;) {
+        if (read_line(c, line, sizeof(line)) < 0) {
+            return -1;
+        }
+
+        char *end = NULL;
+        unsigned long chunk_len = strtoul(line, &end, 16);
+        if (end == line) {
+            return -1;
+        }
+
+        if (chunk_len == 0) {
+            break;
+        }
+
+        if (read_body_bytes(c, chunk_len, on_body, userdata) != 0) {
+            return -1;
+        }
+
+        // CRLF after chunk data
+        if (read_line(c, line, sizeof(line)) != 0) {
+            return -1;
+        }
+    }
+
+    // Trailers, terminated by an empty line
+    for (;;) {
+        int len = read_line(c, line, sizeof(line));
+        if (len < 0) {
+            return -1;
+        }
+        if (len == 0) {
+            return 0;
+        }
+    }
+}
+
+// ============================================================================
+// REQUEST
+// ============================================================================
+
+static const char* header_value(const char *line, const char *name) {
+    size_t name_len = strlen(name);
+    for (size_t i = 0; i < name_len; i++) {
+        if (tolower((unsigned char)line[i]) != tolower((unsigned char)name[i])) {
+            return NULL;
+        }
+    }
+    if (line[name_len] != ':') {
+        return NULL;
+    }
+
+    const char *v = line + name_len + 1;
+    while (*v == ' ' || *v == '\t') {
+        v++;
+    }
+    return v;
+}
+
+static int contains_token(const char *value, const char *token) {
+    size_t token_len = strlen(token);
+    for (const char *p = value; *p; p++) {
+        size_t i = 0;
+        while (i < token_len && p[i] && tolower((unsigned char)p[i]) == token[i]) {
+            i++;
+        }
+        if (i == token_len) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int do_request(http_client_t *c,
+                      const char *method, const char *path,
+                      const char *content_type,
+                      const char *body, size_t body_len,
+                      http_body_cb on_body, void *userdata,
+                      int *status_out, int *retryable) {
+    int reused = (c->sock != HTTP_INVALID_SOCKET);
+    *retryable = 0;
+
+    if (!reused && conn_open(c) != 0) {
+        return -1;
+    }
+
+    // Request line + headers
+    char header[2048];
+    int default_port = (c->use_tls && strcmp(c->port, "443") == 0) ||
+                       (!c->use_tls && strcmp(c->port, "80") == 0);
+    int hlen = snprintf(header, sizeof(header),
+                        "%s %s%s HTTP/1.1\r\n"
+                        "Host: %s%s%s\r\n"
+                        "User-Agent: dna-messenger\r\n"
+                        "Accept: application/json\r\n"
+                        "Connection: keep-alive\r\n",
+                        method, c->prefix, path,
+                        c->host, default_port ? "" : ":", default_port ? "" : c->port);
+
+    if (body || strcmp(method, "POST") == 0 || strcmp(method, "PUT") == 0) {
+        hlen += snprintf(header + hlen, sizeof(header) - (size_t)hlen,
+                         "Content-Type: %s\r\n"
+                         "Content-Length: %zu\r\n",
+                         content_type ? content_type : "application/octet-stream",
+                         body ? body_len : 0);
+    }
+    if (hlen < 0 || (size_t)hlen + 3 > sizeof(header)) {
+        fprintf(stderr, "Error: HTTP request header too long\n");
+        return -1;
+    }
+    memcpy(header + hlen, "\r\n", 3);
+    hlen += 2;
+
+    c->got_bytes = 0;
+
+    if (conn_write(c, header, (size_t)hlen) != 0 ||
+        (body && body_len > 0 && conn_write(c, body, body_len) != 0)) {
+        conn_close(c);
+        *retryable = reused;
+        return -1;
+    }
+
+    // Status line (skip interim 1xx responses)
+    char line[HTTP_LINE_MAX];
+    int status = 0;
+    int http10 = 0;
+    for (;;) {
+        if (read_line(c, line, sizeof(line)) < 0) {
+            *retryable = reused && !c->got_bytes;
+            conn_close(c);
+            return -1;
+        }
+
+        int minor = 1;
+        if (sscanf(line, "HTTP/1.%d %d", &minor, &status) != 2) {
+            fprintf(stderr, "Error: Malformed HTTP status line\n");
+            conn_close(c);
+            return -1;
+        }
+        http10 = (minor == 0);
+
+        if (status >= 200 || status < 100) {
+            break;
+        }
+
+        // Discard 1xx headers
+        int len;
+        while ((len = read_line(c, line, sizeof(line))) > 0) {
+        }
+        if (len < 0) {
+            conn_close(c);
+            return -1;
+        }
+    }
+
+    // Headers
+    long long content_length = -1;
+    int chunked = 0;
+    int keep_alive = !http10;
+
+    for (;;) {
+        int len = read_line(c, line, sizeof(line));
+        if (len < 0) {
+            conn_close(c);
+            return -1;
+        }
+        if (len == 0) {
+            break;
+        }
+
+        const char *v;
+        if ((v = header_value(line, "Content-Length")) != NULL) {
+            content_length = strtoll(v, NULL, 10);
+        } else if ((v = header_value(line, "Transfer-Encoding")) != NULL) {
+            chunked = contains_token(v, "chunked");
+        } else if ((v = header_value(line, "Connection")) != NULL) {
+            if (contains_token(v, "close")) {
+                keep_alive = 0;
+            } else if (contains_token(v, "keep-alive")) {
+                keep_alive = 1;
+            }
+        }
+    }
+
+    // Body
+    int rc = 0;
+    if (strcmp(method, "HEAD") == 0 || status == 204 || status == 304) {
+        rc = 0;
+    } else if (chunked) {
+        rc = read_body_chunked(c, on_body, userdata);
+    } else if (content_length >= 0) {
+        rc = read_body_bytes(c, (size_t)content_length, on_body, userdata);
+    } else {
+        rc = read_body_until_close(c, on_body, userdata);
+        keep_alive = 0;
+    }
+
+    if (rc != 0 || !keep_alive) {
+        conn_close(c);
+    }
+    if (rc != 0) {
+        return -1;
+    }
+
+    if (status_out) {
+        *status_out = status;
+    }
+    return 0;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+http_client_t* http_client_new(const char *base_url) {
+    if (!base_url) {
+        return NULL;
+    }
+
+#ifdef _WIN32
+    static int wsa_initialized = 0;
+    if (!wsa_initialized) {
+        WSADATA wsa;
+        if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
+            fprintf(stderr, "Error: WSAStartup failed\n");
+            return NULL;
+        }
+        wsa_initialized = 1;
+    }
+#endif
+
+    http_client_t *c = calloc(1, sizeof(http_client_t));
+    if (!c) {
+        return NULL;
+    }
+    c->sock = HTTP_INVALID_SOCKET;
+
+    if (parse_base_url(c, base_url) != 0) {
+        free(c);
+        return NULL;
+    }
+
+    if (c->use_tls) {
+        c->ssl_ctx = SSL_CTX_new(TLS_client_method());
+        if (!c->ssl_ctx) {
+            free(c);
+            return NULL;
+        }
+        SSL_CTX_set_min_proto_version(c->ssl_ctx, TLS1_2_VERSION);
+        SSL_CTX_set_verify(c->ssl_ctx, SSL_VERIFY_PEER, NULL);
+        SSL_CTX_set_default_verify_paths(c->ssl_ctx);
+        SSL_CTX_set_session_cache_mode(c->ssl_ctx, SSL_SESS_CACHE_CLIENT);
+    }
+
+    return c;
+}
+
+void http_client_free(http_client_t *client) {
+    if (!client) {
+        return;
+    }
+
+    conn_close(client);
+
+    if (client->session) {
+        SSL_SESSION_free(client->session);
+    }
+    if (client->ssl_ctx) {
+        SSL_CTX_free(client->ssl_ctx);
+    }
+
+    free(client);
+}
+
+int http_client_request(http_client_t *client,
+                        const char *method,
+                        const char *path,
+                        const char *content_type,
+                        const char *body, size_t body_len,
+                        http_body_cb on_body, void *userdata,
+                        int *status_out) {
+    if (!client || !method || !path || path[0] != '/') {
+        return -1;
+    }
+
+    int retryable = 0;
+    int rc = do_request(client, method, path, content_type, body, body_len,
+                        on_body, userdata, status_out, &retryable);
+    if (rc != 0 && retryable) {
+        // Idle keep-alive connection was closed by the server - retry once
+        rc = do_request(client, method, path, content_type, body, body_len,
+                        on_body, userdata, status_out, &retryable);
+    }
+
+    return rc;
+}
+
+int http_client_get(http_client_t *client, const char *path,
+                    http_body_cb on_body, void *userdata, int *status_out) {
+    return http_client_request(client, "GET", path, NULL, NULL, 0,
+                               on_body, userdata, status_out);
+}
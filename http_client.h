@@ -0,0 +1,98 @@
+/*
+ * DNA Messenger - Minimal HTTP/1.1 Client
+ *
+ * In-process client used for keyserver lookups (replaces popen("curl")).
+ *
+ * Features:
+ * - http:// and https:// (OpenSSL, peer + hostname verification)
+ * - Persistent connections (HTTP/1.1 keep-alive) with TLS session resumption
+ * - Content-Length, chunked and read-until-close bodies
+ * - Response body is streamed to a callback (no fixed-size buffers)
+ *
+ * A client is bound to one base URL (scheme://host[:port][/prefix]) and is
+ * not thread-safe; use one client per thread.
+ */
+
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct http_client http_client_t;
+
+/**
+ * Body callback - invoked for each chunk of response body as it arrives
+ *
+ * @param data Body bytes (not NUL-terminated)
+ * @param len Number of bytes
+ * @param userdata Opaque pointer passed to http_client_request()
+ * @return 0 to continue, non-zero to abort the transfer
+ */
+typedef int (*http_body_cb)(const char *data, size_t len, void *userdata);
+
+/**
+ * Create client for a base URL
+ *
+ * No connection is made until the first request.
+ *
+ * @param base_url e.g. "https://cpunk.io/api/keyserver"
+ * @return Client, or NULL on invalid URL / allocation failure
+ */
+http_client_t* http_client_new(const char *base_url);
+
+/**
+ * Close connection and free client
+ */
+void http_client_free(http_client_t *client);
+
+/**
+ * Perform a request against base URL + path
+ *
+ * Reuses the open connection when possible. If a reused connection turns
+ * out to be closed by the server before any response bytes arrive, the
+ * request is retried once on a fresh connection.
+ *
+ * @param client HTTP client
+ * @param method "GET", "POST", ...
+ * @param path Path appended to the base URL prefix (must start with '/')
+ * @param content_type Request Content-Type (NULL if no body)
+ * @param body Request body (NULL if none)
+ * @param body_len Request body length
+ * @param on_body Body callback (NULL to discard body)
+ * @param userdata Passed to on_body
+ * @param status_out Output: HTTP status code
+ * @return 0 on success (any HTTP status), -1 on transport error
+ */
+int http_client_request(http_client_t *client,
+                        const char *method,
+                        const char *path,
+                        const char *content_type,
+                        const char *body, size_t body_len,
+                        http_body_cb on_body, void *userdata,
+                        int *status_out);
+
+/**
+ * Convenience wrapper: GET base URL + path
+ */
+int http_client_get(http_client_t *client, const char *path,
+                    http_body_cb on_body, void *userdata, int *status_out);
+
+/**
+ * Percent-encode a string for use as a URL path segment
+ *
+ * @param in Input string
+ * @param out Output buffer
+ * @param out_size Output buffer size
+ * @return 0 on success, -1 if output buffer is too small
+ */
+int http_client_escape(const char *in, char *out, size_t out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_CLIENT_H
@@ -0,0 +1,68 @@
+#!/bin/bash
+#
+# DNA Keyserver - Lookup throughput vs. HTTP worker threads
+#
+# Starts the keyserver once per thread count and drives
+# GET /api/keyserver/lookup/<dna> with wrk, printing requests/second.
+#
+# Usage: bench/bench_lookup.sh <keyserver.conf> <registered-dna> [threads ...]
+#   threads default: 1 2 4 ... up to the number of CPU cores
+#
+# Requires: wrk, a built keyserver (build/keyserver) and a database with
+# <registered-dna> registered. Rate limits are raised for the run.
+#
+
+set -e
+
+CONF="$1"
+DNA="$2"
+shift 2 || { echo "Usage: $0 <keyserver.conf> <registered-dna> [threads ...]"; exit 1; }
+
+KEYSERVER="${KEYSERVER:-$(dirname "$0")/../build/keyserver}"
+PORT="${PORT:-18080}"
+DURATION="${DURATION:-10s}"
+CONNECTIONS="${CONNECTIONS:-256}"
+CORES=$(nproc)
+
+command -v wrk >/dev/null || { echo "Error: wrk not found"; exit 1; }
+[ -x "$KEYSERVER" ] || { echo "Error: keyserver binary not found: $KEYSERVER"; exit 1; }
+
+THREADS="$*"
+if [ -z "$THREADS" ]; then
+    t=1
+    while [ $t -lt $CORES ]; do THREADS="$THREADS $t"; t=$((t * 2)); done
+    THREADS="$THREADS $CORES"
+fi
+
+TMP_CONF=$(mktemp)
+trap 'rm -f "$TMP_CONF"; [ -n "$PID" ] && kill $PID 2>/dev/null' EXIT
+
+printf "%-8s %-12s %s\n" "threads" "req/s" "latency p99"
+for t in $THREADS; do
+    # Later keys win: override port, threads, pool size and rate limits
+    {
+        cat "$CONF"
+        echo "port = $PORT"
+        echo "thread_pool_size = $t"
+        echo "pool_size = $t"
+        echo "rate_limit_lookup_count = 1000000000"
+        echo "rate_limit_lookup_period = 1"
+    } > "$TMP_CONF"
+
+    "$KEYSERVER" "$TMP_CONF" >/dev/null 2>&1 &
+    PID=$!
+    for _ in $(seq 50); do
+        curl -sf "http://127.0.0.1:$PORT/api/keyserver/health" >/dev/null && break
+        sleep 0.1
+    done
+
+    OUT=$(wrk -t "$t" -c "$CONNECTIONS" -d "$DURATION" --latency \
+              "http://127.0.0.1:$PORT/api/keyserver/lookup/$DNA")
+    RPS=$(echo "$OUT" | awk '/Requests\/sec/ {print $2}')
+    P99=$(echo "$OUT" | awk '$1 == "99%" {print $2}')
+    printf "%-8s %-12s %s\n" "$t" "$RPS" "$P99"
+
+    kill $PID
+    wait $PID 2>/dev/null || true
+    PID=
+done
@@ -36,7 +36,8 @@ CREATE TABLE keyserver_identities (
 
 -- Indexes for performance
 CREATE INDEX idx_dna ON keyserver_identities(dna);
-CREATE INDEX idx_registered_at ON keyserver_identities(registered_at DESC);
+-- (registered_at, id) matches the /list keyset cursor and sort order
+CREATE INDEX idx_registered_at ON keyserver_identities(registered_at DESC, id DESC);
 CREATE INDEX idx_last_updated ON keyserver_identities(last_updated DESC);
 
 -- Function to update last_updated timestamp
@@ -54,6 +55,24 @@ CREATE TRIGGER trigger_update_last_updated
     FOR EACH ROW
     EXECUTE FUNCTION update_last_updated();
 
+-- Notify keyservers so they drop cached lookups (payload: dna)
+CREATE OR REPLACE FUNCTION notify_identity_changed()
+RETURNS TRIGGER AS $$
+BEGIN
+    IF TG_OP = 'DELETE' THEN
+        PERFORM pg_notify('keyserver_identities', OLD.dna);
+    ELSE
+        PERFORM pg_notify('keyserver_identities', NEW.dna);
+    END IF;
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE TRIGGER trigger_notify_identity_changed
+    AFTER INSERT OR UPDATE OR DELETE ON keyserver_identities
+    FOR EACH ROW
+    EXECUTE FUNCTION notify_identity_changed();
+
 -- Comments
 COMMENT ON TABLE keyserver_identities IS 'DNA Messenger public key registry';
 COMMENT ON COLUMN keyserver_identities.dna IS 'DNA handle (3-32 alphanumeric + underscore)';
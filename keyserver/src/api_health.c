@@ -5,33 +5,75 @@
 #include "keyserver.h"
 #include "http_utils.h"
 #include "db.h"
+#include "db_pool.h"
+#include "identity_cache.h"
+#include "identity_count.h"
 #include <sys/sysinfo.h>
 
-enum MHD_Result api_health_handler(struct MHD_Connection *connection, PGconn *db_conn) {
-    json_object *response = json_object_new_object();
+enum MHD_Result api_health_handler(struct MHD_Connection *connection, PGconn *db_conn, db_pool_t *db_pool) {
+    json_writer_t w;
+    json_writer_init(&w);
+    json_writer_object_begin(&w);
 
     // Basic health status
-    json_object_object_add(response, "status", json_object_new_string("ok"));
-    json_object_object_add(response, "version", json_object_new_string(KEYSERVER_VERSION));
+    json_writer_key(&w, "status");
+    json_writer_string(&w, "ok");
+    json_writer_key(&w, "version");
+    json_writer_string(&w, KEYSERVER_VERSION);
 
     // Uptime
     struct sysinfo info;
     if (sysinfo(&info) == 0) {
-        json_object_object_add(response, "uptime", json_object_new_int64(info.uptime));
+        json_writer_key(&w, "uptime");
+        json_writer_int(&w, info.uptime);
     }
 
     // Database status
     if (db_conn && PQstatus(db_conn) == CONNECTION_OK) {
-        json_object_object_add(response, "database", json_object_new_string("connected"));
+        json_writer_key(&w, "database");
+        json_writer_string(&w, "connected");
 
-        // Get total identities count
-        int total = db_count_identities(db_conn);
+        // Approximate total (refreshed in the background)
+        int64_t total = identity_count_get();
         if (total >= 0) {
-            json_object_object_add(response, "total_identities", json_object_new_int(total));
+            json_writer_key(&w, "total_identities");
+            json_writer_int(&w, total);
         }
     } else {
-        json_object_object_add(response, "database", json_object_new_string("disconnected"));
+        json_writer_key(&w, "database");
+        json_writer_string(&w, "disconnected");
     }
 
-    return http_send_json_response(connection, HTTP_OK, response);
+    // Connection pool usage
+    int pool_size, pool_open, pool_in_use;
+    db_pool_stats(db_pool, &pool_size, &pool_open, &pool_in_use);
+    json_writer_key(&w, "db_pool");
+    json_writer_object_begin(&w);
+    json_writer_key(&w, "size");
+    json_writer_int(&w, pool_size);
+    json_writer_key(&w, "open");
+    json_writer_int(&w, pool_open);
+    json_writer_key(&w, "in_use");
+    json_writer_int(&w, pool_in_use);
+    json_writer_object_end(&w);
+
+    // Lookup cache usage
+    int cache_entries;
+    size_t cache_bytes;
+    uint64_t cache_hits, cache_misses;
+    identity_cache_stats(&cache_entries, &cache_bytes, &cache_hits, &cache_misses);
+    json_writer_key(&w, "identity_cache");
+    json_writer_object_begin(&w);
+    json_writer_key(&w, "entries");
+    json_writer_int(&w, cache_entries);
+    json_writer_key(&w, "bytes");
+    json_writer_uint(&w, cache_bytes);
+    json_writer_key(&w, "hits");
+    json_writer_uint(&w, cache_hits);
+    json_writer_key(&w, "misses");
+    json_writer_uint(&w, cache_misses);
+    json_writer_object_end(&w);
+
+    json_writer_object_end(&w);
+    return http_send_json_writer(connection, HTTP_OK, &w);
 }
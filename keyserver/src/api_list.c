@@ -1,15 +1,63 @@
 /*
  * API Handler: GET /list
+ *
+ * Query: limit (1-1000), search (DNA prefix, at most MAX_DNA_LENGTH),
+ * after (cursor from the previous page's pagination.next_after).
+ * The former offset parameter is rejected rather than ignored.
  */
 
 #include "keyserver.h"
 #include "http_utils.h"
 #include "rate_limit.h"
 #include "db.h"
+#include "identity_count.h"
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+/**
+ * Parse "<YYYY-MM-DDTHH:MM:SS[.ffffff]>,<id>" cursor
+ *
+ * @return: 0 on success, -1 if malformed
+ */
+static int parse_after_cursor(const char *after, char *time_out, size_t time_size, int *id_out) {
+    const char *comma = strrchr(after, ',');
+    if (!comma || (size_t)(comma - after) >= time_size) {
+        return -1;
+    }
+
+    size_t time_len = (size_t)(comma - after);
+    memcpy(time_out, after, time_len);
+    time_out[time_len] = '\0';
+
+    int year, month, day, hour, minute, second, consumed = 0;
+    if (sscanf(time_out, "%4d-%2d-%2dT%2d:%2d:%2d%n",
+               &year, &month, &day, &hour, &minute, &second, &consumed) != 6) {
+        return -1;
+    }
+    const char *frac = time_out + consumed;
+    if (*frac == '.') {
+        frac++;
+        if (!*frac || strspn(frac, "0123456789") != strlen(frac) || strlen(frac) > 6) {
+            return -1;
+        }
+    } else if (*frac) {
+        return -1;
+    }
+
+    char *end;
+    long id = strtol(comma + 1, &end, 10);
+    if (end == comma + 1 || *end || id < 0 || id > 0x7fffffff) {
+        return -1;
+    }
+    *id_out = (int)id;
+
+    return 0;
+}
+
 enum MHD_Result api_list_handler(struct MHD_Connection *connection, PGconn *db_conn,
                                   const char *url) {
+    (void)url;
     char client_ip[46];
 
     // Get client IP
@@ -23,64 +71,96 @@ enum MHD_Result api_list_handler(struct MHD_Connection *connection, PGconn *db_c
         return http_send_error(connection, HTTP_TOO_MANY_REQUESTS, "Rate limit exceeded");
     }
 
-    // Parse query parameters (limit, offset, search)
+    // Parse query parameters (limit, after, search)
     int limit = 100;  // default
-    int offset = 0;   // default
     const char *search = NULL;
 
     const char *limit_str = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "limit");
-    const char *offset_str = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "offset");
+    const char *after_str = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "after");
     search = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "search");
 
+    // Old clients would otherwise get page one over and over
+    if (MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "offset")) {
+        return http_send_error(connection, HTTP_BAD_REQUEST,
+                               "'offset' is not supported; pass pagination.next_after as 'after'");
+    }
+
+    if (search && strlen(search) > MAX_DNA_LENGTH) {
+        return http_send_error(connection, HTTP_BAD_REQUEST, "Search prefix too long");
+    }
+
     if (limit_str) {
         limit = atoi(limit_str);
         if (limit < 1) limit = 1;
         if (limit > 1000) limit = 1000;
     }
 
-    if (offset_str) {
-        offset = atoi(offset_str);
-        if (offset < 0) offset = 0;
+    char after_time[40];
+    int after_id = 0;
+    if (after_str && *after_str &&
+        parse_after_cursor(after_str, after_time, sizeof(after_time), &after_id) != 0) {
+        return http_send_error(connection, HTTP_BAD_REQUEST, "Invalid 'after' cursor");
     }
 
     // Query database
     identity_t *identities = NULL;
     int count = 0;
+    bool has_more = false;
+    char next_after[64];
 
-    if (db_list_identities(db_conn, limit, offset, search, &identities, &count) != 0) {
+    if (db_list_identities(db_conn, limit, after_str && *after_str ? after_time : NULL,
+                           after_id, search, &identities, &count,
+                           &has_more, next_after, sizeof(next_after)) != 0) {
         return http_send_error(connection, HTTP_INTERNAL_ERROR, "Database query failed");
     }
 
-    // Get total count
-    int total = db_count_identities(db_conn);
+    // Maintained in the background, never counted per request
+    int64_t total_estimate = identity_count_get();
 
     // Build JSON response
-    json_object *response = json_object_new_object();
-    json_object_object_add(response, "success", json_object_new_boolean(true));
-    json_object_object_add(response, "total", json_object_new_int(total));
+    json_writer_t w;
+    json_writer_init(&w);
+    json_writer_object_begin(&w);
+    json_writer_key(&w, "success");
+    json_writer_bool(&w, true);
+    json_writer_key(&w, "total_estimate");
+    if (total_estimate >= 0) {
+        json_writer_int(&w, total_estimate);
+    } else {
+        json_writer_null(&w);
+    }
 
     // Identities array
-    json_object *identities_array = json_object_new_array();
+    json_writer_key(&w, "identities");
+    json_writer_array_begin(&w);
     for (int i = 0; i < count; i++) {
-        json_object *id_obj = json_object_new_object();
-        json_object_object_add(id_obj, "dna", json_object_new_string(identities[i].dna));
-        json_object_object_add(id_obj, "version", json_object_new_int(identities[i].version));
-        json_object_object_add(id_obj, "registered_at", json_object_new_string(identities[i].registered_at));
-        json_object_object_add(id_obj, "last_updated", json_object_new_string(identities[i].last_updated));
-
-        json_object_array_add(identities_array, id_obj);
+        json_writer_object_begin(&w);
+        json_writer_key(&w, "dna");
+        json_writer_string(&w, identities[i].dna);
+        json_writer_key(&w, "version");
+        json_writer_int(&w, identities[i].version);
+        json_writer_key(&w, "registered_at");
+        json_writer_string(&w, identities[i].registered_at);
+        json_writer_key(&w, "last_updated");
+        json_writer_string(&w, identities[i].last_updated);
+        json_writer_object_end(&w);
     }
-    json_object_object_add(response, "identities", identities_array);
+    json_writer_array_end(&w);
 
     // Pagination info
-    json_object *pagination = json_object_new_object();
-    json_object_object_add(pagination, "limit", json_object_new_int(limit));
-    json_object_object_add(pagination, "offset", json_object_new_int(offset));
-    json_object_object_add(pagination, "has_more", json_object_new_boolean(offset + count < total));
-    json_object_object_add(response, "pagination", pagination);
+    json_writer_key(&w, "pagination");
+    json_writer_object_begin(&w);
+    json_writer_key(&w, "limit");
+    json_writer_int(&w, limit);
+    json_writer_key(&w, "has_more");
+    json_writer_bool(&w, has_more);
+    json_writer_key(&w, "next_after");
+    json_writer_string(&w, has_more ? next_after : NULL);
+    json_writer_object_end(&w);
+    json_writer_object_end(&w);
 
     db_free_identities(identities, count);
 
     LOG_INFO("List: returned %d identities", count);
-    return http_send_json_response(connection, HTTP_OK, response);
+    return http_send_json_writer(connection, HTTP_OK, &w);
 }
@@ -1,16 +1,70 @@
 /*
- * API Handler: GET /lookup/<identity>
+ * API Handlers: GET /lookup/<identity>, POST /lookup_batch
  */
 
 #include "keyserver.h"
 #include "http_utils.h"
 #include "rate_limit.h"
+#include "validation.h"
 #include "db.h"
+#include "db_pool.h"
+#include "identity_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
-enum MHD_Result api_lookup_handler(struct MHD_Connection *connection, PGconn *db_conn,
+// Identity data object (shared by single and batch lookup)
+static void write_identity_data(json_writer_t *w, const identity_t *identity) {
+    json_writer_object_begin(w);
+    json_writer_key(w, "v");
+    json_writer_int(w, identity->schema_version);
+    json_writer_key(w, "dna");
+    json_writer_string(w, identity->dna);
+    json_writer_key(w, "dilithium_pub");
+    json_writer_string(w, identity->dilithium_pub);
+    json_writer_key(w, "kyber_pub");
+    json_writer_string(w, identity->kyber_pub);
+    json_writer_key(w, "cf20pub");
+    json_writer_string(w, identity->cf20pub);
+    json_writer_key(w, "version");
+    json_writer_int(w, identity->version);
+    json_writer_key(w, "updated_at");
+    json_writer_int(w, identity->updated_at);
+    json_writer_key(w, "sig");
+    json_writer_string(w, identity->sig);
+    json_writer_object_end(w);
+}
+
+// "dna", "data", "registered_at", "last_updated" members of a lookup result
+static void write_identity_members(json_writer_t *w, const identity_t *identity) {
+    json_writer_key(w, "dna");
+    json_writer_string(w, identity->dna);
+    json_writer_key(w, "data");
+    write_identity_data(w, identity);
+    json_writer_key(w, "registered_at");
+    json_writer_string(w, identity->registered_at);
+    json_writer_key(w, "last_updated");
+    json_writer_string(w, identity->last_updated);
+}
+
+// Strong validator for a lookup reply: the body only changes with the version
+static void lookup_etag(char *buf, size_t size, const char *dna, int version) {
+    snprintf(buf, size, "\"%s:%d\"", dna, version);
+}
+
+// Client already holds this version (If-None-Match or ?since_version=)
+static bool lookup_is_current(const char *if_none_match, long since_version,
+                              const char *etag, int version) {
+    if (since_version >= 0 && version <= since_version) {
+        return true;
+    }
+    return http_etag_matches(if_none_match, etag);
+}
+
+enum MHD_Result api_lookup_handler(struct MHD_Connection *connection, db_pool_t *db_pool,
                                     const char *dna) {
     char client_ip[46];
+    char etag[MAX_DNA_LENGTH + 16];
 
     // Get client IP
     if (http_get_client_ip(connection, client_ip, sizeof(client_ip)) != 0) {
@@ -23,48 +77,190 @@ enum MHD_Result api_lookup_handler(struct MHD_Connection *connection, PGconn *db
         return http_send_error(connection, HTTP_TOO_MANY_REQUESTS, "Rate limit exceeded");
     }
 
+    // Conditional request: 304 when the client's version is still current
+    long since_version = -1;
+    const char *since_str = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "since_version");
+    if (since_str) {
+        char *end;
+        since_version = strtol(since_str, &end, 10);
+        if (end == since_str || *end != '\0' || since_version < 0) {
+            return http_send_error(connection, HTTP_BAD_REQUEST, "Invalid since_version");
+        }
+    }
+    const char *if_none_match = MHD_lookup_connection_value(connection, MHD_HEADER_KIND, "If-None-Match");
+
+    // Cached response: sent in place, no database or allocation
+    identity_cache_blob_t *cached = identity_cache_get(dna);
+    if (cached) {
+        lookup_etag(etag, sizeof(etag), dna, cached->version);
+        if (lookup_is_current(if_none_match, since_version, etag, cached->version)) {
+            identity_cache_release(cached);
+            LOG_DEBUG("Lookup: %s not modified (cached)", dna);
+            return http_send_not_modified(connection, etag);
+        }
+
+        LOG_DEBUG("Lookup: %s found (cached)", dna);
+        return http_send_owned(connection, HTTP_OK, "application/json", etag,
+                               cached->data, cached->len, identity_cache_release_data);
+    }
+
     // Query database
+    uint64_t generation = identity_cache_generation(dna);
+    PGconn *db_conn = db_pool_acquire(db_pool);
+    if (!db_conn) {
+        return http_send_error(connection, HTTP_SERVICE_UNAVAILABLE, "Database unavailable");
+    }
+
     identity_t identity;
     memset(&identity, 0, sizeof(identity));
 
     int result = db_lookup_identity(db_conn, dna, &identity);
+    db_pool_release(db_pool, db_conn);
+
+    json_writer_t w;
+    json_writer_init(&w);
 
     if (result == -2) {
         // Not found
-        json_object *response = json_object_new_object();
-        json_object_object_add(response, "success", json_object_new_boolean(false));
-        json_object_object_add(response, "error", json_object_new_string("Identity not found"));
-        json_object_object_add(response, "dna", json_object_new_string(dna));
+        json_writer_object_begin(&w);
+        json_writer_key(&w, "success");
+        json_writer_bool(&w, false);
+        json_writer_key(&w, "error");
+        json_writer_string(&w, "Identity not found");
+        json_writer_key(&w, "dna");
+        json_writer_string(&w, dna);
+        json_writer_object_end(&w);
 
-        return http_send_json_response(connection, HTTP_NOT_FOUND, response);
+        return http_send_json_writer(connection, HTTP_NOT_FOUND, &w);
     }
 
     if (result != 0) {
+        json_writer_discard(&w);
         return http_send_error(connection, HTTP_INTERNAL_ERROR, "Database query failed");
     }
 
     // Build JSON response
-    json_object *response = json_object_new_object();
-    json_object_object_add(response, "success", json_object_new_boolean(true));
-    json_object_object_add(response, "dna", json_object_new_string(identity.dna));
-
-    // Data object with full identity info
-    json_object *data = json_object_new_object();
-    json_object_object_add(data, "v", json_object_new_int(identity.schema_version));
-    json_object_object_add(data, "dna", json_object_new_string(identity.dna));
-    json_object_object_add(data, "dilithium_pub", json_object_new_string(identity.dilithium_pub));
-    json_object_object_add(data, "kyber_pub", json_object_new_string(identity.kyber_pub));
-    json_object_object_add(data, "cf20pub", json_object_new_string(identity.cf20pub));
-    json_object_object_add(data, "version", json_object_new_int(identity.version));
-    json_object_object_add(data, "updated_at", json_object_new_int(identity.updated_at));
-    json_object_object_add(data, "sig", json_object_new_string(identity.sig));
-
-    json_object_object_add(response, "data", data);
-    json_object_object_add(response, "registered_at", json_object_new_string(identity.registered_at));
-    json_object_object_add(response, "last_updated", json_object_new_string(identity.last_updated));
+    json_writer_object_begin(&w);
+    json_writer_key(&w, "success");
+    json_writer_bool(&w, true);
+    write_identity_members(&w, &identity);
+    json_writer_object_end(&w);
 
+    int version = identity.version;
     db_free_identity(&identity);
 
+    // The cached body doubles as the reply buffer (one allocation)
+    identity_cache_blob_t *blob = json_writer_failed(&w) ? NULL :
+                                  identity_cache_blob_create(w.buf, w.len);
+    json_writer_discard(&w);
+    if (!blob) {
+        return http_send_error(connection, HTTP_INTERNAL_ERROR, "Out of memory");
+    }
+    blob->version = version;
+    identity_cache_put(dna, blob, generation);
+
+    lookup_etag(etag, sizeof(etag), dna, version);
+    if (lookup_is_current(if_none_match, since_version, etag, version)) {
+        identity_cache_release(blob);
+        LOG_DEBUG("Lookup: %s not modified", dna);
+        return http_send_not_modified(connection, etag);
+    }
+
     LOG_INFO("Lookup: %s found", dna);
-    return http_send_json_response(connection, HTTP_OK, response);
+    return http_send_owned(connection, HTTP_OK, "application/json", etag,
+                           blob->data, blob->len, identity_cache_release_data);
+}
+
+enum MHD_Result api_lookup_batch_handler(struct MHD_Connection *connection, PGconn *db_conn,
+                                          const char *upload_data, size_t upload_data_size) {
+    char client_ip[46];
+
+    // Get client IP
+    if (http_get_client_ip(connection, client_ip, sizeof(client_ip)) != 0) {
+        return http_send_error(connection, HTTP_INTERNAL_ERROR, "Failed to get client IP");
+    }
+
+    // Rate limiting (one lookup token per batch - batch size is capped below)
+    if (!rate_limit_check(client_ip, RATE_LIMIT_TYPE_LOOKUP)) {
+        LOG_WARN("Rate limit exceeded for batch lookup: %s", client_ip);
+        return http_send_error(connection, HTTP_TOO_MANY_REQUESTS, "Rate limit exceeded");
+    }
+
+    // Parse JSON payload: {"dnas": ["alice", "bob", ...]}
+    json_object *payload = http_parse_json_post(upload_data, upload_data_size);
+    if (!payload) {
+        return http_send_error(connection, HTTP_BAD_REQUEST, "Invalid JSON");
+    }
+
+    json_object *dnas_obj;
+    if (!json_object_object_get_ex(payload, "dnas", &dnas_obj) ||
+        !json_object_is_type(dnas_obj, json_type_array)) {
+        json_object_put(payload);
+        return http_send_error(connection, HTTP_BAD_REQUEST, "Missing 'dnas' array");
+    }
+
+    int dna_count = (int)json_object_array_length(dnas_obj);
+    if (dna_count == 0 || dna_count > MAX_LOOKUP_BATCH) {
+        json_object_put(payload);
+        return http_send_error(connection, HTTP_BAD_REQUEST, "'dnas' must contain 1-100 entries");
+    }
+
+    const char *dnas[MAX_LOOKUP_BATCH];
+    for (int i = 0; i < dna_count; i++) {
+        json_object *item = json_object_array_get_idx(dnas_obj, i);
+        dnas[i] = json_object_is_type(item, json_type_string) ? json_object_get_string(item) : NULL;
+        if (!validate_dna(dnas[i])) {
+            json_object_put(payload);
+            return http_send_error(connection, HTTP_BAD_REQUEST, "Invalid DNA handle in 'dnas'");
+        }
+    }
+
+    // Query database (single round trip)
+    identity_t *identities = NULL;
+    int count = 0;
+    if (db_lookup_identities_batch(db_conn, dnas, dna_count, &identities, &count) != 0) {
+        json_object_put(payload);
+        return http_send_error(connection, HTTP_INTERNAL_ERROR, "Database query failed");
+    }
+
+    // Build JSON response
+    json_writer_t w;
+    json_writer_init(&w);
+    json_writer_object_begin(&w);
+    json_writer_key(&w, "success");
+    json_writer_bool(&w, true);
+    json_writer_key(&w, "count");
+    json_writer_int(&w, count);
+
+    json_writer_key(&w, "results");
+    json_writer_array_begin(&w);
+    for (int i = 0; i < count; i++) {
+        json_writer_object_begin(&w);
+        write_identity_members(&w, &identities[i]);
+        json_writer_object_end(&w);
+    }
+    json_writer_array_end(&w);
+
+    json_writer_key(&w, "not_found");
+    json_writer_array_begin(&w);
+    for (int i = 0; i < dna_count; i++) {
+        int found = 0;
+        for (int j = 0; j < count; j++) {
+            if (strcmp(dnas[i], identities[j].dna) == 0) {
+                found = 1;
+                break;
+            }
+        }
+        if (!found) {
+            json_writer_string(&w, dnas[i]);
+        }
+    }
+    json_writer_array_end(&w);
+    json_writer_object_end(&w);
+
+    db_free_identities(identities, count);
+    json_object_put(payload);
+
+    LOG_INFO("Batch lookup: %d/%d found", count, dna_count);
+    return http_send_json_writer(connection, HTTP_OK, &w);
 }
@@ -0,0 +1,19 @@
+/*
+ * API Handler: GET /metrics
+ */
+
+#include "keyserver.h"
+#include "http_utils.h"
+#include "metrics.h"
+#include <stdlib.h>
+
+enum MHD_Result api_metrics_handler(struct MHD_Connection *connection, db_pool_t *db_pool) {
+    size_t len;
+    char *text = metrics_render(db_pool, &len);
+    if (!text) {
+        return http_send_error(connection, HTTP_INTERNAL_ERROR, "Out of memory");
+    }
+
+    return http_send_owned(connection, HTTP_OK, "text/plain; version=0.0.4; charset=utf-8", NULL,
+                           text, len, free);
+}
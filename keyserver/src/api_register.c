@@ -1,5 +1,9 @@
 /*
  * API Handler: POST /register
+ *
+ * Runs in two passes: the first validates the payload and queues its
+ * signature check, then suspends the connection; the second (after the
+ * verify worker resumes it) stores the identity.
  */
 
 #include "keyserver.h"
@@ -8,10 +12,12 @@
 #include "validation.h"
 #include "signature.h"
 #include "db.h"
+#include "db_pool.h"
 #include <string.h>
 
-enum MHD_Result api_register_handler(struct MHD_Connection *connection, PGconn *db_conn,
-                                      const char *upload_data, size_t upload_data_size) {
+static enum MHD_Result register_submit(struct MHD_Connection *connection,
+                                       const char *upload_data, size_t upload_data_size,
+                                       signature_job_t **verify_job) {
     char client_ip[46];
     char error_msg[512];
 
@@ -39,20 +45,7 @@ enum MHD_Result api_register_handler(struct MHD_Connection *connection, PGconn *
         return http_send_error(connection, HTTP_BAD_REQUEST, error_msg);
     }
 
-    // Extract fields
     json_object *field;
-    json_object_object_get_ex(payload, "dna", &field);
-    const char *dna = json_object_get_string(field);
-
-    json_object_object_get_ex(payload, "dilithium_pub", &field);
-    const char *dilithium_pub = json_object_get_string(field);
-
-    json_object_object_get_ex(payload, "kyber_pub", &field);
-    const char *kyber_pub = json_object_get_string(field);
-
-    json_object_object_get_ex(payload, "cf20pub", &field);
-    const char *cf20pub = json_object_get_string(field);
-
     json_object_object_get_ex(payload, "version", &field);
     int version = json_object_get_int(field);
 
@@ -63,30 +56,69 @@ enum MHD_Result api_register_handler(struct MHD_Connection *connection, PGconn *
         return http_send_error(connection, HTTP_BAD_REQUEST, "Registration version must be 1");
     }
 
-    json_object_object_get_ex(payload, "updated_at", &field);
-    int updated_at = json_object_get_int(field);
+    json_object_object_get_ex(payload, "dna", &field);
+    const char *dna = json_object_get_string(field);
+
+    json_object_object_get_ex(payload, "dilithium_pub", &field);
+    const char *dilithium_pub = json_object_get_string(field);
 
     json_object_object_get_ex(payload, "sig", &field);
     const char *signature = json_object_get_string(field);
 
-    // Verify signature
+    // Queue signature verification
     LOG_INFO("Verifying signature for %s", dna);
-    int sig_result = signature_verify(payload, signature, dilithium_pub,
-                                      g_config.verify_json_path,
-                                      g_config.verify_timeout);
+    signature_job_t *job = signature_job_submit(payload, signature, dilithium_pub);
+    json_object_put(payload);  // Job holds its own reference
+    if (!job) {
+        LOG_WARN("Signature verification queue full");
+        return http_send_error(connection, HTTP_SERVICE_UNAVAILABLE, "Server busy");
+    }
+
+    *verify_job = job;
+    return http_suspend_until_verified(connection, job);
+}
+
+static enum MHD_Result register_finish(struct MHD_Connection *connection, db_pool_t *db_pool,
+                                       json_object *payload, int sig_result) {
+    char client_ip[46];
+    char error_msg[512];
 
     if (sig_result == -1) {
+        if (http_get_client_ip(connection, client_ip, sizeof(client_ip)) != 0) {
+            strcpy(client_ip, "unknown");
+        }
         LOG_WARN("Invalid signature from %s", client_ip);
-        json_object_put(payload);
         return http_send_error(connection, HTTP_BAD_REQUEST, "Invalid signature");
     }
 
     if (sig_result == -2) {
         LOG_ERROR("Signature verification error");
-        json_object_put(payload);
         return http_send_error(connection, HTTP_INTERNAL_ERROR, "Signature verification error");
     }
 
+    // Extract fields
+    json_object *field;
+    json_object_object_get_ex(payload, "dna", &field);
+    const char *dna = json_object_get_string(field);
+
+    json_object_object_get_ex(payload, "dilithium_pub", &field);
+    const char *dilithium_pub = json_object_get_string(field);
+
+    json_object_object_get_ex(payload, "kyber_pub", &field);
+    const char *kyber_pub = json_object_get_string(field);
+
+    json_object_object_get_ex(payload, "cf20pub", &field);
+    const char *cf20pub = json_object_get_string(field);
+
+    json_object_object_get_ex(payload, "version", &field);
+    int version = json_object_get_int(field);
+
+    json_object_object_get_ex(payload, "updated_at", &field);
+    int updated_at = json_object_get_int(field);
+
+    json_object_object_get_ex(payload, "sig", &field);
+    const char *signature = json_object_get_string(field);
+
     // Build identity structure
     identity_t identity;
     memset(&identity, 0, sizeof(identity));
@@ -101,18 +133,21 @@ enum MHD_Result api_register_handler(struct MHD_Connection *connection, PGconn *
     identity.schema_version = 1;
 
     // Insert in database (registration only)
+    PGconn *db_conn = db_pool_acquire(db_pool);
+    if (!db_conn) {
+        return http_send_error(connection, HTTP_SERVICE_UNAVAILABLE, "Database unavailable");
+    }
     int db_result = db_insert_identity(db_conn, &identity);
+    db_pool_release(db_pool, db_conn);
 
     if (db_result == -3) {
         // Already exists
         snprintf(error_msg, sizeof(error_msg), "Identity already registered. Use /api/keyserver/update to update keys.");
-        json_object_put(payload);
         return http_send_error(connection, HTTP_CONFLICT, error_msg);
     }
 
     if (db_result != 0) {
         LOG_ERROR("Database insert failed");
-        json_object_put(payload);
         return http_send_error(connection, HTTP_INTERNAL_ERROR, "Database error");
     }
 
@@ -123,8 +158,23 @@ enum MHD_Result api_register_handler(struct MHD_Connection *connection, PGconn *
     json_object_object_add(response, "version", json_object_new_int(version));
     json_object_object_add(response, "message", json_object_new_string("Identity registered successfully"));
 
-    json_object_put(payload);
-
     LOG_INFO("Registered: %s (version %d)", dna, version);
     return http_send_json_response(connection, HTTP_OK, response);
 }
+
+enum MHD_Result api_register_handler(struct MHD_Connection *connection, db_pool_t *db_pool,
+                                      const char *upload_data, size_t upload_data_size,
+                                      signature_job_t **verify_job) {
+    if (!*verify_job) {
+        return register_submit(connection, upload_data, upload_data_size, verify_job);
+    }
+
+    // Resumed by the verify worker
+    signature_job_t *job = *verify_job;
+    *verify_job = NULL;
+
+    enum MHD_Result ret = register_finish(connection, db_pool, signature_job_payload(job),
+                                          signature_job_result(job));
+    signature_job_free(job);
+    return ret;
+}
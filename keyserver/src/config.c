@@ -14,6 +14,7 @@ void config_init_defaults(config_t *config) {
     strcpy(config->bind_address, "0.0.0.0");
     config->port = DEFAULT_PORT;
     config->max_connections = DEFAULT_MAX_CONNECTIONS;
+    config->thread_pool_size = 0;
 
     // Database
     strcpy(config->db_host, DEFAULT_DB_HOST);
@@ -23,9 +24,14 @@ void config_init_defaults(config_t *config) {
     strcpy(config->db_password, "");
     config->db_pool_size = 10;
     config->db_pool_timeout = 5;
+    config->count_refresh = 60;
+
+    // Identity cache
+    config->cache_size_mb = 64;
+    config->cache_ttl = 300;
 
     // Security
-    strcpy(config->verify_json_path, "../utils/verify_json");
+    config->verify_threads = 0;
     config->verify_timeout = 5;
     config->max_timestamp_skew = MAX_TIMESTAMP_SKEW;
 
@@ -92,6 +98,8 @@ static void parse_line(const char *line, config_t *config) {
         config->port = atoi(v);
     } else if (strcmp(k, "max_connections") == 0) {
         config->max_connections = atoi(v);
+    } else if (strcmp(k, "thread_pool_size") == 0) {
+        config->thread_pool_size = atoi(v);
     }
     // Database settings
     else if (strcmp(k, "host") == 0) {
@@ -102,14 +110,46 @@ static void parse_line(const char *line, config_t *config) {
         strncpy(config->db_user, v, sizeof(config->db_user) - 1);
     } else if (strcmp(k, "password") == 0) {
         strncpy(config->db_password, v, sizeof(config->db_password) - 1);
+    } else if (strcmp(k, "pool_size") == 0) {
+        config->db_pool_size = atoi(v);
+    } else if (strcmp(k, "pool_timeout") == 0) {
+        config->db_pool_timeout = atoi(v);
+    } else if (strcmp(k, "count_refresh") == 0) {
+        config->count_refresh = atoi(v);
+    }
+    // Identity cache
+    else if (strcmp(k, "cache_size_mb") == 0) {
+        config->cache_size_mb = atoi(v);
+    } else if (strcmp(k, "cache_ttl") == 0) {
+        config->cache_ttl = atoi(v);
     }
     // Security
-    else if (strcmp(k, "verify_json_path") == 0) {
-        strncpy(config->verify_json_path, v, sizeof(config->verify_json_path) - 1);
+    else if (strcmp(k, "verify_threads") == 0) {
+        config->verify_threads = atoi(v);
+    } else if (strcmp(k, "verify_timeout") == 0) {
+        config->verify_timeout = atoi(v);
+    }
+    // Rate limits
+    else if (strcmp(k, "rate_limit_register_count") == 0) {
+        config->rate_limit_register_count = atoi(v);
+    } else if (strcmp(k, "rate_limit_register_period") == 0) {
+        config->rate_limit_register_period = atoi(v);
+    } else if (strcmp(k, "rate_limit_lookup_count") == 0) {
+        config->rate_limit_lookup_count = atoi(v);
+    } else if (strcmp(k, "rate_limit_lookup_period") == 0) {
+        config->rate_limit_lookup_period = atoi(v);
+    } else if (strcmp(k, "rate_limit_list_count") == 0) {
+        config->rate_limit_list_count = atoi(v);
+    } else if (strcmp(k, "rate_limit_list_period") == 0) {
+        config->rate_limit_list_period = atoi(v);
     }
     // Logging
     else if (strcmp(k, "level") == 0) {
         strncpy(config->log_level, v, sizeof(config->log_level) - 1);
+    } else if (strcmp(k, "file") == 0) {
+        strncpy(config->log_file, v, sizeof(config->log_file) - 1);
+    } else if (strcmp(k, "format") == 0) {
+        strncpy(config->log_format, v, sizeof(config->log_format) - 1);
     }
 }
 
@@ -132,8 +172,14 @@ int config_load(const char *filename, config_t *config) {
 void config_print(const config_t *config) {
     printf("Configuration:\n");
     printf("  Server: %s:%d\n", config->bind_address, config->port);
+    printf("  HTTP threads: %d%s\n", config->thread_pool_size,
+           config->thread_pool_size <= 0 ? " (one per CPU core)" : "");
     printf("  Database: %s@%s:%d/%s\n",
            config->db_user, config->db_host, config->db_port, config->db_name);
-    printf("  Verify binary: %s\n", config->verify_json_path);
-    printf("  Log level: %s\n", config->log_level);
+    printf("  DB pool: %d connections, %ds timeout\n", config->db_pool_size, config->db_pool_timeout);
+    printf("  Identity cache: %d MB, %ds ttl\n", config->cache_size_mb, config->cache_ttl);
+    printf("  Verify threads: %d%s, %ds queue timeout\n", config->verify_threads,
+           config->verify_threads <= 0 ? " (one per CPU core)" : "", config->verify_timeout);
+    printf("  Log: %s, %s, %s\n", config->log_level, config->log_format,
+           config->log_file[0] ? config->log_file : "stderr");
 }
@@ -3,6 +3,8 @@
  */
 
 #include "db.h"
+#include "identity_cache.h"
+#include "identity_count.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -84,6 +86,8 @@ int db_insert_identity(PGconn *conn, const identity_t *identity) {
     }
 
     PQclear(res);
+    identity_cache_invalidate(identity->dna);
+    identity_count_add(1);
     LOG_INFO("Registered identity: %s (version %d)", identity->dna, identity->version);
     return 0;
 }
@@ -149,6 +153,7 @@ int db_update_identity(PGconn *conn, const identity_t *identity) {
     }
 
     PQclear(res);
+    identity_cache_invalidate(identity->dna);
     LOG_INFO("Updated identity: %s (version %d)", identity->dna, identity->version);
     return 0;
 }
@@ -215,6 +220,7 @@ int db_insert_or_update_identity(PGconn *conn, const identity_t *identity) {
     }
 
     PQclear(res);
+    identity_cache_invalidate(identity->dna);
     LOG_INFO("Stored identity: %s (version %d)", identity->dna, identity->version);
     return 0;
 }
@@ -259,44 +265,151 @@ int db_lookup_identity(PGconn *conn, const char *dna, identity_t *identity) {
     return 0;
 }
 
-int db_list_identities(PGconn *conn, int limit, int offset, const char *search,
-                       identity_t **identities, int *count) {
+int db_lookup_identities_batch(PGconn *conn, const char **dnas, int dna_count,
+                               identity_t **identities, int *count) {
+    const char *sql =
+        "SELECT dna, dilithium_pub, kyber_pub, cf20pub, "
+        "version, updated_at, sig, schema_version, "
+        "TO_CHAR(registered_at, 'YYYY-MM-DD HH24:MI:SS'), "
+        "TO_CHAR(last_updated, 'YYYY-MM-DD HH24:MI:SS') "
+        "FROM keyserver_identities WHERE dna = ANY($1::text[])";
+
+    *identities = NULL;
+    *count = 0;
+
+    if (dna_count <= 0) {
+        return 0;
+    }
+
+    // Build text[] literal: {"alice","bob",...}
+    size_t array_size = 3;
+    for (int i = 0; i < dna_count; i++) {
+        array_size += strlen(dnas[i]) + 3;
+    }
+
+    char *array = malloc(array_size);
+    if (!array) {
+        return -1;
+    }
+
+    char *p = array;
+    *p++ = '{';
+    for (int i = 0; i < dna_count; i++) {
+        if (i > 0) *p++ = ',';
+        *p++ = '"';
+        size_t len = strlen(dnas[i]);
+        memcpy(p, dnas[i], len);
+        p += len;
+        *p++ = '"';
+    }
+    *p++ = '}';
+    *p = '\0';
+
+    const char *paramValues[1] = {array};
+
+    PGresult *res = PQexecParams(conn, sql, 1, NULL, paramValues,
+                                 NULL, NULL, 0);
+    free(array);
+
+    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+        LOG_ERROR("Batch lookup failed: %s", PQerrorMessage(conn));
+        PQclear(res);
+        return -1;
+    }
+
+    int rows = PQntuples(res);
+    if (rows == 0) {
+        PQclear(res);
+        return 0;
+    }
+
+    *identities = calloc(rows, sizeof(identity_t));
+    if (!*identities) {
+        PQclear(res);
+        return -1;
+    }
+
+    for (int i = 0; i < rows; i++) {
+        identity_t *id = &(*identities)[i];
+        strncpy(id->dna, PQgetvalue(res, i, 0), MAX_DNA_LENGTH);
+        id->dilithium_pub = strdup(PQgetvalue(res, i, 1));
+        id->kyber_pub = strdup(PQgetvalue(res, i, 2));
+        strncpy(id->cf20pub, PQgetvalue(res, i, 3), CF20_ADDRESS_LENGTH);
+        id->version = atoi(PQgetvalue(res, i, 4));
+        id->updated_at = atoi(PQgetvalue(res, i, 5));
+        id->sig = strdup(PQgetvalue(res, i, 6));
+        id->schema_version = atoi(PQgetvalue(res, i, 7));
+        strncpy(id->registered_at, PQgetvalue(res, i, 8), 31);
+        strncpy(id->last_updated, PQgetvalue(res, i, 9), 31);
+    }
+
+    *count = rows;
+    PQclear(res);
+    return 0;
+}
+
+int db_list_identities(PGconn *conn, int limit, const char *after_time, int after_id,
+                       const char *search, identity_t **identities, int *count,
+                       bool *has_more, char *next_after, size_t next_after_size) {
     char sql[1024];
-    const char *paramValues[3];
+    char where[256] = "";
+    const char *paramValues[4];
     int param_count = 0;
 
+    char after_id_str[32], limit_str[32];
+    char search_pattern[2 * MAX_DNA_LENGTH + 2];
+
+    *identities = NULL;
+    *count = 0;
+    *has_more = false;
+
+    // Keyset cursor: rows strictly after (registered_at, id) in list order.
+    // The plain registered_at bound lets idx_registered_at drive the scan.
+    if (after_time) {
+        snprintf(after_id_str, sizeof(after_id_str), "%d", after_id);
+        paramValues[param_count++] = after_time;
+        paramValues[param_count++] = after_id_str;
+        snprintf(where, sizeof(where),
+                 "WHERE registered_at <= $1::timestamp "
+                 "AND (registered_at, id) < ($1::timestamp, $2::integer) ");
+    }
+
     if (search && strlen(search) > 0) {
-        snprintf(sql, sizeof(sql),
-                 "SELECT dna, version, "
-                 "TO_CHAR(registered_at, 'YYYY-MM-DD HH24:MI:SS'), "
-                 "TO_CHAR(last_updated, 'YYYY-MM-DD HH24:MI:SS') "
-                 "FROM keyserver_identities "
-                 "WHERE dna LIKE $1 "
-                 "ORDER BY registered_at DESC LIMIT $2 OFFSET $3");
-
-        char search_pattern[MAX_DNA_LENGTH + 2];
-        snprintf(search_pattern, sizeof(search_pattern), "%s%%", search);
+        if (strlen(search) > MAX_DNA_LENGTH) {
+            LOG_ERROR("List search prefix too long");
+            return -1;
+        }
+
+        // Prefix match: the user's %, _ and \ are literal characters
+        size_t n = 0;
+        for (const char *p = search; *p; p++) {
+            if (*p == '%' || *p == '_' || *p == '\\') {
+                search_pattern[n++] = '\\';
+            }
+            search_pattern[n++] = *p;
+        }
+        search_pattern[n++] = '%';
+        search_pattern[n] = '\0';
+
         paramValues[param_count++] = search_pattern;
-    } else {
-        snprintf(sql, sizeof(sql),
-                 "SELECT dna, version, "
-                 "TO_CHAR(registered_at, 'YYYY-MM-DD HH24:MI:SS'), "
-                 "TO_CHAR(last_updated, 'YYYY-MM-DD HH24:MI:SS') "
-                 "FROM keyserver_identities "
-                 "ORDER BY registered_at DESC LIMIT $1 OFFSET $2");
+        size_t used = strlen(where);
+        snprintf(where + used, sizeof(where) - used, "%s dna LIKE $%d ESCAPE '\\' ",
+                 after_time ? "AND" : "WHERE", param_count);
     }
 
-    char limit_str[32], offset_str[32];
-    snprintf(limit_str, sizeof(limit_str), "%d", limit);
-    snprintf(offset_str, sizeof(offset_str), "%d", offset);
+    // One extra row tells whether another page exists
+    snprintf(limit_str, sizeof(limit_str), "%d", limit + 1);
+    paramValues[param_count++] = limit_str;
 
-    if (search && strlen(search) > 0) {
-        paramValues[param_count++] = limit_str;
-        paramValues[param_count++] = offset_str;
-    } else {
-        paramValues[param_count++] = limit_str;
-        paramValues[param_count++] = offset_str;
-    }
+    snprintf(sql, sizeof(sql),
+             "SELECT id, dna, version, "
+             "TO_CHAR(registered_at, 'YYYY-MM-DD HH24:MI:SS'), "
+             "TO_CHAR(last_updated, 'YYYY-MM-DD HH24:MI:SS'), "
+             "TO_CHAR(registered_at, 'YYYY-MM-DD\"T\"HH24:MI:SS.US') "
+             "FROM keyserver_identities "
+             "%s"
+             "ORDER BY registered_at DESC, id DESC LIMIT $%d",
+             where, param_count);
 
     PGresult *res = PQexecParams(conn, sql, param_count, NULL, paramValues,
                                  NULL, NULL, 0);
@@ -308,14 +421,33 @@ int db_list_identities(PGconn *conn, int limit, int offset, const char *search,
     }
 
     *count = PQntuples(res);
-    *identities = calloc(*count, sizeof(identity_t));
+    if (*count > limit) {
+        *count = limit;
+        *has_more = true;
+    }
+    *identities = calloc(*count > 0 ? *count : 1, sizeof(identity_t));
+    if (!*identities) {
+        PQclear(res);
+        *count = 0;
+        return -1;
+    }
 
     for (int i = 0; i < *count; i++) {
         identity_t *id = &(*identities)[i];
-        strncpy(id->dna, PQgetvalue(res, i, 0), MAX_DNA_LENGTH);
-        id->version = atoi(PQgetvalue(res, i, 1));
-        strncpy(id->registered_at, PQgetvalue(res, i, 2), 31);
-        strncpy(id->last_updated, PQgetvalue(res, i, 3), 31);
+        id->id = atoi(PQgetvalue(res, i, 0));
+        strncpy(id->dna, PQgetvalue(res, i, 1), MAX_DNA_LENGTH);
+        id->version = atoi(PQgetvalue(res, i, 2));
+        strncpy(id->registered_at, PQgetvalue(res, i, 3), 31);
+        strncpy(id->last_updated, PQgetvalue(res, i, 4), 31);
+    }
+
+    // Cursor of the last row: "<registered_at with microseconds>,<id>"
+    if (next_after && next_after_size > 0) {
+        next_after[0] = '\0';
+        if (*count > 0) {
+            snprintf(next_after, next_after_size, "%s,%s",
+                     PQgetvalue(res, *count - 1, 5), PQgetvalue(res, *count - 1, 0));
+        }
     }
 
     PQclear(res);
@@ -339,6 +471,26 @@ int db_count_identities(PGconn *conn) {
     return count;
 }
 
+int64_t db_estimate_identities(PGconn *conn) {
+    // Planner estimate (maintained by VACUUM/ANALYZE); -1 if never analyzed
+    const char *sql =
+        "SELECT reltuples::bigint FROM pg_class "
+        "WHERE oid = 'keyserver_identities'::regclass";
+
+    PGresult *res = PQexec(conn, sql);
+
+    if (PQresultStatus(res) != PGRES_TUPLES_OK || PQntuples(res) == 0) {
+        LOG_ERROR("Count estimate failed: %s", PQerrorMessage(conn));
+        PQclear(res);
+        return -1;
+    }
+
+    int64_t estimate = atoll(PQgetvalue(res, 0, 0));
+    PQclear(res);
+
+    return estimate;
+}
+
 void db_free_identity(identity_t *identity) {
     if (identity) {
         if (identity->dilithium_pub) free(identity->dilithium_pub);
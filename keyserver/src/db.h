@@ -61,27 +61,60 @@ int db_insert_or_update_identity(PGconn *conn, const identity_t *identity);
 int db_lookup_identity(PGconn *conn, const char *dna, identity_t *identity);
 
 /**
- * List all identities with pagination
+ * Lookup multiple identities by DNA handle in one query
+ *
+ * Handles that are not registered are simply absent from the result.
+ *
+ * @param conn: Database connection
+ * @param dnas: Array of DNA handle strings (must be validated)
+ * @param dna_count: Number of handles
+ * @param identities: Array to populate with results (caller frees with db_free_identities)
+ * @param count: Number of results returned
+ * @return 0 on success, -1 on error
+ */
+int db_lookup_identities_batch(PGconn *conn, const char **dnas, int dna_count,
+                               identity_t **identities, int *count);
+
+/**
+ * List identities, newest registration first (keyset pagination)
+ *
+ * Pages are continued from a cursor instead of an offset, so every page
+ * costs the same index range scan.
  *
  * @param conn: Database connection
  * @param limit: Maximum number of results
- * @param offset: Offset for pagination
- * @param search: Optional search prefix (NULL for all)
+ * @param after_time: Cursor registered_at ("YYYY-MM-DDTHH:MM:SS.ffffff"), NULL for the first page
+ * @param after_id: Cursor id (ignored without after_time)
+ * @param search: Optional literal DNA prefix, at most MAX_DNA_LENGTH (NULL for all)
  * @param identities: Array to populate with results
  * @param count: Number of results returned
+ * @param has_more: Output true if rows remain after this page
+ * @param next_after: Output cursor of the last row ("<registered_at>,<id>", empty if none)
+ * @param next_after_size: Size of next_after buffer
  * @return 0 on success, -1 on error
  */
-int db_list_identities(PGconn *conn, int limit, int offset, const char *search,
-                       identity_t **identities, int *count);
+int db_list_identities(PGconn *conn, int limit, const char *after_time, int after_id,
+                       const char *search, identity_t **identities, int *count,
+                       bool *has_more, char *next_after, size_t next_after_size);
 
 /**
  * Get total count of identities
  *
+ * Scans the whole table; prefer db_estimate_identities on hot paths.
+ *
  * @param conn: Database connection
  * @return Count or -1 on error
  */
 int db_count_identities(PGconn *conn);
 
+/**
+ * Get planner estimate of identity count (constant time)
+ *
+ * @param conn: Database connection
+ * @return Estimate, or -1 if the table has not been analyzed yet or on error
+ */
+int64_t db_estimate_identities(PGconn *conn);
+
 /**
  * Free identity structure
  *
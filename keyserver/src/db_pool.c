@@ -0,0 +1,213 @@
+/*
+ * Database Connection Pool
+ */
+
+#include "db_pool.h"
+#include "db.h"
+#include "metrics.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+typedef struct {
+    PGconn *conn;        // NULL = not connected
+    bool in_use;         // Checked out (or being connected)
+    time_t last_used;
+} db_pool_slot_t;
+
+struct db_pool {
+    pthread_mutex_t lock;
+    pthread_cond_t available;
+    db_pool_slot_t *slots;
+    int size;
+    int timeout;         // Checkout wait (seconds)
+    const config_t *config;
+};
+
+db_pool_t* db_pool_create(const config_t *config) {
+    db_pool_t *pool = calloc(1, sizeof(db_pool_t));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->size = config->db_pool_size > 0 ? config->db_pool_size : 1;
+    pool->timeout = config->db_pool_timeout > 0 ? config->db_pool_timeout : 1;
+    pool->config = config;
+    pool->slots = calloc((size_t)pool->size, sizeof(db_pool_slot_t));
+    if (!pool->slots) {
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->available, NULL);
+
+    // Fail at startup if the database is unreachable; the rest open on demand
+    pool->slots[0].conn = db_connect(config);
+    if (!pool->slots[0].conn) {
+        db_pool_destroy(pool);
+        return NULL;
+    }
+    pool->slots[0].last_used = time(NULL);
+
+    LOG_INFO("Database pool: %d connections max, %ds checkout timeout", pool->size, pool->timeout);
+    return pool;
+}
+
+void db_pool_destroy(db_pool_t *pool) {
+    if (!pool) {
+        return;
+    }
+
+    for (int i = 0; i < pool->size; i++) {
+        db_disconnect(pool->slots[i].conn);
+    }
+
+    pthread_cond_destroy(&pool->available);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->slots);
+    free(pool);
+}
+
+/**
+ * Make a checked-out connection usable (called without the pool lock)
+ *
+ * Works on the caller's copy of the slot's connection; the caller stores
+ * the result back under the lock, so db_pool_stats never sees a torn update.
+ *
+ * @param conn: In: slot connection (NULL = not connected). Out: usable connection or NULL
+ * @param last_used: When the connection was last released
+ * @return 0 if healthy, -1 if the connection is gone
+ */
+static int db_pool_check(db_pool_t *pool, PGconn **conn, time_t last_used) {
+    if (!*conn) {
+        *conn = db_connect(pool->config);
+        return *conn ? 0 : -1;
+    }
+
+    // Idle connections may have been dropped by the server or a firewall
+    if (PQstatus(*conn) == CONNECTION_OK &&
+        time(NULL) - last_used > DB_POOL_HEALTHCHECK_IDLE) {
+        PGresult *res = PQexec(*conn, "SELECT 1");
+        PQclear(res);
+    }
+
+    if (PQstatus(*conn) != CONNECTION_OK) {
+        LOG_WARN("Database connection lost, reconnecting");
+        PQreset(*conn);
+        if (PQstatus(*conn) != CONNECTION_OK) {
+            LOG_ERROR("Database reconnect failed: %s", PQerrorMessage(*conn));
+            db_disconnect(*conn);
+            *conn = NULL;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+PGconn* db_pool_acquire(db_pool_t *pool) {
+    if (!pool) {
+        return NULL;
+    }
+
+    uint64_t wait_start = metrics_now_us();
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += pool->timeout;
+
+    pthread_mutex_lock(&pool->lock);
+
+    db_pool_slot_t *slot = NULL;
+    while (!slot) {
+        // Prefer an open connection, else a free slot to connect
+        db_pool_slot_t *empty = NULL;
+        for (int i = 0; i < pool->size; i++) {
+            if (pool->slots[i].in_use) {
+                continue;
+            }
+            if (pool->slots[i].conn) {
+                slot = &pool->slots[i];
+                break;
+            }
+            if (!empty) {
+                empty = &pool->slots[i];
+            }
+        }
+        if (!slot) {
+            slot = empty;
+        }
+        if (slot) {
+            break;
+        }
+
+        if (pthread_cond_timedwait(&pool->available, &pool->lock, &deadline) == ETIMEDOUT) {
+            pthread_mutex_unlock(&pool->lock);
+            metrics_count(METRICS_DB_POOL_TIMEOUT);
+            metrics_observe(METRICS_HIST_DB_POOL_WAIT, metrics_now_us() - wait_start);
+            LOG_WARN("Database pool exhausted (%d connections busy for %ds)", pool->size, pool->timeout);
+            return NULL;
+        }
+    }
+
+    // The slot stays in_use (ours alone) until the check below is published
+    slot->in_use = true;
+    PGconn *conn = slot->conn;
+    time_t last_used = slot->last_used;
+    pthread_mutex_unlock(&pool->lock);
+    metrics_observe(METRICS_HIST_DB_POOL_WAIT, metrics_now_us() - wait_start);
+
+    // Connect / health-check outside the lock
+    int rc = db_pool_check(pool, &conn, last_used);
+
+    pthread_mutex_lock(&pool->lock);
+    slot->conn = conn;
+    if (rc != 0) {
+        slot->in_use = false;
+        pthread_cond_signal(&pool->available);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return rc == 0 ? conn : NULL;
+}
+
+void db_pool_release(db_pool_t *pool, PGconn *conn) {
+    if (!pool || !conn) {
+        return;
+    }
+
+    // Never hand out a connection stuck inside a transaction
+    PGTransactionStatusType txn = PQtransactionStatus(conn);
+    if (txn == PQTRANS_INTRANS || txn == PQTRANS_INERROR) {
+        PGresult *res = PQexec(conn, "ROLLBACK");
+        PQclear(res);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    for (int i = 0; i < pool->size; i++) {
+        if (pool->slots[i].conn == conn) {
+            pool->slots[i].in_use = false;
+            pool->slots[i].last_used = time(NULL);
+            break;
+        }
+    }
+    pthread_cond_signal(&pool->available);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void db_pool_stats(db_pool_t *pool, int *size, int *open, int *in_use) {
+    int n_open = 0;
+    int n_in_use = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (int i = 0; i < pool->size; i++) {
+        if (pool->slots[i].conn) n_open++;
+        if (pool->slots[i].in_use) n_in_use++;
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    if (size) *size = pool->size;
+    if (open) *open = n_open;
+    if (in_use) *in_use = n_in_use;
+}
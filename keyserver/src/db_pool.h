@@ -0,0 +1,66 @@
+/*
+ * Database Connection Pool
+ *
+ * Fixed-size pool of PostgreSQL connections (config db_pool_size). Each
+ * request checks out one connection for its exclusive use, so concurrent
+ * requests never share a PGconn. Connections are opened on demand,
+ * health-checked on checkout and reconnected when broken.
+ */
+
+#ifndef DB_POOL_H
+#define DB_POOL_H
+
+#include "keyserver.h"
+#include <libpq-fe.h>
+
+// Connections idle longer than this are pinged before being handed out
+#define DB_POOL_HEALTHCHECK_IDLE 30  // seconds
+
+typedef struct db_pool db_pool_t;
+
+/**
+ * Create pool and open its first connection
+ *
+ * @param config: Configuration (DB connection details, db_pool_size, db_pool_timeout)
+ * @return Pool or NULL if the database is unreachable
+ */
+db_pool_t* db_pool_create(const config_t *config);
+
+/**
+ * Close all connections and free pool
+ *
+ * All connections must have been released.
+ *
+ * @param pool: Pool
+ */
+void db_pool_destroy(db_pool_t *pool);
+
+/**
+ * Check out a healthy connection
+ *
+ * Waits up to db_pool_timeout seconds when all connections are in use.
+ *
+ * @param pool: Pool
+ * @return Connection (return with db_pool_release) or NULL on timeout/DB failure
+ */
+PGconn* db_pool_acquire(db_pool_t *pool);
+
+/**
+ * Return connection to pool
+ *
+ * @param pool: Pool
+ * @param conn: Connection from db_pool_acquire (NULL is ignored)
+ */
+void db_pool_release(db_pool_t *pool, PGconn *conn);
+
+/**
+ * Get pool usage
+ *
+ * @param pool: Pool
+ * @param size: Maximum connections (may be NULL)
+ * @param open: Connections currently open (may be NULL)
+ * @param in_use: Connections currently checked out (may be NULL)
+ */
+void db_pool_stats(db_pool_t *pool, int *size, int *open, int *in_use);
+
+#endif // DB_POOL_H
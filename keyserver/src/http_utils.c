@@ -4,9 +4,75 @@
 
 #include "http_utils.h"
 #include "keyserver.h"
+#include "metrics.h"
 #include <string.h>
 #include <arpa/inet.h>
 
+// Send headers shared by all replies (takes over response)
+static enum MHD_Result queue_response(struct MHD_Connection *connection, int status_code,
+                                      const char *content_type, const char *etag,
+                                      struct MHD_Response *response) {
+    if (!response) {
+        return MHD_NO;
+    }
+
+    metrics_request_end(status_code);
+
+    if (content_type) {
+        MHD_add_response_header(response, "Content-Type", content_type);
+    }
+    if (etag) {
+        // Clients must revalidate, which is a 304 while the version is unchanged
+        MHD_add_response_header(response, "ETag", etag);
+        MHD_add_response_header(response, "Cache-Control", "no-cache");
+    }
+    MHD_add_response_header(response, "Access-Control-Allow-Origin", "*");
+
+    enum MHD_Result ret = MHD_queue_response(connection, status_code, response);
+
+    MHD_destroy_response(response);
+
+    return ret;
+}
+
+enum MHD_Result http_send_owned(struct MHD_Connection *connection, int status_code,
+                                const char *content_type, const char *etag,
+                                char *body, size_t len, void (*free_cb)(void *body)) {
+#if MHD_VERSION >= 0x00097100
+    struct MHD_Response *response =
+        MHD_create_response_from_buffer_with_free_callback(len, body, free_cb);
+    if (!response) {
+        free_cb(body);
+    }
+#else
+    // No free callback before 0.9.71: copy once
+    struct MHD_Response *response = MHD_create_response_from_buffer(
+        len,
+        body,
+        MHD_RESPMEM_MUST_COPY
+    );
+    free_cb(body);
+#endif
+
+    return queue_response(connection, status_code, content_type, etag, response);
+}
+
+enum MHD_Result http_send_json_owned(struct MHD_Connection *connection, int status_code,
+                                     char *body, size_t len, void (*free_cb)(void *body)) {
+    return http_send_owned(connection, status_code, "application/json", NULL, body, len, free_cb);
+}
+
+enum MHD_Result http_send_json_writer(struct MHD_Connection *connection,
+                                      int status_code, json_writer_t *w) {
+    size_t len;
+    char *body = json_writer_detach(w, &len);
+    if (!body) {
+        return MHD_NO;
+    }
+
+    return http_send_json_owned(connection, status_code, body, len, json_writer_release_buffer);
+}
+
 enum MHD_Result http_send_json_response(struct MHD_Connection *connection,
                                          int status_code, json_object *json_obj) {
     const char *json_str = json_object_to_json_string_ext(json_obj,
@@ -18,12 +84,7 @@ enum MHD_Result http_send_json_response(struct MHD_Connection *connection,
         MHD_RESPMEM_MUST_COPY
     );
 
-    MHD_add_response_header(response, "Content-Type", "application/json");
-    MHD_add_response_header(response, "Access-Control-Allow-Origin", "*");
-
-    enum MHD_Result ret = MHD_queue_response(connection, status_code, response);
-
-    MHD_destroy_response(response);
+    enum MHD_Result ret = queue_response(connection, status_code, "application/json", NULL, response);
     json_object_put(json_obj);
 
     return ret;
@@ -31,19 +92,75 @@ enum MHD_Result http_send_json_response(struct MHD_Connection *connection,
 
 enum MHD_Result http_send_error(struct MHD_Connection *connection,
                                  int status_code, const char *error_msg) {
-    json_object *response = json_object_new_object();
-    json_object_object_add(response, "success", json_object_new_boolean(false));
-    json_object_object_add(response, "error", json_object_new_string(error_msg));
-
-    return http_send_json_response(connection, status_code, response);
+    json_writer_t w;
+    json_writer_init(&w);
+    json_writer_object_begin(&w);
+    json_writer_key(&w, "success");
+    json_writer_bool(&w, false);
+    json_writer_key(&w, "error");
+    json_writer_string(&w, error_msg);
+    json_writer_object_end(&w);
+
+    return http_send_json_writer(connection, status_code, &w);
 }
 
 enum MHD_Result http_send_success(struct MHD_Connection *connection, const char *message) {
-    json_object *response = json_object_new_object();
-    json_object_object_add(response, "success", json_object_new_boolean(true));
-    json_object_object_add(response, "message", json_object_new_string(message));
+    json_writer_t w;
+    json_writer_init(&w);
+    json_writer_object_begin(&w);
+    json_writer_key(&w, "success");
+    json_writer_bool(&w, true);
+    json_writer_key(&w, "message");
+    json_writer_string(&w, message);
+    json_writer_object_end(&w);
+
+    return http_send_json_writer(connection, HTTP_OK, &w);
+}
 
-    return http_send_json_response(connection, HTTP_OK, response);
+enum MHD_Result http_send_not_modified(struct MHD_Connection *connection, const char *etag) {
+    struct MHD_Response *response = MHD_create_response_from_buffer(0, NULL, MHD_RESPMEM_PERSISTENT);
+    return queue_response(connection, HTTP_NOT_MODIFIED, NULL, etag, response);
+}
+
+bool http_etag_matches(const char *header, const char *etag) {
+    if (!header) {
+        return false;
+    }
+
+    size_t etag_len = strlen(etag);
+    const char *p = header;
+    while (*p) {
+        while (*p == ' ' || *p == '\t' || *p == ',') {
+            p++;
+        }
+        if (*p == '*') {
+            return true;
+        }
+        // Weak comparison: W/"x" matches "x"
+        if (p[0] == 'W' && p[1] == '/') {
+            p += 2;
+        }
+
+        const char *end = p;
+        if (*end == '"') {
+            end = strchr(end + 1, '"');
+            end = end ? end + 1 : p + strlen(p);
+        } else {
+            while (*end && *end != ',') {
+                end++;
+            }
+        }
+
+        if ((size_t)(end - p) == etag_len && memcmp(p, etag, etag_len) == 0) {
+            return true;
+        }
+        p = end;
+        while (*p && *p != ',') {
+            p++;
+        }
+    }
+
+    return false;
 }
 
 int http_get_client_ip(struct MHD_Connection *connection,
@@ -91,3 +208,19 @@ json_object* http_parse_json_post(const char *upload_data,
 
     return obj;
 }
+
+static void resume_connection(void *arg) {
+    MHD_resume_connection((struct MHD_Connection*)arg);
+}
+
+enum MHD_Result http_suspend_until_verified(struct MHD_Connection *connection,
+                                            signature_job_t *job) {
+    MHD_suspend_connection(connection);
+
+    // Finished before the callback was registered: resume right away
+    if (!signature_job_on_complete(job, resume_connection, connection)) {
+        MHD_resume_connection(connection);
+    }
+
+    return MHD_YES;
+}
@@ -7,6 +7,8 @@
 
 #include <microhttpd.h>
 #include <json-c/json.h>
+#include "signature.h"
+#include "json_writer.h"
 
 /**
  * Send JSON response
@@ -19,6 +21,75 @@
 enum MHD_Result http_send_json_response(struct MHD_Connection *connection,
                                          int status_code, json_object *json_obj);
 
+/**
+ * Send a body without copying it
+ *
+ * MHD reads the body in place and calls free_cb(body) once the response is
+ * gone (immediately if it could not be created).
+ *
+ * @param connection: MHD connection
+ * @param status_code: HTTP status code
+ * @param content_type: Content-Type header value
+ * @param etag: ETag header value including quotes (NULL = none)
+ * @param body: Response body
+ * @param len: Length of body
+ * @param free_cb: Releases body
+ * @return MHD result code
+ */
+enum MHD_Result http_send_owned(struct MHD_Connection *connection, int status_code,
+                                const char *content_type, const char *etag,
+                                char *body, size_t len, void (*free_cb)(void *body));
+
+/**
+ * Send serialized JSON without copying it
+ *
+ * MHD reads the body in place and calls free_cb(body) once the response is
+ * gone (immediately if it could not be created).
+ *
+ * @param connection: MHD connection
+ * @param status_code: HTTP status code
+ * @param body: JSON text
+ * @param len: Length of body
+ * @param free_cb: Releases body
+ * @return MHD result code
+ */
+enum MHD_Result http_send_json_owned(struct MHD_Connection *connection, int status_code,
+                                     char *body, size_t len, void (*free_cb)(void *body));
+
+/**
+ * Send JSON built with a json_writer_t
+ *
+ * The writer's buffer is handed to MHD and returns to the thread's spare
+ * slot when the response is freed.
+ *
+ * @param connection: MHD connection
+ * @param status_code: HTTP status code
+ * @param w: Writer (empty afterwards)
+ * @return MHD result code
+ */
+enum MHD_Result http_send_json_writer(struct MHD_Connection *connection,
+                                      int status_code, json_writer_t *w);
+
+/**
+ * Send 304 Not Modified
+ *
+ * @param connection: MHD connection
+ * @param etag: Current ETag including quotes
+ * @return MHD result code
+ */
+enum MHD_Result http_send_not_modified(struct MHD_Connection *connection, const char *etag);
+
+/**
+ * Check an If-None-Match header against an ETag
+ *
+ * Handles lists, "*" and weak (W/) validators.
+ *
+ * @param header: If-None-Match value (NULL = no header)
+ * @param etag: Current ETag including quotes
+ * @return true if the client's copy is current
+ */
+bool http_etag_matches(const char *header, const char *etag);
+
 /**
  * Send error response
  *
@@ -60,4 +131,17 @@ int http_get_client_ip(struct MHD_Connection *connection,
 json_object* http_parse_json_post(const char *upload_data,
                                   size_t upload_data_size);
 
+/**
+ * Suspend connection until a signature verification finishes
+ *
+ * MHD calls the request handler again once the job is done, so the
+ * HTTP thread can serve other connections meanwhile.
+ *
+ * @param connection: MHD connection (daemon needs suspend/resume enabled)
+ * @param job: Submitted verification job
+ * @return MHD result code
+ */
+enum MHD_Result http_suspend_until_verified(struct MHD_Connection *connection,
+                                            signature_job_t *job);
+
 #endif // HTTP_UTILS_H
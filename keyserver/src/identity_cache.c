@@ -0,0 +1,390 @@
+/*
+ * Identity Cache
+ */
+
+#include "identity_cache.h"
+#include "db.h"
+#include "metrics.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+
+typedef struct cache_entry {
+    char dna[MAX_DNA_LENGTH + 1];
+    uint32_t hash;
+    time_t cached_at;
+    int referenced;                   // Set on hit (atomic), cleared by the clock hand
+    identity_cache_blob_t *blob;
+    struct cache_entry *hnext;        // Bucket chain
+    struct cache_entry *prev, *next;  // Clock order, oldest first
+} cache_entry_t;
+
+typedef struct {
+    pthread_rwlock_t lock;
+    cache_entry_t *buckets[IDENTITY_CACHE_BUCKETS];
+    cache_entry_t *clock_head;
+    cache_entry_t *clock_tail;
+    size_t bytes;
+    int entries;
+    uint64_t generation;              // Bumped by every invalidation
+} cache_shard_t;
+
+static cache_shard_t shards[IDENTITY_CACHE_SHARDS];
+static bool cache_enabled = false;
+static size_t shard_max_bytes = 0;
+static int cache_ttl = 0;
+
+static pthread_t listen_tid;
+static bool listen_started = false;
+static int listen_running = 0;
+
+// FNV-1a
+static uint32_t dna_hash(const char *dna) {
+    uint32_t h = 2166136261u;
+    for (const unsigned char *p = (const unsigned char*)dna; *p; p++) {
+        h ^= *p;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static cache_shard_t* shard_for(uint32_t hash) {
+    return &shards[hash & (IDENTITY_CACHE_SHARDS - 1)];
+}
+
+static cache_entry_t** bucket_for(cache_shard_t *shard, uint32_t hash) {
+    // Shard index uses the low bits, bucket index the next ones
+    return &shard->buckets[(hash / IDENTITY_CACHE_SHARDS) & (IDENTITY_CACHE_BUCKETS - 1)];
+}
+
+static size_t entry_cost(size_t len) {
+    return sizeof(cache_entry_t) + sizeof(identity_cache_blob_t) + len;
+}
+
+static cache_entry_t* shard_find(cache_shard_t *shard, const char *dna, uint32_t hash) {
+    for (cache_entry_t *e = *bucket_for(shard, hash); e; e = e->hnext) {
+        if (e->hash == hash && strcmp(e->dna, dna) == 0) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+// Unlink and free entry (write lock held)
+static void shard_remove(cache_shard_t *shard, cache_entry_t *entry) {
+    cache_entry_t **pp = bucket_for(shard, entry->hash);
+    while (*pp != entry) {
+        pp = &(*pp)->hnext;
+    }
+    *pp = entry->hnext;
+
+    if (entry->prev) entry->prev->next = entry->next;
+    else shard->clock_head = entry->next;
+    if (entry->next) entry->next->prev = entry->prev;
+    else shard->clock_tail = entry->prev;
+
+    shard->bytes -= entry_cost(entry->blob->len);
+    shard->entries--;
+    identity_cache_release(entry->blob);
+    free(entry);
+}
+
+static void clock_append(cache_shard_t *shard, cache_entry_t *entry) {
+    entry->next = NULL;
+    entry->prev = shard->clock_tail;
+    if (shard->clock_tail) shard->clock_tail->next = entry;
+    else shard->clock_head = entry;
+    shard->clock_tail = entry;
+}
+
+// Evict until `needed` more bytes fit (write lock held)
+static void shard_make_room(cache_shard_t *shard, size_t needed) {
+    while (shard->clock_head && shard->bytes + needed > shard_max_bytes) {
+        cache_entry_t *e = shard->clock_head;
+
+        // Second chance for entries hit since the hand last passed
+        if (__atomic_exchange_n(&e->referenced, 0, __ATOMIC_RELAXED) && e->next) {
+            shard->clock_head = e->next;
+            shard->clock_head->prev = NULL;
+            clock_append(shard, e);
+            continue;
+        }
+        shard_remove(shard, e);
+    }
+}
+
+static void shard_clear(cache_shard_t *shard) {
+    while (shard->clock_head) {
+        shard_remove(shard, shard->clock_head);
+    }
+    shard->generation++;
+}
+
+int identity_cache_init(size_t max_bytes, int ttl) {
+    for (int i = 0; i < IDENTITY_CACHE_SHARDS; i++) {
+        memset(&shards[i], 0, sizeof(cache_shard_t));
+        if (pthread_rwlock_init(&shards[i].lock, NULL) != 0) {
+            return -1;
+        }
+    }
+
+    cache_enabled = max_bytes > 0;
+    shard_max_bytes = max_bytes / IDENTITY_CACHE_SHARDS;
+    cache_ttl = ttl > 0 ? ttl : 0;
+
+    if (cache_enabled) {
+        LOG_INFO("Identity cache: %zu MB, %d shards, ttl %ds",
+                 max_bytes / (1024 * 1024), IDENTITY_CACHE_SHARDS, cache_ttl);
+    } else {
+        LOG_INFO("Identity cache disabled");
+    }
+    return 0;
+}
+
+void identity_cache_cleanup(void) {
+    if (listen_started) {
+        __atomic_store_n(&listen_running, 0, __ATOMIC_RELEASE);
+        pthread_join(listen_tid, NULL);
+        listen_started = false;
+    }
+
+    for (int i = 0; i < IDENTITY_CACHE_SHARDS; i++) {
+        shard_clear(&shards[i]);
+        pthread_rwlock_destroy(&shards[i].lock);
+    }
+    cache_enabled = false;
+}
+
+identity_cache_blob_t* identity_cache_get(const char *dna) {
+    if (!cache_enabled) {
+        return NULL;
+    }
+
+    uint32_t hash = dna_hash(dna);
+    cache_shard_t *shard = shard_for(hash);
+    identity_cache_blob_t *blob = NULL;
+
+    pthread_rwlock_rdlock(&shard->lock);
+    cache_entry_t *e = shard_find(shard, dna, hash);
+    if (e && (cache_ttl == 0 || time(NULL) - e->cached_at < cache_ttl)) {
+        __atomic_store_n(&e->referenced, 1, __ATOMIC_RELAXED);
+        blob = e->blob;
+        __atomic_add_fetch(&blob->refs, 1, __ATOMIC_RELAXED);
+    }
+    pthread_rwlock_unlock(&shard->lock);
+
+    metrics_count(blob ? METRICS_CACHE_HIT : METRICS_CACHE_MISS);
+    return blob;
+}
+
+identity_cache_blob_t* identity_cache_blob_create(const char *data, size_t len) {
+    identity_cache_blob_t *blob = malloc(sizeof(identity_cache_blob_t) + len);
+    if (!blob) {
+        return NULL;
+    }
+    blob->refs = 1;
+    blob->version = 0;
+    blob->len = len;
+    memcpy(blob->data, data, len);
+    return blob;
+}
+
+void identity_cache_release(identity_cache_blob_t *blob) {
+    if (blob && __atomic_sub_fetch(&blob->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(blob);
+    }
+}
+
+void identity_cache_release_data(void *data) {
+    identity_cache_release((identity_cache_blob_t*)((char*)data - offsetof(identity_cache_blob_t, data)));
+}
+
+uint64_t identity_cache_generation(const char *dna) {
+    cache_shard_t *shard = shard_for(dna_hash(dna));
+
+    pthread_rwlock_rdlock(&shard->lock);
+    uint64_t generation = shard->generation;
+    pthread_rwlock_unlock(&shard->lock);
+
+    return generation;
+}
+
+void identity_cache_put(const char *dna, identity_cache_blob_t *blob, uint64_t generation) {
+    if (!cache_enabled || strlen(dna) > MAX_DNA_LENGTH || entry_cost(blob->len) > shard_max_bytes) {
+        return;
+    }
+
+    cache_entry_t *entry = calloc(1, sizeof(cache_entry_t));
+    if (!entry) {
+        return;
+    }
+    __atomic_add_fetch(&blob->refs, 1, __ATOMIC_RELAXED);
+
+    strcpy(entry->dna, dna);
+    entry->hash = dna_hash(dna);
+    entry->cached_at = time(NULL);
+    entry->blob = blob;
+
+    cache_shard_t *shard = shard_for(entry->hash);
+    pthread_rwlock_wrlock(&shard->lock);
+
+    // Written or invalidated while the caller was querying
+    if (shard->generation != generation) {
+        pthread_rwlock_unlock(&shard->lock);
+        identity_cache_release(blob);
+        free(entry);
+        return;
+    }
+
+    cache_entry_t *old = shard_find(shard, dna, entry->hash);
+    if (old) {
+        shard_remove(shard, old);
+    }
+    shard_make_room(shard, entry_cost(blob->len));
+
+    cache_entry_t **bucket = bucket_for(shard, entry->hash);
+    entry->hnext = *bucket;
+    *bucket = entry;
+    clock_append(shard, entry);
+    shard->bytes += entry_cost(blob->len);
+    shard->entries++;
+
+    pthread_rwlock_unlock(&shard->lock);
+}
+
+void identity_cache_invalidate(const char *dna) {
+    if (!cache_enabled) {
+        return;
+    }
+
+    uint32_t hash = dna_hash(dna);
+    cache_shard_t *shard = shard_for(hash);
+
+    pthread_rwlock_wrlock(&shard->lock);
+    cache_entry_t *e = shard_find(shard, dna, hash);
+    if (e) {
+        shard_remove(shard, e);
+    }
+    shard->generation++;
+    pthread_rwlock_unlock(&shard->lock);
+}
+
+void identity_cache_clear(void) {
+    if (!cache_enabled) {
+        return;
+    }
+
+    for (int i = 0; i < IDENTITY_CACHE_SHARDS; i++) {
+        pthread_rwlock_wrlock(&shards[i].lock);
+        shard_clear(&shards[i]);
+        pthread_rwlock_unlock(&shards[i].lock);
+    }
+}
+
+void identity_cache_stats(int *entries, size_t *bytes, uint64_t *hits, uint64_t *misses) {
+    int total_entries = 0;
+    size_t total_bytes = 0;
+
+    for (int i = 0; i < IDENTITY_CACHE_SHARDS; i++) {
+        pthread_rwlock_rdlock(&shards[i].lock);
+        total_entries += shards[i].entries;
+        total_bytes += shards[i].bytes;
+        pthread_rwlock_unlock(&shards[i].lock);
+    }
+
+    if (entries) *entries = total_entries;
+    if (bytes) *bytes = total_bytes;
+    if (hits) *hits = metrics_counter_total(METRICS_CACHE_HIT);
+    if (misses) *misses = metrics_counter_total(METRICS_CACHE_MISS);
+}
+
+// ============================================================================
+// NOTIFY LISTENER
+// ============================================================================
+
+static PGconn* listen_connect(const config_t *config) {
+    PGconn *conn = db_connect(config);
+    if (!conn) {
+        return NULL;
+    }
+
+    PGresult *res = PQexec(conn, "LISTEN " IDENTITY_CACHE_CHANNEL);
+    if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+        LOG_ERROR("LISTEN failed: %s", PQerrorMessage(conn));
+        PQclear(res);
+        db_disconnect(conn);
+        return NULL;
+    }
+    PQclear(res);
+
+    return conn;
+}
+
+static void* listen_thread(void *arg) {
+    const config_t *config = arg;
+    PGconn *conn = NULL;
+    int retry_wait = 0;
+
+    while (__atomic_load_n(&listen_running, __ATOMIC_ACQUIRE)) {
+        if (!conn) {
+            if (retry_wait > 0) {
+                retry_wait--;
+                sleep(1);
+                continue;
+            }
+            conn = listen_connect(config);
+            if (!conn) {
+                retry_wait = 5;
+                continue;
+            }
+            // Writes from other instances may have been missed while disconnected
+            identity_cache_clear();
+        }
+
+        struct pollfd pfd = { .fd = PQsocket(conn), .events = POLLIN, .revents = 0 };
+        int rc = poll(&pfd, 1, 1000);
+        if (rc == 0 || (rc < 0 && errno == EINTR)) {
+            continue;
+        }
+
+        if (rc < 0 || !PQconsumeInput(conn)) {
+            LOG_WARN("Identity cache listener lost connection: %s", PQerrorMessage(conn));
+            db_disconnect(conn);
+            conn = NULL;
+            identity_cache_clear();
+            continue;
+        }
+
+        PGnotify *notify;
+        while ((notify = PQnotifies(conn)) != NULL) {
+            if (notify->extra && notify->extra[0]) {
+                identity_cache_invalidate(notify->extra);
+            } else {
+                identity_cache_clear();
+            }
+            PQfreemem(notify);
+        }
+    }
+
+    db_disconnect(conn);
+    return NULL;
+}
+
+int identity_cache_listen_start(const config_t *config) {
+    if (!cache_enabled || listen_started) {
+        return 0;
+    }
+
+    listen_running = 1;
+    if (pthread_create(&listen_tid, NULL, listen_thread, (void*)config) != 0) {
+        LOG_ERROR("Failed to start identity cache listener");
+        listen_running = 0;
+        return -1;
+    }
+    listen_started = true;
+
+    return 0;
+}
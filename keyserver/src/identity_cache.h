@@ -0,0 +1,133 @@
+/*
+ * Identity Cache
+ *
+ * In-memory cache of GET /lookup responses, keyed by DNA handle. Entries
+ * hold the serialized JSON body, so a hit only copies bytes. The table is
+ * split into shards with a read-write lock each; lookups take the read
+ * lock only. Memory is bounded by cache_size_mb (clock eviction per shard).
+ *
+ * Entries are dropped when this process writes an identity, when
+ * PostgreSQL sends a NOTIFY on IDENTITY_CACHE_CHANNEL (writes from other
+ * keyserver instances), and after cache_ttl seconds as a backstop.
+ */
+
+#ifndef IDENTITY_CACHE_H
+#define IDENTITY_CACHE_H
+
+#include "keyserver.h"
+#include <stddef.h>
+
+#define IDENTITY_CACHE_SHARDS 16           // Power of two
+#define IDENTITY_CACHE_BUCKETS 1024        // Hash buckets per shard (power of two)
+#define IDENTITY_CACHE_CHANNEL "keyserver_identities"
+
+// Cached response body (immutable, reference counted)
+typedef struct {
+    int refs;
+    int version;        // Identity version (ETag); set before identity_cache_put
+    size_t len;
+    char data[];
+} identity_cache_blob_t;
+
+/**
+ * Initialize cache
+ *
+ * @param max_bytes: Memory limit for all entries (0 disables the cache)
+ * @param ttl: Seconds an entry stays valid (0 = until invalidated)
+ * @return 0 on success, -1 on error
+ */
+int identity_cache_init(size_t max_bytes, int ttl);
+
+/**
+ * Stop the NOTIFY listener and free all entries
+ */
+void identity_cache_cleanup(void);
+
+/**
+ * Get cached response body
+ *
+ * @param dna: DNA handle
+ * @return Body (release with identity_cache_release) or NULL on miss
+ */
+identity_cache_blob_t* identity_cache_get(const char *dna);
+
+/**
+ * Create response body for identity_cache_put
+ *
+ * @param data: JSON body (copied)
+ * @param len: Body length
+ * @return Body with one reference or NULL on allocation failure
+ */
+identity_cache_blob_t* identity_cache_blob_create(const char *data, size_t len);
+
+/**
+ * Drop a reference to a body
+ *
+ * @param blob: Body (NULL is ignored)
+ */
+void identity_cache_release(identity_cache_blob_t *blob);
+
+/**
+ * Drop a reference given the body's data pointer (MHD free callback)
+ *
+ * @param data: blob->data
+ */
+void identity_cache_release_data(void *data);
+
+/**
+ * Get invalidation generation for a handle
+ *
+ * Read this before querying the database and pass it to identity_cache_put,
+ * so a row that changed during the query is not cached.
+ *
+ * @param dna: DNA handle
+ * @return Generation counter
+ */
+uint64_t identity_cache_generation(const char *dna);
+
+/**
+ * Store response body
+ *
+ * Skipped if the handle was invalidated since generation was read.
+ *
+ * @param dna: DNA handle
+ * @param blob: Body (the cache takes its own reference)
+ * @param generation: Value of identity_cache_generation before the query
+ */
+void identity_cache_put(const char *dna, identity_cache_blob_t *blob, uint64_t generation);
+
+/**
+ * Drop cached entry for a handle
+ *
+ * @param dna: DNA handle
+ */
+void identity_cache_invalidate(const char *dna);
+
+/**
+ * Drop all entries
+ */
+void identity_cache_clear(void);
+
+/**
+ * Get cache usage
+ *
+ * @param entries: Cached entries (may be NULL)
+ * @param bytes: Memory used by entries (may be NULL)
+ * @param hits: Lookups served from cache (may be NULL)
+ * @param misses: Lookups that went to the database (may be NULL)
+ */
+void identity_cache_stats(int *entries, size_t *bytes, uint64_t *hits, uint64_t *misses);
+
+/**
+ * Start listening for invalidations from PostgreSQL
+ *
+ * Opens a dedicated connection and LISTENs on IDENTITY_CACHE_CHANNEL
+ * (see sql/schema.sql). Reconnects in the background; the cache is
+ * cleared whenever notifications may have been missed.
+ *
+ * @param config: Configuration with DB connection details
+ * @return 0 on success, -1 on error
+ */
+int identity_cache_listen_start(const config_t *config);
+
+#endif // IDENTITY_CACHE_H
@@ -0,0 +1,102 @@
+/*
+ * Approximate Identity Count
+ */
+
+#include "identity_count.h"
+#include "db.h"
+#include <pthread.h>
+
+static int64_t identity_count = -1;
+
+static pthread_mutex_t refresh_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t refresh_wake = PTHREAD_COND_INITIALIZER;
+static pthread_t refresh_tid;
+static bool refresh_started = false;
+static bool refresh_running = false;
+static db_pool_t *refresh_pool = NULL;
+static int refresh_interval = 60;
+
+static void refresh_count(void) {
+    PGconn *conn = db_pool_acquire(refresh_pool);
+    if (!conn) {
+        LOG_WARN("Identity count refresh skipped: database unavailable");
+        return;
+    }
+
+    int64_t count = db_estimate_identities(conn);
+    if (count < IDENTITY_COUNT_EXACT_LIMIT) {
+        // Not analyzed yet or small enough to count exactly
+        count = db_count_identities(conn);
+    }
+    db_pool_release(refresh_pool, conn);
+
+    if (count >= 0) {
+        __atomic_store_n(&identity_count, count, __ATOMIC_RELAXED);
+    }
+}
+
+static void* refresh_thread(void *arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&refresh_lock);
+    while (refresh_running) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += refresh_interval;
+        pthread_cond_timedwait(&refresh_wake, &refresh_lock, &deadline);
+        if (!refresh_running) {
+            break;
+        }
+
+        pthread_mutex_unlock(&refresh_lock);
+        refresh_count();
+        pthread_mutex_lock(&refresh_lock);
+    }
+    pthread_mutex_unlock(&refresh_lock);
+
+    return NULL;
+}
+
+int identity_count_start(db_pool_t *pool, int interval) {
+    refresh_pool = pool;
+    refresh_interval = interval > 0 ? interval : 1;
+
+    refresh_count();
+
+    refresh_running = true;
+    if (pthread_create(&refresh_tid, NULL, refresh_thread, NULL) != 0) {
+        LOG_ERROR("Failed to start identity count refresh");
+        refresh_running = false;
+        return -1;
+    }
+    refresh_started = true;
+
+    return 0;
+}
+
+void identity_count_stop(void) {
+    if (!refresh_started) {
+        return;
+    }
+
+    pthread_mutex_lock(&refresh_lock);
+    refresh_running = false;
+    pthread_cond_signal(&refresh_wake);
+    pthread_mutex_unlock(&refresh_lock);
+
+    pthread_join(refresh_tid, NULL);
+    refresh_started = false;
+}
+
+int64_t identity_count_get(void) {
+    return __atomic_load_n(&identity_count, __ATOMIC_RELAXED);
+}
+
+void identity_count_add(int delta) {
+    // Unknown stays unknown until the next refresh
+    int64_t current = __atomic_load_n(&identity_count, __ATOMIC_RELAXED);
+    while (current >= 0 &&
+           !__atomic_compare_exchange_n(&identity_count, &current, current + delta, false,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
@@ -0,0 +1,47 @@
+/*
+ * Approximate Identity Count
+ *
+ * Total shown by /list and /health. A background thread refreshes it
+ * every count_refresh seconds: exact COUNT(*) while the table is small,
+ * the planner estimate (pg_class.reltuples) once it is large. Successful
+ * registrations bump it in between, so requests never count rows.
+ */
+
+#ifndef IDENTITY_COUNT_H
+#define IDENTITY_COUNT_H
+
+#include "keyserver.h"
+#include "db_pool.h"
+
+// Below this estimate the refresh runs an exact COUNT(*)
+#define IDENTITY_COUNT_EXACT_LIMIT 100000
+
+/**
+ * Take the first count and start the refresh thread
+ *
+ * @param pool: Database pool (one connection is borrowed per refresh)
+ * @param interval: Seconds between refreshes (minimum 1)
+ * @return 0 on success, -1 on error
+ */
+int identity_count_start(db_pool_t *pool, int interval);
+
+/**
+ * Stop the refresh thread
+ */
+void identity_count_stop(void);
+
+/**
+ * Get approximate number of registered identities
+ *
+ * @return Count, or -1 if not known yet
+ */
+int64_t identity_count_get(void);
+
+/**
+ * Adjust the count after a write
+ *
+ * @param delta: Rows added (negative for removed)
+ */
+void identity_count_add(int delta);
+
+#endif // IDENTITY_COUNT_H
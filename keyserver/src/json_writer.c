@@ -0,0 +1,235 @@
+/*
+ * Streaming JSON Writer
+ */
+
+#include "json_writer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Buffer waiting for the next reply on this thread
+static __thread char *spare_buf = NULL;
+static __thread size_t spare_cap = 0;
+
+// Capacity is stored in front of the buffer so a released buffer can be reused
+typedef struct {
+    size_t cap;
+    char data[];
+} writer_block_t;
+
+static writer_block_t* block_of(void *buf) {
+    return (writer_block_t*)((char*)buf - offsetof(writer_block_t, data));
+}
+
+void json_writer_init(json_writer_t *w) {
+    memset(w, 0, sizeof(json_writer_t));
+    if (spare_buf) {
+        w->buf = spare_buf;
+        w->cap = spare_cap;
+        spare_buf = NULL;
+        spare_cap = 0;
+    }
+}
+
+void json_writer_release_buffer(void *buf) {
+    if (!buf) {
+        return;
+    }
+
+    // Keep the larger of the two buffers
+    writer_block_t *block = block_of(buf);
+    if (spare_buf && spare_cap >= block->cap) {
+        free(block);
+        return;
+    }
+    if (spare_buf) {
+        free(block_of(spare_buf));
+    }
+    spare_buf = block->data;
+    spare_cap = block->cap;
+}
+
+void json_writer_discard(json_writer_t *w) {
+    json_writer_release_buffer(w->buf);
+    memset(w, 0, sizeof(json_writer_t));
+}
+
+char* json_writer_detach(json_writer_t *w, size_t *len) {
+    if (w->failed || !w->buf) {
+        json_writer_discard(w);
+        *len = 0;
+        return NULL;
+    }
+
+    char *buf = w->buf;
+    *len = w->len;
+    memset(w, 0, sizeof(json_writer_t));
+    return buf;
+}
+
+bool json_writer_failed(const json_writer_t *w) {
+    return w->failed;
+}
+
+static bool reserve(json_writer_t *w, size_t extra) {
+    if (w->failed) {
+        return false;
+    }
+    if (w->len + extra <= w->cap) {
+        return true;
+    }
+
+    size_t cap = w->cap ? w->cap : JSON_WRITER_INITIAL_SIZE;
+    while (cap < w->len + extra) {
+        cap *= 2;
+    }
+
+    writer_block_t *block = realloc(w->buf ? block_of(w->buf) : NULL,
+                                    sizeof(writer_block_t) + cap);
+    if (!block) {
+        w->failed = true;
+        return false;
+    }
+    block->cap = cap;
+    w->buf = block->data;
+    w->cap = cap;
+    return true;
+}
+
+static void put(json_writer_t *w, const char *s, size_t n) {
+    if (reserve(w, n)) {
+        memcpy(w->buf + w->len, s, n);
+        w->len += n;
+    }
+}
+
+static void put_char(json_writer_t *w, char c) {
+    if (reserve(w, 1)) {
+        w->buf[w->len++] = c;
+    }
+}
+
+// Comma between values; nothing right after a key
+static void value_prefix(json_writer_t *w) {
+    if (w->after_key) {
+        w->after_key = false;
+        return;
+    }
+    if (w->depth > 0) {
+        if (w->has_items[w->depth - 1]) {
+            put_char(w, ',');
+        }
+        w->has_items[w->depth - 1] = true;
+    }
+}
+
+static void put_escaped(json_writer_t *w, const char *s) {
+    put_char(w, '"');
+    const char *run = s;
+    for (const char *p = s; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+
+        put(w, run, (size_t)(p - run));
+        run = p + 1;
+
+        switch (c) {
+            case '"':  put(w, "\\\"", 2); break;
+            case '\\': put(w, "\\\\", 2); break;
+            case '\n': put(w, "\\n", 2); break;
+            case '\r': put(w, "\\r", 2); break;
+            case '\t': put(w, "\\t", 2); break;
+            default: {
+                char esc[8];
+                snprintf(esc, sizeof(esc), "\\u%04x", c);
+                put(w, esc, 6);
+            }
+        }
+    }
+    put(w, run, strlen(run));
+    put_char(w, '"');
+}
+
+static void open_container(json_writer_t *w, char c) {
+    value_prefix(w);
+    if (w->depth >= JSON_WRITER_MAX_DEPTH) {
+        w->failed = true;
+        return;
+    }
+    put_char(w, c);
+    w->has_items[w->depth++] = false;
+}
+
+static void close_container(json_writer_t *w, char c) {
+    if (w->depth > 0) {
+        w->depth--;
+    }
+    put_char(w, c);
+}
+
+void json_writer_object_begin(json_writer_t *w) {
+    open_container(w, '{');
+}
+
+void json_writer_object_end(json_writer_t *w) {
+    close_container(w, '}');
+}
+
+void json_writer_array_begin(json_writer_t *w) {
+    open_container(w, '[');
+}
+
+void json_writer_array_end(json_writer_t *w) {
+    close_container(w, ']');
+}
+
+void json_writer_key(json_writer_t *w, const char *key) {
+    value_prefix(w);
+    put_escaped(w, key);
+    put_char(w, ':');
+    w->after_key = true;
+}
+
+void json_writer_string(json_writer_t *w, const char *value) {
+    if (!value) {
+        json_writer_null(w);
+        return;
+    }
+    value_prefix(w);
+    put_escaped(w, value);
+}
+
+void json_writer_int(json_writer_t *w, int64_t value) {
+    char num[24];
+    int n = snprintf(num, sizeof(num), "%lld", (long long)value);
+    value_prefix(w);
+    put(w, num, (size_t)n);
+}
+
+void json_writer_uint(json_writer_t *w, uint64_t value) {
+    char num[24];
+    int n = snprintf(num, sizeof(num), "%llu", (unsigned long long)value);
+    value_prefix(w);
+    put(w, num, (size_t)n);
+}
+
+void json_writer_bool(json_writer_t *w, bool value) {
+    value_prefix(w);
+    if (value) {
+        put(w, "true", 4);
+    } else {
+        put(w, "false", 5);
+    }
+}
+
+void json_writer_null(json_writer_t *w) {
+    value_prefix(w);
+    put(w, "null", 4);
+}
+
+void json_writer_raw(json_writer_t *w, const char *json, size_t len) {
+    value_prefix(w);
+    put(w, json, len);
+}
@@ -0,0 +1,103 @@
+/*
+ * Streaming JSON Writer
+ *
+ * Writes JSON text directly into a byte buffer, without building a json-c
+ * object tree. Each thread keeps a spare buffer: json_writer_init takes it
+ * and the buffer comes back when the response that used it is freed, so
+ * steady-state replies allocate nothing.
+ *
+ * Writes never fail individually; on out-of-memory the writer is marked
+ * failed and json_writer_failed() reports it at the end.
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define JSON_WRITER_INITIAL_SIZE 16384
+#define JSON_WRITER_MAX_DEPTH 32
+
+typedef struct {
+    char *buf;
+    size_t len;
+    size_t cap;
+    int depth;
+    bool has_items[JSON_WRITER_MAX_DEPTH];  // Comma needed before next value
+    bool after_key;                          // Next value follows "key":
+    bool failed;
+} json_writer_t;
+
+/**
+ * Start writing (takes this thread's spare buffer if there is one)
+ *
+ * @param w: Writer
+ */
+void json_writer_init(json_writer_t *w);
+
+/**
+ * Hand the buffer back for reuse without sending it
+ *
+ * @param w: Writer
+ */
+void json_writer_discard(json_writer_t *w);
+
+/**
+ * Take ownership of the written bytes
+ *
+ * The writer is empty afterwards. Return the buffer with
+ * json_writer_release_buffer.
+ *
+ * @param w: Writer
+ * @param len: Output length of the JSON text
+ * @return Buffer (not NUL-terminated) or NULL if the writer failed
+ */
+char* json_writer_detach(json_writer_t *w, size_t *len);
+
+/**
+ * Return a detached buffer to the calling thread's spare slot (or free it)
+ *
+ * @param buf: Buffer from json_writer_detach
+ */
+void json_writer_release_buffer(void *buf);
+
+/**
+ * @param w: Writer
+ * @return true if a write failed (out of memory or nesting too deep)
+ */
+bool json_writer_failed(const json_writer_t *w);
+
+void json_writer_object_begin(json_writer_t *w);
+void json_writer_object_end(json_writer_t *w);
+void json_writer_array_begin(json_writer_t *w);
+void json_writer_array_end(json_writer_t *w);
+
+/**
+ * Write object key (next call writes its value)
+ *
+ * @param w: Writer
+ * @param key: Key (escaped like any string)
+ */
+void json_writer_key(json_writer_t *w, const char *key);
+
+/**
+ * Write string value (NULL writes null)
+ */
+void json_writer_string(json_writer_t *w, const char *value);
+void json_writer_int(json_writer_t *w, int64_t value);
+void json_writer_uint(json_writer_t *w, uint64_t value);
+void json_writer_bool(json_writer_t *w, bool value);
+void json_writer_null(json_writer_t *w);
+
+/**
+ * Append already serialized JSON as one value
+ *
+ * @param w: Writer
+ * @param json: JSON text
+ * @param len: Length of json
+ */
+void json_writer_raw(json_writer_t *w, const char *json, size_t len);
+
+#endif // JSON_WRITER_H
@@ -27,6 +27,7 @@
 #define MAX_PUBKEY_B64 4096
 #define CF20_ADDRESS_LENGTH 103  // Cellframe address (can be empty)
 #define MAX_TIMESTAMP_SKEW 3600  // 1 hour
+#define MAX_LOOKUP_BATCH 100     // DNA handles per POST /lookup_batch
 
 // Rate limits
 #define RATE_LIMIT_REGISTER 10    // per hour
@@ -35,11 +36,13 @@
 
 // HTTP status codes
 #define HTTP_OK 200
+#define HTTP_NOT_MODIFIED 304
 #define HTTP_BAD_REQUEST 400
 #define HTTP_NOT_FOUND 404
 #define HTTP_CONFLICT 409
 #define HTTP_TOO_MANY_REQUESTS 429
 #define HTTP_INTERNAL_ERROR 500
+#define HTTP_SERVICE_UNAVAILABLE 503
 
 // Identity structure
 typedef struct {
@@ -62,6 +65,7 @@ typedef struct {
     char bind_address[256];
     int port;
     int max_connections;
+    int thread_pool_size;        // HTTP worker threads (0 = one per CPU core)
 
     // Database
     char db_host[256];
@@ -71,10 +75,15 @@ typedef struct {
     char db_password[256];
     int db_pool_size;
     int db_pool_timeout;
+    int count_refresh;           // Seconds between identity total refreshes
+
+    // Identity cache
+    int cache_size_mb;           // Lookup response cache (0 = disabled)
+    int cache_ttl;               // Seconds before a cached entry is refetched
 
     // Security
-    char verify_json_path[512];
-    int verify_timeout;
+    int verify_threads;          // Signature verify workers (0 = one per CPU core)
+    int verify_timeout;          // Max seconds a verification may wait in the queue
     int max_timestamp_skew;
 
     // Rate limits
@@ -102,12 +111,26 @@ typedef struct {
 // Global configuration
 extern config_t g_config;
 
-// Logging macros
-#define LOG_DEBUG(fmt, ...) log_message("DEBUG", fmt, ##__VA_ARGS__)
-#define LOG_INFO(fmt, ...)  log_message("INFO",  fmt, ##__VA_ARGS__)
-#define LOG_WARN(fmt, ...)  log_message("WARN",  fmt, ##__VA_ARGS__)
-#define LOG_ERROR(fmt, ...) log_message("ERROR", fmt, ##__VA_ARGS__)
+// Logging (log.c): the level is checked before any argument is formatted
+typedef enum {
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_ERROR
+} log_level_t;
+
+extern int log_min_level;
+
+#define LOG_AT(level, fmt, ...) \
+    do { \
+        if ((level) >= log_min_level) log_message((level), fmt, ##__VA_ARGS__); \
+    } while (0)
+
+#define LOG_DEBUG(fmt, ...) LOG_AT(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#define LOG_INFO(fmt, ...)  LOG_AT(LOG_LEVEL_INFO,  fmt, ##__VA_ARGS__)
+#define LOG_WARN(fmt, ...)  LOG_AT(LOG_LEVEL_WARN,  fmt, ##__VA_ARGS__)
+#define LOG_ERROR(fmt, ...) LOG_AT(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
 
-void log_message(const char *level, const char *fmt, ...);
+void log_message(log_level_t level, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
 
 #endif // KEYSERVER_H
@@ -0,0 +1,307 @@
+/*
+ * Asynchronous Logger
+ */
+
+#include "log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include <time.h>
+#include <pthread.h>
+
+// Worst case line: every message byte escaped as \u00XX plus the envelope
+#define LOG_LINE_MAX (LOG_MESSAGE_MAX * 6 + 128)
+
+int log_min_level = LOG_LEVEL_INFO;
+
+typedef struct {
+    size_t seq;                 // Slot state (bounded MPMC queue sequence)
+    log_level_t level;
+    struct timespec ts;
+    char message[LOG_MESSAGE_MAX];
+} log_record_t;
+
+static const char *level_names[] = { "DEBUG", "INFO", "WARN", "ERROR" };
+static const char *level_names_json[] = { "debug", "info", "warn", "error" };
+
+static log_record_t *ring = NULL;
+static size_t enqueue_pos __attribute__((aligned(64))) = 0;
+static size_t dequeue_pos __attribute__((aligned(64))) = 0;   // Writer thread only
+static uint64_t dropped = 0;
+
+static bool async_running = false;
+static bool writer_stop = false;
+static pthread_t writer_tid;
+static FILE *log_out = NULL;           // NULL = stderr
+static bool json_format = false;
+
+// ============================================================================
+// FORMATTING
+// ============================================================================
+
+static size_t append_json_string(char *dst, size_t pos, const char *s) {
+    dst[pos++] = '"';
+    for (const unsigned char *p = (const unsigned char*)s; *p; p++) {
+        switch (*p) {
+            case '"':  dst[pos++] = '\\'; dst[pos++] = '"'; break;
+            case '\\': dst[pos++] = '\\'; dst[pos++] = '\\'; break;
+            case '\n': dst[pos++] = '\\'; dst[pos++] = 'n'; break;
+            case '\r': dst[pos++] = '\\'; dst[pos++] = 'r'; break;
+            case '\t': dst[pos++] = '\\'; dst[pos++] = 't'; break;
+            default:
+                if (*p < 0x20) {
+                    pos += (size_t)sprintf(dst + pos, "\\u%04x", *p);
+                } else {
+                    dst[pos++] = (char)*p;
+                }
+        }
+    }
+    dst[pos++] = '"';
+    return pos;
+}
+
+/**
+ * Format one record as a line
+ *
+ * @param dst: Output (at least LOG_LINE_MAX bytes)
+ * @param level: Level
+ * @param ts: Wall clock time of the record
+ * @param message: Formatted message
+ * @return Line length including the newline
+ */
+static size_t format_line(char *dst, log_level_t level, const struct timespec *ts,
+                          const char *message) {
+    struct tm tm_info;
+    char stamp[32];
+
+    if (json_format) {
+        gmtime_r(&ts->tv_sec, &tm_info);
+        strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &tm_info);
+        size_t pos = (size_t)sprintf(dst, "{\"time\":\"%s.%03ldZ\",\"level\":\"%s\",\"msg\":",
+                                     stamp, ts->tv_nsec / 1000000, level_names_json[level]);
+        pos = append_json_string(dst, pos, message);
+        dst[pos++] = '}';
+        dst[pos++] = '\n';
+        return pos;
+    }
+
+    localtime_r(&ts->tv_sec, &tm_info);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm_info);
+    int n = snprintf(dst, LOG_LINE_MAX, "[%s] %s - %s\n", level_names[level], stamp, message);
+    return n < LOG_LINE_MAX ? (size_t)n : LOG_LINE_MAX - 1;
+}
+
+// Before log_init / after log_shutdown: one write per line, straight to stderr
+static void write_direct(log_level_t level, const struct timespec *ts, const char *message) {
+    char line[LOG_LINE_MAX];
+    size_t len = format_line(line, level, ts, message);
+    fwrite(line, 1, len, stderr);
+}
+
+// ============================================================================
+// RING BUFFER (bounded MPMC queue, used with a single consumer)
+// ============================================================================
+
+// Claim a slot to fill; NULL when the ring is full
+static log_record_t* ring_claim(size_t *pos_out) {
+    size_t pos = __atomic_load_n(&enqueue_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        log_record_t *slot = &ring[pos & (LOG_RING_SIZE - 1)];
+        size_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&enqueue_pos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                *pos_out = pos;
+                return slot;
+            }
+        } else if (diff < 0) {
+            return NULL;   // Writer has not consumed this lap yet
+        } else {
+            pos = __atomic_load_n(&enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+// Next published record, or NULL (writer thread)
+static log_record_t* ring_peek(void) {
+    log_record_t *slot = &ring[dequeue_pos & (LOG_RING_SIZE - 1)];
+    size_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+    return seq == dequeue_pos + 1 ? slot : NULL;
+}
+
+// Hand the slot back to producers (writer thread)
+static void ring_release(log_record_t *slot) {
+    __atomic_store_n(&slot->seq, dequeue_pos + LOG_RING_SIZE, __ATOMIC_RELEASE);
+    dequeue_pos++;
+}
+
+// ============================================================================
+// WRITER THREAD
+// ============================================================================
+
+static void flush_batch(const char *batch, size_t len) {
+    FILE *out = log_out ? log_out : stderr;
+    if (len > 0) {
+        fwrite(batch, 1, len, out);
+        fflush(out);
+    }
+}
+
+static void* writer_thread(void *arg) {
+    (void)arg;
+
+    char *batch = malloc(LOG_BATCH_BYTES);
+    if (!batch) {
+        return NULL;
+    }
+
+    for (;;) {
+        bool stopping = __atomic_load_n(&writer_stop, __ATOMIC_ACQUIRE);
+        size_t len = 0;
+
+        log_record_t *rec;
+        while ((rec = ring_peek()) != NULL) {
+            if (LOG_BATCH_BYTES - len < LOG_LINE_MAX) {
+                flush_batch(batch, len);
+                len = 0;
+            }
+            len += format_line(batch + len, rec->level, &rec->ts, rec->message);
+            ring_release(rec);
+        }
+
+        uint64_t lost = __atomic_exchange_n(&dropped, 0, __ATOMIC_RELAXED);
+        if (lost > 0) {
+            if (LOG_BATCH_BYTES - len < LOG_LINE_MAX) {
+                flush_batch(batch, len);
+                len = 0;
+            }
+            char message[64];
+            struct timespec now;
+            clock_gettime(CLOCK_REALTIME, &now);
+            snprintf(message, sizeof(message), "Log ring full: %llu records dropped",
+                     (unsigned long long)lost);
+            len += format_line(batch + len, LOG_LEVEL_WARN, &now, message);
+        }
+
+        flush_batch(batch, len);
+
+        if (stopping) {
+            break;
+        }
+        if (len == 0) {
+            struct timespec idle = { 0, LOG_IDLE_MS * 1000000L };
+            nanosleep(&idle, NULL);
+        }
+    }
+
+    free(batch);
+    return NULL;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void log_message(log_level_t level, const char *fmt, ...) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    va_list args;
+    if (!__atomic_load_n(&async_running, __ATOMIC_ACQUIRE)) {
+        char message[LOG_MESSAGE_MAX];
+        va_start(args, fmt);
+        vsnprintf(message, sizeof(message), fmt, args);
+        va_end(args);
+        write_direct(level, &ts, message);
+        return;
+    }
+
+    size_t pos;
+    log_record_t *slot = ring_claim(&pos);
+    if (!slot) {
+        __atomic_add_fetch(&dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    slot->level = level;
+    slot->ts = ts;
+    va_start(args, fmt);
+    vsnprintf(slot->message, sizeof(slot->message), fmt, args);
+    va_end(args);
+
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+}
+
+int log_level_parse(const char *name) {
+    for (int i = LOG_LEVEL_DEBUG; i <= LOG_LEVEL_ERROR; i++) {
+        if (strcasecmp(name, level_names_json[i]) == 0) {
+            return i;
+        }
+    }
+    if (strcasecmp(name, "warning") == 0) {
+        return LOG_LEVEL_WARN;
+    }
+    return -1;
+}
+
+int log_init(const config_t *config) {
+    int ret = 0;
+
+    int level = log_level_parse(config->log_level);
+    if (level < 0) {
+        LOG_WARN("Unknown log level '%s', using info", config->log_level);
+        level = LOG_LEVEL_INFO;
+    }
+    log_min_level = level;
+
+    if (strcmp(config->log_format, "json") == 0) {
+        json_format = true;
+    } else if (strcmp(config->log_format, "text") != 0) {
+        LOG_WARN("Unknown log format '%s', using text", config->log_format);
+    }
+
+    if (config->log_file[0] != '\0') {
+        log_out = fopen(config->log_file, "a");
+        if (!log_out) {
+            LOG_ERROR("Cannot open log file %s, logging to stderr", config->log_file);
+            ret = -1;
+        }
+    }
+
+    ring = calloc(LOG_RING_SIZE, sizeof(log_record_t));
+    if (!ring) {
+        LOG_WARN("Log ring not allocated: logging synchronously");
+        return ret;
+    }
+    for (size_t i = 0; i < LOG_RING_SIZE; i++) {
+        ring[i].seq = i;
+    }
+
+    if (pthread_create(&writer_tid, NULL, writer_thread, NULL) != 0) {
+        LOG_WARN("Log writer not started: logging synchronously");
+        return ret;
+    }
+    __atomic_store_n(&async_running, true, __ATOMIC_RELEASE);
+    atexit(log_shutdown);
+
+    return ret;
+}
+
+void log_shutdown(void) {
+    if (!__atomic_exchange_n(&async_running, false, __ATOMIC_ACQ_REL)) {
+        return;
+    }
+
+    __atomic_store_n(&writer_stop, true, __ATOMIC_RELEASE);
+    pthread_join(writer_tid, NULL);
+
+    // The ring stays allocated: a thread still running at exit may be filling a slot
+    if (log_out) {
+        fclose(log_out);
+        log_out = NULL;
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * Asynchronous Logger
+ *
+ * LOG_* calls format into a slot of a bounded lock-free ring buffer and
+ * return; a writer thread turns records into text or JSON lines and writes
+ * them to log_file (or stderr) in batches, flushing once per batch. When
+ * the ring is full records are dropped and counted, so request threads
+ * never wait for the disk. Until log_init (and after log_shutdown) records
+ * are written to stderr directly.
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include "keyserver.h"
+
+#define LOG_RING_SIZE 2048        // Records (power of two)
+#define LOG_MESSAGE_MAX 1024      // Bytes per message, longer ones are truncated
+#define LOG_BATCH_BYTES 65536     // Writer output buffer
+#define LOG_IDLE_MS 20            // Writer poll interval when the ring is empty
+
+/**
+ * Apply log settings and start the writer thread
+ *
+ * @param config: Configuration (log_level, log_file, log_format)
+ * @return 0 on success, -1 if log_file cannot be opened (logging continues on stderr)
+ */
+int log_init(const config_t *config);
+
+/**
+ * Write out queued records and stop the writer thread
+ *
+ * Registered with atexit() by log_init; safe to call more than once.
+ */
+void log_shutdown(void);
+
+/**
+ * Parse a level name
+ *
+ * @param name: "debug", "info", "warn" or "error"
+ * @return Level, or -1 if unknown
+ */
+int log_level_parse(const char *name);
+
+#endif // LOG_H
@@ -4,52 +4,64 @@
 
 #include "keyserver.h"
 #include "config.h"
+#include "log.h"
 #include "db.h"
+#include "db_pool.h"
 #include "rate_limit.h"
 #include "http_utils.h"
+#include "signature.h"
+#include "identity_cache.h"
+#include "identity_count.h"
+#include "metrics.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <signal.h>
-#include <stdarg.h>
 #include <time.h>
+#include <unistd.h>
 #include <microhttpd.h>
 
 // API handler declarations
-enum MHD_Result api_health_handler(struct MHD_Connection *connection, PGconn *db_conn);
+enum MHD_Result api_health_handler(struct MHD_Connection *connection, PGconn *db_conn, db_pool_t *db_pool);
+enum MHD_Result api_metrics_handler(struct MHD_Connection *connection, db_pool_t *db_pool);
 enum MHD_Result api_list_handler(struct MHD_Connection *connection, PGconn *db_conn, const char *url);
-enum MHD_Result api_lookup_handler(struct MHD_Connection *connection, PGconn *db_conn, const char *identity);
-enum MHD_Result api_register_handler(struct MHD_Connection *connection, PGconn *db_conn,
-                                      const char *upload_data, size_t upload_data_size);
-enum MHD_Result api_update_handler(struct MHD_Connection *connection, PGconn *db_conn,
-                                    const char *upload_data, size_t upload_data_size);
+enum MHD_Result api_lookup_handler(struct MHD_Connection *connection, db_pool_t *db_pool, const char *identity);
+enum MHD_Result api_lookup_batch_handler(struct MHD_Connection *connection, PGconn *db_conn,
+                                          const char *upload_data, size_t upload_data_size);
+enum MHD_Result api_register_handler(struct MHD_Connection *connection, db_pool_t *db_pool,
+                                      const char *upload_data, size_t upload_data_size,
+                                      signature_job_t **verify_job);
+enum MHD_Result api_update_handler(struct MHD_Connection *connection, db_pool_t *db_pool,
+                                    const char *upload_data, size_t upload_data_size,
+                                    signature_job_t **verify_job);
+
+// Internal polling threads, epoll where available (no FD_SETSIZE cap)
+#if MHD_VERSION >= 0x00095300
+#define KEYSERVER_MHD_FLAGS MHD_USE_AUTO_INTERNAL_THREAD
+#elif defined(__linux__)
+#define KEYSERVER_MHD_FLAGS (MHD_USE_SELECT_INTERNALLY | MHD_USE_EPOLL_LINUX_ONLY)
+#else
+#define KEYSERVER_MHD_FLAGS MHD_USE_SELECT_INTERNALLY
+#endif
+
+// Register/update connections are suspended while their signature is verified
+#if MHD_VERSION >= 0x00095300
+#define KEYSERVER_MHD_SUSPEND MHD_ALLOW_SUSPEND_RESUME
+#else
+#define KEYSERVER_MHD_SUSPEND MHD_USE_SUSPEND_RESUME
+#endif
 
 // Global state
 static struct MHD_Daemon *http_daemon = NULL;
-static PGconn *db_conn = NULL;
+static db_pool_t *db_pool = NULL;
 static volatile sig_atomic_t running = 1;
 
-// Logging
-void log_message(const char *level, const char *fmt, ...) {
-    time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
-    char timestamp[32];
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
-
-    fprintf(stderr, "[%s] %s - ", level, timestamp);
-
-    va_list args;
-    va_start(args, fmt);
-    vfprintf(stderr, fmt, args);
-    va_end(args);
-
-    fprintf(stderr, "\n");
-}
-
 // POST data handler structure
 struct post_data {
     char *data;
     size_t size;
+    signature_job_t *verify_job;  // Set while suspended for verification
+    uint64_t started_us;          // Arrival, for request latency
 };
 
 // Request handler
@@ -68,6 +80,7 @@ static enum MHD_Result answer_to_connection(void *cls, struct MHD_Connection *co
             // First call - allocate structure
             pd = calloc(1, sizeof(struct post_data));
             if (!pd) return MHD_NO;
+            pd->started_us = metrics_now_us();
             *con_cls = pd;
             return MHD_YES;
         }
@@ -92,15 +105,34 @@ static enum MHD_Result answer_to_connection(void *cls, struct MHD_Connection *co
 
         // Route: POST /api/keyserver/register
         if (strcmp(url, "/api/keyserver/register") == 0) {
-            ret = api_register_handler(connection, db_conn, pd->data, pd->size);
+            metrics_request_begin(METRICS_ROUTE_REGISTER, pd->started_us);
+            ret = api_register_handler(connection, db_pool, pd->data, pd->size, &pd->verify_job);
         }
         // Route: POST /api/keyserver/update
         else if (strcmp(url, "/api/keyserver/update") == 0) {
-            ret = api_update_handler(connection, db_conn, pd->data, pd->size);
+            metrics_request_begin(METRICS_ROUTE_UPDATE, pd->started_us);
+            ret = api_update_handler(connection, db_pool, pd->data, pd->size, &pd->verify_job);
+        }
+        // Route: POST /api/keyserver/lookup_batch
+        else if (strcmp(url, "/api/keyserver/lookup_batch") == 0) {
+            metrics_request_begin(METRICS_ROUTE_LOOKUP_BATCH, pd->started_us);
+            PGconn *db_conn = db_pool_acquire(db_pool);
+            if (!db_conn) {
+                ret = http_send_error(connection, HTTP_SERVICE_UNAVAILABLE, "Database unavailable");
+            } else {
+                ret = api_lookup_batch_handler(connection, db_conn, pd->data, pd->size);
+                db_pool_release(db_pool, db_conn);
+            }
         } else {
+            metrics_request_begin(METRICS_ROUTE_OTHER, pd->started_us);
             ret = http_send_error(connection, HTTP_NOT_FOUND, "Not found");
         }
 
+        // Suspended until verified: called again with the same POST data
+        if (pd->verify_job) {
+            return ret;
+        }
+
         // Cleanup
         if (pd->data) free(pd->data);
         free(pd);
@@ -109,27 +141,49 @@ static enum MHD_Result answer_to_connection(void *cls, struct MHD_Connection *co
         return ret;
     }
 
+    uint64_t started_us = metrics_now_us();
+
     // GET requests
     if (strcmp(method, "GET") == 0) {
-        // Route: GET /api/keyserver/health
+        // Route: GET /api/keyserver/health (reports the database state itself)
         if (strcmp(url, "/api/keyserver/health") == 0) {
-            return api_health_handler(connection, db_conn);
+            metrics_request_begin(METRICS_ROUTE_HEALTH, started_us);
+            PGconn *db_conn = db_pool_acquire(db_pool);
+            enum MHD_Result ret = api_health_handler(connection, db_conn, db_pool);
+            db_pool_release(db_pool, db_conn);
+            return ret;
+        }
+
+        // Route: GET /api/keyserver/lookup/<dna> (database only on cache miss)
+        if (strncmp(url, "/api/keyserver/lookup/", 22) == 0) {
+            const char *dna = url + 22;
+            metrics_request_begin(METRICS_ROUTE_LOOKUP, started_us);
+            return api_lookup_handler(connection, db_pool, dna);
         }
 
         // Route: GET /api/keyserver/list
         if (strcmp(url, "/api/keyserver/list") == 0 ||
             strncmp(url, "/api/keyserver/list?", 20) == 0) {
-            return api_list_handler(connection, db_conn, url);
+            metrics_request_begin(METRICS_ROUTE_LIST, started_us);
+            PGconn *db_conn = db_pool_acquire(db_pool);
+            if (!db_conn) {
+                return http_send_error(connection, HTTP_SERVICE_UNAVAILABLE, "Database unavailable");
+            }
+
+            enum MHD_Result ret = api_list_handler(connection, db_conn, url);
+            db_pool_release(db_pool, db_conn);
+            return ret;
         }
 
-        // Route: GET /api/keyserver/lookup/<dna>
-        if (strncmp(url, "/api/keyserver/lookup/", 22) == 0) {
-            const char *dna = url + 22;
-            return api_lookup_handler(connection, db_conn, dna);
+        // Route: GET /metrics (Prometheus scrape)
+        if (strcmp(url, "/metrics") == 0) {
+            metrics_request_begin(METRICS_ROUTE_METRICS, started_us);
+            return api_metrics_handler(connection, db_pool);
         }
     }
 
     // 404 Not Found
+    metrics_request_begin(METRICS_ROUTE_OTHER, started_us);
     return http_send_error(connection, HTTP_NOT_FOUND, "Not found");
 }
 
@@ -148,6 +202,7 @@ static void request_completed(void *cls, struct MHD_Connection *connection,
 
     struct post_data *pd = *con_cls;
     if (pd) {
+        signature_job_free(pd->verify_job);
         if (pd->data) free(pd->data);
         free(pd);
     }
@@ -174,10 +229,13 @@ int main(int argc, char *argv[]) {
     config_print(&g_config);
     printf("\n");
 
+    // Logging goes through the background writer from here on
+    log_init(&g_config);
+
     // Connect to database
     LOG_INFO("Connecting to PostgreSQL...");
-    db_conn = db_connect(&g_config);
-    if (!db_conn) {
+    db_pool = db_pool_create(&g_config);
+    if (!db_pool) {
         LOG_ERROR("Failed to connect to database");
         return 1;
     }
@@ -186,26 +244,62 @@ int main(int argc, char *argv[]) {
     rate_limit_init();
     LOG_INFO("Rate limiter initialized");
 
+    // Approximate identity total for /list and /health
+    identity_count_start(db_pool, g_config.count_refresh);
+
+    // Lookup cache, invalidated by writes here and NOTIFYs from other instances
+    if (identity_cache_init((size_t)g_config.cache_size_mb * 1024 * 1024, g_config.cache_ttl) != 0) {
+        LOG_ERROR("Failed to initialize identity cache");
+        identity_count_stop();
+        db_pool_destroy(db_pool);
+        return 1;
+    }
+    identity_cache_listen_start(&g_config);
+
+    // Signature verify workers (in-process Dilithium3)
+    if (signature_pool_init(g_config.verify_threads, g_config.verify_timeout) != 0) {
+        LOG_ERROR("Failed to start signature verification");
+        identity_cache_cleanup();
+        identity_count_stop();
+        db_pool_destroy(db_pool);
+        return 1;
+    }
+
     // Setup signal handlers
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
 
+    // Worker threads: each runs its own poll loop and handles requests to completion
+    int threads = g_config.thread_pool_size;
+    if (threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (int)cpus : 1;
+    }
+    if (g_config.db_pool_size < threads) {
+        LOG_WARN("pool_size (%d) < HTTP threads (%d): requests may wait for database connections",
+                 g_config.db_pool_size, threads);
+    }
+
     // Start HTTP server
-    LOG_INFO("Starting HTTP server on %s:%d", g_config.bind_address, g_config.port);
+    LOG_INFO("Starting HTTP server on %s:%d (%d threads)", g_config.bind_address, g_config.port, threads);
 
     http_daemon = MHD_start_daemon(
-        MHD_USE_SELECT_INTERNALLY | MHD_USE_DEBUG,
+        KEYSERVER_MHD_FLAGS | KEYSERVER_MHD_SUSPEND | MHD_USE_DEBUG,
         g_config.port,
         NULL, NULL,
         &answer_to_connection, NULL,
         MHD_OPTION_NOTIFY_COMPLETED, request_completed, NULL,
         MHD_OPTION_CONNECTION_LIMIT, (unsigned int)g_config.max_connections,
+        MHD_OPTION_THREAD_POOL_SIZE, (unsigned int)threads,
         MHD_OPTION_END
     );
 
     if (!http_daemon) {
         LOG_ERROR("Failed to start HTTP server");
-        db_disconnect(db_conn);
+        signature_pool_cleanup();
+        identity_cache_cleanup();
+        identity_count_stop();
+        db_pool_destroy(db_pool);
         return 1;
     }
 
@@ -217,8 +311,10 @@ int main(int argc, char *argv[]) {
     printf("  POST /api/keyserver/register\n");
     printf("  POST /api/keyserver/update\n");
     printf("  GET  /api/keyserver/lookup/<dna>\n");
+    printf("  POST /api/keyserver/lookup_batch\n");
     printf("  GET  /api/keyserver/list\n");
     printf("  GET  /api/keyserver/health\n");
+    printf("  GET  /metrics\n");
     printf("\n");
     printf("Press Ctrl+C to stop\n");
     printf("====================================\n\n");
@@ -231,13 +327,19 @@ int main(int argc, char *argv[]) {
     // Cleanup
     LOG_INFO("Shutting down...");
 
+    // Finish queued verifications first: MHD cannot stop with suspended connections
+    signature_pool_cleanup();
+
     if (http_daemon) {
         MHD_stop_daemon(http_daemon);
     }
 
     rate_limit_cleanup();
-    db_disconnect(db_conn);
+    identity_cache_cleanup();
+    identity_count_stop();
+    db_pool_destroy(db_pool);
 
     LOG_INFO("Keyserver stopped");
+    log_shutdown();
     return 0;
 }
@@ -0,0 +1,381 @@
+/*
+ * Metrics - Prometheus exposition
+ */
+
+#include "metrics.h"
+#include "identity_cache.h"
+#include "identity_count.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <pthread.h>
+
+// Status codes reported individually; anything else is "other"
+static const int status_codes[] = { 200, 304, 400, 404, 409, 429, 500, 503 };
+#define STATUS_COUNT (sizeof(status_codes) / sizeof(status_codes[0]) + 1)
+
+static const char *route_names[METRICS_ROUTE_COUNT] = {
+    "register", "update", "lookup", "lookup_batch", "list", "health", "metrics", "other"
+};
+
+typedef struct {
+    uint64_t buckets[METRICS_HIST_BUCKETS];
+    uint64_t sum_us;
+} histogram_t;
+
+// Written only by its owning thread, read by scrapes
+typedef struct metrics_slab {
+    uint64_t counters[METRICS_COUNTER_COUNT];
+    uint64_t requests[METRICS_ROUTE_COUNT][STATUS_COUNT];
+    histogram_t latency[METRICS_ROUTE_COUNT];
+    histogram_t hists[METRICS_HIST_COUNT];
+    struct metrics_slab *next;
+} __attribute__((aligned(64))) metrics_slab_t;
+
+// Slabs outlive their threads so totals never go backwards
+static metrics_slab_t *slabs = NULL;
+static pthread_mutex_t slabs_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static __thread metrics_slab_t *thread_slab = NULL;
+static __thread bool request_active = false;
+static __thread metrics_route_t request_route;
+static __thread uint64_t request_started_us;
+
+static metrics_slab_t* get_slab(void) {
+    if (thread_slab) {
+        return thread_slab;
+    }
+
+    metrics_slab_t *slab = aligned_alloc(64, sizeof(metrics_slab_t));
+    if (!slab) {
+        return NULL;
+    }
+    memset(slab, 0, sizeof(metrics_slab_t));
+
+    pthread_mutex_lock(&slabs_lock);
+    slab->next = slabs;
+    __atomic_store_n(&slabs, slab, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&slabs_lock);
+
+    thread_slab = slab;
+    return slab;
+}
+
+// Single writer: a relaxed load/store pair, no locked instruction
+static inline void bump(uint64_t *value, uint64_t delta) {
+    __atomic_store_n(value, __atomic_load_n(value, __ATOMIC_RELAXED) + delta, __ATOMIC_RELAXED);
+}
+
+// Bucket i counts values <= bucket_bound_us(i)
+static int bucket_index(uint64_t us) {
+    if (us <= (1u << METRICS_HIST_MIN_SHIFT)) {
+        return 0;
+    }
+
+    uint64_t v = us - 1;
+    int msb = 63 - __builtin_clzll(v);
+    int octave = msb - METRICS_HIST_MIN_SHIFT;
+    if (octave >= METRICS_HIST_OCTAVES) {
+        return METRICS_HIST_BUCKETS - 1;
+    }
+
+    int upper_half = (int)((v >> (msb - 1)) & 1);
+    return 1 + octave * 2 + upper_half;
+}
+
+static uint64_t bucket_bound_us(int i) {
+    if (i == 0) {
+        return 1u << METRICS_HIST_MIN_SHIFT;
+    }
+
+    int octave = (i - 1) / 2;
+    uint64_t base = (uint64_t)1 << (octave + METRICS_HIST_MIN_SHIFT);
+    return (i - 1) % 2 == 0 ? base + base / 2 : base * 2;
+}
+
+static void histogram_record(histogram_t *h, uint64_t us) {
+    bump(&h->buckets[bucket_index(us)], 1);
+    bump(&h->sum_us, us);
+}
+
+static size_t status_index(int status_code) {
+    for (size_t i = 0; i < STATUS_COUNT - 1; i++) {
+        if (status_codes[i] == status_code) {
+            return i;
+        }
+    }
+    return STATUS_COUNT - 1;
+}
+
+// ============================================================================
+// RECORDING
+// ============================================================================
+
+uint64_t metrics_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+void metrics_count(metrics_counter_t counter) {
+    metrics_slab_t *slab = get_slab();
+    if (slab) {
+        bump(&slab->counters[counter], 1);
+    }
+}
+
+void metrics_observe(metrics_hist_t hist, uint64_t us) {
+    metrics_slab_t *slab = get_slab();
+    if (slab) {
+        histogram_record(&slab->hists[hist], us);
+    }
+}
+
+void metrics_request_begin(metrics_route_t route, uint64_t started_us) {
+    request_active = true;
+    request_route = route;
+    request_started_us = started_us;
+}
+
+void metrics_request_end(int status_code) {
+    if (!request_active) {
+        return;
+    }
+    request_active = false;
+
+    metrics_slab_t *slab = get_slab();
+    if (!slab) {
+        return;
+    }
+
+    uint64_t now = metrics_now_us();
+    uint64_t us = now > request_started_us ? now - request_started_us : 0;
+    bump(&slab->requests[request_route][status_index(status_code)], 1);
+    histogram_record(&slab->latency[request_route], us);
+}
+
+uint64_t metrics_counter_total(metrics_counter_t counter) {
+    uint64_t total = 0;
+    for (metrics_slab_t *s = __atomic_load_n(&slabs, __ATOMIC_ACQUIRE); s; s = s->next) {
+        total += __atomic_load_n(&s->counters[counter], __ATOMIC_RELAXED);
+    }
+    return total;
+}
+
+// ============================================================================
+// EXPOSITION
+// ============================================================================
+
+typedef struct {
+    char *buf;
+    size_t len;
+    size_t cap;
+    bool failed;
+} text_t;
+
+static void text_printf(text_t *t, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static void text_printf(text_t *t, const char *fmt, ...) {
+    if (t->failed) {
+        return;
+    }
+
+    for (;;) {
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(t->buf + t->len, t->cap - t->len, fmt, args);
+        va_end(args);
+        if (n < 0) {
+            t->failed = true;
+            return;
+        }
+        if ((size_t)n < t->cap - t->len) {
+            t->len += (size_t)n;
+            return;
+        }
+
+        size_t cap = t->cap * 2;
+        while (cap - t->len <= (size_t)n) {
+            cap *= 2;
+        }
+        char *buf = realloc(t->buf, cap);
+        if (!buf) {
+            t->failed = true;
+            return;
+        }
+        t->buf = buf;
+        t->cap = cap;
+    }
+}
+
+static void sum_histogram(histogram_t *out, const histogram_t *h) {
+    for (int i = 0; i < METRICS_HIST_BUCKETS; i++) {
+        out->buckets[i] += __atomic_load_n(&h->buckets[i], __ATOMIC_RELAXED);
+    }
+    out->sum_us += __atomic_load_n(&h->sum_us, __ATOMIC_RELAXED);
+}
+
+static void write_header(text_t *t, const char *name, const char *type, const char *help) {
+    text_printf(t, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+// labels: "" or `key="value",` (trailing comma)
+static void write_histogram(text_t *t, const char *name, const char *labels, const histogram_t *h) {
+    uint64_t cumulative = 0;
+    for (int i = 0; i < METRICS_HIST_BUCKETS - 1; i++) {
+        cumulative += h->buckets[i];
+        text_printf(t, "%s_bucket{%sle=\"%.9g\"} %llu\n", name, labels,
+                    (double)bucket_bound_us(i) / 1e6, (unsigned long long)cumulative);
+    }
+    cumulative += h->buckets[METRICS_HIST_BUCKETS - 1];
+    text_printf(t, "%s_bucket{%sle=\"+Inf\"} %llu\n", name, labels, (unsigned long long)cumulative);
+
+    // _sum/_count take the labels without the trailing comma
+    size_t labels_len = strlen(labels);
+    if (labels_len > 0) {
+        int plain = (int)labels_len - 1;
+        text_printf(t, "%s_sum{%.*s} %.6f\n", name, plain, labels, (double)h->sum_us / 1e6);
+        text_printf(t, "%s_count{%.*s} %llu\n", name, plain, labels, (unsigned long long)cumulative);
+    } else {
+        text_printf(t, "%s_sum %.6f\n", name, (double)h->sum_us / 1e6);
+        text_printf(t, "%s_count %llu\n", name, (unsigned long long)cumulative);
+    }
+}
+
+char* metrics_render(db_pool_t *db_pool, size_t *len) {
+    // Merge every thread's slab
+    metrics_slab_t *total = calloc(1, sizeof(metrics_slab_t));
+    if (!total) {
+        return NULL;
+    }
+
+    for (metrics_slab_t *s = __atomic_load_n(&slabs, __ATOMIC_ACQUIRE); s; s = s->next) {
+        for (int c = 0; c < METRICS_COUNTER_COUNT; c++) {
+            total->counters[c] += __atomic_load_n(&s->counters[c], __ATOMIC_RELAXED);
+        }
+        for (int r = 0; r < METRICS_ROUTE_COUNT; r++) {
+            for (size_t i = 0; i < STATUS_COUNT; i++) {
+                total->requests[r][i] += __atomic_load_n(&s->requests[r][i], __ATOMIC_RELAXED);
+            }
+            sum_histogram(&total->latency[r], &s->latency[r]);
+        }
+        for (int h = 0; h < METRICS_HIST_COUNT; h++) {
+            sum_histogram(&total->hists[h], &s->hists[h]);
+        }
+    }
+
+    text_t t = { .buf = malloc(16384), .len = 0, .cap = 16384, .failed = false };
+    if (!t.buf) {
+        free(total);
+        return NULL;
+    }
+    char labels[64];
+
+    // Requests
+    write_header(&t, "keyserver_requests_total", "counter", "Requests answered, by route and status code.");
+    for (int r = 0; r < METRICS_ROUTE_COUNT; r++) {
+        for (size_t i = 0; i < STATUS_COUNT; i++) {
+            if (total->requests[r][i] == 0) {
+                continue;
+            }
+            if (i < STATUS_COUNT - 1) {
+                text_printf(&t, "keyserver_requests_total{route=\"%s\",code=\"%d\"} %llu\n",
+                            route_names[r], status_codes[i], (unsigned long long)total->requests[r][i]);
+            } else {
+                text_printf(&t, "keyserver_requests_total{route=\"%s\",code=\"other\"} %llu\n",
+                            route_names[r], (unsigned long long)total->requests[r][i]);
+            }
+        }
+    }
+
+    write_header(&t, "keyserver_request_duration_seconds", "histogram",
+                 "Time from request arrival to response, by route.");
+    for (int r = 0; r < METRICS_ROUTE_COUNT; r++) {
+        snprintf(labels, sizeof(labels), "route=\"%s\",", route_names[r]);
+        write_histogram(&t, "keyserver_request_duration_seconds", labels, &total->latency[r]);
+    }
+
+    // Database pool
+    int pool_size = 0, pool_open = 0, pool_in_use = 0;
+    db_pool_stats(db_pool, &pool_size, &pool_open, &pool_in_use);
+    write_header(&t, "keyserver_db_pool_connections", "gauge", "Database connections by state.");
+    text_printf(&t, "keyserver_db_pool_connections{state=\"max\"} %d\n", pool_size);
+    text_printf(&t, "keyserver_db_pool_connections{state=\"open\"} %d\n", pool_open);
+    text_printf(&t, "keyserver_db_pool_connections{state=\"in_use\"} %d\n", pool_in_use);
+
+    write_header(&t, "keyserver_db_pool_wait_seconds", "histogram",
+                 "Time spent waiting to check out a database connection.");
+    write_histogram(&t, "keyserver_db_pool_wait_seconds", "", &total->hists[METRICS_HIST_DB_POOL_WAIT]);
+
+    write_header(&t, "keyserver_db_pool_timeouts_total", "counter",
+                 "Checkouts that gave up because every connection was busy.");
+    text_printf(&t, "keyserver_db_pool_timeouts_total %llu\n",
+                (unsigned long long)total->counters[METRICS_DB_POOL_TIMEOUT]);
+
+    // Signature verification
+    write_header(&t, "keyserver_signature_verify_seconds", "histogram",
+                 "Dilithium3 signature verification time.");
+    write_histogram(&t, "keyserver_signature_verify_seconds", "", &total->hists[METRICS_HIST_VERIFY]);
+
+    write_header(&t, "keyserver_signature_queue_seconds", "histogram",
+                 "Time a signature waited for a verify worker.");
+    write_histogram(&t, "keyserver_signature_queue_seconds", "", &total->hists[METRICS_HIST_VERIFY_QUEUE]);
+
+    write_header(&t, "keyserver_signature_verifications_total", "counter",
+                 "Signature verifications by result.");
+    text_printf(&t, "keyserver_signature_verifications_total{result=\"valid\"} %llu\n",
+                (unsigned long long)total->counters[METRICS_VERIFY_VALID]);
+    text_printf(&t, "keyserver_signature_verifications_total{result=\"invalid\"} %llu\n",
+                (unsigned long long)total->counters[METRICS_VERIFY_INVALID]);
+    text_printf(&t, "keyserver_signature_verifications_total{result=\"error\"} %llu\n",
+                (unsigned long long)total->counters[METRICS_VERIFY_ERROR]);
+
+    // Lookup cache
+    uint64_t hits = total->counters[METRICS_CACHE_HIT];
+    uint64_t misses = total->counters[METRICS_CACHE_MISS];
+    int cache_entries;
+    size_t cache_bytes;
+    identity_cache_stats(&cache_entries, &cache_bytes, NULL, NULL);
+
+    write_header(&t, "keyserver_identity_cache_requests_total", "counter", "Lookup cache requests by result.");
+    text_printf(&t, "keyserver_identity_cache_requests_total{result=\"hit\"} %llu\n", (unsigned long long)hits);
+    text_printf(&t, "keyserver_identity_cache_requests_total{result=\"miss\"} %llu\n", (unsigned long long)misses);
+
+    write_header(&t, "keyserver_identity_cache_hit_ratio", "gauge", "Lookup cache hits / requests since start.");
+    text_printf(&t, "keyserver_identity_cache_hit_ratio %.6f\n",
+                hits + misses > 0 ? (double)hits / (double)(hits + misses) : 0.0);
+
+    write_header(&t, "keyserver_identity_cache_entries", "gauge", "Identities held in the lookup cache.");
+    text_printf(&t, "keyserver_identity_cache_entries %d\n", cache_entries);
+
+    write_header(&t, "keyserver_identity_cache_bytes", "gauge", "Memory used by the lookup cache.");
+    text_printf(&t, "keyserver_identity_cache_bytes %zu\n", cache_bytes);
+
+    // Rate limiting
+    write_header(&t, "keyserver_rate_limit_rejections_total", "counter", "Requests rejected by the rate limiter.");
+    text_printf(&t, "keyserver_rate_limit_rejections_total{type=\"register\"} %llu\n",
+                (unsigned long long)total->counters[METRICS_RATE_LIMITED_REGISTER]);
+    text_printf(&t, "keyserver_rate_limit_rejections_total{type=\"lookup\"} %llu\n",
+                (unsigned long long)total->counters[METRICS_RATE_LIMITED_LOOKUP]);
+    text_printf(&t, "keyserver_rate_limit_rejections_total{type=\"list\"} %llu\n",
+                (unsigned long long)total->counters[METRICS_RATE_LIMITED_LIST]);
+
+    // Identities
+    int64_t identities = identity_count_get();
+    if (identities >= 0) {
+        write_header(&t, "keyserver_identities", "gauge", "Registered identities (approximate).");
+        text_printf(&t, "keyserver_identities %lld\n", (long long)identities);
+    }
+
+    free(total);
+
+    if (t.failed) {
+        free(t.buf);
+        return NULL;
+    }
+
+    *len = t.len;
+    return t.buf;
+}
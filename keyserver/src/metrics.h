@@ -0,0 +1,112 @@
+/*
+ * Metrics - Prometheus exposition (GET /metrics)
+ *
+ * Every thread records into its own slab of counters and log-linear
+ * (HDR-style) latency histograms, with plain relaxed atomic stores and no
+ * shared cache lines. A scrape walks all slabs and sums them.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "keyserver.h"
+#include "db_pool.h"
+
+// Histogram buckets: <16us, then two per power of two up to 2^26us (~67s), then +Inf
+#define METRICS_HIST_MIN_SHIFT 4
+#define METRICS_HIST_OCTAVES 22
+#define METRICS_HIST_BUCKETS (1 + METRICS_HIST_OCTAVES * 2 + 1)
+
+typedef enum {
+    METRICS_ROUTE_REGISTER,
+    METRICS_ROUTE_UPDATE,
+    METRICS_ROUTE_LOOKUP,
+    METRICS_ROUTE_LOOKUP_BATCH,
+    METRICS_ROUTE_LIST,
+    METRICS_ROUTE_HEALTH,
+    METRICS_ROUTE_METRICS,
+    METRICS_ROUTE_OTHER,
+    METRICS_ROUTE_COUNT
+} metrics_route_t;
+
+typedef enum {
+    METRICS_CACHE_HIT,
+    METRICS_CACHE_MISS,
+    METRICS_RATE_LIMITED_REGISTER,
+    METRICS_RATE_LIMITED_LOOKUP,
+    METRICS_RATE_LIMITED_LIST,
+    METRICS_DB_POOL_TIMEOUT,
+    METRICS_VERIFY_VALID,
+    METRICS_VERIFY_INVALID,
+    METRICS_VERIFY_ERROR,
+    METRICS_COUNTER_COUNT
+} metrics_counter_t;
+
+typedef enum {
+    METRICS_HIST_DB_POOL_WAIT,      // db_pool_acquire
+    METRICS_HIST_VERIFY,            // Dilithium3 verification
+    METRICS_HIST_VERIFY_QUEUE,      // Wait for a verify worker
+    METRICS_HIST_COUNT
+} metrics_hist_t;
+
+/**
+ * Monotonic timestamp for latency measurement
+ *
+ * @return Microseconds
+ */
+uint64_t metrics_now_us(void);
+
+/**
+ * Increment counter
+ *
+ * @param counter: Counter
+ */
+void metrics_count(metrics_counter_t counter);
+
+/**
+ * Record duration in a histogram
+ *
+ * @param hist: Histogram
+ * @param us: Duration in microseconds
+ */
+void metrics_observe(metrics_hist_t hist, uint64_t us);
+
+/**
+ * Start timing a request on this thread
+ *
+ * The next response queued by http_utils on this thread is recorded
+ * against route. Resumed requests call this again with their original
+ * start time.
+ *
+ * @param route: Route
+ * @param started_us: metrics_now_us() when the request arrived
+ */
+void metrics_request_begin(metrics_route_t route, uint64_t started_us);
+
+/**
+ * Record the response of the request begun on this thread
+ *
+ * No-op if no request is being timed.
+ *
+ * @param status_code: HTTP status sent
+ */
+void metrics_request_end(int status_code);
+
+/**
+ * Sum a counter over all threads
+ *
+ * @param counter: Counter
+ * @return Total
+ */
+uint64_t metrics_counter_total(metrics_counter_t counter);
+
+/**
+ * Write all metrics in Prometheus text format
+ *
+ * @param db_pool: Database pool (for pool gauges)
+ * @param len: Output length
+ * @return Malloc'd text (caller frees) or NULL on allocation failure
+ */
+char* metrics_render(db_pool_t *db_pool, size_t *len);
+
+#endif // METRICS_H
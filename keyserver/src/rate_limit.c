@@ -3,139 +3,358 @@
  */
 
 #include "rate_limit.h"
+#include "metrics.h"
 #include <string.h>
 #include <time.h>
 #include <stdlib.h>
+#include <pthread.h>
 
-#define MAX_BUCKETS 10000
+#define RATE_LIMIT_TYPES 3
+#define TOKEN_SCALE 1000000   // Tokens are kept in millionths for smooth refill
 
-typedef struct {
+typedef struct bucket {
     char ip[46];
-    time_t last_refill;
-    int tokens_register;
-    int tokens_lookup;
-    int tokens_list;
+    uint32_t hash;
+    int64_t last_refill_ms;             // Monotonic clock
+    int64_t tokens[RATE_LIMIT_TYPES];   // Scaled by TOKEN_SCALE
+    int64_t refill_rem[RATE_LIMIT_TYPES]; // Refill not yet worth a scaled token (x period_ms)
+    struct bucket *next;                // Hash chain
+    struct bucket *lru_prev;            // Towards most recently checked
+    struct bucket *lru_next;            // Towards least recently checked
 } bucket_t;
 
-static bucket_t *buckets[MAX_BUCKETS] = {0};
-static int bucket_count = 0;
+typedef struct {
+    pthread_mutex_t lock;
+    bucket_t **table;
+    size_t mask;                        // Table size - 1 (power of two)
+    size_t count;
+    bucket_t *lru_head;                 // Most recently checked
+    bucket_t *lru_tail;                 // Evicted first when the shard is full
+} __attribute__((aligned(64))) shard_t;
+
+typedef struct {
+    int64_t capacity;                   // Scaled tokens
+    int64_t count;                      // Requests per period
+    int64_t period_ms;
+} limit_t;
+
+static shard_t shards[RATE_LIMIT_SHARDS];
+static limit_t limits[RATE_LIMIT_TYPES];
 
-// Simple hash function for IP addresses
-static unsigned int hash_ip(const char *ip) {
-    unsigned int hash = 5381;
-    int c;
-    while ((c = *ip++)) {
-        hash = ((hash << 5) + hash) + c;
+static pthread_mutex_t sweep_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sweep_wake = PTHREAD_COND_INITIALIZER;
+static pthread_t sweep_tid;
+static bool sweep_running = false;
+
+// FNV-1a over the IP string
+static uint32_t hash_ip(const char *ip) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char*)ip; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
     }
-    return hash % MAX_BUCKETS;
+    return hash;
 }
 
-void rate_limit_init(void) {
-    memset(buckets, 0, sizeof(buckets));
-    bucket_count = 0;
+// Coarse monotonic clock: no syscall, immune to wall clock jumps
+static int64_t now_ms(void) {
+    struct timespec ts;
+#ifdef CLOCK_MONOTONIC_COARSE
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int64_t (*clock_ms)(void) = now_ms;
+
+static void set_limit(rate_limit_type_t type, int count, int period) {
+    limits[type].count = count > 0 ? count : 1;
+    limits[type].period_ms = (int64_t)(period > 0 ? period : 1) * 1000;
+    limits[type].capacity = limits[type].count * TOKEN_SCALE;
+}
+
+static void refill_tokens(bucket_t *bucket, int64_t now) {
+    int64_t elapsed = now - bucket->last_refill_ms;
+    if (elapsed <= 0) return;
+
+    for (int t = 0; t < RATE_LIMIT_TYPES; t++) {
+        const limit_t *limit = &limits[t];
+
+        // Full bucket after one period; cap first so the product cannot overflow
+        if (bucket->tokens[t] >= limit->capacity || elapsed >= limit->period_ms) {
+            bucket->tokens[t] = limit->capacity;
+            bucket->refill_rem[t] = 0;
+            continue;
+        }
+
+        // Carry the division remainder: at low rates with frequent checks
+        // each step alone would round down to nothing
+        int64_t refill = elapsed * limit->capacity + bucket->refill_rem[t];
+        bucket->tokens[t] += refill / limit->period_ms;
+        bucket->refill_rem[t] = refill % limit->period_ms;
+        if (bucket->tokens[t] >= limit->capacity) {
+            bucket->tokens[t] = limit->capacity;
+            bucket->refill_rem[t] = 0;
+        }
+    }
+
+    bucket->last_refill_ms = now;
+}
+
+// Every bucket full again: nothing to remember about this IP
+static bool bucket_idle(const bucket_t *bucket) {
+    for (int t = 0; t < RATE_LIMIT_TYPES; t++) {
+        if (bucket->tokens[t] < limits[t].capacity) {
+            return false;
+        }
+    }
+    return true;
 }
 
-static bucket_t* get_or_create_bucket(const char *ip) {
-    unsigned int idx = hash_ip(ip);
+static void lru_unlink(shard_t *shard, bucket_t *b) {
+    if (b->lru_prev) b->lru_prev->lru_next = b->lru_next; else shard->lru_head = b->lru_next;
+    if (b->lru_next) b->lru_next->lru_prev = b->lru_prev; else shard->lru_tail = b->lru_prev;
+    b->lru_prev = b->lru_next = NULL;
+}
+
+static void lru_push_front(shard_t *shard, bucket_t *b) {
+    b->lru_prev = NULL;
+    b->lru_next = shard->lru_head;
+    if (shard->lru_head) shard->lru_head->lru_prev = b; else shard->lru_tail = b;
+    shard->lru_head = b;
+}
 
-    // Check if bucket exists
-    if (buckets[idx] && strcmp(buckets[idx]->ip, ip) == 0) {
-        return buckets[idx];
+// Unlink and free the least recently checked bucket (shard lock held)
+static void evict_lru_bucket(shard_t *shard) {
+    bucket_t *victim = shard->lru_tail;
+    if (!victim) return;
+
+    bucket_t **pp = &shard->table[(victim->hash / RATE_LIMIT_SHARDS) & shard->mask];
+    while (*pp != victim) {
+        pp = &(*pp)->next;
     }
+    *pp = victim->next;
 
-    // Create new bucket
+    lru_unlink(shard, victim);
+    free(victim);
+    shard->count--;
+}
+
+// Double the table when chains average more than two entries (shard lock held)
+static void shard_grow(shard_t *shard) {
+    size_t new_size = (shard->mask + 1) * 2;
+    bucket_t **table = calloc(new_size, sizeof(bucket_t*));
+    if (!table) {
+        return;  // Keep the longer chains
+    }
+
+    for (size_t i = 0; i <= shard->mask; i++) {
+        bucket_t *b = shard->table[i];
+        while (b) {
+            bucket_t *next = b->next;
+            size_t idx = (b->hash / RATE_LIMIT_SHARDS) & (new_size - 1);
+            b->next = table[idx];
+            table[idx] = b;
+            b = next;
+        }
+    }
+
+    free(shard->table);
+    shard->table = table;
+    shard->mask = new_size - 1;
+}
+
+static bucket_t* get_or_create_bucket(shard_t *shard, const char *ip, uint32_t hash, int64_t now) {
+    // Shard index uses the low hash bits, chain index the bits above
+    bucket_t **chain = &shard->table[(hash / RATE_LIMIT_SHARDS) & shard->mask];
+    for (bucket_t *b = *chain; b; b = b->next) {
+        if (b->hash == hash && strcmp(b->ip, ip) == 0) {
+            if (shard->lru_head != b) {
+                lru_unlink(shard, b);
+                lru_push_front(shard, b);
+            }
+            return b;
+        }
+    }
+
+    // Bounded memory under many source IPs: forget the longest-quiet one
+    // (it starts over with full buckets if it comes back)
+    if (shard->count >= RATE_LIMIT_SHARD_MAX_BUCKETS) {
+        evict_lru_bucket(shard);
+    }
+
+    // New IP starts with full buckets; collisions chain, never replace
     bucket_t *bucket = calloc(1, sizeof(bucket_t));
     if (!bucket) return NULL;
 
     strncpy(bucket->ip, ip, sizeof(bucket->ip) - 1);
-    bucket->last_refill = time(NULL);
-    bucket->tokens_register = g_config.rate_limit_register_count;
-    bucket->tokens_lookup = g_config.rate_limit_lookup_count;
-    bucket->tokens_list = g_config.rate_limit_list_count;
-
-    // Handle collision - simple replace for now
-    if (buckets[idx]) {
-        free(buckets[idx]);
+    bucket->hash = hash;
+    bucket->last_refill_ms = now;
+    for (int t = 0; t < RATE_LIMIT_TYPES; t++) {
+        bucket->tokens[t] = limits[t].capacity;
     }
 
-    buckets[idx] = bucket;
-    bucket_count++;
+    bucket->next = *chain;
+    *chain = bucket;
+    lru_push_front(shard, bucket);
+    shard->count++;
+
+    if (shard->count > 2 * (shard->mask + 1)) {
+        shard_grow(shard);
+    }
 
     return bucket;
 }
 
-static void refill_tokens(bucket_t *bucket) {
-    time_t now = time(NULL);
-    time_t elapsed = now - bucket->last_refill;
+// Drop buckets that have refilled completely (idle IPs)
+static void sweep_idle_buckets(void) {
+    int64_t now = clock_ms();
+    size_t evicted = 0;
 
-    if (elapsed <= 0) return;
+    for (int s = 0; s < RATE_LIMIT_SHARDS; s++) {
+        shard_t *shard = &shards[s];
+        pthread_mutex_lock(&shard->lock);
+        for (size_t i = 0; i <= shard->mask; i++) {
+            bucket_t **pp = &shard->table[i];
+            while (*pp) {
+                bucket_t *b = *pp;
+                refill_tokens(b, now);
+                if (bucket_idle(b)) {
+                    *pp = b->next;
+                    lru_unlink(shard, b);
+                    free(b);
+                    shard->count--;
+                    evicted++;
+                } else {
+                    pp = &b->next;
+                }
+            }
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
 
-    // Refill register tokens (per hour)
-    if (elapsed >= g_config.rate_limit_register_period) {
-        bucket->tokens_register = g_config.rate_limit_register_count;
+    if (evicted > 0) {
+        LOG_DEBUG("Rate limiter evicted %zu idle buckets", evicted);
     }
+}
 
-    // Refill lookup tokens (per minute)
-    int lookup_periods = elapsed / g_config.rate_limit_lookup_period;
-    if (lookup_periods > 0) {
-        bucket->tokens_lookup += lookup_periods * g_config.rate_limit_lookup_count;
-        if (bucket->tokens_lookup > g_config.rate_limit_lookup_count) {
-            bucket->tokens_lookup = g_config.rate_limit_lookup_count;
+static void* sweep_thread(void *arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&sweep_lock);
+    while (sweep_running) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += RATE_LIMIT_SWEEP_INTERVAL;
+        pthread_cond_timedwait(&sweep_wake, &sweep_lock, &deadline);
+        if (!sweep_running) {
+            break;
         }
+
+        pthread_mutex_unlock(&sweep_lock);
+        sweep_idle_buckets();
+        pthread_mutex_lock(&sweep_lock);
     }
+    pthread_mutex_unlock(&sweep_lock);
 
-    // Refill list tokens (per minute)
-    int list_periods = elapsed / g_config.rate_limit_list_period;
-    if (list_periods > 0) {
-        bucket->tokens_list += list_periods * g_config.rate_limit_list_count;
-        if (bucket->tokens_list > g_config.rate_limit_list_count) {
-            bucket->tokens_list = g_config.rate_limit_list_count;
-        }
+    return NULL;
+}
+
+void rate_limit_init(void) {
+    set_limit(RATE_LIMIT_TYPE_REGISTER, g_config.rate_limit_register_count,
+              g_config.rate_limit_register_period);
+    set_limit(RATE_LIMIT_TYPE_LOOKUP, g_config.rate_limit_lookup_count,
+              g_config.rate_limit_lookup_period);
+    set_limit(RATE_LIMIT_TYPE_LIST, g_config.rate_limit_list_count,
+              g_config.rate_limit_list_period);
+
+    for (int s = 0; s < RATE_LIMIT_SHARDS; s++) {
+        pthread_mutex_init(&shards[s].lock, NULL);
+        shards[s].table = calloc(RATE_LIMIT_SHARD_INITIAL, sizeof(bucket_t*));
+        shards[s].mask = shards[s].table ? RATE_LIMIT_SHARD_INITIAL - 1 : 0;
+        shards[s].count = 0;
+        shards[s].lru_head = NULL;
+        shards[s].lru_tail = NULL;
     }
 
-    bucket->last_refill = now;
+    sweep_running = true;
+    if (pthread_create(&sweep_tid, NULL, sweep_thread, NULL) != 0) {
+        LOG_WARN("Rate limiter sweep thread not started: idle buckets are kept");
+        sweep_running = false;
+    }
 }
 
 bool rate_limit_check(const char *ip, rate_limit_type_t type) {
     if (!ip) return false;
 
-    bucket_t *bucket = get_or_create_bucket(ip);
-    if (!bucket) return false;
+    uint32_t hash = hash_ip(ip);
+    shard_t *shard = &shards[hash % RATE_LIMIT_SHARDS];
+    int64_t now = clock_ms();
 
-    refill_tokens(bucket);
+    pthread_mutex_lock(&shard->lock);
 
-    switch (type) {
-        case RATE_LIMIT_TYPE_REGISTER:
-            if (bucket->tokens_register > 0) {
-                bucket->tokens_register--;
-                return true;
-            }
-            break;
+    bool allowed = false;
+    bucket_t *bucket = shard->table ? get_or_create_bucket(shard, ip, hash, now) : NULL;
+    if (bucket) {
+        refill_tokens(bucket, now);
+        if (bucket->tokens[type] >= TOKEN_SCALE) {
+            bucket->tokens[type] -= TOKEN_SCALE;
+            allowed = true;
+        }
+    }
 
-        case RATE_LIMIT_TYPE_LOOKUP:
-            if (bucket->tokens_lookup > 0) {
-                bucket->tokens_lookup--;
-                return true;
-            }
-            break;
+    pthread_mutex_unlock(&shard->lock);
 
-        case RATE_LIMIT_TYPE_LIST:
-            if (bucket->tokens_list > 0) {
-                bucket->tokens_list--;
-                return true;
-            }
-            break;
+    if (!allowed) {
+        metrics_count(METRICS_RATE_LIMITED_REGISTER + type);
     }
+    return allowed;
+}
 
-    return false;
+size_t rate_limit_bucket_count(void) {
+    size_t total = 0;
+    for (int s = 0; s < RATE_LIMIT_SHARDS; s++) {
+        pthread_mutex_lock(&shards[s].lock);
+        total += shards[s].count;
+        pthread_mutex_unlock(&shards[s].lock);
+    }
+    return total;
+}
+
+void rate_limit_set_clock(int64_t (*now)(void)) {
+    clock_ms = now ? now : now_ms;
 }
 
 void rate_limit_cleanup(void) {
-    for (int i = 0; i < MAX_BUCKETS; i++) {
-        if (buckets[i]) {
-            free(buckets[i]);
-            buckets[i] = NULL;
+    pthread_mutex_lock(&sweep_lock);
+    bool was_running = sweep_running;
+    sweep_running = false;
+    pthread_cond_signal(&sweep_wake);
+    pthread_mutex_unlock(&sweep_lock);
+    if (was_running) {
+        pthread_join(sweep_tid, NULL);
+    }
+
+    for (int s = 0; s < RATE_LIMIT_SHARDS; s++) {
+        shard_t *shard = &shards[s];
+        pthread_mutex_lock(&shard->lock);
+        for (size_t i = 0; shard->table && i <= shard->mask; i++) {
+            bucket_t *b = shard->table[i];
+            while (b) {
+                bucket_t *next = b->next;
+                free(b);
+                b = next;
+            }
         }
+        free(shard->table);
+        shard->table = NULL;
+        shard->mask = 0;
+        shard->count = 0;
+        shard->lru_head = NULL;
+        shard->lru_tail = NULL;
+        pthread_mutex_unlock(&shard->lock);
+        pthread_mutex_destroy(&shard->lock);
     }
-    bucket_count = 0;
 }
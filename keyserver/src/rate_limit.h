@@ -1,5 +1,12 @@
 /*
  * Rate Limiting - Token Bucket Algorithm
+ *
+ * Per-IP token buckets in a sharded hash map (one lock per shard, chains
+ * grow with the number of IPs so a check stays O(1)). Tokens refill
+ * continuously from a coarse monotonic clock. A background thread drops
+ * buckets of IPs that have been idle long enough to be full again; a full
+ * shard forgets its least recently seen IP, so memory stays bounded even
+ * when source addresses rotate.
  */
 
 #ifndef RATE_LIMIT_H
@@ -7,6 +14,11 @@
 
 #include "keyserver.h"
 
+#define RATE_LIMIT_SHARDS 64            // Independent locks
+#define RATE_LIMIT_SHARD_INITIAL 256    // Hash chains per shard at start (power of two)
+#define RATE_LIMIT_SWEEP_INTERVAL 60    // Seconds between idle bucket sweeps
+#define RATE_LIMIT_SHARD_MAX_BUCKETS 4096  // Per shard (~256K IPs, ~40 MB in total)
+
 // Rate limit types
 typedef enum {
     RATE_LIMIT_TYPE_REGISTER,
@@ -15,7 +27,9 @@ typedef enum {
 } rate_limit_type_t;
 
 /**
- * Initialize rate limiter
+ * Initialize rate limiter and start the idle bucket sweeper
+ *
+ * Reads the rate_limit_* settings from g_config.
  */
 void rate_limit_init(void);
 
@@ -28,6 +42,16 @@ void rate_limit_init(void);
  */
 bool rate_limit_check(const char *ip, rate_limit_type_t type);
 
+/**
+ * Number of IPs currently tracked
+ */
+size_t rate_limit_bucket_count(void);
+
+/**
+ * Replace the monotonic millisecond clock (tests); NULL restores the default
+ */
+void rate_limit_set_clock(int64_t (*now)(void));
+
 /**
  * Cleanup rate limiter (call on shutdown)
  */
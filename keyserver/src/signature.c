@@ -3,11 +3,94 @@
  */
 
 #include "signature.h"
+#include "qgp_dilithium.h"
+#include "metrics.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
-#include <sys/wait.h>
+#include <pthread.h>
+
+struct signature_job {
+    json_object *payload;
+    char *signature;
+    char *public_key;
+    uint64_t queued_us;        // metrics_now_us()
+
+    // Guarded by pool.lock
+    int result;
+    bool finished;
+    int refs;                  // Submitter + queue/worker
+    signature_done_cb done_cb;
+    void *done_arg;
+    signature_job_t *next;
+};
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    pthread_t *threads;
+    int thread_count;
+    signature_job_t *head;
+    signature_job_t *tail;
+    int pending;
+    int max_pending;
+    int timeout;
+    bool running;
+} pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work = PTHREAD_COND_INITIALIZER
+};
+
+// ============================================================================
+// VERIFICATION
+// ============================================================================
+
+static int base64_value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+/**
+ * Decode base64 into a fixed-size buffer
+ *
+ * @return: 0 if input decodes to exactly out_len bytes, -1 otherwise
+ */
+static int base64_decode_exact(const char *input, uint8_t *out, size_t out_len) {
+    size_t len = strlen(input);
+    if (len == 0 || len % 4 != 0) {
+        return -1;
+    }
+
+    size_t padding = 0;
+    if (input[len - 1] == '=') padding++;
+    if (input[len - 2] == '=') padding++;
+    if ((len / 4) * 3 - padding != out_len) {
+        return -1;
+    }
+
+    size_t j = 0;
+    for (size_t i = 0; i < len; i += 4) {
+        int v[4];
+        for (int k = 0; k < 4; k++) {
+            v[k] = input[i + k] == '=' && i + 4 == len && k >= 2 ? 0 : base64_value(input[i + k]);
+            if (v[k] < 0) {
+                return -1;
+            }
+        }
+        uint32_t triple = ((uint32_t)v[0] << 18) | ((uint32_t)v[1] << 12) |
+                          ((uint32_t)v[2] << 6) | (uint32_t)v[3];
+        if (j < out_len) out[j++] = (triple >> 16) & 0xFF;
+        if (j < out_len) out[j++] = (triple >> 8) & 0xFF;
+        if (j < out_len) out[j++] = triple & 0xFF;
+    }
+
+    return 0;
+}
 
 char* signature_build_canonical_json(json_object *payload) {
     // Create a copy without "sig" field
@@ -29,54 +112,218 @@ char* signature_build_canonical_json(json_object *payload) {
 }
 
 int signature_verify(json_object *payload, const char *signature,
-                    const char *public_key, const char *verify_path,
-                    int timeout) {
+                    const char *public_key) {
+    uint8_t sig[QGP_DILITHIUM3_BYTES];
+    uint8_t pk[QGP_DILITHIUM3_PUBLICKEYBYTES];
+
+    // Malformed keys and signatures are invalid, not server errors
+    if (base64_decode_exact(signature, sig, sizeof(sig)) != 0) {
+        LOG_DEBUG("Signature is not a base64 Dilithium3 signature");
+        return -1;
+    }
+    if (base64_decode_exact(public_key, pk, sizeof(pk)) != 0) {
+        LOG_DEBUG("Public key is not a base64 Dilithium3 public key");
+        return -1;
+    }
+
     // Build canonical JSON (without sig field)
     char *canonical_json = signature_build_canonical_json(payload);
     if (!canonical_json) {
         return -2;
     }
 
-    // Check if verify_json exists
-    if (access(verify_path, X_OK) != 0) {
-        LOG_ERROR("verify_json not found or not executable: %s", verify_path);
-        free(canonical_json);
-        return -2;
-    }
+    int result = qgp_dilithium3_verify(sig, sizeof(sig),
+                                       (const uint8_t*)canonical_json, strlen(canonical_json),
+                                       pk);
+    free(canonical_json);
 
-    // Fork and execute verify_json
-    pid_t pid = fork();
-    if (pid < 0) {
-        LOG_ERROR("fork() failed");
-        free(canonical_json);
-        return -2;
+    return result == 0 ? 0 : -1;
+}
+
+// ============================================================================
+// VERIFY WORKER POOL
+// ============================================================================
+
+// Drop one reference (pool.lock held)
+static void job_unref_locked(signature_job_t *job) {
+    if (--job->refs > 0) {
+        return;
     }
+    json_object_put(job->payload);
+    free(job->signature);
+    free(job->public_key);
+    free(job);
+}
+
+static void* verify_worker(void *arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&pool.lock);
+    for (;;) {
+        while (pool.running && !pool.head) {
+            pthread_cond_wait(&pool.work, &pool.lock);
+        }
+        // Drain the queue before exiting so every callback runs
+        signature_job_t *job = pool.head;
+        if (!job) {
+            break;
+        }
+        pool.head = job->next;
+        if (!pool.head) {
+            pool.tail = NULL;
+        }
+        pool.pending--;
+        pthread_mutex_unlock(&pool.lock);
+
+        int result;
+        uint64_t started = metrics_now_us();
+        metrics_observe(METRICS_HIST_VERIFY_QUEUE, started - job->queued_us);
+        if (pool.timeout > 0 && started - job->queued_us > (uint64_t)pool.timeout * 1000000) {
+            LOG_WARN("Signature verification timed out in queue");
+            result = -2;
+        } else {
+            result = signature_verify(job->payload, job->signature, job->public_key);
+            metrics_observe(METRICS_HIST_VERIFY, metrics_now_us() - started);
+        }
+        metrics_count(result == 0 ? METRICS_VERIFY_VALID :
+                      result == -1 ? METRICS_VERIFY_INVALID : METRICS_VERIFY_ERROR);
+
+        pthread_mutex_lock(&pool.lock);
+        job->result = result;
+        job->finished = true;
+        signature_done_cb cb = job->done_cb;
+        void *cb_arg = job->done_arg;
+        job_unref_locked(job);
 
-    if (pid == 0) {
-        // Child process
-        execl(verify_path, verify_path, canonical_json, signature, public_key, NULL);
-        _exit(1);  // exec failed
+        if (cb) {
+            // The submitter may free the job as soon as it sees the result
+            pthread_mutex_unlock(&pool.lock);
+            cb(cb_arg);
+            pthread_mutex_lock(&pool.lock);
+        }
     }
+    pthread_mutex_unlock(&pool.lock);
 
-    // Parent process - wait for child
-    free(canonical_json);
+    return NULL;
+}
 
-    int status;
-    pid_t result = waitpid(pid, &status, 0);
+int signature_pool_init(int threads, int timeout) {
+    if (threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (int)cpus : 1;
+    }
 
-    if (result == -1) {
-        LOG_ERROR("waitpid() failed");
-        return -2;
+    pool.threads = calloc((size_t)threads, sizeof(pthread_t));
+    if (!pool.threads) {
+        return -1;
     }
 
-    if (WIFEXITED(status)) {
-        int exit_code = WEXITSTATUS(status);
-        if (exit_code == 0) {
-            return 0;  // Valid signature
-        } else {
-            return -1;  // Invalid signature
+    pool.head = pool.tail = NULL;
+    pool.pending = 0;
+    pool.max_pending = threads * SIGNATURE_QUEUE_PER_WORKER;
+    pool.timeout = timeout;
+    pool.running = true;
+    pool.thread_count = 0;
+
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&pool.threads[i], NULL, verify_worker, NULL) != 0) {
+            LOG_ERROR("Failed to start signature verify thread");
+            signature_pool_cleanup();
+            return -1;
         }
+        pool.thread_count++;
+    }
+
+    LOG_INFO("Signature verification: %d threads, %d queued max", threads, pool.max_pending);
+    return 0;
+}
+
+void signature_pool_cleanup(void) {
+    pthread_mutex_lock(&pool.lock);
+    pool.running = false;
+    pthread_cond_broadcast(&pool.work);
+    pthread_mutex_unlock(&pool.lock);
+
+    for (int i = 0; i < pool.thread_count; i++) {
+        pthread_join(pool.threads[i], NULL);
+    }
+
+    free(pool.threads);
+    pool.threads = NULL;
+    pool.thread_count = 0;
+}
+
+signature_job_t* signature_job_submit(json_object *payload, const char *signature,
+                                      const char *public_key) {
+    signature_job_t *job = calloc(1, sizeof(signature_job_t));
+    if (!job) {
+        return NULL;
+    }
+
+    job->signature = strdup(signature);
+    job->public_key = strdup(public_key);
+    if (!job->signature || !job->public_key) {
+        free(job->signature);
+        free(job->public_key);
+        free(job);
+        return NULL;
+    }
+    job->payload = json_object_get(payload);
+    job->queued_us = metrics_now_us();
+    job->refs = 2;
+
+    pthread_mutex_lock(&pool.lock);
+    if (!pool.running || pool.pending >= pool.max_pending) {
+        job->refs = 1;
+        job_unref_locked(job);
+        pthread_mutex_unlock(&pool.lock);
+        return NULL;
+    }
+
+    if (pool.tail) {
+        pool.tail->next = job;
+    } else {
+        pool.head = job;
+    }
+    pool.tail = job;
+    pool.pending++;
+    pthread_cond_signal(&pool.work);
+    pthread_mutex_unlock(&pool.lock);
+
+    return job;
+}
+
+bool signature_job_on_complete(signature_job_t *job, signature_done_cb cb, void *arg) {
+    pthread_mutex_lock(&pool.lock);
+    bool pending = !job->finished;
+    if (pending) {
+        job->done_cb = cb;
+        job->done_arg = arg;
+    }
+    pthread_mutex_unlock(&pool.lock);
+
+    return pending;
+}
+
+int signature_job_result(signature_job_t *job) {
+    pthread_mutex_lock(&pool.lock);
+    int result = job->finished ? job->result : -2;
+    pthread_mutex_unlock(&pool.lock);
+
+    return result;
+}
+
+json_object* signature_job_payload(signature_job_t *job) {
+    return job->payload;
+}
+
+void signature_job_free(signature_job_t *job) {
+    if (!job) {
+        return;
     }
 
-    return -2;  // Error
+    pthread_mutex_lock(&pool.lock);
+    job->done_cb = NULL;
+    job_unref_locked(job);
+    pthread_mutex_unlock(&pool.lock);
 }
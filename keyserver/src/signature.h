@@ -1,5 +1,9 @@
 /*
  * Signature Verification - Dilithium3
+ *
+ * Signatures are verified in-process with the vendored crypto/dilithium
+ * library. Register/update requests hand their verification to a small
+ * worker pool so HTTP threads are not blocked by it.
  */
 
 #ifndef SIGNATURE_H
@@ -8,21 +12,30 @@
 #include "keyserver.h"
 #include <json-c/json.h>
 
+// Pending verifications allowed per worker before submit() refuses new jobs
+#define SIGNATURE_QUEUE_PER_WORKER 64
+
+typedef struct signature_job signature_job_t;
+
+/**
+ * Completion callback, called from a verify worker thread
+ *
+ * @param arg: Argument given to signature_job_on_complete()
+ */
+typedef void (*signature_done_cb)(void *arg);
+
 /**
  * Verify Dilithium3 signature on JSON payload
  *
- * Calls the verify_json utility as a subprocess
+ * Runs in the calling thread
  *
- * @param payload: JSON object (without "sig" field)
+ * @param payload: JSON object (the "sig" field is excluded from the signed data)
  * @param signature: Base64-encoded Dilithium3 signature
  * @param public_key: Base64-encoded Dilithium3 public key
- * @param verify_path: Path to verify_json binary
- * @param timeout: Timeout in seconds
  * @return 0 if valid, -1 if invalid, -2 on error
  */
 int signature_verify(json_object *payload, const char *signature,
-                    const char *public_key, const char *verify_path,
-                    int timeout);
+                    const char *public_key);
 
 /**
  * Build canonical JSON string (without "sig" field)
@@ -32,4 +45,75 @@ int signature_verify(json_object *payload, const char *signature,
  */
 char* signature_build_canonical_json(json_object *payload);
 
+// ============================================================================
+// VERIFY WORKER POOL
+// ============================================================================
+
+/**
+ * Start verify worker threads
+ *
+ * @param threads: Number of workers (0 = one per CPU core)
+ * @param timeout: Seconds a job may wait in the queue before it fails
+ * @return 0 on success, -1 on error
+ */
+int signature_pool_init(int threads, int timeout);
+
+/**
+ * Finish queued jobs and stop the workers
+ *
+ * New submissions fail once this has been called. Completion callbacks of
+ * queued jobs still run, so suspended connections get resumed.
+ */
+void signature_pool_cleanup(void);
+
+/**
+ * Queue a verification
+ *
+ * The job keeps a reference to payload (see signature_job_payload).
+ *
+ * @param payload: JSON object including "sig"
+ * @param signature: Base64-encoded Dilithium3 signature
+ * @param public_key: Base64-encoded Dilithium3 public key
+ * @return Job handle (free with signature_job_free), NULL if the queue is full
+ *         or the pool is stopped
+ */
+signature_job_t* signature_job_submit(json_object *payload, const char *signature,
+                                      const char *public_key);
+
+/**
+ * Request a callback when the job finishes
+ *
+ * @param job: Job handle
+ * @param cb: Callback (called once, from a worker thread)
+ * @param arg: Callback argument
+ * @return true if cb will be called, false if the job has already finished
+ *         (cb is not called)
+ */
+bool signature_job_on_complete(signature_job_t *job, signature_done_cb cb, void *arg);
+
+/**
+ * Get job result
+ *
+ * @param job: Finished job
+ * @return 0 if valid, -1 if invalid, -2 on error (including queue timeout)
+ */
+int signature_job_result(signature_job_t *job);
+
+/**
+ * Get the payload the job was submitted with
+ *
+ * @param job: Job handle
+ * @return Payload (owned by the job)
+ */
+json_object* signature_job_payload(signature_job_t *job);
+
+/**
+ * Release job handle
+ *
+ * Safe to call before the job finished; the worker drops it afterwards.
+ *
+ * @param job: Job handle (NULL is ignored)
+ */
+void signature_job_free(signature_job_t *job);
+
 #endif // SIGNATURE_H
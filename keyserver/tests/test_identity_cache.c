@@ -0,0 +1,202 @@
+/*
+ * Unit test: identity_cache (hits, invalidation, generation check,
+ * memory bound, TTL, concurrent writers)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "identity_cache.h"
+#include "tests/test_util.h"
+
+static void put_body(const char *dna, const char *body, int version, uint64_t generation) {
+    identity_cache_blob_t *blob = identity_cache_blob_create(body, strlen(body));
+    if (!blob) {
+        return;
+    }
+    blob->version = version;
+    identity_cache_put(dna, blob, generation);
+    identity_cache_release(blob);
+}
+
+static void test_put_get(void) {
+    CHECK(identity_cache_init(1024 * 1024, 0) == 0);
+
+    CHECK(identity_cache_get("alice") == NULL);
+    put_body("alice", "{\"v\":1}", 1, identity_cache_generation("alice"));
+
+    identity_cache_blob_t *blob = identity_cache_get("alice");
+    CHECK(blob != NULL);
+    if (blob) {
+        CHECK(blob->version == 1);
+        CHECK(blob->len == 7 && memcmp(blob->data, "{\"v\":1}", 7) == 0);
+        identity_cache_release(blob);
+    }
+
+    // Replacing keeps one entry
+    put_body("alice", "{\"v\":2}", 2, identity_cache_generation("alice"));
+    blob = identity_cache_get("alice");
+    CHECK(blob != NULL && blob->version == 2);
+    identity_cache_release(blob);
+
+    int entries = 0;
+    identity_cache_stats(&entries, NULL, NULL, NULL);
+    CHECK(entries == 1);
+
+    identity_cache_cleanup();
+}
+
+static void test_invalidate(void) {
+    CHECK(identity_cache_init(1024 * 1024, 0) == 0);
+
+    put_body("alice", "{\"v\":1}", 1, identity_cache_generation("alice"));
+    put_body("bob", "{\"v\":1}", 1, identity_cache_generation("bob"));
+
+    // A body held by a response outlives its invalidated entry
+    identity_cache_blob_t *held = identity_cache_get("alice");
+    identity_cache_invalidate("alice");
+    CHECK(identity_cache_get("alice") == NULL);
+    CHECK(held != NULL && held->version == 1);
+    identity_cache_release(held);
+
+    identity_cache_blob_t *blob = identity_cache_get("bob");
+    CHECK(blob != NULL);
+    identity_cache_release(blob);
+
+    // Row changed while the lookup was querying: its result is not cached
+    uint64_t generation = identity_cache_generation("alice");
+    identity_cache_invalidate("alice");
+    put_body("alice", "{\"v\":1}", 1, generation);
+    CHECK(identity_cache_get("alice") == NULL);
+
+    put_body("alice", "{\"v\":2}", 2, identity_cache_generation("alice"));
+    blob = identity_cache_get("alice");
+    CHECK(blob != NULL && blob->version == 2);
+    identity_cache_release(blob);
+
+    // Clear drops everything and also rejects lookups that started before it
+    generation = identity_cache_generation("carol");
+    identity_cache_clear();
+    CHECK(identity_cache_get("alice") == NULL);
+    CHECK(identity_cache_get("bob") == NULL);
+    put_body("carol", "{\"v\":1}", 1, generation);
+    CHECK(identity_cache_get("carol") == NULL);
+
+    identity_cache_cleanup();
+}
+
+static void test_memory_bound(void) {
+    const size_t max_bytes = IDENTITY_CACHE_SHARDS * 4096;
+    CHECK(identity_cache_init(max_bytes, 0) == 0);
+
+    char dna[16];
+    char body[200];
+    memset(body, 'x', sizeof(body) - 1);
+    body[sizeof(body) - 1] = '\0';
+    for (int i = 0; i < 2000; i++) {
+        snprintf(dna, sizeof(dna), "user%d", i);
+        put_body(dna, body, 1, identity_cache_generation(dna));
+    }
+
+    int entries = 0;
+    size_t bytes = 0;
+    identity_cache_stats(&entries, &bytes, NULL, NULL);
+    CHECK(entries > 0 && entries < 2000);
+    CHECK(bytes <= max_bytes);
+
+    // The newest entry survived
+    identity_cache_blob_t *blob = identity_cache_get("user1999");
+    CHECK(blob != NULL);
+    identity_cache_release(blob);
+
+    identity_cache_cleanup();
+}
+
+static void test_ttl(void) {
+    CHECK(identity_cache_init(1024 * 1024, 1) == 0);
+
+    put_body("alice", "{\"v\":1}", 1, identity_cache_generation("alice"));
+    test_sleep_ms(2100);
+    CHECK(identity_cache_get("alice") == NULL);
+
+    identity_cache_cleanup();
+}
+
+// Lookups racing writes must never leave an old version cached
+#define RACE_HANDLES 3
+#define RACE_WRITES 2000
+
+static const char *race_dna[RACE_HANDLES] = { "alice", "bob", "carol" };
+static int race_db_version[RACE_HANDLES];
+static int race_writers_done;
+
+static void* race_lookup(void *arg) {
+    (void)arg;
+    for (unsigned i = 0; !__atomic_load_n(&race_writers_done, __ATOMIC_ACQUIRE); i++) {
+        int h = (int)(i % RACE_HANDLES);
+        identity_cache_blob_t *cached = identity_cache_get(race_dna[h]);
+        if (cached) {
+            identity_cache_release(cached);
+            continue;
+        }
+
+        // Same order as api_lookup: generation, then "query", then put
+        uint64_t generation = identity_cache_generation(race_dna[h]);
+        int version = __atomic_load_n(&race_db_version[h], __ATOMIC_ACQUIRE);
+        put_body(race_dna[h], "{}", version, generation);
+    }
+    return NULL;
+}
+
+static void* race_write(void *arg) {
+    int h = *(int*)arg;
+    for (int i = 0; i < RACE_WRITES; i++) {
+        // Same order as db.c: commit the row, then invalidate
+        __atomic_add_fetch(&race_db_version[h], 1, __ATOMIC_RELEASE);
+        identity_cache_invalidate(race_dna[h]);
+    }
+    return NULL;
+}
+
+static void test_concurrent_writers(void) {
+    CHECK(identity_cache_init(1024 * 1024, 0) == 0);
+
+    pthread_t readers[4], writers[RACE_HANDLES];
+    int handles[RACE_HANDLES];
+    race_writers_done = 0;
+    for (int i = 0; i < 4; i++) {
+        pthread_create(&readers[i], NULL, race_lookup, NULL);
+    }
+    for (int h = 0; h < RACE_HANDLES; h++) {
+        race_db_version[h] = 0;
+        handles[h] = h;
+        pthread_create(&writers[h], NULL, race_write, &handles[h]);
+    }
+    for (int h = 0; h < RACE_HANDLES; h++) {
+        pthread_join(writers[h], NULL);
+    }
+    __atomic_store_n(&race_writers_done, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < 4; i++) {
+        pthread_join(readers[i], NULL);
+    }
+
+    for (int h = 0; h < RACE_HANDLES; h++) {
+        identity_cache_blob_t *blob = identity_cache_get(race_dna[h]);
+        CHECK(blob == NULL || blob->version == RACE_WRITES);
+        identity_cache_release(blob);
+    }
+
+    identity_cache_cleanup();
+}
+
+int main(void) {
+    log_min_level = LOG_LEVEL_ERROR;  // Expected warnings would bury the results
+
+    RUN(test_put_get);
+    RUN(test_invalidate);
+    RUN(test_memory_bound);
+    RUN(test_ttl);
+    RUN(test_concurrent_writers);
+
+    return test_summary();
+}
@@ -0,0 +1,112 @@
+/*
+ * Unit test: rate_limit (token buckets, slow refill, per-shard bucket cap)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "keyserver.h"
+#include "rate_limit.h"
+#include "tests/test_util.h"
+
+static int64_t fake_now = 1000000;
+
+static int64_t fake_clock(void) {
+    return fake_now;
+}
+
+static void test_burst_and_refill(void) {
+    const char *ip = "192.0.2.1";
+
+    // 3 per hour
+    CHECK(rate_limit_check(ip, RATE_LIMIT_TYPE_REGISTER));
+    CHECK(rate_limit_check(ip, RATE_LIMIT_TYPE_REGISTER));
+    CHECK(rate_limit_check(ip, RATE_LIMIT_TYPE_REGISTER));
+    CHECK(!rate_limit_check(ip, RATE_LIMIT_TYPE_REGISTER));
+
+    // Types are independent
+    CHECK(rate_limit_check(ip, RATE_LIMIT_TYPE_LOOKUP));
+
+    // One token back after a third of the period
+    fake_now += 1200 * 1000;
+    CHECK(rate_limit_check(ip, RATE_LIMIT_TYPE_REGISTER));
+    CHECK(!rate_limit_check(ip, RATE_LIMIT_TYPE_REGISTER));
+
+    // Never more than the burst
+    fake_now += 24 * 3600 * 1000;
+    for (int i = 0; i < 3; i++) {
+        CHECK(rate_limit_check(ip, RATE_LIMIT_TYPE_REGISTER));
+    }
+    CHECK(!rate_limit_check(ip, RATE_LIMIT_TYPE_REGISTER));
+}
+
+static void test_slow_refill_frequent_checks(void) {
+    const char *ip = "192.0.2.2";
+
+    // 1 per hour: a 3 ms step is worth less than one scaled token
+    CHECK(rate_limit_check(ip, RATE_LIMIT_TYPE_LIST));
+    CHECK(!rate_limit_check(ip, RATE_LIMIT_TYPE_LIST));
+
+    int64_t start = fake_now;
+    bool allowed = false;
+    while (!allowed && fake_now - start < 2 * 3600 * 1000) {
+        fake_now += 3;
+        allowed = rate_limit_check(ip, RATE_LIMIT_TYPE_LIST);
+        if (fake_now - start == 1800 * 1000) {
+            CHECK(!allowed);
+        }
+    }
+    CHECK(allowed);
+    CHECK(fake_now - start >= 3600 * 1000 - 3);
+    CHECK(fake_now - start <= 3600 * 1000 + 3);
+}
+
+static void test_bucket_cap(void) {
+    const size_t max_total = (size_t)RATE_LIMIT_SHARDS * RATE_LIMIT_SHARD_MAX_BUCKETS;
+    const char *busy = "198.51.100.1";
+    const char *quiet = "198.51.100.2";
+
+    for (int i = 0; i < 3; i++) {
+        rate_limit_check(busy, RATE_LIMIT_TYPE_REGISTER);
+        rate_limit_check(quiet, RATE_LIMIT_TYPE_REGISTER);
+    }
+    CHECK(!rate_limit_check(busy, RATE_LIMIT_TYPE_REGISTER));
+    CHECK(!rate_limit_check(quiet, RATE_LIMIT_TYPE_REGISTER));
+
+    // Flood with fresh addresses; the busy IP keeps being seen
+    char ip[46];
+    for (size_t i = 0; i < 2 * max_total; i++) {
+        snprintf(ip, sizeof(ip), "10.%zu.%zu.%zu", (i >> 16) & 0xFF, (i >> 8) & 0xFF, i & 0xFF);
+        rate_limit_check(ip, RATE_LIMIT_TYPE_LOOKUP);
+        if (i % 512 == 0) {
+            CHECK(!rate_limit_check(busy, RATE_LIMIT_TYPE_REGISTER));
+        }
+    }
+
+    CHECK(rate_limit_bucket_count() <= max_total);
+
+    // Still limited (recently seen); the quiet IP was forgotten and starts over
+    CHECK(!rate_limit_check(busy, RATE_LIMIT_TYPE_REGISTER));
+    CHECK(rate_limit_check(quiet, RATE_LIMIT_TYPE_REGISTER));
+}
+
+int main(void) {
+    log_min_level = LOG_LEVEL_ERROR;  // Expected warnings would bury the results
+
+    g_config.rate_limit_register_count = 3;
+    g_config.rate_limit_register_period = 3600;
+    g_config.rate_limit_lookup_count = 100;
+    g_config.rate_limit_lookup_period = 60;
+    g_config.rate_limit_list_count = 1;
+    g_config.rate_limit_list_period = 3600;
+
+    rate_limit_set_clock(fake_clock);
+    rate_limit_init();
+
+    RUN(test_burst_and_refill);
+    RUN(test_slow_refill_frequent_checks);
+    RUN(test_bucket_cap);
+
+    rate_limit_cleanup();
+    rate_limit_set_clock(NULL);
+    return test_summary();
+}
@@ -0,0 +1,322 @@
+/*
+ * Unit test: signature verify worker pool (results, callbacks, full
+ * queue, queue timeout, drain on cleanup, concurrent submitters)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "signature.h"
+#include "qgp_dilithium.h"
+#include "tests/test_util.h"
+
+static char *public_key_b64;
+static char *valid_sig_b64;
+static json_object *valid_payload;
+
+static char* base64_encode(const uint8_t *in, size_t len) {
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    char *out = malloc(4 * ((len + 2) / 3) + 1);
+    if (!out) {
+        return NULL;
+    }
+
+    size_t o = 0;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)in[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)in[i + 1] << 8;
+        if (i + 2 < len) v |= in[i + 2];
+        out[o++] = alphabet[(v >> 18) & 63];
+        out[o++] = alphabet[(v >> 12) & 63];
+        out[o++] = i + 1 < len ? alphabet[(v >> 6) & 63] : '=';
+        out[o++] = i + 2 < len ? alphabet[v & 63] : '=';
+    }
+    out[o] = '\0';
+    return out;
+}
+
+static json_object* make_payload(const char *dna) {
+    json_object *payload = json_object_new_object();
+    json_object_object_add(payload, "dna", json_object_new_string(dna));
+    json_object_object_add(payload, "version", json_object_new_int(1));
+    return payload;
+}
+
+// Sign a payload once; every job verifies against it
+static int setup_keys(void) {
+    static uint8_t pk[QGP_DILITHIUM3_PUBLICKEYBYTES];
+    static uint8_t sk[QGP_DILITHIUM3_SECRETKEYBYTES];
+    static uint8_t sig[QGP_DILITHIUM3_BYTES];
+    size_t siglen = 0;
+
+    if (qgp_dilithium3_keypair(pk, sk) != 0) {
+        return -1;
+    }
+
+    valid_payload = make_payload("alice");
+    char *canonical = signature_build_canonical_json(valid_payload);
+    if (!canonical) {
+        return -1;
+    }
+    int rc = qgp_dilithium3_signature(sig, &siglen, (const uint8_t*)canonical, strlen(canonical), sk);
+    free(canonical);
+    if (rc != 0 || siglen != sizeof(sig)) {
+        return -1;
+    }
+
+    public_key_b64 = base64_encode(pk, sizeof(pk));
+    valid_sig_b64 = base64_encode(sig, sizeof(sig));
+    return public_key_b64 && valid_sig_b64 ? 0 : -1;
+}
+
+// Completion flag a submitter can block on
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool done;
+} waiter_t;
+
+static void waiter_done(void *arg) {
+    waiter_t *w = arg;
+    pthread_mutex_lock(&w->lock);
+    w->done = true;
+    pthread_cond_signal(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+}
+
+static int wait_result(signature_job_t *job) {
+    waiter_t w = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, false };
+    if (signature_job_on_complete(job, waiter_done, &w)) {
+        pthread_mutex_lock(&w.lock);
+        while (!w.done) {
+            pthread_cond_wait(&w.cond, &w.lock);
+        }
+        pthread_mutex_unlock(&w.lock);
+    }
+    return signature_job_result(job);
+}
+
+// Callback that parks its worker until the test opens the gate
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool entered;
+    bool open;
+} gate = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, false, false };
+
+static void gate_block(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&gate.lock);
+    gate.entered = true;
+    pthread_cond_broadcast(&gate.cond);
+    while (!gate.open) {
+        pthread_cond_wait(&gate.cond, &gate.lock);
+    }
+    pthread_mutex_unlock(&gate.lock);
+}
+
+// Occupy the only worker; returns the blocking job
+static signature_job_t* gate_close(void) {
+    pthread_mutex_lock(&gate.lock);
+    gate.entered = false;
+    gate.open = false;
+    pthread_mutex_unlock(&gate.lock);
+
+    // Retry in the unlikely case the job finished before the callback was set
+    signature_job_t *job = NULL;
+    while (!job) {
+        job = signature_job_submit(valid_payload, valid_sig_b64, public_key_b64);
+        if (job && !signature_job_on_complete(job, gate_block, NULL)) {
+            signature_job_free(job);
+            job = NULL;
+        }
+    }
+
+    pthread_mutex_lock(&gate.lock);
+    while (!gate.entered) {
+        pthread_cond_wait(&gate.cond, &gate.lock);
+    }
+    pthread_mutex_unlock(&gate.lock);
+    return job;
+}
+
+static void gate_open(void) {
+    pthread_mutex_lock(&gate.lock);
+    gate.open = true;
+    pthread_cond_broadcast(&gate.cond);
+    pthread_mutex_unlock(&gate.lock);
+}
+
+static void* gate_open_later(void *arg) {
+    (void)arg;
+    test_sleep_ms(100);
+    gate_open();
+    return NULL;
+}
+
+static void test_results(void) {
+    CHECK(signature_pool_init(2, 0) == 0);
+
+    signature_job_t *job = signature_job_submit(valid_payload, valid_sig_b64, public_key_b64);
+    CHECK(job != NULL);
+    CHECK(wait_result(job) == 0);
+    CHECK(signature_job_payload(job) == valid_payload);
+    signature_job_free(job);
+
+    // Signed fields changed after signing
+    json_object *tampered = make_payload("mallory");
+    job = signature_job_submit(tampered, valid_sig_b64, public_key_b64);
+    json_object_put(tampered);  // The job keeps its own reference
+    CHECK(job != NULL);
+    CHECK(wait_result(job) == -1);
+    signature_job_free(job);
+
+    // Malformed base64 is invalid, not an error
+    job = signature_job_submit(valid_payload, "not base64!", public_key_b64);
+    CHECK(job != NULL);
+    CHECK(wait_result(job) == -1);
+    signature_job_free(job);
+
+    // Dropping the handle early is safe
+    job = signature_job_submit(valid_payload, valid_sig_b64, public_key_b64);
+    CHECK(job != NULL);
+    signature_job_free(job);
+
+    signature_pool_cleanup();
+}
+
+static void test_queue_full_and_timeout(void) {
+    CHECK(signature_pool_init(1, 1) == 0);
+
+    signature_job_t *blocker = gate_close();
+
+    signature_job_t *queued[SIGNATURE_QUEUE_PER_WORKER];
+    for (int i = 0; i < SIGNATURE_QUEUE_PER_WORKER; i++) {
+        queued[i] = signature_job_submit(valid_payload, valid_sig_b64, public_key_b64);
+        CHECK(queued[i] != NULL);
+    }
+    CHECK(signature_job_submit(valid_payload, valid_sig_b64, public_key_b64) == NULL);
+
+    // Unfinished jobs report an error rather than a verdict
+    CHECK(signature_job_result(queued[0]) == -2);
+
+    // Everything queued behind the stalled worker outlives the 1s timeout
+    test_sleep_ms(1200);
+    gate_open();
+    for (int i = 0; i < SIGNATURE_QUEUE_PER_WORKER; i++) {
+        if (queued[i]) {
+            CHECK(wait_result(queued[i]) == -2);
+            signature_job_free(queued[i]);
+        }
+    }
+    CHECK(signature_job_result(blocker) == 0);
+    signature_job_free(blocker);
+
+    // Room again once the queue drained
+    signature_job_t *job = signature_job_submit(valid_payload, valid_sig_b64, public_key_b64);
+    CHECK(job != NULL);
+    CHECK(wait_result(job) == 0);
+    signature_job_free(job);
+
+    signature_pool_cleanup();
+}
+
+static int drained;
+
+static void count_done(void *arg) {
+    (void)arg;
+    __atomic_add_fetch(&drained, 1, __ATOMIC_RELAXED);
+}
+
+static void test_cleanup_drains(void) {
+    CHECK(signature_pool_init(1, 0) == 0);
+
+    signature_job_t *blocker = gate_close();
+
+    signature_job_t *jobs[8];
+    int callbacks = 0;
+    drained = 0;
+    for (int i = 0; i < 8; i++) {
+        jobs[i] = signature_job_submit(valid_payload, valid_sig_b64, public_key_b64);
+        CHECK(jobs[i] != NULL);
+        if (jobs[i] && signature_job_on_complete(jobs[i], count_done, NULL)) {
+            callbacks++;
+        }
+    }
+    CHECK(callbacks == 8);
+
+    // Cleanup waits for the queue; open the gate from another thread
+    pthread_t opener;
+    pthread_create(&opener, NULL, gate_open_later, NULL);
+    signature_pool_cleanup();
+    pthread_join(opener, NULL);
+
+    CHECK(drained == callbacks);
+    for (int i = 0; i < 8; i++) {
+        if (jobs[i]) {
+            CHECK(signature_job_result(jobs[i]) == 0);
+            signature_job_free(jobs[i]);
+        }
+    }
+    signature_job_free(blocker);
+
+    // Stopped pool refuses work
+    CHECK(signature_job_submit(valid_payload, valid_sig_b64, public_key_b64) == NULL);
+}
+
+#define SUBMITTERS 4
+#define JOBS_PER_SUBMITTER 25
+
+static void* submitter(void *arg) {
+    int *failures = arg;
+    json_object *tampered = make_payload("mallory");
+
+    for (int i = 0; i < JOBS_PER_SUBMITTER; i++) {
+        bool expect_valid = (i % 2) == 0;
+        signature_job_t *job = signature_job_submit(expect_valid ? valid_payload : tampered,
+                                                    valid_sig_b64, public_key_b64);
+        if (!job || wait_result(job) != (expect_valid ? 0 : -1)) {
+            (*failures)++;
+        }
+        signature_job_free(job);
+    }
+
+    json_object_put(tampered);
+    return NULL;
+}
+
+static void test_concurrent_submitters(void) {
+    CHECK(signature_pool_init(3, 0) == 0);
+
+    pthread_t threads[SUBMITTERS];
+    int failures[SUBMITTERS] = { 0 };
+    for (int i = 0; i < SUBMITTERS; i++) {
+        pthread_create(&threads[i], NULL, submitter, &failures[i]);
+    }
+    for (int i = 0; i < SUBMITTERS; i++) {
+        pthread_join(threads[i], NULL);
+        CHECK(failures[i] == 0);
+    }
+
+    signature_pool_cleanup();
+}
+
+int main(void) {
+    log_min_level = LOG_LEVEL_ERROR;  // Expected warnings would bury the results
+
+    if (setup_keys() != 0) {
+        fprintf(stderr, "Failed to create test signature\n");
+        return 1;
+    }
+
+    RUN(test_results);
+    RUN(test_queue_full_and_timeout);
+    RUN(test_cleanup_drains);
+    RUN(test_concurrent_submitters);
+
+    json_object_put(valid_payload);
+    free(public_key_b64);
+    free(valid_sig_b64);
+    return test_summary();
+}
@@ -12,8 +12,6 @@
 #include <errno.h>
 #ifdef _WIN32
 #include <windows.h>
-#define popen _popen
-#define pclose _pclose
 #else
 #include <sys/time.h>
 #endif
@@ -32,10 +30,20 @@
 #include "qgp_aes.h"  // For qgp_aes256_encrypt
 #include "aes_keywrap.h"  // For aes256_wrap_key
 #include "qgp_random.h"  // For qgp_randombytes
+#include "http_client.h"  // For keyserver API requests
 
 // Global configuration
 static dna_config_t g_config;
 
+// Resident private keys (see RESIDENT PRIVATE KEYS)
+static void resident_keys_clear(messenger_context_t *ctx);
+static qgp_key_t* resident_sign_key(messenger_context_t *ctx);
+static qgp_key_t* resident_enc_key(messenger_context_t *ctx);
+
+// Background pubkey revalidation (see PERSISTENT PUBKEY STORE)
+static pubkey_revalidator_t* pubkey_revalidator_new(pubkey_store_t *store);
+static void pubkey_revalidator_free(pubkey_revalidator_t *rv);
+
 // ============================================================================
 // INITIALIZATION
 // ============================================================================
@@ -88,9 +96,58 @@ messenger_context_t* messenger_init(const char *identity) {
         return NULL;
     }
 
+    // Keyserver client (connects lazily on first lookup)
+    ctx->http = http_client_new(g_config.keyserver_url);
+    if (!ctx->http) {
+        fprintf(stderr, "Error: Invalid keyserver URL '%s'\n", g_config.keyserver_url);
+        dna_context_free(ctx->dna_ctx);
+        PQfinish(ctx->pg_conn);
+        free(ctx->identity);
+        free(ctx);
+        return NULL;
+    }
+
     // Initialize pubkey cache
-    ctx->cache_count = 0;
-    memset(ctx->cache, 0, sizeof(ctx->cache));
+    ctx->pubkey_cache = pubkey_cache_new((size_t)(g_config.pubkey_cache_size > 0 ? g_config.pubkey_cache_size : 0),
+                                         g_config.pubkey_cache_ttl);
+    if (!ctx->pubkey_cache) {
+        fprintf(stderr, "Error: Failed to create pubkey cache\n");
+        http_client_free(ctx->http);
+        dna_context_free(ctx->dna_ctx);
+        PQfinish(ctx->pg_conn);
+        free(ctx->identity);
+        free(ctx);
+        return NULL;
+    }
+
+    // Decrypted message cache (disk tier is attached once the Kyber key is loaded)
+    ctx->message_cache = plaintext_cache_new((size_t)(g_config.message_cache_size > 0 ? g_config.message_cache_size : 0), 0);
+    if (!ctx->message_cache) {
+        fprintf(stderr, "Error: Failed to create message cache\n");
+        pubkey_cache_free(ctx->pubkey_cache);
+        http_client_free(ctx->http);
+        dna_context_free(ctx->dna_ctx);
+        PQfinish(ctx->pg_conn);
+        free(ctx->identity);
+        free(ctx);
+        return NULL;
+    }
+
+    // Persistent pubkey store (optional - runs without it if ~/.dna is unusable)
+    const char *home = qgp_platform_home_dir();
+    if (home) {
+        char store_path[512];
+        snprintf(store_path, sizeof(store_path), "%s/.dna", home);
+        if (qgp_platform_is_directory(store_path)) {
+            snprintf(store_path, sizeof(store_path), "%s/.dna/%s", home, PUBKEY_STORE_FILE_NAME);
+            ctx->pubkey_store = pubkey_store_open(store_path);
+            if (!ctx->pubkey_store) {
+                fprintf(stderr, "Warning: Failed to open pubkey store %s\n", store_path);
+            } else {
+                ctx->revalidator = pubkey_revalidator_new(ctx->pubkey_store);
+            }
+        }
+    }
 
     printf("✓ Messenger initialized for '%s'\n", identity);
     printf("✓ Connected to PostgreSQL: dna_messenger\n");
@@ -103,11 +160,21 @@ void messenger_free(messenger_context_t *ctx) {
         return;
     }
 
+    messenger_unsubscribe(ctx);
+
+    // Wipe resident private keys and decrypted messages
+    resident_keys_clear(ctx);
+    plaintext_cache_free(ctx->message_cache);
+
+    // Stop background revalidation before closing the store it writes to
+    pubkey_revalidator_free(ctx->revalidator);
+    pubkey_store_close(ctx->pubkey_store);
+
     // Free pubkey cache
-    for (int i = 0; i < ctx->cache_count; i++) {
-        free(ctx->cache[i].identity);
-        free(ctx->cache[i].signing_pubkey);
-        free(ctx->cache[i].encryption_pubkey);
+    pubkey_cache_free(ctx->pubkey_cache);
+
+    if (ctx->http) {
+        http_client_free(ctx->http);
     }
 
     if (ctx->dna_ctx) {
@@ -122,6 +189,136 @@ void messenger_free(messenger_context_t *ctx) {
     free(ctx);
 }
 
+// ============================================================================
+// RESIDENT PRIVATE KEYS
+// ============================================================================
+
+/**
+ * Load ~/.dna/<identity>-<suffix>.pqkey and lock its private part in RAM
+ * Returns key (free with resident_key_free), NULL on error
+ */
+static qgp_key_t* resident_key_load(messenger_context_t *ctx, const char *suffix,
+                                    size_t expected_private_size) {
+    const char *home = qgp_platform_home_dir();
+    if (!home) {
+        fprintf(stderr, "Error: Cannot get home directory\n");
+        return NULL;
+    }
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/.dna/%s-%s.pqkey", home, ctx->identity, suffix);
+
+    qgp_key_t *key = NULL;
+    if (qgp_key_load(path, &key) != 0) {
+        fprintf(stderr, "Error: Cannot load private key from %s\n", path);
+        return NULL;
+    }
+
+    if (key->private_key_size != expected_private_size) {
+        fprintf(stderr, "Error: Invalid private key size in %s: %zu (expected %zu)\n",
+                path, key->private_key_size, expected_private_size);
+        qgp_key_free(key);
+        return NULL;
+    }
+
+    // Best effort: keep the key out of swap (may exceed RLIMIT_MEMLOCK)
+    if (qgp_platform_lock_memory(key->private_key, key->private_key_size) != 0) {
+        fprintf(stderr, "Warning: Could not lock private key in memory (%s)\n", suffix);
+    }
+
+    return key;
+}
+
+static void resident_key_free(qgp_key_t *key) {
+    if (!key) {
+        return;
+    }
+
+    if (key->private_key) {
+        qgp_platform_secure_zero(key->private_key, key->private_key_size);
+        qgp_platform_unlock_memory(key->private_key, key->private_key_size);
+    }
+    qgp_key_free(key);
+}
+
+/**
+ * Wipe both resident keys; they are reloaded from disk on next use
+ * (both go together: munlock is per page, not per allocation)
+ */
+static void resident_keys_clear(messenger_context_t *ctx) {
+    // Disk tier key is derived from the Kyber key
+    plaintext_cache_detach_disk(ctx->message_cache);
+
+    resident_key_free(ctx->sign_key);
+    resident_key_free(ctx->enc_key);
+    ctx->sign_key = NULL;
+    ctx->enc_key = NULL;
+}
+
+static qgp_key_t* resident_sign_key(messenger_context_t *ctx) {
+    if (!ctx->sign_key) {
+        ctx->sign_key = resident_key_load(ctx, "dilithium", QGP_DILITHIUM3_SECRETKEYBYTES);
+    }
+    return ctx->sign_key;
+}
+
+/**
+ * Attach the encrypted on-disk message cache (~/.dna/<identity>-messages.cache)
+ * Key = SHA-256("DNA message cache v1" || Kyber private key)
+ */
+static void message_cache_attach_disk(messenger_context_t *ctx, const qgp_key_t *enc_key) {
+    static const char label[] = "DNA message cache v1";
+    const char *home = qgp_platform_home_dir();
+    if (!home) {
+        return;
+    }
+
+    uint8_t key[32];
+    unsigned int key_len = 0;
+    EVP_MD_CTX *md = EVP_MD_CTX_new();
+    int ok = md &&
+             EVP_DigestInit_ex(md, EVP_sha256(), NULL) == 1 &&
+             EVP_DigestUpdate(md, label, sizeof(label) - 1) == 1 &&
+             EVP_DigestUpdate(md, enc_key->private_key, enc_key->private_key_size) == 1 &&
+             EVP_DigestFinal_ex(md, key, &key_len) == 1 && key_len == sizeof(key);
+    EVP_MD_CTX_free(md);
+
+    if (ok) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/.dna/%s-messages.cache", home, ctx->identity);
+        if (plaintext_cache_attach_disk(ctx->message_cache, path, key) != 0) {
+            fprintf(stderr, "Warning: Failed to open message cache %s\n", path);
+        }
+    }
+
+    qgp_platform_secure_zero(key, sizeof(key));
+}
+
+static qgp_key_t* resident_enc_key(messenger_context_t *ctx) {
+    if (!ctx->enc_key) {
+        ctx->enc_key = resident_key_load(ctx, "kyber512", QGP_KYBER512_SECRETKEYBYTES);
+        if (ctx->enc_key && g_config.message_cache_disk) {
+            message_cache_attach_disk(ctx, ctx->enc_key);
+        }
+    }
+    return ctx->enc_key;
+}
+
+int messenger_reload_keys(messenger_context_t *ctx) {
+    if (!ctx) {
+        return -1;
+    }
+
+    resident_keys_clear(ctx);
+
+    if (!resident_sign_key(ctx) || !resident_enc_key(ctx)) {
+        resident_keys_clear(ctx);
+        return -1;
+    }
+
+    return 0;
+}
+
 // ============================================================================
 // KEY GENERATION
 // ============================================================================
@@ -131,6 +328,9 @@ int messenger_generate_keys(messenger_context_t *ctx, const char *identity) {
         return -1;
     }
 
+    // Key files are about to be replaced - drop resident copies
+    resident_keys_clear(ctx);
+
     // Check if identity already exists in keyserver
     uint8_t *existing_sign = NULL, *existing_enc = NULL;
     size_t sign_len = 0, enc_len = 0;
@@ -239,6 +439,9 @@ int messenger_restore_keys(messenger_context_t *ctx, const char *identity) {
         return -1;
     }
 
+    // Key files are about to be replaced - drop resident copies
+    resident_keys_clear(ctx);
+
     // Check if identity already exists in keyserver
     uint8_t *existing_sign = NULL, *existing_enc = NULL;
     size_t sign_len = 0, enc_len = 0;
@@ -343,6 +546,9 @@ int messenger_restore_keys_from_file(messenger_context_t *ctx, const char *ident
         return -1;
     }
 
+    // Key files are about to be replaced - drop resident copies
+    resident_keys_clear(ctx);
+
     // For restore, identity MUST exist in keyserver
     // We're verifying the restored keys match what's already there
     uint8_t *keyserver_sign = NULL, *keyserver_enc = NULL;
@@ -791,117 +997,106 @@ static size_t base64_decode(const char *input, uint8_t **output) {
     return decoded_size;
 }
 
-int messenger_load_pubkey(
-    messenger_context_t *ctx,
-    const char *identity,
-    uint8_t **signing_pubkey_out,
-    size_t *signing_pubkey_len_out,
-    uint8_t **encryption_pubkey_out,
-    size_t *encryption_pubkey_len_out
-) {
-    if (!ctx || !identity) {
-        return -1;
-    }
-
-    // Check cache first
-    for (int i = 0; i < ctx->cache_count; i++) {
-        if (strcmp(ctx->cache[i].identity, identity) == 0) {
-            // Cache hit - duplicate and return
-            *signing_pubkey_out = malloc(ctx->cache[i].signing_pubkey_len);
-            *encryption_pubkey_out = malloc(ctx->cache[i].encryption_pubkey_len);
-
-            if (!*signing_pubkey_out || !*encryption_pubkey_out) {
-                free(*signing_pubkey_out);
-                free(*encryption_pubkey_out);
-                return -1;
-            }
+// Incremental JSON parse state for streamed HTTP bodies
+typedef struct {
+    struct json_tokener *tok;
+    struct json_object *root;
+    enum json_tokener_error err;
+} json_stream_t;
 
-            memcpy(*signing_pubkey_out, ctx->cache[i].signing_pubkey, ctx->cache[i].signing_pubkey_len);
-            memcpy(*encryption_pubkey_out, ctx->cache[i].encryption_pubkey, ctx->cache[i].encryption_pubkey_len);
-            *signing_pubkey_len_out = ctx->cache[i].signing_pubkey_len;
-            *encryption_pubkey_len_out = ctx->cache[i].encryption_pubkey_len;
+static int json_stream_feed(const char *data, size_t len, void *userdata) {
+    json_stream_t *js = (json_stream_t*)userdata;
 
-            return 0;
-        }
+    // Already complete (trailing whitespace/newline) or already failed
+    if (js->root || js->err != json_tokener_continue) {
+        return 0;
     }
 
-    // Cache miss - fetch from API: https://cpunk.io/api/keyserver/lookup/<identity>
-    char url[512];
-    snprintf(url, sizeof(url), "https://cpunk.io/api/keyserver/lookup/%s", identity);
+    js->root = json_tokener_parse_ex(js->tok, data, (int)len);
+    js->err = json_tokener_get_error(js->tok);
+    return (!js->root && js->err != json_tokener_continue) ? -1 : 0;
+}
 
-    char cmd[1024];
-#ifdef _WIN32
-    snprintf(cmd, sizeof(cmd), "curl -s \"%s\"", url);
-#else
-    snprintf(cmd, sizeof(cmd), "curl -s '%s'", url);
-#endif
+/**
+ * Request <keyserver_url><path> and parse the response body as JSON
+ * GET if json_body is NULL, otherwise POST json_body as application/json
+ * Returns parsed root (caller must json_object_put), NULL on error or 304
+ */
+static struct json_object* keyserver_request_json(http_client_t *http, const char *path,
+                                                  const char *json_body, int *status_out) {
+    json_stream_t js;
+    js.tok = json_tokener_new();
+    js.root = NULL;
+    js.err = json_tokener_continue;
+    if (!js.tok) {
+        return NULL;
+    }
 
-    FILE *fp = popen(cmd, "r");
-    if (!fp) {
-        fprintf(stderr, "Error: Failed to fetch public key from API\n");
-        return -1;
+    int status = 0;
+    int rc;
+    if (json_body) {
+        rc = http_client_request(http, "POST", path, "application/json",
+                                 json_body, strlen(json_body),
+                                 json_stream_feed, &js, &status);
+    } else {
+        rc = http_client_get(http, path, json_stream_feed, &js, &status);
     }
 
-    // Read response (up to 10KB)
-    char response[10240];
-    size_t response_len = fread(response, 1, sizeof(response) - 1, fp);
-    response[response_len] = '\0';
-    pclose(fp);
+    // Flush a top-level value that needs a terminator (e.g. bare number)
+    if (rc == 0 && !js.root && js.err == json_tokener_continue) {
+        js.root = json_tokener_parse_ex(js.tok, "", 1);
+    }
+    json_tokener_free(js.tok);
 
-    // Trim whitespace and newlines (Windows CRLF issue)
-    while (response_len > 0 &&
-           (response[response_len-1] == '\n' ||
-            response[response_len-1] == '\r' ||
-            response[response_len-1] == ' ' ||
-            response[response_len-1] == '\t')) {
-        response[--response_len] = '\0';
+    if (status_out) {
+        *status_out = status;
     }
 
-    // Parse JSON response using json-c
-    struct json_object *root = json_tokener_parse(response);
-    if (!root) {
-        fprintf(stderr, "Error: Failed to parse JSON response for '%s'\n", identity);
-        fprintf(stderr, "Raw response (%zu bytes): '%s'\n", response_len, response);
-        return -1;
+    if (rc != 0) {
+        fprintf(stderr, "Error: Keyserver request failed: %s%s\n", g_config.keyserver_url, path);
+        if (js.root) {
+            json_object_put(js.root);
+        }
+        return NULL;
     }
 
-    // Check success field
-    struct json_object *success_obj = json_object_object_get(root, "success");
-    if (!success_obj || !json_object_get_boolean(success_obj)) {
-        fprintf(stderr, "Error: API returned failure for identity '%s'\n", identity);
-        json_object_put(root);
-        return -1;
+    // Conditional request answered 304: no body, caller checks *status_out
+    if (status == 304) {
+        if (js.root) {
+            json_object_put(js.root);
+        }
+        return NULL;
     }
 
-    // Get data object
-    struct json_object *data_obj = json_object_object_get(root, "data");
-    if (!data_obj) {
-        fprintf(stderr, "Error: No 'data' field in API response\n");
-        json_object_put(root);
-        return -1;
+    if (!js.root) {
+        fprintf(stderr, "Error: Failed to parse keyserver response (HTTP %d)\n", status);
+        return NULL;
     }
 
-    // Extract base64-encoded public keys
+    return js.root;
+}
+
+/**
+ * Decode dilithium_pub / kyber_pub (and optionally version) from a keyserver "data" object
+ * Returns 0 on success (caller frees outputs), -1 on error
+ */
+static int keyserver_decode_pubkeys(struct json_object *data_obj,
+                                    uint8_t **signing_pubkey_out, size_t *signing_pubkey_len_out,
+                                    uint8_t **encryption_pubkey_out, size_t *encryption_pubkey_len_out,
+                                    uint32_t *version_out) {
     struct json_object *dilithium_obj = json_object_object_get(data_obj, "dilithium_pub");
     struct json_object *kyber_obj = json_object_object_get(data_obj, "kyber_pub");
 
     if (!dilithium_obj || !kyber_obj) {
         fprintf(stderr, "Error: Missing public keys in API response\n");
-        json_object_put(root);
         return -1;
     }
 
-    const char *dilithium_b64 = json_object_get_string(dilithium_obj);
-    const char *kyber_b64 = json_object_get_string(kyber_obj);
-
-    // Decode base64
     uint8_t *dilithium_decoded = NULL;
     uint8_t *kyber_decoded = NULL;
 
-    size_t dilithium_len = base64_decode(dilithium_b64, &dilithium_decoded);
-    size_t kyber_len = base64_decode(kyber_b64, &kyber_decoded);
-
-    json_object_put(root);
+    size_t dilithium_len = base64_decode(json_object_get_string(dilithium_obj), &dilithium_decoded);
+    size_t kyber_len = base64_decode(json_object_get_string(kyber_obj), &kyber_decoded);
 
     if (dilithium_len == 0 || kyber_len == 0) {
         fprintf(stderr, "Error: Base64 decode failed\n");
@@ -915,189 +1110,800 @@ int messenger_load_pubkey(
     *encryption_pubkey_out = kyber_decoded;
     *encryption_pubkey_len_out = kyber_len;
 
-    printf("✓ Fetched public key for '%s' from API (dilithium: %zu bytes, kyber: %zu bytes)\n",
-           identity, dilithium_len, kyber_len);
-
-    // Add to cache (if space available)
-    if (ctx->cache_count < PUBKEY_CACHE_SIZE) {
-        pubkey_cache_entry_t *entry = &ctx->cache[ctx->cache_count];
-        entry->identity = strdup(identity);
-        entry->signing_pubkey = malloc(dilithium_len);
-        entry->encryption_pubkey = malloc(kyber_len);
-
-        if (entry->identity && entry->signing_pubkey && entry->encryption_pubkey) {
-            memcpy(entry->signing_pubkey, dilithium_decoded, dilithium_len);
-            memcpy(entry->encryption_pubkey, kyber_decoded, kyber_len);
-            entry->signing_pubkey_len = dilithium_len;
-            entry->encryption_pubkey_len = kyber_len;
-            ctx->cache_count++;
-        } else {
-            // Cleanup on allocation failure
-            free(entry->identity);
-            free(entry->signing_pubkey);
-            free(entry->encryption_pubkey);
-        }
+    if (version_out) {
+        struct json_object *version_obj = json_object_object_get(data_obj, "version");
+        *version_out = version_obj ? (uint32_t)json_object_get_int(version_obj) : 0;
     }
-
     return 0;
 }
 
-int messenger_list_pubkeys(messenger_context_t *ctx) {
-    if (!ctx) {
-        return -1;
-    }
+// ============================================================================
+// PERSISTENT PUBKEY STORE (~/.dna/pubkeys.cache)
+// ============================================================================
 
-    // Fetch from cpunk.io API
-    const char *url = "https://cpunk.io/api/keyserver/list";
-    char cmd[1024];
-#ifdef _WIN32
-    snprintf(cmd, sizeof(cmd), "curl -s \"%s\"", url);
-#else
-    snprintf(cmd, sizeof(cmd), "curl -s '%s'", url);
-#endif
+/**
+ * Background revalidation of keys served from the on-disk store
+ *
+ * Store records older than pubkey_cache_ttl are still served immediately
+ * (stale-while-revalidate) and queued here. A worker thread re-checks them
+ * against the keyserver with its own HTTP client, using conditional lookups
+ * (304 Not Modified while the version is unchanged), and refreshes the store.
+ * Identities whose keys changed are reported back via `updated`; the owning
+ * thread drops them from the memory cache in pubkey_revalidate_apply(), so
+ * the memory cache itself is never touched from the worker.
+ */
+struct pubkey_revalidator {
+    qgp_mutex_t *lock;
+    qgp_thread_t *thread;
+    int running;                 // Worker started and not yet finished
+    int stop;                    // Set by messenger_free
+    pubkey_store_t *store;
 
-    FILE *fp = popen(cmd, "r");
-    if (!fp) {
-        fprintf(stderr, "Error: Failed to fetch identity list from keyserver\n");
-        return -1;
-    }
+    char **pending;              // Identities to revalidate
+    size_t pending_count;
+    size_t pending_cap;
 
-    char response[102400]; // 100KB buffer for large lists
-    size_t response_len = fread(response, 1, sizeof(response) - 1, fp);
-    response[response_len] = '\0';
-    pclose(fp);
+    char **updated;              // Identities whose keys changed
+    size_t updated_count;
+    size_t updated_cap;
+};
 
-    // Trim whitespace
-    while (response_len > 0 &&
-           (response[response_len-1] == '\n' ||
-            response[response_len-1] == '\r' ||
-            response[response_len-1] == ' ' ||
-            response[response_len-1] == '\t')) {
-        response[--response_len] = '\0';
+// Maximum identities per POST /lookup_batch (keyserver MAX_LOOKUP_BATCH)
+#define KEYSERVER_LOOKUP_BATCH_MAX 100
+
+/**
+ * Append a copy of s to list unless already present
+ * Returns 0 on success, -1 on allocation failure
+ */
+static int identity_list_add(char ***list, size_t *count, size_t *cap, const char *s) {
+    for (size_t i = 0; i < *count; i++) {
+        if (strcmp((*list)[i], s) == 0) {
+            return 0;
+        }
     }
 
-    // Parse JSON response
-    struct json_object *root = json_tokener_parse(response);
-    if (!root) {
-        fprintf(stderr, "Error: Failed to parse JSON response\n");
-        return -1;
+    if (*count == *cap) {
+        size_t new_cap = *cap ? *cap * 2 : 16;
+        char **grown = realloc(*list, new_cap * sizeof(char*));
+        if (!grown) {
+            return -1;
+        }
+        *list = grown;
+        *cap = new_cap;
     }
 
-    // Check success field
-    struct json_object *success_obj = json_object_object_get(root, "success");
-    if (!success_obj || !json_object_get_boolean(success_obj)) {
-        fprintf(stderr, "Error: API returned failure\n");
-        json_object_put(root);
+    char *copy = strdup(s);
+    if (!copy) {
         return -1;
     }
+    (*list)[(*count)++] = copy;
+    return 0;
+}
 
-    // Get total count
-    struct json_object *total_obj = json_object_object_get(root, "total");
-    int total = total_obj ? json_object_get_int(total_obj) : 0;
+static void identity_list_clear(char **list, size_t *count) {
+    for (size_t i = 0; i < *count; i++) {
+        free(list[i]);
+    }
+    *count = 0;
+}
 
-    printf("\n=== Keyserver (%d identities) ===\n\n", total);
+/**
+ * Store a keyserver answer for identity; record it as updated if keys changed
+ */
+static void pubkey_revalidate_result(pubkey_revalidator_t *rv, const char *identity,
+                                     struct json_object *data_obj) {
+    uint8_t *sign_pk = NULL, *enc_pk = NULL;
+    size_t sign_len = 0, enc_len = 0;
+    uint32_t version = 0;
 
-    // Get identities array
-    struct json_object *identities_obj = json_object_object_get(root, "identities");
-    if (!identities_obj || !json_object_is_type(identities_obj, json_type_array)) {
-        json_object_put(root);
-        return 0;
+    if (keyserver_decode_pubkeys(data_obj, &sign_pk, &sign_len, &enc_pk, &enc_len, &version) != 0) {
+        return;
     }
 
-    int count = json_object_array_length(identities_obj);
-    for (int i = 0; i < count; i++) {
-        struct json_object *identity_obj = json_object_array_get_idx(identities_obj, i);
-        if (!identity_obj) continue;
-
-        struct json_object *dna_obj = json_object_object_get(identity_obj, "dna");
-        struct json_object *registered_obj = json_object_object_get(identity_obj, "registered_at");
+    int changed = 1;
+    pubkey_store_record_t old;
+    if (pubkey_store_get(rv->store, identity, &old) == 0) {
+        changed = old.key_version != version ||
+                  old.signing_pubkey_len != sign_len ||
+                  old.encryption_pubkey_len != enc_len ||
+                  memcmp(old.signing_pubkey, sign_pk, sign_len) != 0 ||
+                  memcmp(old.encryption_pubkey, enc_pk, enc_len) != 0;
+        pubkey_store_record_free(&old);
+    }
 
-        const char *identity = dna_obj ? json_object_get_string(dna_obj) : "unknown";
-        const char *registered_at = registered_obj ? json_object_get_string(registered_obj) : "unknown";
+    // Unchanged keys are re-appended too, refreshing fetched_at
+    pubkey_store_put(rv->store, identity, sign_pk, sign_len, enc_pk, enc_len,
+                     version, (int64_t)time(NULL));
 
-        printf("  %s (added: %s)\n", identity, registered_at);
+    if (changed) {
+        printf("✓ Public key for '%s' changed on keyserver, refreshed local cache\n", identity);
+        qgp_platform_mutex_lock(rv->lock);
+        identity_list_add(&rv->updated, &rv->updated_count, &rv->updated_cap, identity);
+        qgp_platform_mutex_unlock(rv->lock);
     }
 
-    printf("\n");
-    json_object_put(root);
-    return 0;
+    free(sign_pk);
+    free(enc_pk);
 }
 
 /**
- * Get contact list (identities from keyserver)
+ * Revalidate one identity with a conditional GET /lookup/<identity>?since_version=<v>
+ * 304 only refreshes fetched_at; a full answer goes through pubkey_revalidate_result
+ * (keyservers without conditional lookups always send the full answer)
  */
-int messenger_get_contact_list(messenger_context_t *ctx, char ***identities_out, int *count_out) {
-    if (!ctx || !identities_out || !count_out) {
-        return -1;
+static void pubkey_revalidate_identity(pubkey_revalidator_t *rv, http_client_t *http,
+                                       const char *identity) {
+    pubkey_store_record_t old;
+    if (pubkey_store_get(rv->store, identity, &old) != 0) {
+        return;
     }
 
-    // Fetch from cpunk.io API
-    const char *url = "https://cpunk.io/api/keyserver/list";
-    char cmd[1024];
-#ifdef _WIN32
-    snprintf(cmd, sizeof(cmd), "curl -s \"%s\"", url);
-#else
-    snprintf(cmd, sizeof(cmd), "curl -s '%s'", url);
-#endif
-
-    FILE *fp = popen(cmd, "r");
-    if (!fp) {
-        fprintf(stderr, "Error: Failed to fetch identity list from keyserver\n");
-        return -1;
+    char escaped[256];
+    char path[340];
+    if (http_client_escape(identity, escaped, sizeof(escaped)) != 0) {
+        pubkey_store_record_free(&old);
+        return;
     }
+    snprintf(path, sizeof(path), "/lookup/%s?since_version=%u", escaped, old.key_version);
 
-    char response[102400]; // 100KB buffer for large lists
-    size_t response_len = fread(response, 1, sizeof(response) - 1, fp);
-    response[response_len] = '\0';
-    pclose(fp);
+    int status = 0;
+    struct json_object *root = keyserver_request_json(http, path, NULL, &status);
 
-    // Trim whitespace
-    while (response_len > 0 &&
-           (response[response_len-1] == '\n' ||
-            response[response_len-1] == '\r' ||
-            response[response_len-1] == ' ' ||
-            response[response_len-1] == '\t')) {
-        response[--response_len] = '\0';
+    if (!root && status == 304) {
+        // Unchanged: re-append the same keys with a new fetched_at
+        pubkey_store_put(rv->store, identity, old.signing_pubkey, old.signing_pubkey_len,
+                         old.encryption_pubkey, old.encryption_pubkey_len,
+                         old.key_version, (int64_t)time(NULL));
     }
+    pubkey_store_record_free(&old);
 
-    // Parse JSON response
-    struct json_object *root = json_tokener_parse(response);
     if (!root) {
-        fprintf(stderr, "Error: Failed to parse JSON response\n");
-        return -1;
+        return;
     }
 
-    // Check success field
     struct json_object *success_obj = json_object_object_get(root, "success");
-    if (!success_obj || !json_object_get_boolean(success_obj)) {
-        fprintf(stderr, "Error: API returned failure\n");
-        json_object_put(root);
-        return -1;
+    struct json_object *data_obj = json_object_object_get(root, "data");
+    if (success_obj && json_object_get_boolean(success_obj) && data_obj) {
+        pubkey_revalidate_result(rv, identity, data_obj);
     }
+    json_object_put(root);
+}
 
-    // Get identities array
-    struct json_object *identities_obj = json_object_object_get(root, "identities");
-    if (!identities_obj || !json_object_is_type(identities_obj, json_type_array)) {
-        *identities_out = NULL;
-        *count_out = 0;
-        json_object_put(root);
-        return 0;
+/**
+ * Worker thread: drain pending identities, then exit
+ */
+static void* pubkey_revalidate_worker(void *arg) {
+    pubkey_revalidator_t *rv = (pubkey_revalidator_t*)arg;
+    http_client_t *http = http_client_new(g_config.keyserver_url);
+
+    for (;;) {
+        char *batch[KEYSERVER_LOOKUP_BATCH_MAX];
+        size_t n = 0;
+
+        qgp_platform_mutex_lock(rv->lock);
+        if (rv->stop || !http || rv->pending_count == 0) {
+            identity_list_clear(rv->pending, &rv->pending_count);
+            rv->running = 0;
+            qgp_platform_mutex_unlock(rv->lock);
+            break;
+        }
+        while (n < KEYSERVER_LOOKUP_BATCH_MAX && rv->pending_count > 0) {
+            batch[n++] = rv->pending[--rv->pending_count];
+        }
+        qgp_platform_mutex_unlock(rv->lock);
+
+        for (size_t i = 0; i < n; i++) {
+            pubkey_revalidate_identity(rv, http, batch[i]);
+            free(batch[i]);
+        }
     }
 
-    int rows = json_object_array_length(identities_obj);
-    *count_out = rows;
+    http_client_free(http);
+    return NULL;
+}
 
-    if (rows == 0) {
-        *identities_out = NULL;
-        json_object_put(root);
-        return 0;
+static pubkey_revalidator_t* pubkey_revalidator_new(pubkey_store_t *store) {
+    pubkey_revalidator_t *rv = calloc(1, sizeof(pubkey_revalidator_t));
+    if (!rv) {
+        return NULL;
     }
 
-    // Allocate array of string pointers
-    char **identities = (char**)malloc(sizeof(char*) * rows);
-    if (!identities) {
-        fprintf(stderr, "Memory allocation failed\n");
-        json_object_put(root);
+    rv->lock = qgp_platform_mutex_new();
+    if (!rv->lock) {
+        free(rv);
+        return NULL;
+    }
+    rv->store = store;
+    return rv;
+}
+
+static void pubkey_revalidator_free(pubkey_revalidator_t *rv) {
+    if (!rv) {
+        return;
+    }
+
+    qgp_platform_mutex_lock(rv->lock);
+    rv->stop = 1;
+    qgp_thread_t *thread = rv->thread;
+    rv->thread = NULL;
+    qgp_platform_mutex_unlock(rv->lock);
+
+    // Waits for an in-flight request (bounded by the HTTP client timeout)
+    qgp_platform_thread_join(thread);
+
+    identity_list_clear(rv->pending, &rv->pending_count);
+    identity_list_clear(rv->updated, &rv->updated_count);
+    free(rv->pending);
+    free(rv->updated);
+    qgp_platform_mutex_free(rv->lock);
+    free(rv);
+}
+
+/**
+ * Queue identity for background revalidation, starting the worker if idle
+ */
+static void pubkey_revalidate_schedule(messenger_context_t *ctx, const char *identity) {
+    pubkey_revalidator_t *rv = ctx->revalidator;
+    if (!rv) {
+        return;
+    }
+
+    qgp_platform_mutex_lock(rv->lock);
+    if (rv->stop || identity_list_add(&rv->pending, &rv->pending_count, &rv->pending_cap, identity) != 0 ||
+        rv->running) {
+        qgp_platform_mutex_unlock(rv->lock);
+        return;
+    }
+
+    // Previous worker (if any) has finished - reap it and start a new one
+    qgp_thread_t *finished = rv->thread;
+    rv->thread = NULL;
+    rv->running = 1;
+    qgp_platform_mutex_unlock(rv->lock);
+
+    qgp_platform_thread_join(finished);
+    qgp_thread_t *thread = qgp_platform_thread_create(pubkey_revalidate_worker, rv);
+
+    qgp_platform_mutex_lock(rv->lock);
+    if (thread) {
+        rv->thread = thread;
+    } else {
+        rv->running = 0;
+    }
+    qgp_platform_mutex_unlock(rv->lock);
+}
+
+/**
+ * Drop identities whose keys the worker found changed from the memory cache
+ * (next lookup reloads them from the refreshed store)
+ */
+static void pubkey_revalidate_apply(messenger_context_t *ctx) {
+    pubkey_revalidator_t *rv = ctx->revalidator;
+    if (!rv) {
+        return;
+    }
+
+    qgp_platform_mutex_lock(rv->lock);
+    for (size_t i = 0; i < rv->updated_count; i++) {
+        pubkey_cache_remove(ctx->pubkey_cache, rv->updated[i]);
+    }
+    identity_list_clear(rv->updated, &rv->updated_count);
+    qgp_platform_mutex_unlock(rv->lock);
+}
+
+/**
+ * Insert keys fetched from the keyserver into the memory cache and the store
+ * Returns borrowed memory cache entry, NULL on allocation failure
+ */
+static const pubkey_cache_entry_t* pubkey_cache_insert(messenger_context_t *ctx, const char *identity,
+                                                       const uint8_t *signing_pubkey, size_t signing_pubkey_len,
+                                                       const uint8_t *encryption_pubkey, size_t encryption_pubkey_len,
+                                                       uint32_t key_version) {
+    if (ctx->pubkey_store) {
+        pubkey_store_put(ctx->pubkey_store, identity, signing_pubkey, signing_pubkey_len,
+                         encryption_pubkey, encryption_pubkey_len, key_version, (int64_t)time(NULL));
+    }
+
+    return pubkey_cache_put(ctx->pubkey_cache, identity, signing_pubkey, signing_pubkey_len,
+                            encryption_pubkey, encryption_pubkey_len);
+}
+
+/**
+ * Look up identity without network: memory cache, then on-disk store
+ * Stale store records are served and queued for background revalidation
+ * Returns borrowed memory cache entry, NULL if not cached locally
+ */
+static const pubkey_cache_entry_t* pubkey_lookup_local(messenger_context_t *ctx, const char *identity) {
+    pubkey_revalidate_apply(ctx);
+
+    const pubkey_cache_entry_t *entry = pubkey_cache_get(ctx->pubkey_cache, identity);
+    if (entry || !ctx->pubkey_store) {
+        return entry;
+    }
+
+    pubkey_store_record_t record;
+    if (pubkey_store_get(ctx->pubkey_store, identity, &record) != 0) {
+        return NULL;
+    }
+
+    entry = pubkey_cache_put(ctx->pubkey_cache, identity,
+                             record.signing_pubkey, record.signing_pubkey_len,
+                             record.encryption_pubkey, record.encryption_pubkey_len);
+
+    if (entry && g_config.pubkey_cache_ttl > 0 &&
+        (int64_t)time(NULL) - record.fetched_at >= g_config.pubkey_cache_ttl) {
+        pubkey_revalidate_schedule(ctx, identity);
+    }
+
+    pubkey_store_record_free(&record);
+    return entry;
+}
+
+/**
+ * Expanded signing key of identity, if its keys are in the memory cache
+ * Expanded on first use and kept with the cache entry (within the cache's
+ * expanded-key budget), so repeated verifications of one sender skip
+ * unpacking the key and expanding matrix A.
+ * Memory cache only and a peek: never inserts, trims, or counts as a lookup,
+ * so other borrowed keys stay valid and hit statistics are not inflated.
+ * Returns borrowed key (valid until the next cache lookup/insert), NULL if not cached
+ */
+static const qgp_dilithium3_expanded_pk* pubkey_signing_expanded(messenger_context_t *ctx, const char *identity) {
+    const pubkey_cache_entry_t *entry = pubkey_cache_peek(ctx->pubkey_cache, identity);
+    return entry ? pubkey_cache_signing_expanded(ctx->pubkey_cache, entry) : NULL;
+}
+
+/**
+ * Expanded encryption key of identity, if its keys are in the memory cache
+ * Same rules as pubkey_signing_expanded(); repeated sends to one recipient
+ * skip unpacking the Kyber key and generating matrix A.
+ */
+static const qgp_kyber512_expanded_pk* pubkey_encryption_expanded(messenger_context_t *ctx, const char *identity) {
+    const pubkey_cache_entry_t *entry = pubkey_cache_peek(ctx->pubkey_cache, identity);
+    return entry ? pubkey_cache_encryption_expanded(ctx->pubkey_cache, entry) : NULL;
+}
+
+/**
+ * Look up identity in local caches and return copies of its keys
+ * Returns 0 on hit (caller frees outputs), -1 on miss/allocation failure
+ */
+static int pubkey_cache_get_copy(messenger_context_t *ctx, const char *identity,
+                                 uint8_t **signing_pubkey_out, size_t *signing_pubkey_len_out,
+                                 uint8_t **encryption_pubkey_out, size_t *encryption_pubkey_len_out) {
+    const pubkey_cache_entry_t *entry = pubkey_lookup_local(ctx, identity);
+    if (!entry) {
+        return -1;
+    }
+
+    *signing_pubkey_out = malloc(entry->signing_pubkey_len);
+    *encryption_pubkey_out = malloc(entry->encryption_pubkey_len);
+
+    if (!*signing_pubkey_out || !*encryption_pubkey_out) {
+        free(*signing_pubkey_out);
+        free(*encryption_pubkey_out);
+        *signing_pubkey_out = NULL;
+        *encryption_pubkey_out = NULL;
+        return -1;
+    }
+
+    memcpy(*signing_pubkey_out, entry->signing_pubkey, entry->signing_pubkey_len);
+    memcpy(*encryption_pubkey_out, entry->encryption_pubkey, entry->encryption_pubkey_len);
+    *signing_pubkey_len_out = entry->signing_pubkey_len;
+    *encryption_pubkey_len_out = entry->encryption_pubkey_len;
+
+    return 0;
+}
+
+int messenger_get_pubkey(
+    messenger_context_t *ctx,
+    const char *identity,
+    const uint8_t **signing_pubkey_out,
+    size_t *signing_pubkey_len_out,
+    const uint8_t **encryption_pubkey_out,
+    size_t *encryption_pubkey_len_out
+) {
+    if (!ctx || !identity) {
+        return -1;
+    }
+
+    // Check memory cache, then on-disk store
+    const pubkey_cache_entry_t *entry = pubkey_lookup_local(ctx, identity);
+    if (!entry) {
+        // Cache miss - fetch from keyserver: <keyserver_url>/lookup/<identity>
+        char escaped[256];
+        if (http_client_escape(identity, escaped, sizeof(escaped)) != 0) {
+            fprintf(stderr, "Error: Identity too long\n");
+            return -1;
+        }
+
+        char path[300];
+        snprintf(path, sizeof(path), "/lookup/%s", escaped);
+
+        struct json_object *root = keyserver_request_json(ctx->http, path, NULL, NULL);
+        if (!root) {
+            fprintf(stderr, "Error: Failed to fetch public key for '%s'\n", identity);
+            return -1;
+        }
+
+        // Check success field
+        struct json_object *success_obj = json_object_object_get(root, "success");
+        if (!success_obj || !json_object_get_boolean(success_obj)) {
+            fprintf(stderr, "Error: API returned failure for identity '%s'\n", identity);
+            json_object_put(root);
+            return -1;
+        }
+
+        // Get data object
+        struct json_object *data_obj = json_object_object_get(root, "data");
+        if (!data_obj) {
+            fprintf(stderr, "Error: No 'data' field in API response\n");
+            json_object_put(root);
+            return -1;
+        }
+
+        // Extract and decode base64-encoded public keys
+        uint8_t *dilithium = NULL, *kyber = NULL;
+        size_t dilithium_len = 0, kyber_len = 0;
+        uint32_t version = 0;
+        int ret = keyserver_decode_pubkeys(data_obj, &dilithium, &dilithium_len, &kyber, &kyber_len, &version);
+        json_object_put(root);
+        if (ret != 0) {
+            return -1;
+        }
+
+        printf("✓ Fetched public key for '%s' from API (dilithium: %zu bytes, kyber: %zu bytes)\n",
+               identity, dilithium_len, kyber_len);
+
+        entry = pubkey_cache_insert(ctx, identity, dilithium, dilithium_len, kyber, kyber_len, version);
+        free(dilithium);
+        free(kyber);
+        if (!entry) {
+            fprintf(stderr, "Error: Memory allocation failed\n");
+            return -1;
+        }
+    }
+
+    *signing_pubkey_out = entry->signing_pubkey;
+    *signing_pubkey_len_out = entry->signing_pubkey_len;
+    *encryption_pubkey_out = entry->encryption_pubkey;
+    *encryption_pubkey_len_out = entry->encryption_pubkey_len;
+    return 0;
+}
+
+void messenger_get_pubkey_cache_stats(messenger_context_t *ctx, pubkey_cache_stats_t *stats_out) {
+    if (!ctx || !stats_out) {
+        return;
+    }
+
+    pubkey_cache_get_stats(ctx->pubkey_cache, stats_out);
+}
+
+int messenger_load_pubkey(
+    messenger_context_t *ctx,
+    const char *identity,
+    uint8_t **signing_pubkey_out,
+    size_t *signing_pubkey_len_out,
+    uint8_t **encryption_pubkey_out,
+    size_t *encryption_pubkey_len_out
+) {
+    const uint8_t *sign_pk = NULL, *enc_pk = NULL;
+    size_t sign_len = 0, enc_len = 0;
+
+    if (messenger_get_pubkey(ctx, identity, &sign_pk, &sign_len, &enc_pk, &enc_len) != 0) {
+        return -1;
+    }
+
+    // Caller owns the result - copy out of the cache
+    *signing_pubkey_out = malloc(sign_len);
+    *encryption_pubkey_out = malloc(enc_len);
+    if (!*signing_pubkey_out || !*encryption_pubkey_out) {
+        free(*signing_pubkey_out);
+        free(*encryption_pubkey_out);
+        *signing_pubkey_out = NULL;
+        *encryption_pubkey_out = NULL;
+        return -1;
+    }
+
+    memcpy(*signing_pubkey_out, sign_pk, sign_len);
+    memcpy(*encryption_pubkey_out, enc_pk, enc_len);
+    *signing_pubkey_len_out = sign_len;
+    *encryption_pubkey_len_out = enc_len;
+
+    return 0;
+}
+
+/**
+ * Resolve up to KEYSERVER_LOOKUP_BATCH_MAX identities with one POST /lookup_batch
+ * Fills outputs for identities found; leaves others NULL
+ * Returns 0 on success, -1 on transport error, -2 if keyserver has no batch endpoint
+ */
+static int keyserver_lookup_batch(
+    messenger_context_t *ctx,
+    const char **identities,
+    const size_t *indices,
+    size_t count,
+    uint8_t **signing_pubkeys_out,
+    size_t *signing_pubkey_lens_out,
+    uint8_t **encryption_pubkeys_out,
+    size_t *encryption_pubkey_lens_out
+) {
+    // Request body: {"dnas": [...]}
+    struct json_object *req = json_object_new_object();
+    struct json_object *dnas = json_object_new_array();
+    for (size_t i = 0; i < count; i++) {
+        json_object_array_add(dnas, json_object_new_string(identities[indices[i]]));
+    }
+    json_object_object_add(req, "dnas", dnas);
+
+    int status = 0;
+    struct json_object *root = keyserver_request_json(ctx->http, "/lookup_batch",
+                                                      json_object_to_json_string_ext(req, JSON_C_TO_STRING_PLAIN),
+                                                      &status);
+    json_object_put(req);
+
+    if (!root) {
+        return status == 404 ? -2 : -1;
+    }
+
+    struct json_object *success_obj = json_object_object_get(root, "success");
+    struct json_object *results_obj = json_object_object_get(root, "results");
+    if (!success_obj || !json_object_get_boolean(success_obj) ||
+        !results_obj || !json_object_is_type(results_obj, json_type_array)) {
+        json_object_put(root);
+        return status == 404 ? -2 : -1;
+    }
+
+    int rows = json_object_array_length(results_obj);
+    for (int r = 0; r < rows; r++) {
+        struct json_object *entry = json_object_array_get_idx(results_obj, r);
+        struct json_object *dna_obj = entry ? json_object_object_get(entry, "dna") : NULL;
+        struct json_object *data_obj = entry ? json_object_object_get(entry, "data") : NULL;
+        if (!dna_obj || !data_obj) {
+            continue;
+        }
+
+        const char *dna = json_object_get_string(dna_obj);
+        for (size_t i = 0; i < count; i++) {
+            size_t idx = indices[i];
+            if (signing_pubkeys_out[idx] || strcmp(identities[idx], dna) != 0) {
+                continue;
+            }
+
+            uint32_t version = 0;
+            if (keyserver_decode_pubkeys(data_obj,
+                                         &signing_pubkeys_out[idx], &signing_pubkey_lens_out[idx],
+                                         &encryption_pubkeys_out[idx], &encryption_pubkey_lens_out[idx],
+                                         &version) == 0) {
+                pubkey_cache_insert(ctx, identities[idx],
+                                    signing_pubkeys_out[idx], signing_pubkey_lens_out[idx],
+                                    encryption_pubkeys_out[idx], encryption_pubkey_lens_out[idx],
+                                    version);
+            }
+        }
+    }
+
+    json_object_put(root);
+    return 0;
+}
+
+int messenger_load_pubkeys_batch(
+    messenger_context_t *ctx,
+    const char **identities,
+    size_t count,
+    uint8_t **signing_pubkeys_out,
+    size_t *signing_pubkey_lens_out,
+    uint8_t **encryption_pubkeys_out,
+    size_t *encryption_pubkey_lens_out
+) {
+    if (!ctx || !identities || !signing_pubkeys_out || !signing_pubkey_lens_out ||
+        !encryption_pubkeys_out || !encryption_pubkey_lens_out) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        signing_pubkeys_out[i] = NULL;
+        encryption_pubkeys_out[i] = NULL;
+        signing_pubkey_lens_out[i] = 0;
+        encryption_pubkey_lens_out[i] = 0;
+    }
+
+    if (count == 0) {
+        return 0;
+    }
+
+    size_t *misses = malloc(sizeof(size_t) * count);
+    if (!misses) {
+        return -1;
+    }
+
+    // Serve what we can from cache (duplicates in the input are fetched once)
+    size_t miss_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (pubkey_cache_get_copy(ctx, identities[i],
+                                  &signing_pubkeys_out[i], &signing_pubkey_lens_out[i],
+                                  &encryption_pubkeys_out[i], &encryption_pubkey_lens_out[i]) == 0) {
+            continue;
+        }
+
+        int duplicate = 0;
+        for (size_t j = 0; j < miss_count; j++) {
+            if (strcmp(identities[misses[j]], identities[i]) == 0) {
+                duplicate = 1;
+                break;
+            }
+        }
+        if (!duplicate) {
+            misses[miss_count++] = i;
+        }
+    }
+
+    // Resolve misses, one request per KEYSERVER_LOOKUP_BATCH_MAX identities
+    int ret = 0;
+    for (size_t off = 0; off < miss_count && ret == 0; off += KEYSERVER_LOOKUP_BATCH_MAX) {
+        size_t n = miss_count - off;
+        if (n > KEYSERVER_LOOKUP_BATCH_MAX) {
+            n = KEYSERVER_LOOKUP_BATCH_MAX;
+        }
+
+        ret = keyserver_lookup_batch(ctx, identities, misses + off, n,
+                                     signing_pubkeys_out, signing_pubkey_lens_out,
+                                     encryption_pubkeys_out, encryption_pubkey_lens_out);
+        if (ret == -2) {
+            // Older keyserver without /lookup_batch - fall back to single lookups
+            ret = 0;
+            for (size_t i = off; i < miss_count && ret == 0; i++) {
+                size_t idx = misses[i];
+                if (!signing_pubkeys_out[idx]) {
+                    messenger_load_pubkey(ctx, identities[idx],
+                                          &signing_pubkeys_out[idx], &signing_pubkey_lens_out[idx],
+                                          &encryption_pubkeys_out[idx], &encryption_pubkey_lens_out[idx]);
+                }
+            }
+            break;
+        }
+    }
+    free(misses);
+
+    // Fill duplicates from their first occurrence and check everything resolved
+    for (size_t i = 0; i < count && ret == 0; i++) {
+        if (signing_pubkeys_out[i]) {
+            continue;
+        }
+
+        for (size_t j = 0; j < i; j++) {
+            if (signing_pubkeys_out[j] && strcmp(identities[j], identities[i]) == 0) {
+                signing_pubkeys_out[i] = malloc(signing_pubkey_lens_out[j]);
+                encryption_pubkeys_out[i] = malloc(encryption_pubkey_lens_out[j]);
+                if (signing_pubkeys_out[i] && encryption_pubkeys_out[i]) {
+                    memcpy(signing_pubkeys_out[i], signing_pubkeys_out[j], signing_pubkey_lens_out[j]);
+                    memcpy(encryption_pubkeys_out[i], encryption_pubkeys_out[j], encryption_pubkey_lens_out[j]);
+                    signing_pubkey_lens_out[i] = signing_pubkey_lens_out[j];
+                    encryption_pubkey_lens_out[i] = encryption_pubkey_lens_out[j];
+                }
+                break;
+            }
+        }
+
+        if (!signing_pubkeys_out[i] || !encryption_pubkeys_out[i]) {
+            fprintf(stderr, "Error: Public key for '%s' not found on keyserver\n", identities[i]);
+            ret = -1;
+        }
+    }
+
+    if (ret != 0) {
+        for (size_t i = 0; i < count; i++) {
+            free(signing_pubkeys_out[i]);
+            free(encryption_pubkeys_out[i]);
+            signing_pubkeys_out[i] = NULL;
+            encryption_pubkeys_out[i] = NULL;
+        }
+        return -1;
+    }
+
+    return 0;
+}
+
+int messenger_list_pubkeys(messenger_context_t *ctx) {
+    if (!ctx) {
+        return -1;
+    }
+
+    // Fetch from keyserver
+    struct json_object *root = keyserver_request_json(ctx->http, "/list", NULL, NULL);
+    if (!root) {
+        fprintf(stderr, "Error: Failed to fetch identity list from keyserver\n");
+        return -1;
+    }
+
+    // Check success field
+    struct json_object *success_obj = json_object_object_get(root, "success");
+    if (!success_obj || !json_object_get_boolean(success_obj)) {
+        fprintf(stderr, "Error: API returned failure\n");
+        json_object_put(root);
+        return -1;
+    }
+
+    // Approximate count ("total" on keyservers before total_estimate)
+    struct json_object *total_obj = json_object_object_get(root, "total_estimate");
+    if (!total_obj) {
+        total_obj = json_object_object_get(root, "total");
+    }
+    int total = total_obj ? json_object_get_int(total_obj) : 0;
+
+    printf("\n=== Keyserver (~%d identities) ===\n\n", total);
+
+    // Get identities array
+    struct json_object *identities_obj = json_object_object_get(root, "identities");
+    if (!identities_obj || !json_object_is_type(identities_obj, json_type_array)) {
+        json_object_put(root);
+        return 0;
+    }
+
+    int count = json_object_array_length(identities_obj);
+    for (int i = 0; i < count; i++) {
+        struct json_object *identity_obj = json_object_array_get_idx(identities_obj, i);
+        if (!identity_obj) continue;
+
+        struct json_object *dna_obj = json_object_object_get(identity_obj, "dna");
+        struct json_object *registered_obj = json_object_object_get(identity_obj, "registered_at");
+
+        const char *identity = dna_obj ? json_object_get_string(dna_obj) : "unknown";
+        const char *registered_at = registered_obj ? json_object_get_string(registered_obj) : "unknown";
+
+        printf("  %s (added: %s)\n", identity, registered_at);
+    }
+
+    printf("\n");
+    json_object_put(root);
+    return 0;
+}
+
+/**
+ * Get contact list (identities from keyserver)
+ */
+int messenger_get_contact_list(messenger_context_t *ctx, char ***identities_out, int *count_out) {
+    if (!ctx || !identities_out || !count_out) {
+        return -1;
+    }
+
+    // Fetch from keyserver
+    struct json_object *root = keyserver_request_json(ctx->http, "/list", NULL, NULL);
+    if (!root) {
+        fprintf(stderr, "Error: Failed to fetch identity list from keyserver\n");
+        return -1;
+    }
+
+    // Check success field
+    struct json_object *success_obj = json_object_object_get(root, "success");
+    if (!success_obj || !json_object_get_boolean(success_obj)) {
+        fprintf(stderr, "Error: API returned failure\n");
+        json_object_put(root);
+        return -1;
+    }
+
+    // Get identities array
+    struct json_object *identities_obj = json_object_object_get(root, "identities");
+    if (!identities_obj || !json_object_is_type(identities_obj, json_type_array)) {
+        *identities_out = NULL;
+        *count_out = 0;
+        json_object_put(root);
+        return 0;
+    }
+
+    int rows = json_object_array_length(identities_obj);
+    *count_out = rows;
+
+    if (rows == 0) {
+        *identities_out = NULL;
+        json_object_put(root);
+        return 0;
+    }
+
+    // Allocate array of string pointers
+    char **identities = (char**)malloc(sizeof(char*) * rows);
+    if (!identities) {
+        fprintf(stderr, "Memory allocation failed\n");
+        json_object_put(root);
         return -1;
     }
 
@@ -1155,6 +1961,8 @@ typedef struct {
  * @param plaintext: Message to encrypt
  * @param plaintext_len: Message length
  * @param recipient_enc_pubkeys: Array of recipient Kyber512 public keys (800 bytes each)
+ * @param recipient_enc_epks: Optional array of expanded keys matching recipient_enc_pubkeys
+ *                            (NULL, or NULL entries, to use the packed key)
  * @param recipient_count: Number of recipients (including sender)
  * @param sender_sign_key: Sender's Dilithium3 signing key
  * @param ciphertext_out: Output ciphertext (caller must free)
@@ -1165,6 +1973,7 @@ static int messenger_encrypt_multi_recipient(
     const char *plaintext,
     size_t plaintext_len,
     uint8_t **recipient_enc_pubkeys,
+    const qgp_kyber512_expanded_pk **recipient_enc_epks,
     size_t recipient_count,
     qgp_key_t *sender_sign_key,
     uint8_t **ciphertext_out,
@@ -1276,7 +2085,10 @@ static int messenger_encrypt_multi_recipient(
         uint8_t kek[32];  // KEK = shared secret from Kyber
 
         // Kyber512 encapsulation
-        if (qgp_kyber512_enc(kyber_ciphertext, kek, recipient_enc_pubkeys[i]) != 0) {
+        const qgp_kyber512_expanded_pk *epk = recipient_enc_epks ? recipient_enc_epks[i] : NULL;
+        int enc_ret = epk ? qgp_kyber512_enc_expanded(kyber_ciphertext, kek, epk)
+                          : qgp_kyber512_enc(kyber_ciphertext, kek, recipient_enc_pubkeys[i]);
+        if (enc_ret != 0) {
             fprintf(stderr, "Error: Kyber512 encapsulation failed for recipient %zu\n", i+1);
             memset(kek, 0, 32);
             goto cleanup;
@@ -1409,14 +2221,10 @@ int messenger_send_message(
 
     printf("✓ Sender '%s' added as first recipient (can decrypt own sent messages)\n", ctx->identity);
 
-    // Load sender's private signing key from filesystem
-    const char *home = qgp_platform_home_dir();
-    char dilithium_path[512];
-    snprintf(dilithium_path, sizeof(dilithium_path), "%s/.dna/%s-dilithium.pqkey", home, ctx->identity);
-
-    qgp_key_t *sender_sign_key = NULL;
-    if (qgp_key_load(dilithium_path, &sender_sign_key) != 0) {
-        fprintf(stderr, "Error: Cannot load sender's signing key from %s\n", dilithium_path);
+    // Sender's private signing key (resident in context)
+    qgp_key_t *sender_sign_key = resident_sign_key(ctx);
+    if (!sender_sign_key) {
+        fprintf(stderr, "Error: Cannot load sender's signing key\n");
         free(all_recipients);
         return -1;
     }
@@ -1430,38 +2238,46 @@ int messenger_send_message(
         free(enc_pubkeys);
         free(sign_pubkeys);
         free(all_recipients);
-        qgp_key_free(sender_sign_key);
         return -1;
     }
 
-    // Load public keys for all recipients from keyserver
-    for (size_t i = 0; i < total_recipients; i++) {
-        size_t sign_len = 0, enc_len = 0;
-        if (messenger_load_pubkey(ctx, all_recipients[i],
-                                   &sign_pubkeys[i], &sign_len,
-                                   &enc_pubkeys[i], &enc_len) != 0) {
-            fprintf(stderr, "Error: Cannot load public key for '%s' from keyserver\n", all_recipients[i]);
+    // Load public keys for all recipients (cache misses resolved in one keyserver request)
+    size_t *enc_lens = calloc(total_recipients, sizeof(size_t));
+    size_t *sign_lens = calloc(total_recipients, sizeof(size_t));
+    if (!enc_lens || !sign_lens ||
+        messenger_load_pubkeys_batch(ctx, all_recipients, total_recipients,
+                                     sign_pubkeys, sign_lens,
+                                     enc_pubkeys, enc_lens) != 0) {
+        fprintf(stderr, "Error: Cannot load recipient public keys from keyserver\n");
+        free(enc_lens);
+        free(sign_lens);
+        free(enc_pubkeys);
+        free(sign_pubkeys);
+        free(all_recipients);
+        return -1;
+    }
+    printf("✓ Loaded public keys for %zu recipient(s) from keyserver\n", total_recipients);
 
-            // Cleanup on error
-            for (size_t j = 0; j < total_recipients; j++) {
-                free(enc_pubkeys[j]);
-                free(sign_pubkeys[j]);
+    // Borrow cached expanded encryption keys (after all lookups, so none is dropped
+    // before use); only ones made from the key just loaded are used
+    const qgp_kyber512_expanded_pk **enc_epks = calloc(total_recipients, sizeof(*enc_epks));
+    if (enc_epks) {
+        for (size_t i = 0; i < total_recipients; i++) {
+            const qgp_kyber512_expanded_pk *epk = pubkey_encryption_expanded(ctx, all_recipients[i]);
+            if (qgp_kyber512_expanded_pk_matches(epk, enc_pubkeys[i], enc_lens[i])) {
+                enc_epks[i] = epk;
             }
-            free(enc_pubkeys);
-            free(sign_pubkeys);
-            free(all_recipients);
-            qgp_key_free(sender_sign_key);
-            return -1;
         }
-        printf("✓ Loaded public key for '%s' from keyserver\n", all_recipients[i]);
     }
+    free(enc_lens);
+    free(sign_lens);
 
     // Multi-recipient encryption implementation
     uint8_t *ciphertext = NULL;
     size_t ciphertext_len = 0;
     int ret = messenger_encrypt_multi_recipient(
         message, strlen(message),
-        enc_pubkeys, total_recipients,
+        enc_pubkeys, enc_epks, total_recipients,
         sender_sign_key,
         &ciphertext, &ciphertext_len
     );
@@ -1473,8 +2289,8 @@ int messenger_send_message(
     }
     free(enc_pubkeys);
     free(sign_pubkeys);
+    free(enc_epks);
     free(all_recipients);
-    qgp_key_free(sender_sign_key);
 
     if (ret != 0) {
         fprintf(stderr, "Error: Multi-recipient encryption failed\n");
@@ -1655,22 +2471,9 @@ int messenger_read_message(messenger_context_t *ctx, int message_id) {
     printf(" Message #%d from %s\n", message_id, sender);
     printf("========================================\n\n");
 
-    // Load recipient's private Kyber512 key from filesystem
-    const char *home = qgp_platform_home_dir();
-    char kyber_path[512];
-    snprintf(kyber_path, sizeof(kyber_path), "%s/.dna/%s-kyber512.pqkey", home, ctx->identity);
-
-    qgp_key_t *kyber_key = NULL;
-    if (qgp_key_load(kyber_path, &kyber_key) != 0) {
-        fprintf(stderr, "Error: Cannot load private key from %s\n", kyber_path);
-        PQclear(res);
-        return -1;
-    }
-
-    if (kyber_key->private_key_size != 1632) {
-        fprintf(stderr, "Error: Invalid Kyber512 private key size: %zu (expected 1632)\n",
-                kyber_key->private_key_size);
-        qgp_key_free(kyber_key);
+    // Recipient's private Kyber512 key (resident in context)
+    qgp_key_t *kyber_key = resident_enc_key(ctx);
+    if (!kyber_key) {
         PQclear(res);
         return -1;
     }
@@ -1681,33 +2484,31 @@ int messenger_read_message(messenger_context_t *ctx, int message_id) {
     uint8_t *sender_sign_pubkey_from_msg = NULL;
     size_t sender_sign_pubkey_len = 0;
 
-    dna_error_t err = dna_decrypt_message_raw(
+    dna_error_t err = dna_decrypt_message_raw_expanded(
         ctx->dna_ctx,
         ciphertext,
         ciphertext_len,
         kyber_key->private_key,
+        pubkey_signing_expanded(ctx, sender),
         &plaintext,
         &plaintext_len,
         &sender_sign_pubkey_from_msg,
         &sender_sign_pubkey_len
     );
 
-    // Free Kyber key (secure wipes private key internally)
-    qgp_key_free(kyber_key);
-
     if (err != DNA_OK) {
         fprintf(stderr, "Error: Decryption failed: %s\n", dna_error_string(err));
         PQclear(res);
         return -1;
     }
 
-    // Verify sender's public key against keyserver
-    uint8_t *sender_sign_pubkey_keyserver = NULL;
-    uint8_t *sender_enc_pubkey_keyserver = NULL;
+    // Verify sender's public key against keyserver (borrowed from pubkey cache)
+    const uint8_t *sender_sign_pubkey_keyserver = NULL;
+    const uint8_t *sender_enc_pubkey_keyserver = NULL;
     size_t sender_sign_len_keyserver = 0, sender_enc_len_keyserver = 0;
 
-    if (messenger_load_pubkey(ctx, sender, &sender_sign_pubkey_keyserver, &sender_sign_len_keyserver,
-                               &sender_enc_pubkey_keyserver, &sender_enc_len_keyserver) != 0) {
+    if (messenger_get_pubkey(ctx, sender, &sender_sign_pubkey_keyserver, &sender_sign_len_keyserver,
+                             &sender_enc_pubkey_keyserver, &sender_enc_len_keyserver) != 0) {
         fprintf(stderr, "Warning: Could not verify sender '%s' against keyserver\n", sender);
         fprintf(stderr, "Message decrypted but sender identity NOT verified!\n");
     } else {
@@ -1719,13 +2520,9 @@ int messenger_read_message(messenger_context_t *ctx, int message_id) {
             fprintf(stderr, "Possible spoofing attempt!\n");
             free(plaintext);
             free(sender_sign_pubkey_from_msg);
-            free(sender_sign_pubkey_keyserver);
-            free(sender_enc_pubkey_keyserver);
             PQclear(res);
             return -1;
         }
-        free(sender_sign_pubkey_keyserver);
-        free(sender_enc_pubkey_keyserver);
     }
 
     // Display message
@@ -1750,91 +2547,87 @@ int messenger_decrypt_message(messenger_context_t *ctx, int message_id,
         return -1;
     }
 
-    // Fetch message from database
-    // Support decrypting both received messages (recipient = identity) AND sent messages (sender = identity)
-    char id_str[32];
-    snprintf(id_str, sizeof(id_str), "%d", message_id);
-    const char *query = "SELECT sender, ciphertext FROM messages WHERE id = $1 AND (recipient = $2 OR sender = $2)";
-
-    const char *params[2] = {id_str, ctx->identity};
-    PGresult *res = PQexecParams(ctx->pg_conn, query, 2, NULL, params, NULL, NULL, 1); // Binary result
-
-    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
-        PQclear(res);
+    // Recipient's private Kyber512 key (resident in context; also opens the disk cache tier)
+    qgp_key_t *kyber_key = resident_enc_key(ctx);
+    if (!kyber_key) {
         return -1;
     }
 
-    if (PQntuples(res) == 0) {
-        PQclear(res);
-        return -1;
+    // Already decrypted?
+    size_t cached_len = 0;
+    const char *cached = plaintext_cache_get(ctx->message_cache, message_id, &cached_len);
+    if (cached) {
+        *plaintext_out = (char*)malloc(cached_len + 1);
+        if (!*plaintext_out) {
+            return -1;
+        }
+        memcpy(*plaintext_out, cached, cached_len + 1);
+        *plaintext_len_out = cached_len;
+        return 0;
     }
 
-    const char *sender = PQgetvalue(res, 0, 0);
-    const uint8_t *ciphertext = (const uint8_t*)PQgetvalue(res, 0, 1);
-    size_t ciphertext_len = PQgetlength(res, 0, 1);
+    // Fetch message from database
+    // Support decrypting both received messages (recipient = identity) AND sent messages (sender = identity)
+    char id_str[32];
+    snprintf(id_str, sizeof(id_str), "%d", message_id);
+    const char *query = "SELECT sender, ciphertext FROM messages WHERE id = $1 AND (recipient = $2 OR sender = $2)";
 
-    // Load recipient's private Kyber512 key from filesystem
-    const char *home = qgp_platform_home_dir();
-    char kyber_path[512];
-    snprintf(kyber_path, sizeof(kyber_path), "%s/.dna/%s-kyber512.pqkey", home, ctx->identity);
+    const char *params[2] = {id_str, ctx->identity};
+    PGresult *res = PQexecParams(ctx->pg_conn, query, 2, NULL, params, NULL, NULL, 1); // Binary result
 
-    qgp_key_t *kyber_key = NULL;
-    if (qgp_key_load(kyber_path, &kyber_key) != 0) {
+    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
         PQclear(res);
         return -1;
     }
 
-    if (kyber_key->private_key_size != 1632) {
-        qgp_key_free(kyber_key);
+    if (PQntuples(res) == 0) {
         PQclear(res);
         return -1;
     }
 
+    const char *sender = PQgetvalue(res, 0, 0);
+    const uint8_t *ciphertext = (const uint8_t*)PQgetvalue(res, 0, 1);
+    size_t ciphertext_len = PQgetlength(res, 0, 1);
+
     // Decrypt message using raw key
     uint8_t *plaintext = NULL;
     size_t plaintext_len = 0;
     uint8_t *sender_sign_pubkey_from_msg = NULL;
     size_t sender_sign_pubkey_len = 0;
 
-    dna_error_t err = dna_decrypt_message_raw(
+    dna_error_t err = dna_decrypt_message_raw_expanded(
         ctx->dna_ctx,
         ciphertext,
         ciphertext_len,
         kyber_key->private_key,
+        pubkey_signing_expanded(ctx, sender),
         &plaintext,
         &plaintext_len,
         &sender_sign_pubkey_from_msg,
         &sender_sign_pubkey_len
     );
 
-    // Free Kyber key (secure wipes private key internally)
-    qgp_key_free(kyber_key);
-
     if (err != DNA_OK) {
         PQclear(res);
         return -1;
     }
 
-    // Verify sender's public key against keyserver
-    uint8_t *sender_sign_pubkey_keyserver = NULL;
-    uint8_t *sender_enc_pubkey_keyserver = NULL;
+    // Verify sender's public key against keyserver (borrowed from pubkey cache)
+    const uint8_t *sender_sign_pubkey_keyserver = NULL;
+    const uint8_t *sender_enc_pubkey_keyserver = NULL;
     size_t sender_sign_len_keyserver = 0, sender_enc_len_keyserver = 0;
 
-    if (messenger_load_pubkey(ctx, sender, &sender_sign_pubkey_keyserver, &sender_sign_len_keyserver,
-                               &sender_enc_pubkey_keyserver, &sender_enc_len_keyserver) == 0) {
+    if (messenger_get_pubkey(ctx, sender, &sender_sign_pubkey_keyserver, &sender_sign_len_keyserver,
+                             &sender_enc_pubkey_keyserver, &sender_enc_len_keyserver) == 0) {
         // Compare public keys
         if (sender_sign_len_keyserver != sender_sign_pubkey_len ||
             memcmp(sender_sign_pubkey_keyserver, sender_sign_pubkey_from_msg, sender_sign_pubkey_len) != 0) {
             // Signature mismatch - possible spoofing
             free(plaintext);
             free(sender_sign_pubkey_from_msg);
-            free(sender_sign_pubkey_keyserver);
-            free(sender_enc_pubkey_keyserver);
             PQclear(res);
             return -1;
         }
-        free(sender_sign_pubkey_keyserver);
-        free(sender_enc_pubkey_keyserver);
     }
 
     free(sender_sign_pubkey_from_msg);
@@ -1851,6 +2644,8 @@ int messenger_decrypt_message(messenger_context_t *ctx, int message_id,
     (*plaintext_out)[plaintext_len] = '\0';
     *plaintext_len_out = plaintext_len;
 
+    plaintext_cache_put(ctx->message_cache, message_id, *plaintext_out, plaintext_len);
+
     free(plaintext);
     return 0;
 }
@@ -1895,6 +2690,8 @@ int messenger_delete_message(messenger_context_t *ctx, int message_id) {
         return -1;
     }
 
+    plaintext_cache_remove(ctx->message_cache, message_id);
+
     printf("✓ Message %d deleted\n", message_id);
     PQclear(res);
     return 0;
@@ -1915,116 +2712,627 @@ int messenger_search_by_sender(messenger_context_t *ctx, const char *sender) {
         "WHERE recipient = $1 AND sender = $2 "
         "ORDER BY created_at DESC";
 
-    PGresult *res = PQexecParams(ctx->pg_conn, query, 2, NULL, paramValues, NULL, NULL, 0);
+    PGresult *res = PQexecParams(ctx->pg_conn, query, 2, NULL, paramValues, NULL, NULL, 0);
+
+    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+        fprintf(stderr, "Search by sender failed: %s\n", PQerrorMessage(ctx->pg_conn));
+        PQclear(res);
+        return -1;
+    }
+
+    int rows = PQntuples(res);
+    printf("\n=== Messages from %s to %s (%d messages) ===\n\n", sender, ctx->identity, rows);
+
+    for (int i = 0; i < rows; i++) {
+        const char *id = PQgetvalue(res, i, 0);
+        const char *timestamp = PQgetvalue(res, i, 2);
+        printf("  [%s] %s\n", id, timestamp);
+    }
+
+    if (rows == 0) {
+        printf("  (no messages from %s)\n", sender);
+    }
+
+    printf("\n");
+    PQclear(res);
+    return 0;
+}
+
+int messenger_show_conversation(messenger_context_t *ctx, const char *other_identity) {
+    if (!ctx || !other_identity) {
+        return -1;
+    }
+
+    const char *paramValues[4] = {ctx->identity, other_identity, other_identity, ctx->identity};
+    const char *query =
+        "SELECT id, sender, recipient, created_at FROM messages "
+        "WHERE (sender = $1 AND recipient = $2) OR (sender = $3 AND recipient = $4) "
+        "ORDER BY created_at ASC";
+
+    PGresult *res = PQexecParams(ctx->pg_conn, query, 4, NULL, paramValues, NULL, NULL, 0);
+
+    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+        fprintf(stderr, "Show conversation failed: %s\n", PQerrorMessage(ctx->pg_conn));
+        PQclear(res);
+        return -1;
+    }
+
+    int rows = PQntuples(res);
+    printf("\n");
+    printf("========================================\n");
+    printf(" Conversation: %s <-> %s\n", ctx->identity, other_identity);
+    printf(" (%d messages)\n", rows);
+    printf("========================================\n\n");
+
+    for (int i = 0; i < rows; i++) {
+        const char *id = PQgetvalue(res, i, 0);
+        const char *sender = PQgetvalue(res, i, 1);
+        const char *recipient = PQgetvalue(res, i, 2);
+        const char *timestamp = PQgetvalue(res, i, 3);
+
+        // Format: [ID] timestamp sender -> recipient
+        if (strcmp(sender, ctx->identity) == 0) {
+            // Message sent by current user
+            printf("  [%s] %s  You -> %s\n", id, timestamp, recipient);
+        } else {
+            // Message received by current user
+            printf("  [%s] %s  %s -> You\n", id, timestamp, sender);
+        }
+    }
+
+    if (rows == 0) {
+        printf("  (no messages exchanged)\n");
+    }
+
+    printf("\n");
+    PQclear(res);
+    return 0;
+}
+
+/**
+ * Get conversation with another user (returns message array for GUI)
+ */
+int messenger_get_conversation(messenger_context_t *ctx, const char *other_identity,
+                                 message_info_t **messages_out, int *count_out) {
+    if (!ctx || !other_identity || !messages_out || !count_out) {
+        return -1;
+    }
+
+    const char *paramValues[4] = {ctx->identity, other_identity, other_identity, ctx->identity};
+    const char *query =
+        "SELECT id, sender, recipient, created_at, status, delivered_at, read_at FROM messages "
+        "WHERE (sender = $1 AND recipient = $2) OR (sender = $3 AND recipient = $4) "
+        "ORDER BY created_at ASC";
+
+    PGresult *res = PQexecParams(ctx->pg_conn, query, 4, NULL, paramValues, NULL, NULL, 0);
+
+    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+        fprintf(stderr, "Get conversation failed: %s\n", PQerrorMessage(ctx->pg_conn));
+        PQclear(res);
+        return -1;
+    }
+
+    int rows = PQntuples(res);
+    *count_out = rows;
+
+    if (rows == 0) {
+        *messages_out = NULL;
+        PQclear(res);
+        return 0;
+    }
+
+    // Allocate array of message_info_t
+    message_info_t *messages = (message_info_t*)calloc(rows, sizeof(message_info_t));
+    if (!messages) {
+        fprintf(stderr, "Memory allocation failed\n");
+        PQclear(res);
+        return -1;
+    }
+
+    // Copy message data
+    for (int i = 0; i < rows; i++) {
+        const char *id_str = PQgetvalue(res, i, 0);
+        const char *sender = PQgetvalue(res, i, 1);
+        const char *recipient = PQgetvalue(res, i, 2);
+        const char *timestamp = PQgetvalue(res, i, 3);
+        const char *status = PQgetvalue(res, i, 4);
+        const char *delivered_at = PQgetvalue(res, i, 5);
+        const char *read_at = PQgetvalue(res, i, 6);
+
+        messages[i].id = atoi(id_str);
+        messages[i].sender = strdup(sender);
+        messages[i].recipient = strdup(recipient);
+        messages[i].timestamp = strdup(timestamp);
+        messages[i].status = strdup(status ? status : "sent");
+        messages[i].delivered_at = delivered_at ? strdup(delivered_at) : NULL;
+        messages[i].read_at = read_at ? strdup(read_at) : NULL;
+        messages[i].plaintext = NULL;  // Not decrypted
+
+        if (!messages[i].sender || !messages[i].recipient || !messages[i].timestamp || !messages[i].status) {
+            // Clean up on failure
+            for (int j = 0; j <= i; j++) {
+                free(messages[j].sender);
+                free(messages[j].recipient);
+                free(messages[j].timestamp);
+                free(messages[j].status);
+                free(messages[j].delivered_at);
+                free(messages[j].read_at);
+                free(messages[j].plaintext);
+            }
+            free(messages);
+            PQclear(res);
+            return -1;
+        }
+    }
+
+    *messages_out = messages;
+    PQclear(res);
+    return 0;
+}
+
+/**
+ * Free message array
+ */
+void messenger_free_messages(message_info_t *messages, int count) {
+    if (!messages) {
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        free(messages[i].sender);
+        free(messages[i].recipient);
+        free(messages[i].timestamp);
+        free(messages[i].status);
+        free(messages[i].delivered_at);
+        free(messages[i].read_at);
+        free(messages[i].plaintext);
+    }
+    free(messages);
+}
+
+// ============================================================================
+// BATCH CONVERSATION DECRYPT
+// ============================================================================
+
+// Minimum rows per decrypt thread (below this, threading costs more than it saves)
+#define CONVERSATION_DECRYPT_ROWS_PER_THREAD 8
+
+/**
+ * Sender signing key as published on keyserver (for spoofing check)
+ */
+typedef struct {
+    const char *identity;
+    uint8_t *sign_pubkey;        // NULL if keyserver lookup failed
+    size_t sign_pubkey_len;
+    const qgp_dilithium3_expanded_pk *sign_epk;  // Borrowed from pubkey cache, may be NULL
+} conversation_sender_t;
+
+/**
+ * Message not in the plaintext cache: index into messages[] and the
+ * ciphertext query result row
+ */
+typedef struct {
+    int id;
+    int msg;
+    int row;
+} conversation_todo_t;
+
+/**
+ * Decrypt work shared by all threads; thread k handles todo k, k+stride, ...
+ */
+typedef struct {
+    dna_context_t *dna_ctx;
+    const qgp_key_t *enc_key;
+    const PGresult *res;         // id, ciphertext
+    message_info_t *messages;
+    const conversation_todo_t *todo;
+    int todo_count;
+    const conversation_sender_t *senders;
+    size_t sender_count;
+    int first;
+    int stride;
+} conversation_decrypt_job_t;
+
+static void conversation_decrypt_row(const conversation_decrypt_job_t *job, const conversation_todo_t *t) {
+    const char *sender = job->messages[t->msg].sender;
+    const uint8_t *ciphertext = (const uint8_t*)PQgetvalue(job->res, t->row, 1);
+    size_t ciphertext_len = PQgetlength(job->res, t->row, 1);
+
+    uint8_t *plaintext = NULL;
+    size_t plaintext_len = 0;
+    uint8_t *sender_sign_pubkey_from_msg = NULL;
+    size_t sender_sign_pubkey_len = 0;
+
+    const conversation_sender_t *ks = NULL;
+    for (size_t s = 0; s < job->sender_count; s++) {
+        if (strcmp(job->senders[s].identity, sender) == 0) {
+            ks = &job->senders[s];
+            break;
+        }
+    }
+
+    dna_error_t err = dna_decrypt_message_raw_expanded(
+        job->dna_ctx,
+        ciphertext,
+        ciphertext_len,
+        job->enc_key->private_key,
+        ks ? ks->sign_epk : NULL,
+        &plaintext,
+        &plaintext_len,
+        &sender_sign_pubkey_from_msg,
+        &sender_sign_pubkey_len
+    );
+
+    if (err != DNA_OK) {
+        return;
+    }
+
+    // Same check as messenger_decrypt_message(): reject on keyserver mismatch
+    int spoofed = ks && ks->sign_pubkey &&
+                  (ks->sign_pubkey_len != sender_sign_pubkey_len ||
+                   memcmp(ks->sign_pubkey, sender_sign_pubkey_from_msg, sender_sign_pubkey_len) != 0);
+    free(sender_sign_pubkey_from_msg);
+
+    if (!spoofed) {
+        char *text = malloc(plaintext_len + 1);
+        if (text) {
+            memcpy(text, plaintext, plaintext_len);
+            text[plaintext_len] = '\0';
+            job->messages[t->msg].plaintext = text;
+        }
+    }
+
+    free(plaintext);
+}
+
+static void* conversation_decrypt_worker(void *arg) {
+    const conversation_decrypt_job_t *job = (const conversation_decrypt_job_t*)arg;
+
+    for (int k = job->first; k < job->todo_count; k += job->stride) {
+        conversation_decrypt_row(job, &job->todo[k]);
+    }
+    return NULL;
+}
+
+static int conversation_todo_cmp(const void *a, const void *b) {
+    int x = ((const conversation_todo_t*)a)->id;
+    int y = ((const conversation_todo_t*)b)->id;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Copy a (binary-format) text column, NULL for SQL NULL
+ */
+static char* conversation_get_text(const PGresult *res, int row, int col) {
+    if (PQgetisnull(res, row, col)) {
+        return NULL;
+    }
+    return strdup(PQgetvalue(res, row, col));
+}
+
+// int4 column in binary format (network byte order)
+static int conversation_get_int4(const PGresult *res, int row, int col) {
+    const uint8_t *p = (const uint8_t*)PQgetvalue(res, row, col);
+    return (int)(((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3]);
+}
+
+/**
+ * Fetch ciphertexts for todo (sorted by id) and decrypt them, fanned out over threads
+ * Fills messages[].plaintext and adds results to the message cache
+ */
+static int conversation_decrypt_todo(messenger_context_t *ctx, const qgp_key_t *enc_key,
+                                     message_info_t *messages, conversation_todo_t *todo,
+                                     int todo_count, int max_threads) {
+    // Ciphertexts of the misses only: {id,id,...}
+    size_t list_size = (size_t)todo_count * 12 + 3;
+    char *id_list = malloc(list_size);
+    if (!id_list) {
+        return -1;
+    }
+    size_t pos = 0;
+    id_list[pos++] = '{';
+    for (int k = 0; k < todo_count; k++) {
+        pos += (size_t)snprintf(id_list + pos, list_size - pos, k ? ",%d" : "%d", todo[k].id);
+    }
+    id_list[pos++] = '}';
+    id_list[pos] = '\0';
+
+    const char *paramValues[2] = {id_list, ctx->identity};
+    const char *query =
+        "SELECT id, ciphertext FROM messages "
+        "WHERE id = ANY($1::int4[]) AND (sender = $2 OR recipient = $2) "
+        "ORDER BY id";
+
+    PGresult *res = PQexecParams(ctx->pg_conn, query, 2, NULL, paramValues, NULL, NULL, 1);
+    free(id_list);
 
     if (PQresultStatus(res) != PGRES_TUPLES_OK) {
-        fprintf(stderr, "Search by sender failed: %s\n", PQerrorMessage(ctx->pg_conn));
+        fprintf(stderr, "Get conversation ciphertext failed: %s\n", PQerrorMessage(ctx->pg_conn));
         PQclear(res);
         return -1;
     }
 
+    // Both sides sorted by id: merge (rows deleted meanwhile stay undecrypted)
     int rows = PQntuples(res);
-    printf("\n=== Messages from %s to %s (%d messages) ===\n\n", sender, ctx->identity, rows);
+    int matched = 0;
+    for (int k = 0, r = 0; k < todo_count && r < rows; ) {
+        int row_id = conversation_get_int4(res, r, 0);
+        if (row_id < todo[k].id) {
+            r++;
+        } else if (row_id > todo[k].id) {
+            k++;
+        } else {
+            todo[matched] = todo[k];
+            todo[matched++].row = r;
+            k++;
+            r++;
+        }
+    }
+    todo_count = matched;
+
+    // Keyserver signing keys of the (at most two) senders, fetched up front
+    // so worker threads never touch the pubkey cache
+    conversation_sender_t senders[2];
+    size_t sender_count = 0;
+    for (int k = 0; k < todo_count && sender_count < 2; k++) {
+        const char *sender = messages[todo[k].msg].sender;
+        int known = 0;
+        for (size_t s = 0; s < sender_count; s++) {
+            if (strcmp(senders[s].identity, sender) == 0) {
+                known = 1;
+                break;
+            }
+        }
+        if (known) {
+            continue;
+        }
 
-    for (int i = 0; i < rows; i++) {
-        const char *id = PQgetvalue(res, i, 0);
-        const char *timestamp = PQgetvalue(res, i, 2);
-        printf("  [%s] %s\n", id, timestamp);
+        conversation_sender_t *ks = &senders[sender_count++];
+        uint8_t *enc_pubkey = NULL;
+        size_t enc_pubkey_len = 0;
+        ks->identity = sender;
+        ks->sign_pubkey = NULL;
+        ks->sign_pubkey_len = 0;
+        if (messenger_load_pubkey(ctx, ks->identity, &ks->sign_pubkey, &ks->sign_pubkey_len,
+                                  &enc_pubkey, &enc_pubkey_len) == 0) {
+            free(enc_pubkey);
+        }
     }
 
-    if (rows == 0) {
-        printf("  (no messages from %s)\n", sender);
+    // Expanded keys for verification, borrowed once all lookups (which may
+    // insert into the cache) are done; the cache is not touched again until
+    // the workers finish
+    for (size_t s = 0; s < sender_count; s++) {
+        senders[s].sign_epk = pubkey_signing_expanded(ctx, senders[s].identity);
     }
 
-    printf("\n");
+    // Fan out across cores
+    int threads = max_threads > 0 ? max_threads : qgp_platform_cpu_count();
+    int max_useful = todo_count / CONVERSATION_DECRYPT_ROWS_PER_THREAD;
+    if (threads > max_useful) {
+        threads = max_useful;
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    conversation_decrypt_job_t *jobs = calloc((size_t)threads, sizeof(conversation_decrypt_job_t));
+    qgp_thread_t **handles = calloc((size_t)threads, sizeof(qgp_thread_t*));
+    if (!jobs || !handles) {
+        threads = 1;
+    }
+
+    conversation_decrypt_job_t inline_job;
+    for (int t = 0; t < threads; t++) {
+        conversation_decrypt_job_t *job = jobs ? &jobs[t] : &inline_job;
+        job->dna_ctx = ctx->dna_ctx;
+        job->enc_key = enc_key;
+        job->res = res;
+        job->messages = messages;
+        job->todo = todo;
+        job->todo_count = todo_count;
+        job->senders = senders;
+        job->sender_count = sender_count;
+        job->first = t;
+        job->stride = threads;
+    }
+
+    // Thread 0's share runs on the calling thread (as does any share whose thread failed to start)
+    for (int t = 1; t < threads; t++) {
+        handles[t] = qgp_platform_thread_create(conversation_decrypt_worker, &jobs[t]);
+    }
+    conversation_decrypt_worker(jobs ? &jobs[0] : &inline_job);
+    for (int t = 1; t < threads; t++) {
+        if (handles[t]) {
+            qgp_platform_thread_join(handles[t]);
+        } else {
+            conversation_decrypt_worker(&jobs[t]);
+        }
+    }
+
+    free(jobs);
+    free(handles);
+    for (size_t s = 0; s < sender_count; s++) {
+        free(senders[s].sign_pubkey);
+    }
     PQclear(res);
+
+    for (int k = 0; k < todo_count; k++) {
+        const message_info_t *m = &messages[todo[k].msg];
+        if (m->plaintext) {
+            plaintext_cache_put(ctx->message_cache, m->id, m->plaintext, strlen(m->plaintext));
+        }
+    }
+
     return 0;
 }
 
-int messenger_show_conversation(messenger_context_t *ctx, const char *other_identity) {
-    if (!ctx || !other_identity) {
+int messenger_get_conversation_decrypted(messenger_context_t *ctx, const char *other_identity,
+                                         message_info_t **messages_out, int *count_out,
+                                         int max_threads) {
+    if (!ctx || !other_identity || !messages_out || !count_out) {
+        return -1;
+    }
+
+    *messages_out = NULL;
+    *count_out = 0;
+
+    // Rows that fail to decrypt keep plaintext = NULL; only a missing key is fatal
+    qgp_key_t *enc_key = resident_enc_key(ctx);
+    if (!enc_key) {
         return -1;
     }
 
+    // Metadata only; ciphertext is fetched for messages not already decrypted
     const char *paramValues[4] = {ctx->identity, other_identity, other_identity, ctx->identity};
     const char *query =
-        "SELECT id, sender, recipient, created_at FROM messages "
+        "SELECT id, sender, recipient, created_at::text, status, delivered_at::text, read_at::text "
+        "FROM messages "
         "WHERE (sender = $1 AND recipient = $2) OR (sender = $3 AND recipient = $4) "
         "ORDER BY created_at ASC";
 
-    PGresult *res = PQexecParams(ctx->pg_conn, query, 4, NULL, paramValues, NULL, NULL, 0);
+    PGresult *res = PQexecParams(ctx->pg_conn, query, 4, NULL, paramValues, NULL, NULL, 1);
 
     if (PQresultStatus(res) != PGRES_TUPLES_OK) {
-        fprintf(stderr, "Show conversation failed: %s\n", PQerrorMessage(ctx->pg_conn));
+        fprintf(stderr, "Get conversation failed: %s\n", PQerrorMessage(ctx->pg_conn));
         PQclear(res);
         return -1;
     }
 
     int rows = PQntuples(res);
-    printf("\n");
-    printf("========================================\n");
-    printf(" Conversation: %s <-> %s\n", ctx->identity, other_identity);
-    printf(" (%d messages)\n", rows);
-    printf("========================================\n\n");
+    if (rows == 0) {
+        PQclear(res);
+        return 0;
+    }
+
+    message_info_t *messages = (message_info_t*)calloc(rows, sizeof(message_info_t));
+    conversation_todo_t *todo = malloc(sizeof(conversation_todo_t) * (size_t)rows);
+    if (!messages || !todo) {
+        fprintf(stderr, "Memory allocation failed\n");
+        free(messages);
+        free(todo);
+        PQclear(res);
+        return -1;
+    }
 
+    int todo_count = 0;
     for (int i = 0; i < rows; i++) {
-        const char *id = PQgetvalue(res, i, 0);
-        const char *sender = PQgetvalue(res, i, 1);
-        const char *recipient = PQgetvalue(res, i, 2);
-        const char *timestamp = PQgetvalue(res, i, 3);
+        messages[i].id = conversation_get_int4(res, i, 0);
+        messages[i].sender = conversation_get_text(res, i, 1);
+        messages[i].recipient = conversation_get_text(res, i, 2);
+        messages[i].timestamp = conversation_get_text(res, i, 3);
+        messages[i].status = PQgetisnull(res, i, 4) ? strdup("sent") : conversation_get_text(res, i, 4);
+        messages[i].delivered_at = conversation_get_text(res, i, 5);
+        messages[i].read_at = conversation_get_text(res, i, 6);
+        messages[i].plaintext = NULL;
 
-        // Format: [ID] timestamp sender -> recipient
-        if (strcmp(sender, ctx->identity) == 0) {
-            // Message sent by current user
-            printf("  [%s] %s  You -> %s\n", id, timestamp, recipient);
-        } else {
-            // Message received by current user
-            printf("  [%s] %s  %s -> You\n", id, timestamp, sender);
+        if (!messages[i].sender || !messages[i].recipient || !messages[i].timestamp || !messages[i].status) {
+            messenger_free_messages(messages, rows);
+            free(todo);
+            PQclear(res);
+            return -1;
+        }
+
+        size_t cached_len = 0;
+        const char *cached = plaintext_cache_get(ctx->message_cache, messages[i].id, &cached_len);
+        if (cached) {
+            messages[i].plaintext = malloc(cached_len + 1);
+            if (messages[i].plaintext) {
+                memcpy(messages[i].plaintext, cached, cached_len + 1);
+                continue;
+            }
         }
+
+        todo[todo_count].id = messages[i].id;
+        todo[todo_count].msg = i;
+        todo[todo_count].row = -1;
+        todo_count++;
     }
+    PQclear(res);
 
-    if (rows == 0) {
-        printf("  (no messages exchanged)\n");
+    if (todo_count > 0) {
+        qsort(todo, (size_t)todo_count, sizeof(conversation_todo_t), conversation_todo_cmp);
+        if (conversation_decrypt_todo(ctx, enc_key, messages, todo, todo_count, max_threads) != 0) {
+            messenger_free_messages(messages, rows);
+            free(todo);
+            return -1;
+        }
     }
+    free(todo);
 
-    printf("\n");
-    PQclear(res);
+    *messages_out = messages;
+    *count_out = rows;
     return 0;
 }
 
+// ============================================================================
+// CONVERSATION PAGES (KEYSET PAGINATION)
+// ============================================================================
+
 /**
- * Get conversation with another user (returns message array for GUI)
+ * Fetch one page of messages matching where_clause, oldest first
+ *
+ * where_clause uses $1..$nparams. The cursor is the (created_at, id) of
+ * message before_id, so the query walks the index backwards from there
+ * instead of skipping OFFSET rows.
  */
-int messenger_get_conversation(messenger_context_t *ctx, const char *other_identity,
-                                 message_info_t **messages_out, int *count_out) {
-    if (!ctx || !other_identity || !messages_out || !count_out) {
-        return -1;
+static int conversation_fetch_page(messenger_context_t *ctx, const char *where_clause,
+                                   const char **params, int nparams, int before_id, int limit,
+                                   message_info_t **messages_out, int *count_out) {
+    *messages_out = NULL;
+    *count_out = 0;
+
+    if (limit <= 0) {
+        limit = MESSENGER_CONVERSATION_PAGE_DEFAULT;
+    } else if (limit > MESSENGER_CONVERSATION_PAGE_MAX) {
+        limit = MESSENGER_CONVERSATION_PAGE_MAX;
     }
 
-    const char *paramValues[4] = {ctx->identity, other_identity, other_identity, ctx->identity};
-    const char *query =
-        "SELECT id, sender, recipient, created_at, status, delivered_at, read_at FROM messages "
-        "WHERE (sender = $1 AND recipient = $2) OR (sender = $3 AND recipient = $4) "
-        "ORDER BY created_at ASC";
+    char before_str[16];
+    char limit_str[16];
+    snprintf(before_str, sizeof(before_str), "%d", before_id);
+    snprintf(limit_str, sizeof(limit_str), "%d", limit);
 
-    PGresult *res = PQexecParams(ctx->pg_conn, query, 4, NULL, paramValues, NULL, NULL, 0);
+    const char *paramValues[8];
+    for (int i = 0; i < nparams; i++) {
+        paramValues[i] = params[i];
+    }
+
+    char cursor[128] = "";
+    int total = nparams;
+    if (before_id > 0) {
+        paramValues[total++] = before_str;
+        snprintf(cursor, sizeof(cursor),
+                 "AND (created_at, id) < (SELECT created_at, id FROM messages WHERE id = $%d) ",
+                 total);
+    }
+    paramValues[total++] = limit_str;
+
+    // Newest `limit` rows before the cursor, returned in ascending order
+    char query[1024];
+    snprintf(query, sizeof(query),
+             "SELECT id, sender, recipient, created_at::text, status, delivered_at::text, read_at::text "
+             "FROM ("
+             "SELECT id, sender, recipient, created_at, status, delivered_at, read_at "
+             "FROM messages WHERE (%s) %s"
+             "ORDER BY created_at DESC, id DESC LIMIT $%d"
+             ") page ORDER BY created_at ASC, id ASC",
+             where_clause, cursor, total);
+
+    PGresult *res = PQexecParams(ctx->pg_conn, query, total, NULL, paramValues, NULL, NULL, 1);
 
     if (PQresultStatus(res) != PGRES_TUPLES_OK) {
-        fprintf(stderr, "Get conversation failed: %s\n", PQerrorMessage(ctx->pg_conn));
+        fprintf(stderr, "Get conversation page failed: %s\n", PQerrorMessage(ctx->pg_conn));
         PQclear(res);
         return -1;
     }
 
     int rows = PQntuples(res);
-    *count_out = rows;
-
     if (rows == 0) {
-        *messages_out = NULL;
         PQclear(res);
         return 0;
     }
 
-    // Allocate array of message_info_t
     message_info_t *messages = (message_info_t*)calloc(rows, sizeof(message_info_t));
     if (!messages) {
         fprintf(stderr, "Memory allocation failed\n");
@@ -2032,65 +3340,54 @@ int messenger_get_conversation(messenger_context_t *ctx, const char *other_ident
         return -1;
     }
 
-    // Copy message data
     for (int i = 0; i < rows; i++) {
-        const char *id_str = PQgetvalue(res, i, 0);
-        const char *sender = PQgetvalue(res, i, 1);
-        const char *recipient = PQgetvalue(res, i, 2);
-        const char *timestamp = PQgetvalue(res, i, 3);
-        const char *status = PQgetvalue(res, i, 4);
-        const char *delivered_at = PQgetvalue(res, i, 5);
-        const char *read_at = PQgetvalue(res, i, 6);
-
-        messages[i].id = atoi(id_str);
-        messages[i].sender = strdup(sender);
-        messages[i].recipient = strdup(recipient);
-        messages[i].timestamp = strdup(timestamp);
-        messages[i].status = strdup(status ? status : "sent");
-        messages[i].delivered_at = delivered_at ? strdup(delivered_at) : NULL;
-        messages[i].read_at = read_at ? strdup(read_at) : NULL;
+        messages[i].id = conversation_get_int4(res, i, 0);
+        messages[i].sender = conversation_get_text(res, i, 1);
+        messages[i].recipient = conversation_get_text(res, i, 2);
+        messages[i].timestamp = conversation_get_text(res, i, 3);
+        messages[i].status = PQgetisnull(res, i, 4) ? strdup("sent") : conversation_get_text(res, i, 4);
+        messages[i].delivered_at = conversation_get_text(res, i, 5);
+        messages[i].read_at = conversation_get_text(res, i, 6);
         messages[i].plaintext = NULL;  // Not decrypted
 
         if (!messages[i].sender || !messages[i].recipient || !messages[i].timestamp || !messages[i].status) {
-            // Clean up on failure
-            for (int j = 0; j <= i; j++) {
-                free(messages[j].sender);
-                free(messages[j].recipient);
-                free(messages[j].timestamp);
-                free(messages[j].status);
-                free(messages[j].delivered_at);
-                free(messages[j].read_at);
-                free(messages[j].plaintext);
-            }
-            free(messages);
+            messenger_free_messages(messages, rows);
             PQclear(res);
             return -1;
         }
     }
+    PQclear(res);
 
     *messages_out = messages;
-    PQclear(res);
+    *count_out = rows;
     return 0;
 }
 
-/**
- * Free message array
- */
-void messenger_free_messages(message_info_t *messages, int count) {
-    if (!messages) {
-        return;
+int messenger_get_conversation_page(messenger_context_t *ctx, const char *other_identity,
+                                    int before_id, int limit,
+                                    message_info_t **messages_out, int *count_out) {
+    if (!ctx || !other_identity || !messages_out || !count_out) {
+        return -1;
     }
 
-    for (int i = 0; i < count; i++) {
-        free(messages[i].sender);
-        free(messages[i].recipient);
-        free(messages[i].timestamp);
-        free(messages[i].status);
-        free(messages[i].delivered_at);
-        free(messages[i].read_at);
-        free(messages[i].plaintext);
+    const char *params[2] = {ctx->identity, other_identity};
+    return conversation_fetch_page(ctx,
+                                   "(sender = $1 AND recipient = $2) OR (sender = $2 AND recipient = $1)",
+                                   params, 2, before_id, limit, messages_out, count_out);
+}
+
+int messenger_get_group_conversation_page(messenger_context_t *ctx, int group_id,
+                                          int before_id, int limit,
+                                          message_info_t **messages_out, int *count_out) {
+    if (!ctx || !messages_out || !count_out) {
+        return -1;
     }
-    free(messages);
+
+    char group_id_str[32];
+    snprintf(group_id_str, sizeof(group_id_str), "%d", group_id);
+    const char *params[1] = {group_id_str};
+    return conversation_fetch_page(ctx, "group_id = $1",
+                                   params, 1, before_id, limit, messages_out, count_out);
 }
 
 int messenger_search_by_date(messenger_context_t *ctx, const char *start_date,
@@ -2249,6 +3546,171 @@ int messenger_mark_conversation_read(messenger_context_t *ctx, const char *sende
     return 0;
 }
 
+// ============================================================================
+// PUSH EVENTS (LISTEN/NOTIFY)
+// ============================================================================
+
+// Trigger installed by sql/messages_notify.sql
+#define PUSH_TRIGGER_NAME "messages_notify"
+
+/**
+ * Channel for identity: "dna_" + md5 hex (identities may exceed NAMEDATALEN)
+ */
+static int push_channel_name(const char *identity, char *out, size_t out_size) {
+    uint8_t digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_len = 0;
+
+    if (EVP_Digest(identity, strlen(identity), digest, &digest_len, EVP_md5(), NULL) != 1 ||
+        out_size < 4 + (size_t)digest_len * 2 + 1) {
+        return -1;
+    }
+
+    memcpy(out, "dna_", 4);
+    for (unsigned int i = 0; i < digest_len; i++) {
+        snprintf(out + 4 + i * 2, 3, "%02x", digest[i]);
+    }
+    return 0;
+}
+
+/**
+ * Parse "<event>:<id>:<group id>:<peer>" (peer may itself contain ':')
+ */
+static int push_parse_payload(const char *payload, messenger_event_t *event) {
+    const char *p = strchr(payload, ':');
+    if (!p) {
+        return -1;
+    }
+
+    size_t type_len = (size_t)(p - payload);
+    if (type_len == 3 && strncmp(payload, "new", 3) == 0) {
+        event->type = MESSENGER_EVENT_NEW_MESSAGE;
+    } else if (type_len == 6 && strncmp(payload, "status", 6) == 0) {
+        event->type = MESSENGER_EVENT_STATUS_CHANGED;
+    } else {
+        return -1;
+    }
+
+    char *end = NULL;
+    long id = strtol(p + 1, &end, 10);
+    if (end == p + 1 || *end != ':') {
+        return -1;
+    }
+    p = end;
+
+    long group_id = strtol(p + 1, &end, 10);
+    if (end == p + 1 || *end != ':') {
+        return -1;
+    }
+
+    event->message_id = (int)id;
+    event->group_id = (int)group_id;
+    event->peer = end + 1;
+    return 0;
+}
+
+int messenger_subscribe(messenger_context_t *ctx) {
+    if (!ctx) {
+        return -1;
+    }
+
+    if (ctx->listen_conn) {
+        if (PQstatus(ctx->listen_conn) == CONNECTION_OK) {
+            return PQsocket(ctx->listen_conn);
+        }
+        messenger_unsubscribe(ctx);
+    }
+
+    char channel[64];
+    if (push_channel_name(ctx->identity, channel, sizeof(channel)) != 0) {
+        fprintf(stderr, "Error: Failed to derive push channel name\n");
+        return -1;
+    }
+
+    // Dedicated connection: notifications read on ctx->pg_conn would be
+    // consumed by ordinary queries without waking the caller's socket watch
+    char connstring[512];
+    dna_config_build_connstring(&g_config, connstring, sizeof(connstring));
+
+    PGconn *conn = PQconnectdb(connstring);
+    if (PQstatus(conn) != CONNECTION_OK) {
+        fprintf(stderr, "Push connection failed: %s\n", PQerrorMessage(conn));
+        PQfinish(conn);
+        return -1;
+    }
+
+    // Without the trigger LISTEN succeeds but nothing would ever arrive
+    const char *params[1] = {PUSH_TRIGGER_NAME};
+    PGresult *res = PQexecParams(conn,
+        "SELECT 1 FROM pg_trigger WHERE tgname = $1 AND tgrelid = 'messages'::regclass",
+        1, NULL, params, NULL, NULL, 0);
+    if (PQresultStatus(res) != PGRES_TUPLES_OK || PQntuples(res) == 0) {
+        fprintf(stderr, "Warning: Push trigger '%s' not installed (see sql/messages_notify.sql)\n",
+                PUSH_TRIGGER_NAME);
+        PQclear(res);
+        PQfinish(conn);
+        return -1;
+    }
+    PQclear(res);
+
+    char query[96];
+    snprintf(query, sizeof(query), "LISTEN %s", channel);
+    res = PQexec(conn, query);
+    if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+        fprintf(stderr, "LISTEN failed: %s\n", PQerrorMessage(conn));
+        PQclear(res);
+        PQfinish(conn);
+        return -1;
+    }
+    PQclear(res);
+
+    if (PQsetnonblocking(conn, 1) != 0) {
+        fprintf(stderr, "Error: Failed to make push connection non-blocking\n");
+        PQfinish(conn);
+        return -1;
+    }
+
+    ctx->listen_conn = conn;
+    return PQsocket(conn);
+}
+
+int messenger_process_events(messenger_context_t *ctx, messenger_event_callback_t callback,
+                             void *user_data) {
+    if (!ctx || !ctx->listen_conn) {
+        return -1;
+    }
+
+    if (!PQconsumeInput(ctx->listen_conn) || PQstatus(ctx->listen_conn) != CONNECTION_OK) {
+        fprintf(stderr, "Push connection lost: %s\n", PQerrorMessage(ctx->listen_conn));
+        return -1;
+    }
+
+    int count = 0;
+    PGnotify *notify;
+    while ((notify = PQnotifies(ctx->listen_conn)) != NULL) {
+        messenger_event_t event;
+        if (push_parse_payload(notify->extra, &event) == 0) {
+            if (callback) {
+                callback(&event, user_data);
+            }
+            count++;
+        } else {
+            fprintf(stderr, "Warning: Ignoring malformed push payload '%s'\n", notify->extra);
+        }
+        PQfreemem(notify);
+    }
+
+    return count;
+}
+
+void messenger_unsubscribe(messenger_context_t *ctx) {
+    if (!ctx || !ctx->listen_conn) {
+        return;
+    }
+
+    PQfinish(ctx->listen_conn);
+    ctx->listen_conn = NULL;
+}
+
 // ============================================================================
 // GROUP MANAGEMENT
 // ============================================================================
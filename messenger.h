@@ -17,6 +17,11 @@
 #include <stdbool.h>
 #include <libpq-fe.h>
 #include "dna_api.h"
+#include "qgp_types.h"
+#include "http_client.h"
+#include "pubkey_cache.h"
+#include "pubkey_store.h"
+#include "plaintext_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -26,16 +31,7 @@ extern "C" {
 // MESSENGER CONTEXT
 // ============================================================================
 
-// Public key cache entry
-typedef struct {
-    char *identity;
-    uint8_t *signing_pubkey;
-    size_t signing_pubkey_len;
-    uint8_t *encryption_pubkey;
-    size_t encryption_pubkey_len;
-} pubkey_cache_entry_t;
-
-#define PUBKEY_CACHE_SIZE 100
+typedef struct pubkey_revalidator pubkey_revalidator_t;
 
 /**
  * Messenger Context
@@ -45,10 +41,24 @@ typedef struct {
     char *identity;              // User's identity name (e.g., "alice")
     PGconn *pg_conn;             // PostgreSQL connection
     dna_context_t *dna_ctx;      // DNA API context
+    http_client_t *http;         // Keyserver HTTP client (persistent connection)
+
+    // Own private keys, loaded on first use and kept in locked memory
+    qgp_key_t *sign_key;         // Dilithium3 (~/.dna/<identity>-dilithium.pqkey)
+    qgp_key_t *enc_key;          // Kyber512 (~/.dna/<identity>-kyber512.pqkey)
+
+    // Public key cache (API fetch caching, LRU + TTL)
+    pubkey_cache_t *pubkey_cache;
+
+    // Persistent public key store (~/.dna/pubkeys.cache, NULL if unavailable)
+    pubkey_store_t *pubkey_store;
+    pubkey_revalidator_t *revalidator;   // Background refresh of stale store entries
+
+    // Decrypted message cache (by message id; optional encrypted disk tier)
+    plaintext_cache_t *message_cache;
 
-    // Public key cache (API fetch caching)
-    pubkey_cache_entry_t cache[PUBKEY_CACHE_SIZE];
-    int cache_count;
+    // Push events connection (LISTEN, NULL until messenger_subscribe())
+    PGconn *listen_conn;
 } messenger_context_t;
 
 /**
@@ -66,6 +76,10 @@ typedef struct {
     char *plaintext;             // Decrypted message text (NULL if not decrypted)
 } message_info_t;
 
+// Conversation page sizes (messenger_get_conversation_page)
+#define MESSENGER_CONVERSATION_PAGE_DEFAULT 50
+#define MESSENGER_CONVERSATION_PAGE_MAX 500
+
 // ============================================================================
 // INITIALIZATION
 // ============================================================================
@@ -131,6 +145,18 @@ int messenger_restore_keys(messenger_context_t *ctx, const char *identity);
  */
 int messenger_restore_keys_from_file(messenger_context_t *ctx, const char *identity, const char *seed_file);
 
+/**
+ * Reload own private keys from ~/.dna
+ *
+ * Private keys are read once per context and kept resident (locked in RAM,
+ * wiped on messenger_free). Call this after the key files were replaced
+ * outside this context, e.g. by another process rotating keys.
+ *
+ * @param ctx: Messenger context
+ * @return: 0 on success, -1 if either key cannot be loaded
+ */
+int messenger_reload_keys(messenger_context_t *ctx);
+
 // ============================================================================
 // PUBLIC KEY MANAGEMENT (keyserver table)
 // ============================================================================
@@ -160,6 +186,9 @@ int messenger_store_pubkey(
 /**
  * Load public key from keyserver
  *
+ * Checked in order: memory cache, ~/.dna/pubkeys.cache, keyserver. Keys
+ * served from disk past the cache TTL are refreshed in the background.
+ *
  * @param ctx: Messenger context
  * @param identity: Key owner's identity
  * @param signing_pubkey_out: Output signing key (caller must free)
@@ -177,6 +206,63 @@ int messenger_load_pubkey(
     size_t *encryption_pubkey_len_out
 );
 
+/**
+ * Get public keys without copying
+ *
+ * Same lookup as messenger_load_pubkey(), but cache hits cost no allocation.
+ * Returned pointers are owned by the pubkey cache and stay valid until the
+ * next messenger call that may fetch or evict keys (load/get/send).
+ *
+ * @param ctx: Messenger context
+ * @param identity: Key owner's identity
+ * @param signing_pubkey_out: Output borrowed signing key
+ * @param signing_pubkey_len_out: Output signing key length
+ * @param encryption_pubkey_out: Output borrowed encryption key
+ * @param encryption_pubkey_len_out: Output encryption key length
+ * @return: 0 on success, -1 on error
+ */
+int messenger_get_pubkey(
+    messenger_context_t *ctx,
+    const char *identity,
+    const uint8_t **signing_pubkey_out,
+    size_t *signing_pubkey_len_out,
+    const uint8_t **encryption_pubkey_out,
+    size_t *encryption_pubkey_len_out
+);
+
+/**
+ * Get public key cache counters (hits, misses, expired, evictions)
+ *
+ * @param ctx: Messenger context
+ * @param stats_out: Output counters
+ */
+void messenger_get_pubkey_cache_stats(messenger_context_t *ctx, pubkey_cache_stats_t *stats_out);
+
+/**
+ * Load public keys for multiple identities
+ *
+ * Cache hits are served locally; all misses are resolved with a single
+ * POST /lookup_batch request (chunked at 100 identities).
+ *
+ * @param ctx: Messenger context
+ * @param identities: Identity names
+ * @param count: Number of identities
+ * @param signing_pubkeys_out: Output array[count] of signing keys (caller frees each)
+ * @param signing_pubkey_lens_out: Output array[count] of signing key lengths
+ * @param encryption_pubkeys_out: Output array[count] of encryption keys (caller frees each)
+ * @param encryption_pubkey_lens_out: Output array[count] of encryption key lengths
+ * @return: 0 on success, -1 on error or if any identity is not found
+ */
+int messenger_load_pubkeys_batch(
+    messenger_context_t *ctx,
+    const char **identities,
+    size_t count,
+    uint8_t **signing_pubkeys_out,
+    size_t *signing_pubkey_lens_out,
+    uint8_t **encryption_pubkeys_out,
+    size_t *encryption_pubkey_lens_out
+);
+
 /**
  * List all public keys in keyserver
  *
@@ -319,6 +405,48 @@ int messenger_show_conversation(messenger_context_t *ctx, const char *other_iden
 int messenger_get_conversation(messenger_context_t *ctx, const char *other_identity,
                                  message_info_t **messages_out, int *count_out);
 
+/**
+ * Get conversation with plaintext filled in
+ *
+ * Messages already in the decrypted message cache are served from it.
+ * Ciphertext of the rest is fetched in one binary query and decrypted
+ * across up to max_threads threads. Rows that cannot be decrypted, or
+ * whose signer does not match the sender's keyserver key, have
+ * plaintext = NULL.
+ *
+ * @param ctx: Messenger context
+ * @param other_identity: The other person's identity
+ * @param messages_out: Output array of message_info_t (free with messenger_free_messages)
+ * @param count_out: Number of messages returned
+ * @param max_threads: Decrypt threads (0 = one per CPU, 1 = calling thread only)
+ * @return: 0 on success, -1 on error
+ */
+int messenger_get_conversation_decrypted(messenger_context_t *ctx, const char *other_identity,
+                                         message_info_t **messages_out, int *count_out,
+                                         int max_threads);
+
+/**
+ * Get one page of a conversation with another user
+ *
+ * Keyset pagination on (created_at, id): returns up to `limit` messages
+ * older than message before_id (or the newest ones if before_id is 0),
+ * sorted oldest first. Cost depends on the page size, not on the length
+ * of the history. Messages are NOT decrypted (plaintext field is NULL).
+ * Fewer than `limit` messages means the start of the conversation was
+ * reached. Best served by an index on messages (created_at, id).
+ *
+ * @param ctx: Messenger context
+ * @param other_identity: The other person's identity
+ * @param before_id: ID of the oldest message already shown (0 = latest page)
+ * @param limit: Page size (0 = MESSENGER_CONVERSATION_PAGE_DEFAULT, capped at MESSENGER_CONVERSATION_PAGE_MAX)
+ * @param messages_out: Output array of message_info_t (free with messenger_free_messages)
+ * @param count_out: Number of messages returned
+ * @return: 0 on success, -1 on error
+ */
+int messenger_get_conversation_page(messenger_context_t *ctx, const char *other_identity,
+                                    int before_id, int limit,
+                                    message_info_t **messages_out, int *count_out);
+
 /**
  * Free message array
  *
@@ -370,6 +498,63 @@ int messenger_mark_delivered(messenger_context_t *ctx, int message_id);
  */
 int messenger_mark_conversation_read(messenger_context_t *ctx, const char *sender_identity);
 
+// ============================================================================
+// PUSH EVENTS (LISTEN/NOTIFY)
+// ============================================================================
+
+/**
+ * Push event type
+ */
+typedef enum {
+    MESSENGER_EVENT_NEW_MESSAGE,       // Message stored for this identity
+    MESSENGER_EVENT_STATUS_CHANGED     // Status of a message sent by this identity changed
+} messenger_event_type_t;
+
+/**
+ * Push event
+ */
+typedef struct {
+    messenger_event_type_t type;
+    int message_id;
+    int group_id;                // 0 for direct messages
+    const char *peer;            // Sender (new message) or recipient (status change); valid during callback
+} messenger_event_t;
+
+typedef void (*messenger_event_callback_t)(const messenger_event_t *event, void *user_data);
+
+/**
+ * Subscribe to push events for this identity
+ *
+ * Opens a dedicated connection and LISTENs on the identity's channel.
+ * Requires the trigger from sql/messages_notify.sql; fails if it is not
+ * installed so callers can keep polling. Watch the returned socket for
+ * readability (e.g. QSocketNotifier) and call messenger_process_events().
+ * Calling again while subscribed returns the same socket.
+ *
+ * @param ctx: Messenger context
+ * @return: Socket descriptor, or -1 on error
+ */
+int messenger_subscribe(messenger_context_t *ctx);
+
+/**
+ * Read pending push events (non-blocking)
+ *
+ * @param ctx: Messenger context
+ * @param callback: Called once per event
+ * @param user_data: Passed to callback
+ * @return: Number of events, or -1 if not subscribed or the connection was
+ *          lost (call messenger_subscribe() again to reconnect)
+ */
+int messenger_process_events(messenger_context_t *ctx, messenger_event_callback_t callback,
+                             void *user_data);
+
+/**
+ * Close push events connection (no-op if not subscribed)
+ *
+ * @param ctx: Messenger context
+ */
+void messenger_unsubscribe(messenger_context_t *ctx);
+
 // ============================================================================
 // GROUP MANAGEMENT
 // ============================================================================
@@ -551,6 +736,23 @@ int messenger_get_group_conversation(
     int *count_out
 );
 
+/**
+ * Get one page of a group conversation
+ *
+ * Same paging rules as messenger_get_conversation_page().
+ *
+ * @param ctx: Messenger context
+ * @param group_id: Group ID
+ * @param before_id: ID of the oldest message already shown (0 = latest page)
+ * @param limit: Page size (0 = MESSENGER_CONVERSATION_PAGE_DEFAULT)
+ * @param messages_out: Output array of message_info_t (free with messenger_free_messages)
+ * @param count_out: Number of messages returned
+ * @return: 0 on success, -1 on error
+ */
+int messenger_get_group_conversation_page(messenger_context_t *ctx, int group_id,
+                                          int before_id, int limit,
+                                          message_info_t **messages_out, int *count_out);
+
 /**
  * Free group array
  *
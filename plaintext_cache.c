@@ -0,0 +1,827 @@
+/*
+ * DNA Messenger - Decrypted Message Cache
+ *
+ * Memory tier: fixed array of `capacity` nodes, power-of-two slot table of
+ * node indices probed linearly, LRU list threaded through the nodes (same
+ * layout as pubkey_cache.c).
+ *
+ * Disk tier: index of message id -> record offset built by scanning the
+ * file on attach; records are read back with fseek/fread and decrypted on
+ * demand. Appends are single fwrite() calls of a fully built record.
+ * Removal appends a tombstone so the id stays gone after the next attach.
+ */
+
+#include "plaintext_cache.h"
+#include "qgp_platform.h"
+#include "qgp_aes.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <openssl/sha.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+#define SLOT_EMPTY (-1)
+
+#define DISK_MAGIC "DNAPTC01"
+#define DISK_FORMAT_VERSION 1
+#define DISK_HEADER_SIZE 20
+#define DISK_RECORD_HEADER_SIZE 36     // id | len | nonce[12] | tag[16]
+#define DISK_MAX_PLAINTEXT (16 * 1024 * 1024)
+#define DISK_TOMBSTONE 0xFFFFFFFFu     // plaintext_len of a removal record
+#define DISK_COMPACT_MIN_SIZE (1024 * 1024)
+
+typedef struct {
+    int id;
+    char *text;                  // NUL-terminated, len + 1 bytes
+    size_t len;
+    int prev;                    // LRU: towards most recently used
+    int next;                    // LRU: towards least recently used
+    int in_use;
+} text_node_t;
+
+typedef struct {
+    int id;
+    int used;
+    long offset;                 // Record offset in file
+} disk_index_entry_t;
+
+typedef struct {
+    FILE *fp;                    // "a+b": reads anywhere, writes append
+    char *path;
+    uint8_t key[32];
+    long file_size;
+    long live_bytes;
+
+    disk_index_entry_t *index;
+    size_t index_cap;            // Power of two
+    size_t index_count;
+
+    int write_failed;            // Partial append - stop writing
+} disk_tier_t;
+
+struct plaintext_cache {
+    text_node_t *nodes;
+    size_t capacity;
+    size_t count;
+    size_t bytes;
+    size_t max_bytes;
+
+    int *slots;                  // Hash index: node index or SLOT_EMPTY
+    size_t slot_mask;
+
+    int lru_head;                // Most recently used
+    int lru_tail;                // Least recently used
+    int free_head;               // Free node list (linked via next)
+
+    disk_tier_t *disk;           // NULL unless attached
+};
+
+static size_t hash_id(int id) {
+    return (size_t)((uint32_t)id * 2654435761u);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+// ============================================================================
+// MEMORY TIER
+// ============================================================================
+
+static void lru_unlink(plaintext_cache_t *c, int i) {
+    text_node_t *n = &c->nodes[i];
+    if (n->prev != -1) c->nodes[n->prev].next = n->next; else c->lru_head = n->next;
+    if (n->next != -1) c->nodes[n->next].prev = n->prev; else c->lru_tail = n->prev;
+    n->prev = n->next = -1;
+}
+
+static void lru_push_front(plaintext_cache_t *c, int i) {
+    text_node_t *n = &c->nodes[i];
+    n->prev = -1;
+    n->next = c->lru_head;
+    if (c->lru_head != -1) c->nodes[c->lru_head].prev = i; else c->lru_tail = i;
+    c->lru_head = i;
+}
+
+static long slot_find(const plaintext_cache_t *c, int id) {
+    size_t s = hash_id(id) & c->slot_mask;
+    for (;;) {
+        int i = c->slots[s];
+        if (i == SLOT_EMPTY) {
+            return -1;
+        }
+        if (c->nodes[i].id == id) {
+            return (long)s;
+        }
+        s = (s + 1) & c->slot_mask;
+    }
+}
+
+static void slot_insert(plaintext_cache_t *c, int node, int id) {
+    size_t s = hash_id(id) & c->slot_mask;
+    while (c->slots[s] != SLOT_EMPTY) {
+        s = (s + 1) & c->slot_mask;
+    }
+    c->slots[s] = node;
+}
+
+// Backward-shift deletion keeps probe chains intact without tombstones
+static void slot_delete(plaintext_cache_t *c, size_t s) {
+    size_t hole = s;
+    size_t j = s;
+
+    for (;;) {
+        j = (j + 1) & c->slot_mask;
+        int i = c->slots[j];
+        if (i == SLOT_EMPTY) {
+            break;
+        }
+
+        size_t home = hash_id(c->nodes[i].id) & c->slot_mask;
+        if (((j - home) & c->slot_mask) >= ((j - hole) & c->slot_mask)) {
+            c->slots[hole] = i;
+            hole = j;
+        }
+    }
+
+    c->slots[hole] = SLOT_EMPTY;
+}
+
+static void node_wipe(text_node_t *n) {
+    if (n->text) {
+        qgp_platform_secure_zero(n->text, n->len + 1);
+        free(n->text);
+    }
+    n->text = NULL;
+    n->len = 0;
+    n->in_use = 0;
+}
+
+static void remove_at_slot(plaintext_cache_t *c, size_t s) {
+    int i = c->slots[s];
+    text_node_t *n = &c->nodes[i];
+
+    slot_delete(c, s);
+    lru_unlink(c, i);
+
+    c->bytes -= n->len;
+    c->count--;
+    node_wipe(n);
+
+    n->next = c->free_head;
+    c->free_head = i;
+}
+
+static void evict_lru(plaintext_cache_t *c) {
+    long s = slot_find(c, c->nodes[c->lru_tail].id);
+    remove_at_slot(c, (size_t)s);
+}
+
+/**
+ * Insert into memory tier (takes ownership of text)
+ * @return Borrowed text, or NULL if it does not fit (text is wiped and freed)
+ */
+static const char* memory_insert(plaintext_cache_t *c, int id, char *text, size_t len) {
+    long s = slot_find(c, id);
+    if (s >= 0) {
+        remove_at_slot(c, (size_t)s);
+    }
+
+    if (len > c->max_bytes) {
+        qgp_platform_secure_zero(text, len + 1);
+        free(text);
+        return NULL;
+    }
+
+    while (c->count > 0 && (c->free_head == -1 || c->bytes + len > c->max_bytes)) {
+        evict_lru(c);
+    }
+
+    int i = c->free_head;
+    text_node_t *n = &c->nodes[i];
+    c->free_head = n->next;
+
+    n->id = id;
+    n->text = text;
+    n->len = len;
+    n->in_use = 1;
+    c->count++;
+    c->bytes += len;
+
+    slot_insert(c, i, id);
+    lru_push_front(c, i);
+    return text;
+}
+
+// ============================================================================
+// DISK TIER
+// ============================================================================
+
+static disk_index_entry_t* disk_index_find(disk_tier_t *d, int id) {
+    size_t mask = d->index_cap - 1;
+    size_t s = hash_id(id) & mask;
+    while (d->index[s].used && d->index[s].id != id) {
+        s = (s + 1) & mask;
+    }
+    return &d->index[s];
+}
+
+static int disk_index_grow(disk_tier_t *d) {
+    size_t new_cap = d->index_cap ? d->index_cap * 2 : 256;
+    disk_index_entry_t *old = d->index;
+    size_t old_cap = d->index_cap;
+
+    d->index = calloc(new_cap, sizeof(disk_index_entry_t));
+    if (!d->index) {
+        d->index = old;
+        return -1;
+    }
+    d->index_cap = new_cap;
+
+    for (size_t i = 0; i < old_cap; i++) {
+        if (old[i].used) {
+            *disk_index_find(d, old[i].id) = old[i];
+        }
+    }
+    free(old);
+    return 0;
+}
+
+static int disk_index_set(disk_tier_t *d, int id, long offset, long record_len) {
+    if ((d->index_count + 1) * 2 > d->index_cap && disk_index_grow(d) != 0) {
+        return -1;
+    }
+
+    disk_index_entry_t *e = disk_index_find(d, id);
+    if (e->used) {
+        return -1;               // Callers only append ids not yet on disk
+    }
+
+    e->used = 1;
+    e->id = id;
+    e->offset = offset;
+    d->index_count++;
+    d->live_bytes += record_len;
+    return 0;
+}
+
+// Backward-shift delete (same scheme as the memory slot table)
+static void disk_index_delete(disk_tier_t *d, disk_index_entry_t *e) {
+    size_t mask = d->index_cap - 1;
+    size_t hole = (size_t)(e - d->index);
+    size_t j = hole;
+
+    for (;;) {
+        j = (j + 1) & mask;
+        if (!d->index[j].used) {
+            break;
+        }
+        size_t home = hash_id(d->index[j].id) & mask;
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            d->index[hole] = d->index[j];
+            hole = j;
+        }
+    }
+
+    memset(&d->index[hole], 0, sizeof(disk_index_entry_t));
+    d->index_count--;
+}
+
+static void disk_key_id(const uint8_t key[32], uint8_t key_id[8]) {
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    SHA256(key, 32, digest);
+    memcpy(key_id, digest, 8);
+}
+
+static int disk_write_header(FILE *fp, const uint8_t key[32]) {
+    uint8_t header[DISK_HEADER_SIZE];
+    memcpy(header, DISK_MAGIC, 8);
+    put_u32(header + 8, DISK_FORMAT_VERSION);
+    disk_key_id(key, header + 12);
+    return fwrite(header, 1, sizeof(header), fp) == sizeof(header) ? 0 : -1;
+}
+
+/**
+ * Open the disk tier file, created owner-only (0600) on POSIX
+ *
+ * @param append Nonzero: "a+b" (create if missing), zero: "wb" (truncate)
+ */
+static FILE* disk_fopen_private(const char *path, int append) {
+#ifdef _WIN32
+    return fopen(path, append ? "a+b" : "wb");
+#else
+    int flags = append ? (O_RDWR | O_CREAT | O_APPEND) : (O_WRONLY | O_CREAT | O_TRUNC);
+    int fd = open(path, flags, 0600);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    // Files from older versions were created under the default umask
+    fchmod(fd, 0600);
+
+    FILE *fp = fdopen(fd, append ? "a+b" : "wb");
+    if (!fp) {
+        close(fd);
+    }
+    return fp;
+#endif
+}
+
+static int disk_replace_file(const char *tmp_path, const char *path) {
+#ifdef _WIN32
+    remove(path);
+#endif
+    return rename(tmp_path, path);
+}
+
+/**
+ * Read whole file into memory
+ * @return Buffer (caller frees), NULL if missing/unreadable
+ */
+static uint8_t* disk_read_all(const char *path, long *size_out) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        return NULL;
+    }
+
+    uint8_t *buf = NULL;
+    long size = 0;
+    if (fseek(fp, 0, SEEK_END) == 0 && (size = ftell(fp)) > 0 && fseek(fp, 0, SEEK_SET) == 0) {
+        buf = malloc((size_t)size);
+        if (buf && fread(buf, 1, (size_t)size, fp) != (size_t)size) {
+            free(buf);
+            buf = NULL;
+        }
+    }
+
+    fclose(fp);
+    *size_out = buf ? size : 0;
+    return buf;
+}
+
+/**
+ * Write header plus the latest record of every indexed id to path
+ * (offsets in d->index are rewritten on success)
+ */
+static int disk_compact(disk_tier_t *d, const uint8_t *buf) {
+    size_t tmp_len = strlen(d->path) + 5;
+    char *tmp_path = malloc(tmp_len);
+    if (!tmp_path) {
+        return -1;
+    }
+    snprintf(tmp_path, tmp_len, "%s.tmp", d->path);
+
+    FILE *fp = disk_fopen_private(tmp_path, 0);
+    if (!fp) {
+        free(tmp_path);
+        return -1;
+    }
+
+    int ok = (disk_write_header(fp, d->key) == 0);
+    for (size_t i = 0; ok && i < d->index_cap; i++) {
+        disk_index_entry_t *e = &d->index[i];
+        if (e->used) {
+            size_t len = DISK_RECORD_HEADER_SIZE + get_u32(buf + e->offset + 4);
+            ok = fwrite(buf + e->offset, 1, len, fp) == len;
+        }
+    }
+
+    if (fclose(fp) != 0) {
+        ok = 0;
+    }
+    if (ok) {
+        ok = (disk_replace_file(tmp_path, d->path) == 0);
+    }
+    if (!ok) {
+        remove(tmp_path);
+        free(tmp_path);
+        return -1;
+    }
+    free(tmp_path);
+
+    // Same iteration order as the write loop above
+    long offset = DISK_HEADER_SIZE;
+    for (size_t i = 0; i < d->index_cap; i++) {
+        disk_index_entry_t *e = &d->index[i];
+        if (e->used) {
+            long len = DISK_RECORD_HEADER_SIZE + (long)get_u32(buf + e->offset + 4);
+            e->offset = offset;
+            offset += len;
+        }
+    }
+    d->file_size = offset;
+    return 0;
+}
+
+/**
+ * Index the file; recreate it if missing, foreign or written under another key
+ */
+static int disk_load(disk_tier_t *d) {
+    long size = 0;
+    uint8_t *buf = disk_read_all(d->path, &size);
+
+    uint8_t key_id[8];
+    disk_key_id(d->key, key_id);
+
+    if (!buf || size < DISK_HEADER_SIZE ||
+        memcmp(buf, DISK_MAGIC, 8) != 0 ||
+        get_u32(buf + 8) != DISK_FORMAT_VERSION ||
+        memcmp(buf + 12, key_id, 8) != 0) {
+        free(buf);
+
+        FILE *fp = disk_fopen_private(d->path, 0);
+        if (!fp) {
+            return -1;
+        }
+        int rc = disk_write_header(fp, d->key);
+        if (fclose(fp) != 0 || rc != 0) {
+            return -1;
+        }
+        d->file_size = DISK_HEADER_SIZE;
+        return 0;
+    }
+
+    // Scan records; stop at the first truncated one (torn append)
+    long off = DISK_HEADER_SIZE;
+    while (off + DISK_RECORD_HEADER_SIZE <= size) {
+        uint32_t len = get_u32(buf + off + 4);
+
+        if (len == DISK_TOMBSTONE) {
+            // Removed after it was written; compaction drops both records
+            disk_index_entry_t *e = disk_index_find(d, (int)get_u32(buf + off));
+            if (e->used) {
+                d->live_bytes -= DISK_RECORD_HEADER_SIZE + (long)get_u32(buf + e->offset + 4);
+                disk_index_delete(d, e);
+            }
+            off += DISK_RECORD_HEADER_SIZE;
+            continue;
+        }
+
+        if (len > DISK_MAX_PLAINTEXT || (long)len > size - off - DISK_RECORD_HEADER_SIZE) {
+            break;
+        }
+
+        int id = (int)get_u32(buf + off);
+        long record_len = DISK_RECORD_HEADER_SIZE + (long)len;
+
+        if ((d->index_count + 1) * 2 > d->index_cap && disk_index_grow(d) != 0) {
+            free(buf);
+            return -1;
+        }
+        disk_index_entry_t *e = disk_index_find(d, id);
+        if (e->used) {
+            d->live_bytes -= DISK_RECORD_HEADER_SIZE + (long)get_u32(buf + e->offset + 4);
+        } else {
+            e->used = 1;
+            e->id = id;
+            d->index_count++;
+        }
+        e->offset = off;
+        d->live_bytes += record_len;
+
+        off += record_len;
+    }
+
+    d->file_size = size;
+
+    int garbage = (off != size);
+    int sparse = (size > DISK_COMPACT_MIN_SIZE && d->live_bytes * 2 < size - DISK_HEADER_SIZE);
+
+    int rc = 0;
+    if ((garbage || sparse) && disk_compact(d, buf) != 0) {
+        fprintf(stderr, "Warning: Failed to compact message cache %s\n", d->path);
+        rc = garbage ? -1 : 0;
+    }
+
+    free(buf);
+    return rc;
+}
+
+static void disk_close(disk_tier_t *d) {
+    if (!d) {
+        return;
+    }
+
+    if (d->fp) {
+        fclose(d->fp);
+    }
+    qgp_platform_secure_zero(d->key, sizeof(d->key));
+    free(d->index);
+    free(d->path);
+    free(d);
+}
+
+/**
+ * Read and decrypt record for id
+ * @return Plaintext (len + 1 bytes, NUL-terminated, caller frees), NULL on miss
+ */
+static char* disk_get(disk_tier_t *d, int id, size_t *len_out) {
+    if (d->index_count == 0) {
+        return NULL;
+    }
+
+    disk_index_entry_t *e = disk_index_find(d, id);
+    if (!e->used) {
+        return NULL;
+    }
+
+    uint8_t hdr[DISK_RECORD_HEADER_SIZE];
+    if (fseek(d->fp, e->offset, SEEK_SET) != 0 || fread(hdr, 1, sizeof(hdr), d->fp) != sizeof(hdr) ||
+        (int)get_u32(hdr) != id) {
+        return NULL;
+    }
+
+    size_t len = get_u32(hdr + 4);
+    if (len == 0 || len > DISK_MAX_PLAINTEXT) {
+        disk_index_delete(d, e);
+        return NULL;
+    }
+
+    uint8_t *ciphertext = malloc(len);
+    char *plaintext = malloc(len + 1);
+    if (!ciphertext || !plaintext || fread(ciphertext, 1, len, d->fp) != len) {
+        free(ciphertext);
+        free(plaintext);
+        return NULL;
+    }
+
+    size_t plaintext_len = 0;
+    int rc = qgp_aes256_decrypt(d->key, ciphertext, len, hdr, 4, hdr + 8, hdr + 20,
+                                (uint8_t *)plaintext, &plaintext_len);
+    free(ciphertext);
+
+    if (rc != 0 || plaintext_len != len) {
+        // Corrupt record - forget it so we stop trying
+        qgp_platform_secure_zero(plaintext, len + 1);
+        free(plaintext);
+        disk_index_delete(d, e);
+        return NULL;
+    }
+
+    plaintext[len] = '\0';
+    *len_out = len;
+    return plaintext;
+}
+
+static void disk_put(disk_tier_t *d, int id, const char *plaintext, size_t len) {
+    if (d->write_failed || len > DISK_MAX_PLAINTEXT) {
+        return;
+    }
+
+    size_t record_len = DISK_RECORD_HEADER_SIZE + len;
+    uint8_t *record = malloc(record_len);
+    if (!record) {
+        return;
+    }
+
+    put_u32(record, (uint32_t)id);
+    put_u32(record + 4, (uint32_t)len);
+
+    size_t ciphertext_len = 0;
+    if (qgp_aes256_encrypt(d->key, (const uint8_t *)plaintext, len, record, 4,
+                           record + DISK_RECORD_HEADER_SIZE, &ciphertext_len,
+                           record + 8, record + 20) != 0 || ciphertext_len != len) {
+        free(record);
+        return;
+    }
+
+    long offset = d->file_size;
+    if (fseek(d->fp, 0, SEEK_END) != 0 ||
+        fwrite(record, 1, record_len, d->fp) != record_len || fflush(d->fp) != 0) {
+        // File now ends in a torn record; it is dropped on next attach
+        d->write_failed = 1;
+        free(record);
+        return;
+    }
+    free(record);
+
+    d->file_size += (long)record_len;
+    disk_index_set(d, id, offset, (long)record_len);
+}
+
+/**
+ * Append a tombstone for id and drop it from the index
+ */
+static void disk_remove(disk_tier_t *d, disk_index_entry_t *e) {
+    uint8_t record[DISK_RECORD_HEADER_SIZE];
+    memset(record, 0, sizeof(record));
+    put_u32(record, (uint32_t)e->id);
+    put_u32(record + 4, DISK_TOMBSTONE);
+
+    disk_index_delete(d, e);
+
+    if (d->write_failed) {
+        return;
+    }
+    if (fseek(d->fp, 0, SEEK_END) != 0 ||
+        fwrite(record, 1, sizeof(record), d->fp) != sizeof(record) || fflush(d->fp) != 0) {
+        fprintf(stderr, "Warning: Failed to record removal in message cache %s\n", d->path);
+        d->write_failed = 1;
+        return;
+    }
+    d->file_size += DISK_RECORD_HEADER_SIZE;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+plaintext_cache_t* plaintext_cache_new(size_t capacity, size_t max_bytes) {
+    if (capacity == 0) {
+        capacity = PLAINTEXT_CACHE_DEFAULT_CAPACITY;
+    }
+    if (max_bytes == 0) {
+        max_bytes = PLAINTEXT_CACHE_DEFAULT_MAX_BYTES;
+    }
+
+    plaintext_cache_t *c = calloc(1, sizeof(plaintext_cache_t));
+    if (!c) {
+        return NULL;
+    }
+
+    size_t slot_count = 16;
+    while (slot_count < capacity * 2) {
+        slot_count <<= 1;
+    }
+
+    c->nodes = calloc(capacity, sizeof(text_node_t));
+    c->slots = malloc(slot_count * sizeof(int));
+    if (!c->nodes || !c->slots) {
+        free(c->nodes);
+        free(c->slots);
+        free(c);
+        return NULL;
+    }
+
+    for (size_t s = 0; s < slot_count; s++) {
+        c->slots[s] = SLOT_EMPTY;
+    }
+
+    c->capacity = capacity;
+    c->max_bytes = max_bytes;
+    c->slot_mask = slot_count - 1;
+    plaintext_cache_clear(c);
+
+    return c;
+}
+
+void plaintext_cache_free(plaintext_cache_t *cache) {
+    if (!cache) {
+        return;
+    }
+
+    plaintext_cache_detach_disk(cache);
+    plaintext_cache_clear(cache);
+    free(cache->nodes);
+    free(cache->slots);
+    free(cache);
+}
+
+const char* plaintext_cache_get(plaintext_cache_t *cache, int message_id, size_t *len_out) {
+    if (!cache) {
+        return NULL;
+    }
+
+    long s = slot_find(cache, message_id);
+    if (s >= 0) {
+        int i = cache->slots[s];
+        if (cache->lru_head != i) {
+            lru_unlink(cache, i);
+            lru_push_front(cache, i);
+        }
+        if (len_out) {
+            *len_out = cache->nodes[i].len;
+        }
+        return cache->nodes[i].text;
+    }
+
+    if (!cache->disk) {
+        return NULL;
+    }
+
+    size_t len = 0;
+    char *text = disk_get(cache->disk, message_id, &len);
+    if (!text) {
+        return NULL;
+    }
+
+    // Promote; if too large for the memory tier there is nothing to borrow
+    const char *entry = memory_insert(cache, message_id, text, len);
+    if (entry && len_out) {
+        *len_out = len;
+    }
+    return entry;
+}
+
+int plaintext_cache_put(plaintext_cache_t *cache, int message_id, const char *plaintext, size_t len) {
+    if (!cache || !plaintext) {
+        return -1;
+    }
+
+    char *text = malloc(len + 1);
+    if (!text) {
+        return -1;
+    }
+    memcpy(text, plaintext, len);
+    text[len] = '\0';
+
+    if (cache->disk && !disk_index_find(cache->disk, message_id)->used) {
+        disk_put(cache->disk, message_id, plaintext, len);
+    }
+
+    memory_insert(cache, message_id, text, len);
+    return 0;
+}
+
+void plaintext_cache_remove(plaintext_cache_t *cache, int message_id) {
+    if (!cache) {
+        return;
+    }
+
+    long s = slot_find(cache, message_id);
+    if (s >= 0) {
+        remove_at_slot(cache, (size_t)s);
+    }
+
+    // Tombstoned on disk; compaction removes both records
+    if (cache->disk && cache->disk->index_count > 0) {
+        disk_index_entry_t *e = disk_index_find(cache->disk, message_id);
+        if (e->used) {
+            disk_remove(cache->disk, e);
+        }
+    }
+}
+
+void plaintext_cache_clear(plaintext_cache_t *cache) {
+    if (!cache) {
+        return;
+    }
+
+    for (size_t s = 0; s <= cache->slot_mask; s++) {
+        cache->slots[s] = SLOT_EMPTY;
+    }
+
+    for (size_t i = 0; i < cache->capacity; i++) {
+        text_node_t *n = &cache->nodes[i];
+        if (n->in_use) {
+            node_wipe(n);
+        }
+        n->prev = -1;
+        n->next = (i + 1 < cache->capacity) ? (int)(i + 1) : -1;
+    }
+
+    cache->count = 0;
+    cache->bytes = 0;
+    cache->lru_head = -1;
+    cache->lru_tail = -1;
+    cache->free_head = 0;
+}
+
+int plaintext_cache_attach_disk(plaintext_cache_t *cache, const char *path, const uint8_t key[32]) {
+    if (!cache || !path || !key) {
+        return -1;
+    }
+
+    plaintext_cache_detach_disk(cache);
+
+    disk_tier_t *d = calloc(1, sizeof(disk_tier_t));
+    if (!d) {
+        return -1;
+    }
+    memcpy(d->key, key, sizeof(d->key));
+
+    d->path = strdup(path);
+    if (!d->path || disk_index_grow(d) != 0 || disk_load(d) != 0) {
+        disk_close(d);
+        return -1;
+    }
+
+    d->fp = disk_fopen_private(path, 1);
+    if (!d->fp) {
+        disk_close(d);
+        return -1;
+    }
+
+    cache->disk = d;
+    return 0;
+}
+
+void plaintext_cache_detach_disk(plaintext_cache_t *cache) {
+    if (!cache || !cache->disk) {
+        return;
+    }
+
+    disk_close(cache->disk);
+    cache->disk = NULL;
+}
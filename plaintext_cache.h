@@ -0,0 +1,103 @@
+/*
+ * DNA Messenger - Decrypted Message Cache
+ *
+ * Plaintext of already decrypted messages, keyed by message id, so that
+ * refreshing a conversation only decrypts messages not seen before:
+ * - Memory tier: LRU bounded by entry count and total plaintext bytes.
+ *   Plaintext is wiped when evicted, removed or freed.
+ * - Disk tier (opt-in): append-only file of AES-256-GCM encrypted records
+ *   (AAD = message id), consulted on memory misses. Survives restarts.
+ *
+ * Disk file format (little-endian):
+ *   Header:  "DNAPTC01" (8) | format version u32 | key id (8)
+ *   Record:  message id u32 | plaintext_len u32 | nonce[12] | tag[16] | ciphertext
+ *
+ * A record with plaintext_len 0xFFFFFFFF (no ciphertext) is a tombstone:
+ * the id was removed and earlier records for it are ignored.
+ *
+ * key id = first 8 bytes of SHA-256(key); a file written under another key
+ * is discarded on attach. The file is created owner-only (0600).
+ *
+ * Lookups return borrowed plaintext that stays valid until the next
+ * get/put/remove/clear on the same cache. Not thread-safe.
+ */
+
+#ifndef PLAINTEXT_CACHE_H
+#define PLAINTEXT_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PLAINTEXT_CACHE_DEFAULT_CAPACITY 4096
+#define PLAINTEXT_CACHE_DEFAULT_MAX_BYTES (16 * 1024 * 1024)
+
+typedef struct plaintext_cache plaintext_cache_t;
+
+/**
+ * Create cache (memory tier only)
+ *
+ * @param capacity Maximum number of messages (0 = default)
+ * @param max_bytes Maximum total plaintext bytes (0 = default)
+ * @return Cache, or NULL on allocation failure
+ */
+plaintext_cache_t* plaintext_cache_new(size_t capacity, size_t max_bytes);
+
+/**
+ * Wipe and free cache (detaches disk tier)
+ */
+void plaintext_cache_free(plaintext_cache_t *cache);
+
+/**
+ * Look up message plaintext (memory, then disk tier)
+ *
+ * @param cache Cache
+ * @param message_id Message ID
+ * @param len_out Output plaintext length (may be NULL)
+ * @return Borrowed NUL-terminated plaintext, or NULL on miss
+ */
+const char* plaintext_cache_get(plaintext_cache_t *cache, int message_id, size_t *len_out);
+
+/**
+ * Insert message plaintext (copied; also appended to disk tier if attached)
+ *
+ * @return 0 on success, -1 on error
+ */
+int plaintext_cache_put(plaintext_cache_t *cache, int message_id, const char *plaintext, size_t len);
+
+/**
+ * Remove message from both tiers (no-op if absent)
+ */
+void plaintext_cache_remove(plaintext_cache_t *cache, int message_id);
+
+/**
+ * Wipe all memory tier entries
+ */
+void plaintext_cache_clear(plaintext_cache_t *cache);
+
+/**
+ * Attach encrypted disk tier
+ *
+ * Opens (or creates) path and indexes it. Recreates the file if it was
+ * written under a different key or is unreadable.
+ *
+ * @param cache Cache
+ * @param path Disk tier file
+ * @param key 32-byte AES-256 key
+ * @return 0 on success, -1 on error (cache keeps working memory-only)
+ */
+int plaintext_cache_attach_disk(plaintext_cache_t *cache, const char *path, const uint8_t key[32]);
+
+/**
+ * Detach disk tier and wipe its key (file is kept)
+ */
+void plaintext_cache_detach_disk(plaintext_cache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PLAINTEXT_CACHE_H
@@ -0,0 +1,497 @@
+/*
+ * DNA Messenger - Public Key Cache
+ *
+ * Entries live in a fixed array of `capacity` nodes. The hash index is a
+ * power-of-two slot table (>= 2x capacity) of node indices, probed
+ * linearly. LRU order is a doubly linked list threaded through the nodes.
+ *
+ * Expanded keys are tens of KB each, so they get their own byte budget and
+ * a second LRU list over the nodes that hold any. Going over budget only
+ * drops expanded keys (never entries), and only in pubkey_cache_get/put,
+ * so keys borrowed for one batch stay valid until the caller looks up again.
+ */
+
+#include "pubkey_cache.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SLOT_EMPTY (-1)
+
+typedef struct {
+    pubkey_cache_entry_t entry;
+    uint64_t hash;
+    int prev;                    // LRU: towards most recently used
+    int next;                    // LRU: towards least recently used
+    int in_use;
+    size_t expanded_bytes;       // Held by expanded keys; > 0 = on expanded LRU
+    int xprev;                   // Expanded LRU: towards most recently used
+    int xnext;                   // Expanded LRU: towards least recently used
+} cache_node_t;
+
+struct pubkey_cache {
+    cache_node_t *nodes;
+    size_t capacity;
+    size_t count;
+    int ttl;
+
+    int *slots;                  // Hash index: node index or SLOT_EMPTY
+    size_t slot_mask;
+
+    int lru_head;                // Most recently used
+    int lru_tail;                // Least recently used
+    int free_head;               // Free node list (linked via next)
+
+    int xlru_head;               // Expanded keys: most recently used
+    int xlru_tail;               // Expanded keys: least recently used
+    size_t expanded_bytes;
+    size_t expanded_max_bytes;
+
+    pubkey_cache_stats_t stats;
+};
+
+// FNV-1a
+static uint64_t hash_identity(const char *s) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// ============================================================================
+// LRU LIST
+// ============================================================================
+
+static void lru_unlink(pubkey_cache_t *c, int i) {
+    cache_node_t *n = &c->nodes[i];
+    if (n->prev != -1) c->nodes[n->prev].next = n->next; else c->lru_head = n->next;
+    if (n->next != -1) c->nodes[n->next].prev = n->prev; else c->lru_tail = n->prev;
+    n->prev = n->next = -1;
+}
+
+static void lru_push_front(pubkey_cache_t *c, int i) {
+    cache_node_t *n = &c->nodes[i];
+    n->prev = -1;
+    n->next = c->lru_head;
+    if (c->lru_head != -1) c->nodes[c->lru_head].prev = i; else c->lru_tail = i;
+    c->lru_head = i;
+}
+
+// ============================================================================
+// EXPANDED KEY LRU
+// ============================================================================
+
+static void xlru_unlink(pubkey_cache_t *c, int i) {
+    cache_node_t *n = &c->nodes[i];
+    if (n->xprev != -1) c->nodes[n->xprev].xnext = n->xnext; else c->xlru_head = n->xnext;
+    if (n->xnext != -1) c->nodes[n->xnext].xprev = n->xprev; else c->xlru_tail = n->xprev;
+    n->xprev = n->xnext = -1;
+}
+
+static void xlru_push_front(pubkey_cache_t *c, int i) {
+    cache_node_t *n = &c->nodes[i];
+    n->xprev = -1;
+    n->xnext = c->xlru_head;
+    if (c->xlru_head != -1) c->nodes[c->xlru_head].xprev = i; else c->xlru_tail = i;
+    c->xlru_head = i;
+}
+
+// Mark node's expanded keys most recently used
+static void expanded_touch(pubkey_cache_t *c, int i) {
+    if (c->nodes[i].expanded_bytes > 0 && c->xlru_head != i) {
+        xlru_unlink(c, i);
+        xlru_push_front(c, i);
+    }
+}
+
+static void expanded_add(pubkey_cache_t *c, int i, size_t bytes) {
+    cache_node_t *n = &c->nodes[i];
+    if (n->expanded_bytes == 0) {
+        xlru_push_front(c, i);
+    } else {
+        expanded_touch(c, i);
+    }
+    n->expanded_bytes += bytes;
+    c->expanded_bytes += bytes;
+}
+
+static void expanded_drop(pubkey_cache_t *c, int i) {
+    cache_node_t *n = &c->nodes[i];
+
+    if (n->expanded_bytes > 0) {
+        xlru_unlink(c, i);
+        c->expanded_bytes -= n->expanded_bytes;
+        n->expanded_bytes = 0;
+    }
+
+    qgp_dilithium3_expanded_pk_free(n->entry.signing_expanded);
+    qgp_kyber512_expanded_pk_free(n->entry.encryption_expanded);
+    n->entry.signing_expanded = NULL;
+    n->entry.encryption_expanded = NULL;
+}
+
+static void expanded_trim(pubkey_cache_t *c) {
+    while (c->expanded_bytes > c->expanded_max_bytes && c->xlru_tail != -1) {
+        expanded_drop(c, c->xlru_tail);
+        c->stats.expanded_evictions++;
+    }
+}
+
+// Entries handed out by this cache are the first member of their node
+static int entry_node(const pubkey_cache_t *c, const pubkey_cache_entry_t *entry) {
+    return (int)((const cache_node_t *)entry - c->nodes);
+}
+
+// ============================================================================
+// HASH INDEX
+// ============================================================================
+
+/**
+ * Find slot holding identity
+ * @return slot index, or -1 if absent
+ */
+static long slot_find(const pubkey_cache_t *c, const char *identity, uint64_t hash) {
+    size_t s = (size_t)hash & c->slot_mask;
+    for (;;) {
+        int i = c->slots[s];
+        if (i == SLOT_EMPTY) {
+            return -1;
+        }
+        if (c->nodes[i].hash == hash && strcmp(c->nodes[i].entry.identity, identity) == 0) {
+            return (long)s;
+        }
+        s = (s + 1) & c->slot_mask;
+    }
+}
+
+static void slot_insert(pubkey_cache_t *c, int node, uint64_t hash) {
+    size_t s = (size_t)hash & c->slot_mask;
+    while (c->slots[s] != SLOT_EMPTY) {
+        s = (s + 1) & c->slot_mask;
+    }
+    c->slots[s] = node;
+}
+
+// Backward-shift deletion keeps probe chains intact without tombstones
+static void slot_delete(pubkey_cache_t *c, size_t s) {
+    size_t hole = s;
+    size_t j = s;
+
+    for (;;) {
+        j = (j + 1) & c->slot_mask;
+        int i = c->slots[j];
+        if (i == SLOT_EMPTY) {
+            break;
+        }
+
+        size_t home = (size_t)c->nodes[i].hash & c->slot_mask;
+        // Move entry back if its home is not cyclically within (hole, j]
+        if (((j - home) & c->slot_mask) >= ((j - hole) & c->slot_mask)) {
+            c->slots[hole] = i;
+            hole = j;
+        }
+    }
+
+    c->slots[hole] = SLOT_EMPTY;
+}
+
+// ============================================================================
+// NODES
+// ============================================================================
+
+static void node_release(pubkey_cache_t *c, int i) {
+    cache_node_t *n = &c->nodes[i];
+
+    expanded_drop(c, i);
+    free(n->entry.identity);
+    free(n->entry.signing_pubkey);
+    free(n->entry.encryption_pubkey);
+    memset(&n->entry, 0, sizeof(n->entry));
+    n->in_use = 0;
+
+    n->next = c->free_head;
+    c->free_head = i;
+    c->count--;
+}
+
+static void remove_at_slot(pubkey_cache_t *c, size_t s) {
+    int i = c->slots[s];
+    slot_delete(c, s);
+    lru_unlink(c, i);
+    node_release(c, i);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+pubkey_cache_t* pubkey_cache_new(size_t capacity, int ttl_seconds) {
+    if (capacity == 0) {
+        capacity = PUBKEY_CACHE_DEFAULT_CAPACITY;
+    }
+
+    pubkey_cache_t *c = calloc(1, sizeof(pubkey_cache_t));
+    if (!c) {
+        return NULL;
+    }
+
+    size_t slot_count = 16;
+    while (slot_count < capacity * 2) {
+        slot_count <<= 1;
+    }
+
+    c->nodes = calloc(capacity, sizeof(cache_node_t));
+    c->slots = malloc(slot_count * sizeof(int));
+    if (!c->nodes || !c->slots) {
+        free(c->nodes);
+        free(c->slots);
+        free(c);
+        return NULL;
+    }
+
+    for (size_t s = 0; s < slot_count; s++) {
+        c->slots[s] = SLOT_EMPTY;
+    }
+    for (size_t i = 0; i < capacity; i++) {
+        c->nodes[i].prev = -1;
+        c->nodes[i].next = (i + 1 < capacity) ? (int)(i + 1) : -1;
+        c->nodes[i].xprev = -1;
+        c->nodes[i].xnext = -1;
+    }
+
+    c->capacity = capacity;
+    c->slot_mask = slot_count - 1;
+    c->ttl = ttl_seconds > 0 ? ttl_seconds : 0;
+    c->lru_head = -1;
+    c->lru_tail = -1;
+    c->free_head = 0;
+    c->xlru_head = -1;
+    c->xlru_tail = -1;
+    c->expanded_max_bytes = PUBKEY_CACHE_DEFAULT_EXPANDED_BYTES;
+
+    return c;
+}
+
+void pubkey_cache_free(pubkey_cache_t *cache) {
+    if (!cache) {
+        return;
+    }
+
+    pubkey_cache_clear(cache);
+    free(cache->nodes);
+    free(cache->slots);
+    free(cache);
+}
+
+const pubkey_cache_entry_t* pubkey_cache_get(pubkey_cache_t *cache, const char *identity) {
+    if (!cache || !identity) {
+        return NULL;
+    }
+
+    expanded_trim(cache);
+
+    long s = slot_find(cache, identity, hash_identity(identity));
+    if (s < 0) {
+        cache->stats.misses++;
+        return NULL;
+    }
+
+    int i = cache->slots[s];
+    if (cache->ttl > 0 && time(NULL) - cache->nodes[i].entry.fetched_at >= cache->ttl) {
+        remove_at_slot(cache, (size_t)s);
+        cache->stats.expired++;
+        cache->stats.misses++;
+        return NULL;
+    }
+
+    if (cache->lru_head != i) {
+        lru_unlink(cache, i);
+        lru_push_front(cache, i);
+    }
+
+    cache->stats.hits++;
+    return &cache->nodes[i].entry;
+}
+
+const pubkey_cache_entry_t* pubkey_cache_peek(const pubkey_cache_t *cache, const char *identity) {
+    if (!cache || !identity) {
+        return NULL;
+    }
+
+    long s = slot_find(cache, identity, hash_identity(identity));
+    if (s < 0) {
+        return NULL;
+    }
+
+    // Expired entries are left for pubkey_cache_get() to drop and count
+    const cache_node_t *n = &cache->nodes[cache->slots[s]];
+    if (cache->ttl > 0 && time(NULL) - n->entry.fetched_at >= cache->ttl) {
+        return NULL;
+    }
+    return &n->entry;
+}
+
+const pubkey_cache_entry_t* pubkey_cache_put(pubkey_cache_t *cache, const char *identity,
+                                             const uint8_t *signing_pubkey, size_t signing_pubkey_len,
+                                             const uint8_t *encryption_pubkey, size_t encryption_pubkey_len) {
+    if (!cache || !identity || !signing_pubkey || !encryption_pubkey) {
+        return NULL;
+    }
+
+    // Copy first so a failed allocation leaves the cache untouched
+    char *id_copy = strdup(identity);
+    uint8_t *sign_copy = malloc(signing_pubkey_len);
+    uint8_t *enc_copy = malloc(encryption_pubkey_len);
+    if (!id_copy || !sign_copy || !enc_copy) {
+        free(id_copy);
+        free(sign_copy);
+        free(enc_copy);
+        return NULL;
+    }
+    memcpy(sign_copy, signing_pubkey, signing_pubkey_len);
+    memcpy(enc_copy, encryption_pubkey, encryption_pubkey_len);
+
+    expanded_trim(cache);
+
+    uint64_t hash = hash_identity(identity);
+
+    // Replace existing entry
+    long s = slot_find(cache, identity, hash);
+    if (s >= 0) {
+        remove_at_slot(cache, (size_t)s);
+    }
+
+    // Make room
+    if (cache->free_head == -1) {
+        int victim = cache->lru_tail;
+        long vs = slot_find(cache, cache->nodes[victim].entry.identity, cache->nodes[victim].hash);
+        remove_at_slot(cache, (size_t)vs);
+        cache->stats.evictions++;
+    }
+
+    int i = cache->free_head;
+    cache_node_t *n = &cache->nodes[i];
+    cache->free_head = n->next;
+
+    n->entry.identity = id_copy;
+    n->entry.signing_pubkey = sign_copy;
+    n->entry.signing_pubkey_len = signing_pubkey_len;
+    n->entry.encryption_pubkey = enc_copy;
+    n->entry.encryption_pubkey_len = encryption_pubkey_len;
+    n->entry.fetched_at = time(NULL);
+    n->entry.signing_expanded = NULL;
+    n->entry.encryption_expanded = NULL;
+    n->hash = hash;
+    n->in_use = 1;
+    n->expanded_bytes = 0;
+    cache->count++;
+
+    slot_insert(cache, i, hash);
+    lru_push_front(cache, i);
+
+    return &n->entry;
+}
+
+const qgp_dilithium3_expanded_pk* pubkey_cache_signing_expanded(pubkey_cache_t *cache,
+                                                                const pubkey_cache_entry_t *entry) {
+    if (!cache || !entry || entry->signing_pubkey_len != QGP_DILITHIUM3_PUBLICKEYBYTES) {
+        return NULL;
+    }
+
+    // Entries are nodes of this cache; only the cache hands out const pointers to them
+    pubkey_cache_entry_t *e = (pubkey_cache_entry_t*)entry;
+    int i = entry_node(cache, entry);
+    if (!e->signing_expanded) {
+        e->signing_expanded = qgp_dilithium3_pk_expand(e->signing_pubkey);
+        if (e->signing_expanded) {
+            expanded_add(cache, i, qgp_dilithium3_expanded_pk_size());
+        }
+    } else {
+        expanded_touch(cache, i);
+    }
+    return e->signing_expanded;
+}
+
+const qgp_kyber512_expanded_pk* pubkey_cache_encryption_expanded(pubkey_cache_t *cache,
+                                                                 const pubkey_cache_entry_t *entry) {
+    if (!cache || !entry || entry->encryption_pubkey_len != QGP_KYBER512_PUBLICKEYBYTES) {
+        return NULL;
+    }
+
+    pubkey_cache_entry_t *e = (pubkey_cache_entry_t*)entry;
+    int i = entry_node(cache, entry);
+    if (!e->encryption_expanded) {
+        e->encryption_expanded = qgp_kyber512_pk_expand(e->encryption_pubkey);
+        if (e->encryption_expanded) {
+            expanded_add(cache, i, qgp_kyber512_expanded_pk_size());
+        }
+    } else {
+        expanded_touch(cache, i);
+    }
+    return e->encryption_expanded;
+}
+
+void pubkey_cache_remove(pubkey_cache_t *cache, const char *identity) {
+    if (!cache || !identity) {
+        return;
+    }
+
+    long s = slot_find(cache, identity, hash_identity(identity));
+    if (s >= 0) {
+        remove_at_slot(cache, (size_t)s);
+    }
+}
+
+void pubkey_cache_clear(pubkey_cache_t *cache) {
+    if (!cache) {
+        return;
+    }
+
+    for (size_t s = 0; s <= cache->slot_mask; s++) {
+        cache->slots[s] = SLOT_EMPTY;
+    }
+
+    for (size_t i = 0; i < cache->capacity; i++) {
+        cache_node_t *n = &cache->nodes[i];
+        if (n->in_use) {
+            free(n->entry.identity);
+            free(n->entry.signing_pubkey);
+            free(n->entry.encryption_pubkey);
+            qgp_dilithium3_expanded_pk_free(n->entry.signing_expanded);
+            qgp_kyber512_expanded_pk_free(n->entry.encryption_expanded);
+            memset(&n->entry, 0, sizeof(n->entry));
+            n->in_use = 0;
+        }
+        n->prev = -1;
+        n->next = (i + 1 < cache->capacity) ? (int)(i + 1) : -1;
+        n->expanded_bytes = 0;
+        n->xprev = -1;
+        n->xnext = -1;
+    }
+
+    cache->count = 0;
+    cache->lru_head = -1;
+    cache->lru_tail = -1;
+    cache->free_head = 0;
+    cache->xlru_head = -1;
+    cache->xlru_tail = -1;
+    cache->expanded_bytes = 0;
+}
+
+void pubkey_cache_get_stats(const pubkey_cache_t *cache, pubkey_cache_stats_t *stats_out) {
+    if (!cache || !stats_out) {
+        return;
+    }
+
+    *stats_out = cache->stats;
+    stats_out->count = cache->count;
+    stats_out->capacity = cache->capacity;
+    stats_out->expanded_bytes = cache->expanded_bytes;
+}
+
+void pubkey_cache_set_expanded_max_bytes(pubkey_cache_t *cache, size_t max_bytes) {
+    if (cache) {
+        cache->expanded_max_bytes = max_bytes > 0 ? max_bytes : PUBKEY_CACHE_DEFAULT_EXPANDED_BYTES;
+    }
+}
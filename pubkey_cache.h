@@ -0,0 +1,166 @@
+/*
+ * DNA Messenger - Public Key Cache
+ *
+ * Bounded in-memory cache of keyserver public keys:
+ * - Open-addressed hash index (linear probing, backward-shift delete)
+ * - LRU eviction when capacity is reached
+ * - Per-entry TTL (expired entries count as misses and are dropped)
+ * - Hit/miss/expiry/eviction counters for sizing
+ *
+ * Lookups return borrowed, read-only entries. A borrowed entry stays valid
+ * until the next pubkey_cache_put/remove/clear/free on the same cache.
+ * Entries can also hold the signing and encryption keys in expanded form,
+ * built on first use, for repeated verification and encapsulation. Expanded
+ * keys have their own LRU and byte budget; over-budget ones are dropped
+ * (entries are kept) at the next pubkey_cache_get/put.
+ * Not thread-safe.
+ */
+
+#ifndef PUBKEY_CACHE_H
+#define PUBKEY_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include "qgp_dilithium.h"
+#include "qgp_kyber.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PUBKEY_CACHE_DEFAULT_CAPACITY 1024
+#define PUBKEY_CACHE_DEFAULT_TTL 3600      // seconds
+#define PUBKEY_CACHE_DEFAULT_EXPANDED_BYTES (4 * 1024 * 1024)  // ~100 expanded Dilithium3 keys
+
+/**
+ * Cache entry (read-only for callers)
+ */
+typedef struct {
+    char *identity;
+    uint8_t *signing_pubkey;
+    size_t signing_pubkey_len;
+    uint8_t *encryption_pubkey;
+    size_t encryption_pubkey_len;
+    time_t fetched_at;           // When the keys were fetched from keyserver
+    qgp_dilithium3_expanded_pk *signing_expanded;  // NULL until pubkey_cache_signing_expanded()
+    qgp_kyber512_expanded_pk *encryption_expanded; // NULL until pubkey_cache_encryption_expanded()
+} pubkey_cache_entry_t;
+
+/**
+ * Cache counters
+ */
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;             // Includes expired lookups
+    uint64_t expired;
+    uint64_t evictions;          // LRU evictions due to capacity
+    uint64_t expanded_evictions; // Expanded keys dropped to stay within budget
+    size_t count;                // Current number of entries
+    size_t capacity;
+    size_t expanded_bytes;       // Bytes currently held by expanded keys
+} pubkey_cache_stats_t;
+
+typedef struct pubkey_cache pubkey_cache_t;
+
+/**
+ * Create cache
+ *
+ * @param capacity Maximum number of entries (0 = default)
+ * @param ttl_seconds Entry lifetime in seconds (0 = never expire)
+ * @return Cache, or NULL on allocation failure
+ */
+pubkey_cache_t* pubkey_cache_new(size_t capacity, int ttl_seconds);
+
+/**
+ * Free cache and all entries
+ */
+void pubkey_cache_free(pubkey_cache_t *cache);
+
+/**
+ * Look up identity
+ *
+ * A hit marks the entry most recently used.
+ *
+ * @param cache Cache
+ * @param identity Identity name
+ * @return Borrowed entry, or NULL on miss/expired
+ */
+const pubkey_cache_entry_t* pubkey_cache_get(pubkey_cache_t *cache, const char *identity);
+
+/**
+ * Look up identity without side effects on counters or LRU order
+ *
+ * For internal reuse of an entry that was already looked up (e.g. to get
+ * its expanded keys). Expired entries are not returned but left in place.
+ *
+ * @return Borrowed entry, or NULL if absent/expired
+ */
+const pubkey_cache_entry_t* pubkey_cache_peek(const pubkey_cache_t *cache, const char *identity);
+
+/**
+ * Insert or replace identity's keys (inputs are copied)
+ *
+ * Evicts the least recently used entry if the cache is full.
+ *
+ * @return Borrowed entry, or NULL on allocation failure
+ */
+const pubkey_cache_entry_t* pubkey_cache_put(pubkey_cache_t *cache, const char *identity,
+                                             const uint8_t *signing_pubkey, size_t signing_pubkey_len,
+                                             const uint8_t *encryption_pubkey, size_t encryption_pubkey_len);
+
+/**
+ * Get entry's signing key in expanded form
+ *
+ * Expanded on the first call for the entry and kept until the entry is
+ * replaced or dropped, or the expanded-key budget forces it out. The
+ * result stays valid until the next pubkey_cache_get/put/remove/clear/free.
+ *
+ * @param cache Cache
+ * @param entry Entry returned by pubkey_cache_get/put on this cache
+ * @return Borrowed expanded key, or NULL if the signing key is not a
+ *         Dilithium3 key or allocation failed
+ */
+const qgp_dilithium3_expanded_pk* pubkey_cache_signing_expanded(pubkey_cache_t *cache,
+                                                                const pubkey_cache_entry_t *entry);
+
+/**
+ * Get entry's encryption key in expanded form
+ *
+ * Same budget and lifetime rules as pubkey_cache_signing_expanded().
+ *
+ * @param cache Cache
+ * @param entry Entry returned by pubkey_cache_get/put on this cache
+ * @return Borrowed expanded key, or NULL if the encryption key is not a
+ *         Kyber512 key or allocation failed
+ */
+const qgp_kyber512_expanded_pk* pubkey_cache_encryption_expanded(pubkey_cache_t *cache,
+                                                                 const pubkey_cache_entry_t *entry);
+
+/**
+ * Remove identity (no-op if absent)
+ */
+void pubkey_cache_remove(pubkey_cache_t *cache, const char *identity);
+
+/**
+ * Remove all entries (counters are kept)
+ */
+void pubkey_cache_clear(pubkey_cache_t *cache);
+
+/**
+ * Get counters
+ */
+void pubkey_cache_get_stats(const pubkey_cache_t *cache, pubkey_cache_stats_t *stats_out);
+
+/**
+ * Set byte budget for expanded keys (0 = default)
+ *
+ * Takes effect at the next pubkey_cache_get/put.
+ */
+void pubkey_cache_set_expanded_max_bytes(pubkey_cache_t *cache, size_t max_bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PUBKEY_CACHE_H
@@ -0,0 +1,685 @@
+/*
+ * DNA Messenger - Persistent Public Key Store
+ *
+ * Index: open-addressed hash of identity -> (offset, length) of the latest
+ * valid record. Reads go through a read-only mapping of the file that is
+ * refreshed when a record beyond the mapped range is requested. Writes are
+ * single unbuffered appends of a fully built record.
+ *
+ * Several processes (GUI, CLI) share the file. Every get/put takes an
+ * exclusive advisory lock on the open file, checks that the path still
+ * names that file (compaction replaces it) and indexes whatever other
+ * processes appended since the last call, so cached offsets always match
+ * the file being read.
+ */
+
+#include "pubkey_store.h"
+#include "qgp_platform.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <openssl/sha.h>
+
+#define STORE_MAGIC "DNAPKS01"
+#define STORE_FORMAT_VERSION 1
+#define STORE_HEADER_SIZE 16
+#define RECORD_HEADER_SIZE 60
+#define COMPACT_MIN_SIZE (64 * 1024)
+
+typedef struct {
+    uint64_t hash;
+    char *identity;              // NULL = empty slot
+    uint64_t offset;
+    uint32_t length;
+} store_index_entry_t;
+
+struct pubkey_store {
+    char *path;
+    FILE *fp;                    // Append handle; carries the file lock
+    uint64_t file_size;          // Bytes indexed so far (0 = not loaded)
+    uint64_t live_bytes;         // Bytes of latest records only
+
+    const uint8_t *map;
+    size_t map_size;
+
+    store_index_entry_t *index;
+    size_t index_cap;            // Power of two
+    size_t index_count;
+
+    qgp_mutex_t *lock;
+};
+
+// ============================================================================
+// ENCODING
+// ============================================================================
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_u64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+static uint64_t get_u64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+/**
+ * Validate record at p (available bytes: avail)
+ * @return record length if valid, 0 if truncated/corrupt
+ */
+static uint32_t record_check(const uint8_t *p, uint64_t avail) {
+    if (avail < RECORD_HEADER_SIZE) {
+        return 0;
+    }
+
+    uint32_t record_len = get_u32(p);
+    uint16_t identity_len = get_u16(p + 4);
+    uint32_t sign_len = get_u32(p + 52);
+    uint32_t enc_len = get_u32(p + 56);
+
+    if (record_len > avail || identity_len == 0 ||
+        (uint64_t)RECORD_HEADER_SIZE + identity_len + sign_len + enc_len != record_len) {
+        return 0;
+    }
+
+    uint8_t fingerprint[32];
+    SHA256(p + RECORD_HEADER_SIZE + identity_len, (size_t)sign_len + enc_len, fingerprint);
+    if (memcmp(fingerprint, p + 20, 32) != 0) {
+        return 0;
+    }
+
+    return record_len;
+}
+
+// ============================================================================
+// INDEX
+// ============================================================================
+
+static uint64_t hash_identity(const char *s, size_t len) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static store_index_entry_t* index_find(pubkey_store_t *st, const char *identity, size_t len, uint64_t hash) {
+    size_t mask = st->index_cap - 1;
+    for (size_t s = (size_t)hash & mask; ; s = (s + 1) & mask) {
+        store_index_entry_t *e = &st->index[s];
+        if (!e->identity) {
+            return e;
+        }
+        if (e->hash == hash && strncmp(e->identity, identity, len) == 0 && e->identity[len] == '\0') {
+            return e;
+        }
+    }
+}
+
+static int index_grow(pubkey_store_t *st) {
+    size_t old_cap = st->index_cap;
+    store_index_entry_t *old = st->index;
+
+    st->index_cap = old_cap ? old_cap * 2 : 256;
+    st->index = calloc(st->index_cap, sizeof(store_index_entry_t));
+    if (!st->index) {
+        st->index = old;
+        st->index_cap = old_cap;
+        return -1;
+    }
+
+    for (size_t i = 0; i < old_cap; i++) {
+        if (old[i].identity) {
+            *index_find(st, old[i].identity, strlen(old[i].identity), old[i].hash) = old[i];
+        }
+    }
+    free(old);
+    return 0;
+}
+
+/**
+ * Point identity at record (offset, length), replacing any older record
+ */
+static int index_set(pubkey_store_t *st, const char *identity, size_t len,
+                     uint64_t offset, uint32_t length) {
+    if ((st->index_count + 1) * 2 > st->index_cap && index_grow(st) != 0) {
+        return -1;
+    }
+
+    uint64_t hash = hash_identity(identity, len);
+    store_index_entry_t *e = index_find(st, identity, len, hash);
+
+    if (e->identity) {
+        st->live_bytes -= e->length;
+    } else {
+        e->identity = malloc(len + 1);
+        if (!e->identity) {
+            return -1;
+        }
+        memcpy(e->identity, identity, len);
+        e->identity[len] = '\0';
+        e->hash = hash;
+        st->index_count++;
+    }
+
+    e->offset = offset;
+    e->length = length;
+    st->live_bytes += length;
+    return 0;
+}
+
+static void index_clear(pubkey_store_t *st) {
+    for (size_t i = 0; i < st->index_cap; i++) {
+        free(st->index[i].identity);
+    }
+    free(st->index);
+    st->index = NULL;
+    st->index_cap = 0;
+    st->index_count = 0;
+    st->live_bytes = 0;
+}
+
+// ============================================================================
+// FILE
+// ============================================================================
+
+static void store_unmap(pubkey_store_t *st) {
+    qgp_platform_unmap_file((void *)st->map, st->map_size);
+    st->map = NULL;
+    st->map_size = 0;
+}
+
+static void store_remap(pubkey_store_t *st) {
+    store_unmap(st);
+    st->map = qgp_platform_map_file(st->path, &st->map_size);
+}
+
+/**
+ * Forget everything indexed from the current file
+ */
+static void store_reset(pubkey_store_t *st) {
+    index_clear(st);
+    store_unmap(st);
+    st->file_size = 0;
+}
+
+/**
+ * Open path for appending; unbuffered so a record is one write
+ */
+static FILE* open_append(const char *path) {
+    FILE *fp = fopen(path, "ab");
+    if (fp) {
+        setvbuf(fp, NULL, _IONBF, 0);
+    }
+    return fp;
+}
+
+static int write_header(FILE *fp) {
+    uint8_t header[STORE_HEADER_SIZE];
+    memcpy(header, STORE_MAGIC, 8);
+    put_u32(header + 8, STORE_FORMAT_VERSION);
+    put_u32(header + 12, 0);
+    return fwrite(header, 1, sizeof(header), fp) == sizeof(header) ? 0 : -1;
+}
+
+static int replace_file(const char *tmp_path, const char *path) {
+#ifdef _WIN32
+    remove(path);
+#endif
+    return rename(tmp_path, path);
+}
+
+static char* path_with_suffix(const char *path, const char *suffix) {
+    size_t len = strlen(path) + strlen(suffix) + 1;
+    char *out = malloc(len);
+    if (out) {
+        snprintf(out, len, "%s%s", path, suffix);
+    }
+    return out;
+}
+
+/**
+ * Rewrite the file with only the latest record per identity
+ *
+ * Caller holds both locks. The new file is locked before it is renamed
+ * into place and becomes the append handle, so no other process can
+ * write to it before this call returns.
+ */
+static int store_compact(pubkey_store_t *st) {
+    char *tmp_path = path_with_suffix(st->path, ".tmp");
+    if (!tmp_path) {
+        return -1;
+    }
+
+    // Only the lock holder compacts, so a leftover .tmp is from a crash
+    remove(tmp_path);
+    FILE *fp = open_append(tmp_path);
+    if (!fp) {
+        free(tmp_path);
+        return -1;
+    }
+
+    int ok = (qgp_platform_lock_file(fp) == 0 && write_header(fp) == 0);
+    uint64_t offset = STORE_HEADER_SIZE;
+
+    for (size_t i = 0; ok && i < st->index_cap; i++) {
+        store_index_entry_t *e = &st->index[i];
+        if (!e->identity) {
+            continue;
+        }
+        ok = fwrite(st->map + e->offset, 1, e->length, fp) == e->length;
+    }
+
+    if (ok) {
+        store_unmap(st);
+        ok = (replace_file(tmp_path, st->path) == 0);
+    }
+
+    if (!ok) {
+        fclose(fp);
+        remove(tmp_path);
+        free(tmp_path);
+        store_remap(st);
+        return -1;
+    }
+
+    free(tmp_path);
+
+    // Old file is unlinked; closing it releases its lock
+    if (st->fp) {
+        fclose(st->fp);
+    }
+    st->fp = fp;
+    store_remap(st);
+
+    // Same iteration order as the write loop above
+    for (size_t i = 0; i < st->index_cap; i++) {
+        store_index_entry_t *e = &st->index[i];
+        if (e->identity) {
+            e->offset = offset;
+            offset += e->length;
+        }
+    }
+
+    st->file_size = offset;
+    return 0;
+}
+
+/**
+ * Index records in the mapping from offset off; stop at the first
+ * truncated one (torn append)
+ *
+ * @return 0 on success (end_out: offset after last record), -1 on error
+ */
+static int store_scan(pubkey_store_t *st, uint64_t off, uint64_t *end_out) {
+    while (off < st->map_size) {
+        const uint8_t *p = st->map + off;
+        uint64_t avail = st->map_size - off;
+
+        uint32_t len = record_check(p, avail);
+        if (len == 0) {
+            uint32_t claimed = avail >= 4 ? get_u32(p) : 0;
+            if (claimed >= RECORD_HEADER_SIZE && claimed <= avail) {
+                // Corrupt but framed - skip it
+                off += claimed;
+                continue;
+            }
+            break;
+        }
+
+        if (index_set(st, (const char *)p + RECORD_HEADER_SIZE, get_u16(p + 4), off, len) != 0) {
+            return -1;
+        }
+        off += len;
+    }
+
+    *end_out = off;
+    return 0;
+}
+
+/**
+ * Map the file and build the index from scratch
+ * Caller holds both locks; index is empty
+ */
+static int store_load(pubkey_store_t *st) {
+    int64_t size = qgp_platform_file_size(st->fp);
+    if (size < 0) {
+        return -1;
+    }
+
+    if (size == 0) {
+        // Freshly created; the lock keeps other writers out until the header is down
+        if (write_header(st->fp) != 0) {
+            return -1;
+        }
+        store_remap(st);
+        st->file_size = STORE_HEADER_SIZE;
+        return 0;
+    }
+
+    store_remap(st);
+
+    if (!st->map || st->map_size < STORE_HEADER_SIZE ||
+        memcmp(st->map, STORE_MAGIC, 8) != 0 ||
+        get_u32(st->map + 8) != STORE_FORMAT_VERSION) {
+        // Unknown format (newer client?) - keep it for inspection, start empty
+        store_unmap(st);
+        char *bad_path = path_with_suffix(st->path, ".bad");
+        if (!bad_path) {
+            return -1;
+        }
+        int rc = replace_file(st->path, bad_path);
+        if (rc == 0) {
+            fprintf(stderr, "Warning: Unrecognized pubkey store moved to %s\n", bad_path);
+        }
+        free(bad_path);
+        return rc == 0 ? store_compact(st) : -1;
+    }
+
+    uint64_t end;
+    if (store_scan(st, STORE_HEADER_SIZE, &end) != 0) {
+        return -1;
+    }
+    st->file_size = st->map_size;
+
+    // Trailing garbage would hide later appends; mostly-dead files waste mapping
+    int garbage = (end != st->map_size);
+    int sparse = (st->map_size > COMPACT_MIN_SIZE &&
+                  st->live_bytes * 2 < st->map_size - STORE_HEADER_SIZE);
+
+    if ((garbage || sparse) && store_compact(st) != 0) {
+        fprintf(stderr, "Warning: Failed to compact pubkey store %s\n", st->path);
+        if (garbage) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Index records other processes appended since we last looked
+ * Caller holds both locks
+ */
+static int store_catch_up(pubkey_store_t *st) {
+    if (st->file_size == 0) {
+        return store_load(st);
+    }
+
+    int64_t size = qgp_platform_file_size(st->fp);
+    if (size < 0) {
+        return -1;
+    }
+    if ((uint64_t)size == st->file_size) {
+        return 0;
+    }
+    if ((uint64_t)size < st->file_size) {
+        // Truncated behind our back - offsets are meaningless now
+        store_reset(st);
+        return store_load(st);
+    }
+
+    store_remap(st);
+    if (!st->map || st->map_size < st->file_size) {
+        return -1;
+    }
+
+    uint64_t end;
+    if (store_scan(st, st->file_size, &end) != 0) {
+        return -1;
+    }
+    st->file_size = st->map_size;
+
+    // Torn append (crashed or failed writer) would hide later records
+    if (end != st->map_size && store_compact(st) != 0) {
+        fprintf(stderr, "Warning: Failed to compact pubkey store %s\n", st->path);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Take the file lock on the file currently at path and bring the index
+ * up to date with it
+ * Caller holds the mutex
+ */
+static int store_lock(pubkey_store_t *st) {
+    for (;;) {
+        if (!st->fp) {
+            st->fp = open_append(st->path);
+            if (!st->fp) {
+                return -1;
+            }
+        }
+
+        if (qgp_platform_lock_file(st->fp) != 0) {
+            return -1;
+        }
+        if (qgp_platform_same_file(st->fp, st->path)) {
+            break;
+        }
+
+        // Another process compacted and renamed a new file into place
+        qgp_platform_unlock_file(st->fp);
+        fclose(st->fp);
+        st->fp = NULL;
+        store_reset(st);
+    }
+
+    if (store_catch_up(st) != 0) {
+        qgp_platform_unlock_file(st->fp);
+        return -1;
+    }
+    return 0;
+}
+
+static void store_unlock(pubkey_store_t *st) {
+    qgp_platform_unlock_file(st->fp);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+pubkey_store_t* pubkey_store_open(const char *path) {
+    if (!path) {
+        return NULL;
+    }
+
+    pubkey_store_t *st = calloc(1, sizeof(pubkey_store_t));
+    if (!st) {
+        return NULL;
+    }
+
+    st->path = strdup(path);
+    st->lock = qgp_platform_mutex_new();
+    if (!st->path || !st->lock || store_lock(st) != 0) {
+        pubkey_store_close(st);
+        return NULL;
+    }
+    store_unlock(st);
+
+    return st;
+}
+
+void pubkey_store_close(pubkey_store_t *store) {
+    if (!store) {
+        return;
+    }
+
+    if (store->fp) {
+        fclose(store->fp);
+    }
+    store_unmap(store);
+    index_clear(store);
+    qgp_platform_mutex_free(store->lock);
+    free(store->path);
+    free(store);
+}
+
+int pubkey_store_get(pubkey_store_t *store, const char *identity, pubkey_store_record_t *record_out) {
+    if (!store || !identity || !record_out) {
+        return -1;
+    }
+
+    memset(record_out, 0, sizeof(*record_out));
+    size_t id_len = strlen(identity);
+    int ret = -1;
+
+    qgp_platform_mutex_lock(store->lock);
+
+    if (store_lock(store) != 0) {
+        qgp_platform_mutex_unlock(store->lock);
+        return -1;
+    }
+
+    if (store->index_count == 0) {
+        goto done;
+    }
+
+    store_index_entry_t *e = index_find(store, identity, id_len, hash_identity(identity, id_len));
+    if (!e->identity) {
+        goto done;
+    }
+
+    // Record appended after the current mapping was made
+    if (e->offset + e->length > store->map_size) {
+        store_remap(store);
+        if (e->offset + e->length > store->map_size) {
+            goto done;
+        }
+    }
+
+    const uint8_t *p = store->map + e->offset;
+    if (record_check(p, e->length) != e->length) {
+        goto done;
+    }
+
+    // Never hand out keys from a record that belongs to someone else
+    uint16_t identity_len = get_u16(p + 4);
+    if (identity_len != id_len || memcmp(p + RECORD_HEADER_SIZE, identity, id_len) != 0) {
+        goto done;
+    }
+
+    uint32_t sign_len = get_u32(p + 52);
+    uint32_t enc_len = get_u32(p + 56);
+    const uint8_t *sign = p + RECORD_HEADER_SIZE + identity_len;
+    const uint8_t *enc = sign + sign_len;
+
+    record_out->identity = strdup(identity);
+    record_out->signing_pubkey = malloc(sign_len ? sign_len : 1);
+    record_out->encryption_pubkey = malloc(enc_len ? enc_len : 1);
+    if (!record_out->identity || !record_out->signing_pubkey || !record_out->encryption_pubkey) {
+        pubkey_store_record_free(record_out);
+        goto done;
+    }
+
+    memcpy(record_out->signing_pubkey, sign, sign_len);
+    memcpy(record_out->encryption_pubkey, enc, enc_len);
+    record_out->signing_pubkey_len = sign_len;
+    record_out->encryption_pubkey_len = enc_len;
+    record_out->key_version = get_u32(p + 8);
+    record_out->fetched_at = (int64_t)get_u64(p + 12);
+    memcpy(record_out->fingerprint, p + 20, 32);
+    ret = 0;
+
+done:
+    store_unlock(store);
+    qgp_platform_mutex_unlock(store->lock);
+    return ret;
+}
+
+int pubkey_store_put(pubkey_store_t *store, const char *identity,
+                     const uint8_t *signing_pubkey, size_t signing_pubkey_len,
+                     const uint8_t *encryption_pubkey, size_t encryption_pubkey_len,
+                     uint32_t key_version, int64_t fetched_at) {
+    if (!store || !identity || !signing_pubkey || !encryption_pubkey) {
+        return -1;
+    }
+
+    size_t id_len = strlen(identity);
+    if (id_len == 0 || id_len > 0xFFFF ||
+        signing_pubkey_len > 0xFFFFFF || encryption_pubkey_len > 0xFFFFFF) {
+        return -1;
+    }
+
+    uint32_t record_len = (uint32_t)(RECORD_HEADER_SIZE + id_len + signing_pubkey_len + encryption_pubkey_len);
+    uint8_t *rec = malloc(record_len);
+    if (!rec) {
+        return -1;
+    }
+
+    uint8_t *keys = rec + RECORD_HEADER_SIZE + id_len;
+    memcpy(rec + RECORD_HEADER_SIZE, identity, id_len);
+    memcpy(keys, signing_pubkey, signing_pubkey_len);
+    memcpy(keys + signing_pubkey_len, encryption_pubkey, encryption_pubkey_len);
+
+    put_u32(rec, record_len);
+    put_u16(rec + 4, (uint16_t)id_len);
+    put_u16(rec + 6, 0);
+    put_u32(rec + 8, key_version);
+    put_u64(rec + 12, (uint64_t)fetched_at);
+    SHA256(keys, signing_pubkey_len + encryption_pubkey_len, rec + 20);
+    put_u32(rec + 52, (uint32_t)signing_pubkey_len);
+    put_u32(rec + 56, (uint32_t)encryption_pubkey_len);
+
+    int ret = -1;
+    qgp_platform_mutex_lock(store->lock);
+
+    if (store_lock(store) == 0) {
+        // Caught up under the lock, so the append lands at file_size
+        if (fwrite(rec, 1, record_len, store->fp) == record_len) {
+            ret = index_set(store, identity, id_len, store->file_size, record_len);
+            store->file_size += record_len;
+        }
+        // A torn record is found and compacted away by the next catch-up
+        store_unlock(store);
+    }
+
+    qgp_platform_mutex_unlock(store->lock);
+    free(rec);
+    return ret;
+}
+
+size_t pubkey_store_count(pubkey_store_t *store) {
+    if (!store) {
+        return 0;
+    }
+
+    qgp_platform_mutex_lock(store->lock);
+    size_t count = store->index_count;
+    qgp_platform_mutex_unlock(store->lock);
+    return count;
+}
+
+void pubkey_store_record_free(pubkey_store_record_t *record) {
+    if (!record) {
+        return;
+    }
+
+    free(record->identity);
+    free(record->signing_pubkey);
+    free(record->encryption_pubkey);
+    memset(record, 0, sizeof(*record));
+}
@@ -0,0 +1,108 @@
+/*
+ * DNA Messenger - Persistent Public Key Store
+ *
+ * On-disk cache of keyserver public keys (~/.dna/pubkeys.cache), so a
+ * restart does not have to re-fetch every contact's keys.
+ *
+ * File format (little-endian, append-only):
+ *   Header:  "DNAPKS01" (8) | format version u32 | reserved u32
+ *   Record:  record_len u32 | identity_len u16 | flags u16 |
+ *            key_version u32 | fetched_at u64 | fingerprint[32] |
+ *            signing_len u32 | encryption_len u32 |
+ *            identity | signing key | encryption key
+ *
+ * fingerprint = SHA-256(signing key || encryption key). Records whose
+ * fingerprint does not match (torn/corrupt writes) are ignored. The last
+ * record for an identity wins; superseded records are dropped by
+ * compaction when the store is opened. A file with an unknown header is
+ * renamed to <path>.bad rather than overwritten.
+ *
+ * The file is read through a read-only memory mapping. All functions are
+ * thread-safe (internal mutex), and several processes may share one file:
+ * appends and compaction are serialized with an advisory file lock.
+ */
+
+#ifndef PUBKEY_STORE_H
+#define PUBKEY_STORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PUBKEY_STORE_FILE_NAME "pubkeys.cache"
+
+typedef struct pubkey_store pubkey_store_t;
+
+/**
+ * Stored record (caller-owned copy)
+ */
+typedef struct {
+    char *identity;
+    uint8_t *signing_pubkey;
+    size_t signing_pubkey_len;
+    uint8_t *encryption_pubkey;
+    size_t encryption_pubkey_len;
+    uint32_t key_version;        // Keyserver "version" field
+    int64_t fetched_at;          // Unix time keys were last confirmed with keyserver
+    uint8_t fingerprint[32];     // SHA-256(signing || encryption)
+} pubkey_store_record_t;
+
+/**
+ * Open (or create) store file, index it and compact if worthwhile
+ *
+ * @param path Store file path
+ * @return Store, or NULL on error
+ */
+pubkey_store_t* pubkey_store_open(const char *path);
+
+/**
+ * Close store
+ */
+void pubkey_store_close(pubkey_store_t *store);
+
+/**
+ * Read latest record for identity
+ *
+ * @param store Store
+ * @param identity Identity name
+ * @param record_out Output record (free with pubkey_store_record_free)
+ * @return 0 if found, -1 if not found or on error
+ */
+int pubkey_store_get(pubkey_store_t *store, const char *identity, pubkey_store_record_t *record_out);
+
+/**
+ * Append record for identity
+ *
+ * @param store Store
+ * @param identity Identity name
+ * @param signing_pubkey Signing key
+ * @param signing_pubkey_len Signing key length
+ * @param encryption_pubkey Encryption key
+ * @param encryption_pubkey_len Encryption key length
+ * @param key_version Keyserver version of these keys
+ * @param fetched_at Unix time keys were confirmed with keyserver
+ * @return 0 on success, -1 on error
+ */
+int pubkey_store_put(pubkey_store_t *store, const char *identity,
+                     const uint8_t *signing_pubkey, size_t signing_pubkey_len,
+                     const uint8_t *encryption_pubkey, size_t encryption_pubkey_len,
+                     uint32_t key_version, int64_t fetched_at);
+
+/**
+ * Number of identities in store
+ */
+size_t pubkey_store_count(pubkey_store_t *store);
+
+/**
+ * Free record contents
+ */
+void pubkey_store_record_free(pubkey_store_record_t *record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PUBKEY_STORE_H
@@ -6,6 +6,7 @@
 #include "crypto/dilithium/polyvec.h"
 #include "crypto/dilithium/poly.h"
 #include "crypto/dilithium/fips202.h"
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
@@ -13,6 +14,11 @@
 // Wrapper for vendored pq-crystals/dilithium reference implementation
 // FIPS 204 compliant - ML-DSA-65 (NIST Level 3 security)
 
+struct qgp_dilithium3_expanded_pk {
+    uint8_t pk[CRYPTO_PUBLICKEYBYTES];  // Key this was expanded from
+    crypto_sign_expanded_pk epk;
+};
+
 int qgp_dilithium3_keypair(uint8_t *pk, uint8_t *sk)
 {
     if (!pk || !sk) {
@@ -102,3 +108,51 @@ int qgp_dilithium3_verify(const uint8_t *sig, size_t siglen,
     // Context (ctx) is NULL and ctxlen is 0 for pure Dilithium
     return pqcrystals_dilithium3_ref_verify(sig, siglen, m, mlen, NULL, 0, pk);
 }
+
+qgp_dilithium3_expanded_pk* qgp_dilithium3_pk_expand(const uint8_t *pk)
+{
+    if (!pk) {
+        return NULL;
+    }
+
+    qgp_dilithium3_expanded_pk *epk = malloc(sizeof(qgp_dilithium3_expanded_pk));
+    if (!epk) {
+        return NULL;
+    }
+
+    memcpy(epk->pk, pk, CRYPTO_PUBLICKEYBYTES);
+    crypto_sign_pk_expand(&epk->epk, pk);
+    return epk;
+}
+
+void qgp_dilithium3_expanded_pk_free(qgp_dilithium3_expanded_pk *epk)
+{
+    free(epk);
+}
+
+size_t qgp_dilithium3_expanded_pk_size(void)
+{
+    return sizeof(qgp_dilithium3_expanded_pk);
+}
+
+int qgp_dilithium3_expanded_pk_matches(const qgp_dilithium3_expanded_pk *epk,
+                                       const uint8_t *pk, size_t pklen)
+{
+    if (!epk || !pk || pklen != CRYPTO_PUBLICKEYBYTES) {
+        return 0;
+    }
+
+    return memcmp(epk->pk, pk, CRYPTO_PUBLICKEYBYTES) == 0;
+}
+
+int qgp_dilithium3_verify_expanded(const uint8_t *sig, size_t siglen,
+                                    const uint8_t *m, size_t mlen,
+                                    const qgp_dilithium3_expanded_pk *epk)
+{
+    if (!sig || !m || !epk) {
+        return -1;
+    }
+
+    // Context (ctx) is NULL and ctxlen is 0 for pure Dilithium
+    return crypto_sign_verify_expanded(sig, siglen, m, mlen, NULL, 0, &epk->epk);
+}
@@ -50,4 +50,33 @@ int qgp_dilithium3_verify(const uint8_t *sig, size_t siglen,
                            const uint8_t *m, size_t mlen,
                            const uint8_t *pk);
 
+// Expanded public key for repeated verification under one key
+// Holds the key unpacked once: H(pk), matrix A expanded from rho and t1*2^d
+// in NTT form (about 37 KB). Read-only after creation, so one expanded key
+// may be shared between threads.
+typedef struct qgp_dilithium3_expanded_pk qgp_dilithium3_expanded_pk;
+
+// Expand public key
+// pk: public key (must be QGP_DILITHIUM3_PUBLICKEYBYTES)
+// Returns expanded key (free with qgp_dilithium3_expanded_pk_free), NULL on failure
+qgp_dilithium3_expanded_pk* qgp_dilithium3_pk_expand(const uint8_t *pk);
+
+// Free expanded public key (NULL is ignored)
+void qgp_dilithium3_expanded_pk_free(qgp_dilithium3_expanded_pk *epk);
+
+// Bytes held by one expanded public key (for cache memory budgets)
+size_t qgp_dilithium3_expanded_pk_size(void);
+
+// Check whether epk was expanded from pk
+// Returns 1 if pk (pklen bytes) is the key epk was made from, 0 otherwise
+int qgp_dilithium3_expanded_pk_matches(const qgp_dilithium3_expanded_pk *epk,
+                                       const uint8_t *pk, size_t pklen);
+
+// Verification (detached signature) with expanded public key
+// Same result as qgp_dilithium3_verify() with the key epk was made from
+// Returns 0 if signature is valid, -1 if invalid
+int qgp_dilithium3_verify_expanded(const uint8_t *sig, size_t siglen,
+                                    const uint8_t *m, size_t mlen,
+                                    const qgp_dilithium3_expanded_pk *epk);
+
 #endif
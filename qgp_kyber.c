@@ -1,7 +1,13 @@
 #include "qgp_kyber.h"
 #include "crypto/kyber512/kem.h"
+#include <stdlib.h>
 #include <string.h>
 
+struct qgp_kyber512_expanded_pk {
+    uint8_t pk[QGP_KYBER512_PUBLICKEYBYTES];  // Key this was expanded from
+    crypto_kem_expanded_pk epk;
+};
+
 int qgp_kyber512_keypair(uint8_t *pk, uint8_t *sk) {
     if (!pk || !sk) {
         return -1;
@@ -18,6 +24,46 @@ int qgp_kyber512_enc(uint8_t *ct, uint8_t *ss, const uint8_t *pk) {
     return crypto_kem_enc(ct, ss, pk);
 }
 
+qgp_kyber512_expanded_pk* qgp_kyber512_pk_expand(const uint8_t *pk) {
+    if (!pk) {
+        return NULL;
+    }
+
+    qgp_kyber512_expanded_pk *epk = malloc(sizeof(qgp_kyber512_expanded_pk));
+    if (!epk) {
+        return NULL;
+    }
+
+    memcpy(epk->pk, pk, QGP_KYBER512_PUBLICKEYBYTES);
+    crypto_kem_pk_expand(&epk->epk, pk);
+    return epk;
+}
+
+void qgp_kyber512_expanded_pk_free(qgp_kyber512_expanded_pk *epk) {
+    free(epk);
+}
+
+size_t qgp_kyber512_expanded_pk_size(void) {
+    return sizeof(qgp_kyber512_expanded_pk);
+}
+
+int qgp_kyber512_expanded_pk_matches(const qgp_kyber512_expanded_pk *epk,
+                                     const uint8_t *pk, size_t pklen) {
+    if (!epk || !pk || pklen != QGP_KYBER512_PUBLICKEYBYTES) {
+        return 0;
+    }
+
+    return memcmp(epk->pk, pk, QGP_KYBER512_PUBLICKEYBYTES) == 0;
+}
+
+int qgp_kyber512_enc_expanded(uint8_t *ct, uint8_t *ss, const qgp_kyber512_expanded_pk *epk) {
+    if (!ct || !ss || !epk) {
+        return -1;
+    }
+
+    return crypto_kem_enc_expanded(ct, ss, &epk->epk);
+}
+
 int qgp_kyber512_dec(uint8_t *ss, const uint8_t *ct, const uint8_t *sk) {
     if (!ss || !ct || !sk) {
         return -1;
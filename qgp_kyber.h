@@ -36,6 +36,53 @@ int qgp_kyber512_keypair(uint8_t *pk, uint8_t *sk);
  */
 int qgp_kyber512_enc(uint8_t *ct, uint8_t *ss, const uint8_t *pk);
 
+/**
+ * Expanded public key for repeated encapsulation to one recipient
+ *
+ * Holds the key unpacked once: the public polyvec and the transposed
+ * matrix A in NTT domain, plus H(pk) (about 3 KB). Read-only after
+ * creation, so one expanded key may be shared between threads.
+ */
+typedef struct qgp_kyber512_expanded_pk qgp_kyber512_expanded_pk;
+
+/**
+ * Expand public key
+ *
+ * @param pk Input public key (800 bytes)
+ * @return Expanded key (free with qgp_kyber512_expanded_pk_free), NULL on error
+ */
+qgp_kyber512_expanded_pk* qgp_kyber512_pk_expand(const uint8_t *pk);
+
+/**
+ * Free expanded public key (NULL is ignored)
+ */
+void qgp_kyber512_expanded_pk_free(qgp_kyber512_expanded_pk *epk);
+
+/**
+ * Bytes held by one expanded public key (for cache memory budgets)
+ */
+size_t qgp_kyber512_expanded_pk_size(void);
+
+/**
+ * Check whether epk was expanded from pk
+ *
+ * @return 1 if pk (pklen bytes) is the key epk was made from, 0 otherwise
+ */
+int qgp_kyber512_expanded_pk_matches(const qgp_kyber512_expanded_pk *epk,
+                                     const uint8_t *pk, size_t pklen);
+
+/**
+ * Encapsulation with expanded public key
+ *
+ * Same as qgp_kyber512_enc() with the key epk was made from.
+ *
+ * @param ct Output ciphertext (768 bytes)
+ * @param ss Output shared secret (32 bytes)
+ * @param epk Input expanded public key
+ * @return 0 on success, -1 on error
+ */
+int qgp_kyber512_enc_expanded(uint8_t *ct, uint8_t *ss, const qgp_kyber512_expanded_pk *epk);
+
 /**
  * Decapsulation: Recover shared secret from ciphertext
  *
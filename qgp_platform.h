@@ -3,6 +3,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 
 /**
  * qgp_platform.h - Cross-platform abstraction layer
@@ -12,6 +13,10 @@
  * - Directory operations (creation, existence checks)
  * - File system operations (path resolution, home directory)
  * - Path operations (joining, normalization)
+ * - Memory-mapped files (read-only)
+ * - Advisory file locks
+ * - Threads and mutexes
+ * - Secure memory (page locking, wiping)
  *
  * Platform-specific implementations:
  * - Linux: qgp_platform_linux.c
@@ -97,6 +102,158 @@ const char* qgp_platform_home_dir(void);
  */
 char* qgp_platform_join_path(const char *dir, const char *file);
 
+/* ============================================================================
+ * Memory-Mapped Files
+ * ============================================================================ */
+
+/**
+ * Map an entire file read-only into memory
+ *
+ * Linux: open() + fstat() + mmap(PROT_READ, MAP_SHARED)
+ * Windows: CreateFileA() + CreateFileMappingA() + MapViewOfFile()
+ *
+ * The mapping stays valid after the file is appended to, but does not
+ * cover the appended bytes - remap to see them.
+ *
+ * @param path File to map
+ * @param size_out Output: mapped size in bytes
+ * @return Mapped address, or NULL on failure or empty file
+ */
+void* qgp_platform_map_file(const char *path, size_t *size_out);
+
+/**
+ * Unmap a file mapped with qgp_platform_map_file()
+ *
+ * @param addr Mapped address (NULL is a no-op)
+ * @param size Mapped size
+ */
+void qgp_platform_unmap_file(void *addr, size_t size);
+
+/* ============================================================================
+ * Advisory File Locks
+ * ============================================================================ */
+
+/**
+ * Take an exclusive lock on an open file, blocking until it is granted
+ *
+ * Linux: flock(LOCK_EX) - per open file, so two handles in one process
+ *        also exclude each other
+ * Windows: LockFileEx() on a byte beyond any real file data, so ordinary
+ *          reads and writes by other handles are not blocked
+ *
+ * Only cooperating processes that also take the lock are excluded.
+ *
+ * @param fp Open file
+ * @return 0 on success, -1 on failure
+ */
+int qgp_platform_lock_file(FILE *fp);
+
+/**
+ * Release a lock taken with qgp_platform_lock_file()
+ */
+void qgp_platform_unlock_file(FILE *fp);
+
+/**
+ * Check whether path still names the file open as fp
+ *
+ * Linux: fstat()/stat() device and inode comparison
+ * Windows: GetFileInformationByHandle() volume serial and file index
+ *
+ * @return 1 if same file, 0 if path was replaced/removed or on error
+ */
+int qgp_platform_same_file(FILE *fp, const char *path);
+
+/**
+ * Current size of an open file in bytes (ignores stdio buffering)
+ *
+ * @return Size, or -1 on error
+ */
+int64_t qgp_platform_file_size(FILE *fp);
+
+/* ============================================================================
+ * Threads and Mutexes
+ * ============================================================================ */
+
+typedef struct qgp_thread qgp_thread_t;
+typedef struct qgp_mutex qgp_mutex_t;
+
+/**
+ * Start a thread
+ *
+ * Linux: pthread_create()
+ * Windows: CreateThread()
+ *
+ * @param fn Thread entry point
+ * @param arg Argument passed to fn
+ * @return Thread handle (must be joined), or NULL on failure
+ */
+qgp_thread_t* qgp_platform_thread_create(void *(*fn)(void *), void *arg);
+
+/**
+ * Wait for a thread to finish and free its handle
+ *
+ * @param thread Thread handle (NULL is a no-op)
+ */
+void qgp_platform_thread_join(qgp_thread_t *thread);
+
+/**
+ * Number of online CPUs (at least 1)
+ */
+int qgp_platform_cpu_count(void);
+
+/**
+ * Create a (non-recursive) mutex
+ *
+ * @return Mutex, or NULL on failure
+ */
+qgp_mutex_t* qgp_platform_mutex_new(void);
+
+/**
+ * Destroy a mutex (NULL is a no-op)
+ */
+void qgp_platform_mutex_free(qgp_mutex_t *mutex);
+
+void qgp_platform_mutex_lock(qgp_mutex_t *mutex);
+void qgp_platform_mutex_unlock(qgp_mutex_t *mutex);
+
+/* ============================================================================
+ * Secure Memory
+ * ============================================================================ */
+
+/**
+ * Lock memory into RAM so it is never written to swap
+ *
+ * Linux: mlock()
+ * Windows: VirtualLock()
+ *
+ * Fails if the process exceeds its locked-memory limit (RLIMIT_MEMLOCK /
+ * working set size); callers may continue with unlocked memory.
+ *
+ * @param addr Start of region
+ * @param len Region length in bytes
+ * @return 0 on success, -1 on failure
+ */
+int qgp_platform_lock_memory(void *addr, size_t len);
+
+/**
+ * Unlock memory locked with qgp_platform_lock_memory()
+ *
+ * @param addr Start of region
+ * @param len Region length in bytes
+ */
+void qgp_platform_unlock_memory(void *addr, size_t len);
+
+/**
+ * Zero memory in a way the compiler cannot optimize away
+ *
+ * Linux: volatile byte writes
+ * Windows: SecureZeroMemory()
+ *
+ * @param addr Start of region (NULL is a no-op)
+ * @param len Region length in bytes
+ */
+void qgp_platform_secure_zero(void *addr, size_t len);
+
 /* ============================================================================
  * Platform Detection Macros
  * ============================================================================ */
@@ -9,6 +9,9 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <pwd.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <pthread.h>
 
 #ifdef __linux__
 #include <sys/random.h>
@@ -148,3 +151,178 @@ char* qgp_platform_join_path(const char *dir, const char *file) {
 
     return result;
 }
+
+/* ============================================================================
+ * Memory-Mapped Files (Linux Implementation)
+ * ============================================================================ */
+
+void* qgp_platform_map_file(const char *path, size_t *size_out) {
+    if (!path || !size_out) {
+        return NULL;
+    }
+
+    *size_out = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+
+    void *addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  /* Mapping keeps its own reference */
+
+    if (addr == MAP_FAILED) {
+        return NULL;
+    }
+
+    *size_out = (size_t)st.st_size;
+    return addr;
+}
+
+void qgp_platform_unmap_file(void *addr, size_t size) {
+    if (addr) {
+        munmap(addr, size);
+    }
+}
+
+/* ============================================================================
+ * Advisory File Locks (Linux Implementation)
+ * ============================================================================ */
+
+int qgp_platform_lock_file(FILE *fp) {
+    if (!fp) {
+        return -1;
+    }
+
+    int rc;
+    do {
+        rc = flock(fileno(fp), LOCK_EX);
+    } while (rc != 0 && errno == EINTR);
+
+    return rc == 0 ? 0 : -1;
+}
+
+void qgp_platform_unlock_file(FILE *fp) {
+    if (fp) {
+        flock(fileno(fp), LOCK_UN);
+    }
+}
+
+int qgp_platform_same_file(FILE *fp, const char *path) {
+    struct stat a, b;
+    if (!fp || !path || fstat(fileno(fp), &a) != 0 || stat(path, &b) != 0) {
+        return 0;
+    }
+    return a.st_dev == b.st_dev && a.st_ino == b.st_ino;
+}
+
+int64_t qgp_platform_file_size(FILE *fp) {
+    struct stat st;
+    if (!fp || fstat(fileno(fp), &st) != 0) {
+        return -1;
+    }
+    return (int64_t)st.st_size;
+}
+
+/* ============================================================================
+ * Threads and Mutexes (Linux Implementation)
+ * ============================================================================ */
+
+struct qgp_thread {
+    pthread_t handle;
+};
+
+struct qgp_mutex {
+    pthread_mutex_t handle;
+};
+
+qgp_thread_t* qgp_platform_thread_create(void *(*fn)(void *), void *arg) {
+    qgp_thread_t *thread = malloc(sizeof(qgp_thread_t));
+    if (!thread) {
+        return NULL;
+    }
+
+    if (pthread_create(&thread->handle, NULL, fn, arg) != 0) {
+        free(thread);
+        return NULL;
+    }
+
+    return thread;
+}
+
+void qgp_platform_thread_join(qgp_thread_t *thread) {
+    if (thread) {
+        pthread_join(thread->handle, NULL);
+        free(thread);
+    }
+}
+
+int qgp_platform_cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+qgp_mutex_t* qgp_platform_mutex_new(void) {
+    qgp_mutex_t *mutex = malloc(sizeof(qgp_mutex_t));
+    if (!mutex) {
+        return NULL;
+    }
+
+    if (pthread_mutex_init(&mutex->handle, NULL) != 0) {
+        free(mutex);
+        return NULL;
+    }
+
+    return mutex;
+}
+
+void qgp_platform_mutex_free(qgp_mutex_t *mutex) {
+    if (mutex) {
+        pthread_mutex_destroy(&mutex->handle);
+        free(mutex);
+    }
+}
+
+void qgp_platform_mutex_lock(qgp_mutex_t *mutex) {
+    pthread_mutex_lock(&mutex->handle);
+}
+
+void qgp_platform_mutex_unlock(qgp_mutex_t *mutex) {
+    pthread_mutex_unlock(&mutex->handle);
+}
+
+/* ============================================================================
+ * Secure Memory (Linux Implementation)
+ * ============================================================================ */
+
+int qgp_platform_lock_memory(void *addr, size_t len) {
+    if (!addr || len == 0) {
+        return -1;
+    }
+
+    return mlock(addr, len) == 0 ? 0 : -1;
+}
+
+void qgp_platform_unlock_memory(void *addr, size_t len) {
+    if (addr && len > 0) {
+        munlock(addr, len);
+    }
+}
+
+void qgp_platform_secure_zero(void *addr, size_t len) {
+    volatile uint8_t *p = (volatile uint8_t *)addr;
+
+    if (!p) {
+        return;
+    }
+
+    while (len--) {
+        *p++ = 0;
+    }
+}
@@ -8,6 +8,7 @@
 #include <windows.h>
 #include <bcrypt.h>
 #include <direct.h>  /* _mkdir */
+#include <io.h>      /* _get_osfhandle */
 
 /* Link against bcrypt.lib for BCryptGenRandom */
 #pragma comment(lib, "bcrypt.lib")
@@ -156,4 +157,214 @@ char* qgp_platform_join_path(const char *dir, const char *file) {
     return result;
 }
 
+/* ============================================================================
+ * Memory-Mapped Files (Windows Implementation)
+ * ============================================================================ */
+
+void* qgp_platform_map_file(const char *path, size_t *size_out) {
+    if (!path || !size_out) {
+        return NULL;
+    }
+
+    *size_out = 0;
+
+    /* FILE_SHARE_WRITE: the file may be appended to while mapped */
+    HANDLE file = CreateFileA(path, GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) {
+        return NULL;
+    }
+
+    void *addr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);  /* View keeps the mapping alive */
+
+    if (!addr) {
+        return NULL;
+    }
+
+    *size_out = (size_t)size.QuadPart;
+    return addr;
+}
+
+void qgp_platform_unmap_file(void *addr, size_t size) {
+    (void)size;
+    if (addr) {
+        UnmapViewOfFile(addr);
+    }
+}
+
+/* ============================================================================
+ * Advisory File Locks (Windows Implementation)
+ * ============================================================================ */
+
+/* Lock one byte far past any real data so other handles can still read/append */
+#define QGP_LOCK_OFFSET_HIGH 0x7FFFFFFF
+
+int qgp_platform_lock_file(FILE *fp) {
+    if (!fp) {
+        return -1;
+    }
+
+    HANDLE file = (HANDLE)_get_osfhandle(_fileno(fp));
+    OVERLAPPED ov = {0};
+    ov.OffsetHigh = QGP_LOCK_OFFSET_HIGH;
+
+    return LockFileEx(file, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &ov) ? 0 : -1;
+}
+
+void qgp_platform_unlock_file(FILE *fp) {
+    if (!fp) {
+        return;
+    }
+
+    HANDLE file = (HANDLE)_get_osfhandle(_fileno(fp));
+    OVERLAPPED ov = {0};
+    ov.OffsetHigh = QGP_LOCK_OFFSET_HIGH;
+    UnlockFileEx(file, 0, 1, 0, &ov);
+}
+
+int qgp_platform_same_file(FILE *fp, const char *path) {
+    if (!fp || !path) {
+        return 0;
+    }
+
+    BY_HANDLE_FILE_INFORMATION a, b;
+    if (!GetFileInformationByHandle((HANDLE)_get_osfhandle(_fileno(fp)), &a)) {
+        return 0;
+    }
+
+    HANDLE file = CreateFileA(path, 0,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+    BOOL ok = GetFileInformationByHandle(file, &b);
+    CloseHandle(file);
+
+    return ok && a.dwVolumeSerialNumber == b.dwVolumeSerialNumber &&
+           a.nFileIndexHigh == b.nFileIndexHigh && a.nFileIndexLow == b.nFileIndexLow;
+}
+
+int64_t qgp_platform_file_size(FILE *fp) {
+    LARGE_INTEGER size;
+    if (!fp || !GetFileSizeEx((HANDLE)_get_osfhandle(_fileno(fp)), &size)) {
+        return -1;
+    }
+    return (int64_t)size.QuadPart;
+}
+
+/* ============================================================================
+ * Threads and Mutexes (Windows Implementation)
+ * ============================================================================ */
+
+struct qgp_thread {
+    HANDLE handle;
+    void *(*fn)(void *);
+    void *arg;
+};
+
+struct qgp_mutex {
+    CRITICAL_SECTION cs;
+};
+
+static DWORD WINAPI thread_trampoline(LPVOID param) {
+    qgp_thread_t *thread = (qgp_thread_t *)param;
+    thread->fn(thread->arg);
+    return 0;
+}
+
+qgp_thread_t* qgp_platform_thread_create(void *(*fn)(void *), void *arg) {
+    qgp_thread_t *thread = malloc(sizeof(qgp_thread_t));
+    if (!thread) {
+        return NULL;
+    }
+
+    thread->fn = fn;
+    thread->arg = arg;
+    thread->handle = CreateThread(NULL, 0, thread_trampoline, thread, 0, NULL);
+    if (!thread->handle) {
+        free(thread);
+        return NULL;
+    }
+
+    return thread;
+}
+
+void qgp_platform_thread_join(qgp_thread_t *thread) {
+    if (thread) {
+        WaitForSingleObject(thread->handle, INFINITE);
+        CloseHandle(thread->handle);
+        free(thread);
+    }
+}
+
+int qgp_platform_cpu_count(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+}
+
+qgp_mutex_t* qgp_platform_mutex_new(void) {
+    qgp_mutex_t *mutex = malloc(sizeof(qgp_mutex_t));
+    if (!mutex) {
+        return NULL;
+    }
+
+    InitializeCriticalSection(&mutex->cs);
+    return mutex;
+}
+
+void qgp_platform_mutex_free(qgp_mutex_t *mutex) {
+    if (mutex) {
+        DeleteCriticalSection(&mutex->cs);
+        free(mutex);
+    }
+}
+
+void qgp_platform_mutex_lock(qgp_mutex_t *mutex) {
+    EnterCriticalSection(&mutex->cs);
+}
+
+void qgp_platform_mutex_unlock(qgp_mutex_t *mutex) {
+    LeaveCriticalSection(&mutex->cs);
+}
+
+/* ============================================================================
+ * Secure Memory (Windows Implementation)
+ * ============================================================================ */
+
+int qgp_platform_lock_memory(void *addr, size_t len) {
+    if (!addr || len == 0) {
+        return -1;
+    }
+
+    return VirtualLock(addr, len) ? 0 : -1;
+}
+
+void qgp_platform_unlock_memory(void *addr, size_t len) {
+    if (addr && len > 0) {
+        VirtualUnlock(addr, len);
+    }
+}
+
+void qgp_platform_secure_zero(void *addr, size_t len) {
+    if (addr) {
+        SecureZeroMemory(addr, len);
+    }
+}
+
 #endif /* _WIN32 */
@@ -0,0 +1,25 @@
+-- DNA Messenger - Push notifications for the messages table
+-- Run once against the dna_messenger database (requires PostgreSQL 9.0+).
+--
+-- Clients LISTEN on 'dna_' || md5(identity) (see messenger_subscribe()).
+-- Payload: <event>:<message id>:<group id, 0 if none>:<peer identity>
+--   new     INSERT, sent to the recipient (peer = sender)
+--   status  status change, sent to the sender (peer = recipient)
+
+CREATE OR REPLACE FUNCTION dna_messages_notify() RETURNS trigger AS $$
+BEGIN
+    IF TG_OP = 'INSERT' THEN
+        PERFORM pg_notify('dna_' || md5(NEW.recipient),
+                          'new:' || NEW.id || ':' || COALESCE(NEW.group_id, 0) || ':' || NEW.sender);
+    ELSIF NEW.status IS DISTINCT FROM OLD.status THEN
+        PERFORM pg_notify('dna_' || md5(NEW.sender),
+                          'status:' || NEW.id || ':' || COALESCE(NEW.group_id, 0) || ':' || NEW.recipient);
+    END IF;
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS messages_notify ON messages;
+CREATE TRIGGER messages_notify
+    AFTER INSERT OR UPDATE OF status ON messages
+    FOR EACH ROW EXECUTE PROCEDURE dna_messages_notify();
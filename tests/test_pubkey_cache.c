@@ -0,0 +1,217 @@
+/*
+ * Unit test: pubkey_cache (hash index, LRU eviction, TTL, counters,
+ * expanded-key budget)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pubkey_cache.h"
+#include "test_util.h"
+
+static const uint8_t SIGN_KEY[4] = {1, 2, 3, 4};
+static const uint8_t ENC_KEY[3] = {5, 6, 7};
+
+static void put(pubkey_cache_t *cache, const char *identity) {
+    pubkey_cache_put(cache, identity, SIGN_KEY, sizeof(SIGN_KEY), ENC_KEY, sizeof(ENC_KEY));
+}
+
+static void test_put_get(void) {
+    pubkey_cache_t *cache = pubkey_cache_new(8, 0);
+    CHECK(cache != NULL);
+
+    put(cache, "alice");
+    const pubkey_cache_entry_t *e = pubkey_cache_get(cache, "alice");
+    CHECK(e != NULL);
+    CHECK(strcmp(e->identity, "alice") == 0);
+    CHECK(e->signing_pubkey_len == sizeof(SIGN_KEY));
+    CHECK(memcmp(e->signing_pubkey, SIGN_KEY, sizeof(SIGN_KEY)) == 0);
+    CHECK(e->encryption_pubkey_len == sizeof(ENC_KEY));
+    CHECK(memcmp(e->encryption_pubkey, ENC_KEY, sizeof(ENC_KEY)) == 0);
+    CHECK(pubkey_cache_get(cache, "bob") == NULL);
+
+    // Replacing keeps one entry with the new keys
+    uint8_t other[4] = {9, 9, 9, 9};
+    pubkey_cache_put(cache, "alice", other, sizeof(other), ENC_KEY, sizeof(ENC_KEY));
+    e = pubkey_cache_get(cache, "alice");
+    CHECK(e != NULL && memcmp(e->signing_pubkey, other, sizeof(other)) == 0);
+
+    pubkey_cache_stats_t stats;
+    pubkey_cache_get_stats(cache, &stats);
+    CHECK(stats.hits == 2);
+    CHECK(stats.misses == 1);
+    CHECK(stats.count == 1);
+    CHECK(stats.capacity == 8);
+
+    pubkey_cache_free(cache);
+}
+
+static void test_lru_eviction(void) {
+    pubkey_cache_t *cache = pubkey_cache_new(2, 0);
+
+    put(cache, "a");
+    put(cache, "b");
+    CHECK(pubkey_cache_get(cache, "a") != NULL);   // b is now least recently used
+    put(cache, "c");
+
+    CHECK(pubkey_cache_get(cache, "b") == NULL);
+    CHECK(pubkey_cache_get(cache, "a") != NULL);
+    CHECK(pubkey_cache_get(cache, "c") != NULL);
+
+    pubkey_cache_stats_t stats;
+    pubkey_cache_get_stats(cache, &stats);
+    CHECK(stats.evictions == 1);
+    CHECK(stats.count == 2);
+
+    pubkey_cache_free(cache);
+}
+
+static void test_many_and_remove(void) {
+    pubkey_cache_t *cache = pubkey_cache_new(64, 0);
+    char name[32];
+
+    for (int i = 0; i < 200; i++) {
+        snprintf(name, sizeof(name), "user%d", i);
+        put(cache, name);
+    }
+
+    // Only the 64 most recent survive, all still reachable through the index
+    for (int i = 0; i < 200; i++) {
+        snprintf(name, sizeof(name), "user%d", i);
+        CHECK((pubkey_cache_get(cache, name) != NULL) == (i >= 136));
+    }
+
+    // Backward-shift delete must not cut probe chains
+    for (int i = 136; i < 200; i += 2) {
+        snprintf(name, sizeof(name), "user%d", i);
+        pubkey_cache_remove(cache, name);
+    }
+    for (int i = 136; i < 200; i++) {
+        snprintf(name, sizeof(name), "user%d", i);
+        CHECK((pubkey_cache_get(cache, name) != NULL) == (i % 2 == 1));
+    }
+
+    pubkey_cache_clear(cache);
+    pubkey_cache_stats_t stats;
+    pubkey_cache_get_stats(cache, &stats);
+    CHECK(stats.count == 0);
+    CHECK(pubkey_cache_get(cache, "user199") == NULL);
+
+    // Usable again after clear
+    put(cache, "again");
+    CHECK(pubkey_cache_get(cache, "again") != NULL);
+
+    pubkey_cache_free(cache);
+}
+
+static void test_peek_is_silent(void) {
+    pubkey_cache_t *cache = pubkey_cache_new(2, 0);
+
+    put(cache, "a");
+    put(cache, "b");
+    CHECK(pubkey_cache_peek(cache, "a") != NULL);   // Must not make a most recent
+    CHECK(pubkey_cache_peek(cache, "zz") == NULL);
+    put(cache, "c");
+
+    CHECK(pubkey_cache_peek(cache, "a") == NULL);
+    CHECK(pubkey_cache_peek(cache, "b") != NULL);
+
+    pubkey_cache_stats_t stats;
+    pubkey_cache_get_stats(cache, &stats);
+    CHECK(stats.hits == 0);
+    CHECK(stats.misses == 0);
+
+    pubkey_cache_free(cache);
+}
+
+static void test_expanded_budget(void) {
+    static uint8_t sign_pk[QGP_DILITHIUM3_PUBLICKEYBYTES];
+    size_t one = qgp_dilithium3_expanded_pk_size();
+    const char *names[3] = {"a", "b", "c"};
+
+    pubkey_cache_t *cache = pubkey_cache_new(8, 0);
+    pubkey_cache_set_expanded_max_bytes(cache, 2 * one);
+
+    for (int i = 0; i < 3; i++) {
+        memset(sign_pk, i + 1, sizeof(sign_pk));
+        pubkey_cache_put(cache, names[i], sign_pk, sizeof(sign_pk), ENC_KEY, sizeof(ENC_KEY));
+    }
+
+    // Borrowing for a batch may go over budget; all three stay valid
+    const qgp_dilithium3_expanded_pk *epk[3];
+    for (int i = 0; i < 3; i++) {
+        epk[i] = pubkey_cache_signing_expanded(cache, pubkey_cache_peek(cache, names[i]));
+        CHECK(epk[i] != NULL);
+    }
+    memset(sign_pk, 1, sizeof(sign_pk));
+    CHECK(qgp_dilithium3_expanded_pk_matches(epk[0], sign_pk, sizeof(sign_pk)));
+
+    // Second access reuses the expanded key and marks it recently used
+    CHECK(pubkey_cache_signing_expanded(cache, pubkey_cache_peek(cache, "a")) == epk[0]);
+
+    pubkey_cache_stats_t stats;
+    pubkey_cache_get_stats(cache, &stats);
+    CHECK(stats.expanded_bytes == 3 * one);
+    CHECK(stats.hits == 0);
+
+    // Next lookup trims back to budget, dropping the least recently used (b)
+    const pubkey_cache_entry_t *e = pubkey_cache_get(cache, "c");
+    CHECK(e != NULL);
+    pubkey_cache_get_stats(cache, &stats);
+    CHECK(stats.expanded_bytes == 2 * one);
+    CHECK(stats.expanded_evictions == 1);
+    CHECK(stats.count == 3);
+
+    CHECK(pubkey_cache_peek(cache, "b")->signing_expanded == NULL);
+    CHECK(pubkey_cache_peek(cache, "a")->signing_expanded != NULL);
+    CHECK(pubkey_cache_peek(cache, "c")->signing_expanded != NULL);
+
+    // Dropping an entry releases its expanded bytes
+    pubkey_cache_remove(cache, "a");
+    pubkey_cache_get_stats(cache, &stats);
+    CHECK(stats.expanded_bytes == one);
+
+    // Encryption keys share the budget
+    static uint8_t enc_pk[QGP_KYBER512_PUBLICKEYBYTES];
+    memset(enc_pk, 3, sizeof(enc_pk));
+    pubkey_cache_put(cache, "kem", sign_pk, sizeof(sign_pk), enc_pk, sizeof(enc_pk));
+    const qgp_kyber512_expanded_pk *kpk =
+        pubkey_cache_encryption_expanded(cache, pubkey_cache_peek(cache, "kem"));
+    CHECK(kpk != NULL && qgp_kyber512_expanded_pk_matches(kpk, enc_pk, sizeof(enc_pk)));
+    pubkey_cache_get_stats(cache, &stats);
+    CHECK(stats.expanded_bytes == one + qgp_kyber512_expanded_pk_size());
+    pubkey_cache_remove(cache, "kem");
+
+    // Not a Dilithium3 key: nothing to expand
+    put(cache, "short");
+    CHECK(pubkey_cache_signing_expanded(cache, pubkey_cache_peek(cache, "short")) == NULL);
+
+    pubkey_cache_free(cache);
+}
+
+static void test_ttl(void) {
+    pubkey_cache_t *cache = pubkey_cache_new(4, 1);
+
+    put(cache, "alice");
+    CHECK(pubkey_cache_get(cache, "alice") != NULL);
+
+    test_sleep_ms(2100);
+    CHECK(pubkey_cache_get(cache, "alice") == NULL);
+
+    pubkey_cache_stats_t stats;
+    pubkey_cache_get_stats(cache, &stats);
+    CHECK(stats.expired == 1);
+    CHECK(stats.misses == 1);
+    CHECK(stats.count == 0);
+
+    pubkey_cache_free(cache);
+}
+
+int main(void) {
+    RUN(test_put_get);
+    RUN(test_lru_eviction);
+    RUN(test_many_and_remove);
+    RUN(test_peek_is_silent);
+    RUN(test_expanded_budget);
+    RUN(test_ttl);
+    return test_summary();
+}
@@ -0,0 +1,227 @@
+/*
+ * Unit test: pubkey_store (append, reload, compaction, shared file)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pubkey_store.h"
+#include "test_util.h"
+
+static char *store_path;
+
+static void fill_key(uint8_t *buf, size_t len, uint8_t seed) {
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (uint8_t)(seed + i * 7);
+    }
+}
+
+static int put_keys(pubkey_store_t *st, const char *identity, uint8_t seed, size_t len, uint32_t version) {
+    uint8_t *sign = malloc(len);
+    uint8_t *enc = malloc(len / 2);
+    fill_key(sign, len, seed);
+    fill_key(enc, len / 2, (uint8_t)(seed + 1));
+    int rc = pubkey_store_put(st, identity, sign, len, enc, len / 2, version, 1000 + version);
+    free(sign);
+    free(enc);
+    return rc;
+}
+
+/**
+ * Check that identity's stored keys are the ones put with seed
+ */
+static int has_keys(pubkey_store_t *st, const char *identity, uint8_t seed, size_t len) {
+    pubkey_store_record_t rec;
+    if (pubkey_store_get(st, identity, &rec) != 0) {
+        return 0;
+    }
+
+    uint8_t *sign = malloc(len);
+    uint8_t *enc = malloc(len / 2);
+    fill_key(sign, len, seed);
+    fill_key(enc, len / 2, (uint8_t)(seed + 1));
+
+    int ok = strcmp(rec.identity, identity) == 0 &&
+             rec.signing_pubkey_len == len && memcmp(rec.signing_pubkey, sign, len) == 0 &&
+             rec.encryption_pubkey_len == len / 2 && memcmp(rec.encryption_pubkey, enc, len / 2) == 0;
+
+    free(sign);
+    free(enc);
+    pubkey_store_record_free(&rec);
+    return ok;
+}
+
+static void cleanup(void) {
+    char path[600];
+    remove(store_path);
+    snprintf(path, sizeof(path), "%s.bad", store_path);
+    remove(path);
+    snprintf(path, sizeof(path), "%s.tmp", store_path);
+    remove(path);
+}
+
+static void test_put_get_reload(void) {
+    cleanup();
+    pubkey_store_t *st = pubkey_store_open(store_path);
+    CHECK(st != NULL);
+
+    CHECK(put_keys(st, "alice", 1, 64, 1) == 0);
+    CHECK(put_keys(st, "bob", 2, 64, 1) == 0);
+    CHECK(put_keys(st, "alice", 3, 64, 2) == 0);   // Latest wins
+
+    CHECK(has_keys(st, "alice", 3, 64));
+    CHECK(has_keys(st, "bob", 2, 64));
+    CHECK(!has_keys(st, "carol", 0, 64));
+    CHECK(pubkey_store_count(st) == 2);
+
+    pubkey_store_record_t rec;
+    CHECK(pubkey_store_get(st, "alice", &rec) == 0);
+    CHECK(rec.key_version == 2 && rec.fetched_at == 1002);
+    pubkey_store_record_free(&rec);
+
+    pubkey_store_close(st);
+
+    st = pubkey_store_open(store_path);
+    CHECK(st != NULL);
+    CHECK(has_keys(st, "alice", 3, 64));
+    CHECK(has_keys(st, "bob", 2, 64));
+    CHECK(pubkey_store_count(st) == 2);
+    pubkey_store_close(st);
+}
+
+static void test_two_writers(void) {
+    cleanup();
+    pubkey_store_t *a = pubkey_store_open(store_path);
+    pubkey_store_t *b = pubkey_store_open(store_path);
+    CHECK(a != NULL && b != NULL);
+
+    // Same-length identities and key sizes: records are the same size,
+    // so stale offsets would land on the other identity's record
+    CHECK(put_keys(a, "alice", 10, 64, 1) == 0);
+    CHECK(put_keys(b, "bobby", 20, 64, 1) == 0);
+    CHECK(put_keys(a, "carol", 30, 64, 1) == 0);
+    CHECK(put_keys(b, "alice", 40, 64, 2) == 0);
+
+    CHECK(has_keys(a, "bobby", 20, 64));
+    CHECK(has_keys(a, "alice", 40, 64));
+    CHECK(has_keys(b, "carol", 30, 64));
+    CHECK(has_keys(b, "alice", 40, 64));
+    CHECK(pubkey_store_count(a) == 3);
+
+    pubkey_store_close(a);
+    pubkey_store_close(b);
+
+    pubkey_store_t *c = pubkey_store_open(store_path);
+    CHECK(has_keys(c, "alice", 40, 64));
+    CHECK(has_keys(c, "bobby", 20, 64));
+    CHECK(has_keys(c, "carol", 30, 64));
+    pubkey_store_close(c);
+}
+
+static void test_compaction_by_other_process(void) {
+    cleanup();
+    pubkey_store_t *a = pubkey_store_open(store_path);
+
+    // Many superseded records make the file worth compacting on open
+    CHECK(put_keys(a, "bob", 5, 256, 1) == 0);
+    for (int i = 0; i < 60; i++) {
+        CHECK(put_keys(a, "alice", (uint8_t)i, 4096, (uint32_t)i) == 0);
+    }
+
+    FILE *fp = fopen(store_path, "rb");
+    fseek(fp, 0, SEEK_END);
+    long before = ftell(fp);
+    fclose(fp);
+
+    pubkey_store_t *b = pubkey_store_open(store_path);   // Compacts and renames
+    CHECK(b != NULL);
+
+    fp = fopen(store_path, "rb");
+    fseek(fp, 0, SEEK_END);
+    long after = ftell(fp);
+    fclose(fp);
+    CHECK(after < before / 4);
+
+    // a still holds the replaced file; it must notice and follow the new one
+    CHECK(has_keys(a, "alice", 59, 4096));
+    CHECK(put_keys(a, "carol", 77, 64, 1) == 0);
+    CHECK(has_keys(b, "carol", 77, 64));
+    CHECK(has_keys(b, "bob", 5, 256));
+
+    pubkey_store_close(a);
+    pubkey_store_close(b);
+
+    pubkey_store_t *c = pubkey_store_open(store_path);
+    CHECK(has_keys(c, "carol", 77, 64));
+    CHECK(has_keys(c, "alice", 59, 4096));
+    CHECK(pubkey_store_count(c) == 3);
+    pubkey_store_close(c);
+}
+
+static void test_torn_append(void) {
+    cleanup();
+    pubkey_store_t *a = pubkey_store_open(store_path);
+    pubkey_store_t *b = pubkey_store_open(store_path);
+    CHECK(put_keys(a, "alice", 1, 64, 1) == 0);
+
+    // Crashed writer left half a record at the end
+    FILE *fp = fopen(store_path, "ab");
+    uint8_t junk[30];
+    memset(junk, 0x5A, sizeof(junk));
+    junk[0] = 200;   // Claims more bytes than exist
+    junk[1] = junk[2] = junk[3] = 0;
+    fwrite(junk, 1, sizeof(junk), fp);
+    fclose(fp);
+
+    // b compacts the tail away, so a later append is not hidden behind it
+    CHECK(put_keys(b, "bob", 2, 64, 1) == 0);
+    CHECK(has_keys(a, "bob", 2, 64));
+    CHECK(has_keys(a, "alice", 1, 64));
+
+    pubkey_store_close(a);
+    pubkey_store_close(b);
+
+    pubkey_store_t *c = pubkey_store_open(store_path);
+    CHECK(has_keys(c, "alice", 1, 64));
+    CHECK(has_keys(c, "bob", 2, 64));
+    pubkey_store_close(c);
+}
+
+static void test_unknown_format_set_aside(void) {
+    cleanup();
+    FILE *fp = fopen(store_path, "wb");
+    fputs("DNAPKS99 some future format", fp);
+    fclose(fp);
+
+    pubkey_store_t *st = pubkey_store_open(store_path);
+    CHECK(st != NULL);
+    CHECK(pubkey_store_count(st) == 0);
+    CHECK(put_keys(st, "alice", 1, 64, 1) == 0);
+    CHECK(has_keys(st, "alice", 1, 64));
+    pubkey_store_close(st);
+
+    char bad_path[600];
+    char buf[64] = {0};
+    snprintf(bad_path, sizeof(bad_path), "%s.bad", store_path);
+    fp = fopen(bad_path, "rb");
+    CHECK(fp != NULL);
+    if (fp) {
+        CHECK(fread(buf, 1, sizeof(buf) - 1, fp) > 0);
+        fclose(fp);
+    }
+    CHECK(strcmp(buf, "DNAPKS99 some future format") == 0);
+}
+
+int main(void) {
+    store_path = test_temp_path("pubkeys.cache");
+
+    RUN(test_put_get_reload);
+    RUN(test_two_writers);
+    RUN(test_compaction_by_other_process);
+    RUN(test_torn_append);
+    RUN(test_unknown_format_set_aside);
+
+    cleanup();
+    free(store_path);
+    return test_summary();
+}
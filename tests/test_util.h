@@ -0,0 +1,66 @@
+/*
+ * Minimal helpers shared by the unit test programs
+ */
+
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+static int test_failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        test_failures++; \
+    } \
+} while (0)
+
+#define RUN(fn) do { \
+    int before_ = test_failures; \
+    fn(); \
+    printf("%s %s\n", test_failures == before_ ? "✓" : "✗", #fn); \
+} while (0)
+
+static inline int test_summary(void) {
+    if (test_failures) {
+        fprintf(stderr, "%d check(s) failed\n", test_failures);
+        return 1;
+    }
+    printf("✓ All tests passed!\n");
+    return 0;
+}
+
+static inline void test_sleep_ms(int ms) {
+#ifdef _WIN32
+    Sleep((DWORD)ms);
+#else
+    usleep((useconds_t)ms * 1000);
+#endif
+}
+
+/**
+ * Scratch file path unique to this process (caller frees)
+ */
+static inline char* test_temp_path(const char *name) {
+    char *path = malloc(512);
+    if (path) {
+#ifdef _WIN32
+        const char *dir = getenv("TEMP");
+        snprintf(path, 512, "%s\\dna-test-%lu-%s", dir ? dir : ".", (unsigned long)GetCurrentProcessId(), name);
+#else
+        const char *dir = getenv("TMPDIR");
+        snprintf(path, 512, "%s/dna-test-%ld-%s", dir ? dir : "/tmp", (long)getpid(), name);
+#endif
+    }
+    return path;
+}
+
+#endif // TEST_UTIL_H